@@ -0,0 +1,730 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file bench/swifft_bench.cpp
+ * \brief LibSWIFFT benchmark with machine-readable reports
+ *
+ * Runs every FFT, arithmetic and hash entry point of the SWIFFT object of each
+ * supported instruction-set, over batches of blocks from 1 up to beyond the
+ * last-level cache, and for the functions for multiple blocks, over thread
+ * pools of 1 up to one thread per CPU. Each configuration is timed over a
+ * number of samples, and reported in CSV or JSON as percentiles of cycles per
+ * byte and GB/s, where the GB/s of a percentile is that of its time, so that
+ * higher percentiles are slower, along with the data-TLB misses per block
+ * where the kernel exposes the hardware counter.
+ *
+ * Run with --help for the options.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include "libswifft/swifft.h"
+#include "libswifft/swifft_executor.h"
+#include "libswifft/swifft_object.h"
+#include "libswifft/swifft_pool.h"
+#include "libswifft/swifft_runtime_key.h"
+#include "libswifft/swifft_soa.h"
+#include "libswifft/swifft_ver.h"
+#include "testcommon.h"
+
+#define SWIFFT_ISET() SWIFFT_INSTRUCTION_SET
+#include "swifft_impl.inl"
+
+namespace LibSwifft {
+
+//! The size in bytes of the FFT-output elements of a block.
+static const size_t fftoutBlockSize = SWIFFT_N * SWIFFT_M * sizeof(int16_t);
+//! The length in bytes of the range changed by the update functions.
+static const size_t updateLength = 8;
+//! The number of keys of the multi-key functions.
+static const int benchKeys = 8;
+
+//! \brief An instruction-set whose SWIFFT object is benchmarked.
+struct BenchIset {
+	const char *name;                            ///< The name of the instruction-set
+	int (*isSupported)(void);                    ///< Checks whether the running CPU supports it
+	void (*initObject)(swifft_object_t *swifft); ///< Initializes its SWIFFT object
+};
+
+static const BenchIset benchIsets[] = {
+#if defined(__aarch64__)
+	{ "NEON", SWIFFT_IsSupported_NEON, SWIFFT_InitObject_NEON },
+#else
+	{ "AVX", SWIFFT_IsSupported_AVX, SWIFFT_InitObject_AVX },
+	{ "AVX2", SWIFFT_IsSupported_AVX2, SWIFFT_InitObject_AVX2 },
+	{ "AVX512", SWIFFT_IsSupported_AVX512, SWIFFT_InitObject_AVX512 },
+	{ "AVX512BW", SWIFFT_IsSupported_AVX512BW, SWIFFT_InitObject_AVX512BW },
+#endif
+};
+
+//! \brief An aligned buffer, with no copying.
+struct BenchBuffer {
+	BitSequence *data;
+	BenchBuffer() : data(NULL) {}
+	~BenchBuffer() { free(data); }
+	BenchBuffer(const BenchBuffer &) = delete;
+	BenchBuffer & operator=(const BenchBuffer &) = delete;
+	//! \brief Allocates the buffer, filled with random bytes.
+	//! \returns whether it was allocated.
+	bool allocate(size_t size) {
+		free(data);
+		data = static_cast<BitSequence *>(aligned_alloc(SWIFFT_ALIGNMENT, (size + SWIFFT_ALIGNMENT - 1) / SWIFFT_ALIGNMENT * SWIFFT_ALIGNMENT));
+		for (size_t i=0; data != NULL && i<size; i++) {
+			data[i] = (BitSequence)rand();
+		}
+		return data != NULL;
+	}
+	template <class T> T * as() const { return reinterpret_cast<T *>(data); }
+};
+
+//! \brief The buffers an entry point operates on, allocated per batch as it needs.
+struct BenchContext {
+	const swifft_object_t *swifft;  ///< The SWIFFT object
+	const swifft_key_t *key;        ///< The key of the functions with a key
+	const swifft_key_t *keys;       ///< The benchKeys keys of the multi-key functions
+	int nblocks;                    ///< The number of blocks of the batch
+	BenchBuffer input;              ///< The blocks of input
+	BenchBuffer sign;               ///< The blocks of sign bits
+	BenchBuffer zeros;              ///< Blocks of all-zero sign bits, for unsigned FFTs
+	BenchBuffer signMask;           ///< The sign-masks of the blocks
+	BenchBuffer signs;              ///< The uniform sign bytes of the blocks
+	BenchBuffer output;             ///< The hash values
+	BenchBuffer operand;            ///< The hash values operated with
+	BenchBuffer compact;            ///< The compacted hash values
+	BenchBuffer fftout;             ///< The FFT-output elements
+	BenchBuffer constants;          ///< The constant values, per block
+	BenchBuffer soaInput;           ///< The batches of input in the structure-of-arrays layout
+	BenchBuffer soaOutput;          ///< The batches of hash values in the structure-of-arrays layout
+	BenchBuffer oldBytes;           ///< The old bytes of the updated range, per block
+	BenchBuffer newBytes;           ///< The new bytes of the updated range, per block
+	BenchBuffer multiOutput;        ///< The hash values of the multi-key functions, benchKeys per block
+	BenchBuffer pointers;           ///< The addresses of the blocks of input and of the hash values, for the gather functions
+
+	BitSequence *inputAt(int i) const { return input.data + (size_t)i * SWIFFT_INPUT_BLOCK_SIZE; }
+	BitSequence *signAt(int i) const { return sign.data + (size_t)i * SWIFFT_INPUT_BLOCK_SIZE; }
+	BitSequence *zerosAt(int i) const { return zeros.data + (size_t)i * SWIFFT_INPUT_BLOCK_SIZE; }
+	BitSequence *outputAt(int i) const { return output.data + (size_t)i * SWIFFT_OUTPUT_BLOCK_SIZE; }
+	BitSequence *operandAt(int i) const { return operand.data + (size_t)i * SWIFFT_OUTPUT_BLOCK_SIZE; }
+	BitSequence *multiOutputAt(int i) const { return multiOutput.data + (size_t)i * benchKeys * SWIFFT_OUTPUT_BLOCK_SIZE; }
+	BitSequence *compactAt(int i) const { return compact.data + (size_t)i * SWIFFT_COMPACT_BLOCK_SIZE; }
+	int16_t *fftoutAt(int i) const { return fftout.as<int16_t>() + (size_t)i * SWIFFT_N * SWIFFT_M; }
+	int16_t *constantsAt(int i) const { return constants.as<int16_t>() + i; }
+	const BitSequence * const *inputPointers() const { return pointers.as<const BitSequence *>(); }
+	BitSequence * const *outputPointers() const { return pointers.as<BitSequence *>() + nblocks; }
+};
+
+//! The buffers an entry point needs, as bit flags.
+enum {
+	NEEDS_INPUT = 1 << 0, NEEDS_SIGN = 1 << 1, NEEDS_ZEROS = 1 << 2, NEEDS_OUTPUT = 1 << 3,
+	NEEDS_OPERAND = 1 << 4, NEEDS_COMPACT = 1 << 5, NEEDS_FFTOUT = 1 << 6, NEEDS_CONSTANTS = 1 << 7,
+	NEEDS_SOA = 1 << 8, NEEDS_UPDATE = 1 << 9, NEEDS_MULTIKEY = 1 << 10,
+	NEEDS_SIGN_MASK = 1 << 11, NEEDS_UNIFORM_SIGN = 1 << 12, NEEDS_POINTERS = 1 << 13,
+};
+
+//! \brief A benchmarked entry point of the SWIFFT object.
+struct BenchOp {
+	const char *name;      ///< The name of the entry point
+	const char *api;       ///< The API of the entry point: fft, arith or hash
+	const char *sign;      ///< Whether the input is signed: signed, unsigned, or none if not applicable
+	bool multiple;         ///< Whether the entry point is for multiple blocks, running on the executor
+	int needs;             ///< The buffers the entry point needs, see NEEDS_*
+	size_t blockBytes;     ///< The bytes of data processed per block, for cycles per byte and GB/s
+	std::function<void(const BenchContext &)> run; ///< Runs the entry point over the batch
+};
+
+//! \brief Returns the size in bytes of the buffers of a batch touched by an entry point.
+static size_t footprint(const BenchOp &op, size_t nblocks) {
+	size_t size = 0;
+	size += (op.needs & NEEDS_INPUT) ? SWIFFT_INPUT_BLOCK_SIZE : 0;
+	size += (op.needs & (NEEDS_SIGN | NEEDS_ZEROS)) ? SWIFFT_INPUT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_OUTPUT) ? SWIFFT_OUTPUT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_OPERAND) ? SWIFFT_OUTPUT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_COMPACT) ? SWIFFT_COMPACT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_FFTOUT) ? fftoutBlockSize : 0;
+	size += (op.needs & NEEDS_CONSTANTS) ? sizeof(int16_t) : 0;
+	size += (op.needs & NEEDS_SOA) ? SWIFFT_INPUT_BLOCK_SIZE + SWIFFT_OUTPUT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_UPDATE) ? 2 * updateLength : 0;
+	size += (op.needs & NEEDS_MULTIKEY) ? benchKeys * SWIFFT_OUTPUT_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_SIGN_MASK) ? SWIFFT_SIGN_MASK_BLOCK_SIZE : 0;
+	size += (op.needs & NEEDS_UNIFORM_SIGN) ? 1 : 0;
+	size += (op.needs & NEEDS_POINTERS) ? 2 * sizeof(BitSequence *) : 0;
+	return size * nblocks;
+}
+
+//! \brief Allocates the buffers of a batch that an entry point needs.
+//! \returns whether they were allocated.
+static bool allocate(BenchContext &c, const BenchOp &op) {
+	const size_t n = c.nblocks;
+	bool ok = true;
+	ok = ok && (!(op.needs & NEEDS_INPUT) || c.input.allocate(n * SWIFFT_INPUT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_SIGN) || c.sign.allocate(n * SWIFFT_INPUT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_ZEROS) || c.zeros.allocate(n * SWIFFT_INPUT_BLOCK_SIZE));
+	if (ok && (op.needs & NEEDS_ZEROS)) {
+		memset(c.zeros.data, 0, n * SWIFFT_INPUT_BLOCK_SIZE);
+	}
+	ok = ok && (!(op.needs & NEEDS_OUTPUT) || c.output.allocate(n * SWIFFT_OUTPUT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_OPERAND) || c.operand.allocate(n * SWIFFT_OUTPUT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_COMPACT) || c.compact.allocate(n * SWIFFT_COMPACT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_FFTOUT) || c.fftout.allocate(n * fftoutBlockSize));
+	ok = ok && (!(op.needs & NEEDS_CONSTANTS) || c.constants.allocate(n * sizeof(int16_t)));
+	ok = ok && (!(op.needs & NEEDS_SOA) || c.soaInput.allocate(SWIFFT_SOA_BATCHES(n) * SWIFFT_SOA_INPUT_BATCH_SIZE));
+	ok = ok && (!(op.needs & NEEDS_SOA) || c.soaOutput.allocate(SWIFFT_SOA_BATCHES(n) * SWIFFT_SOA_OUTPUT_BATCH_SIZE));
+	ok = ok && (!(op.needs & NEEDS_UPDATE) || c.oldBytes.allocate(n * updateLength));
+	ok = ok && (!(op.needs & NEEDS_UPDATE) || c.newBytes.allocate(n * updateLength));
+	ok = ok && (!(op.needs & NEEDS_MULTIKEY) || c.multiOutput.allocate(n * benchKeys * SWIFFT_OUTPUT_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_SIGN_MASK) || c.signMask.allocate(n * SWIFFT_SIGN_MASK_BLOCK_SIZE));
+	ok = ok && (!(op.needs & NEEDS_UNIFORM_SIGN) || c.signs.allocate(n));
+	ok = ok && (!(op.needs & NEEDS_POINTERS) || c.pointers.allocate(n * 2 * sizeof(BitSequence *)));
+	if (!ok) {
+		return false;
+	}
+	// hash values and FFT-output elements in the ranges produced by the library
+	if (op.needs & NEEDS_INPUT) {
+		if (op.needs & NEEDS_OUTPUT) {
+			SWIFFT_ComputeMultiple(c.nblocks, c.input.data, c.output.data);
+		}
+		if (op.needs & NEEDS_OPERAND) {
+			SWIFFT_ComputeMultiple(c.nblocks, c.input.data, c.operand.data);
+		}
+		if (op.needs & NEEDS_FFTOUT) {
+			SWIFFT_fftMultiple(c.nblocks, c.input.data, (op.needs & NEEDS_SIGN) ? c.sign.data : c.zeros.data, SWIFFT_M, c.fftoutAt(0));
+		}
+	}
+	else {
+		for (size_t i=0; (op.needs & NEEDS_OUTPUT) && i<n*SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(int16_t); i++) {
+			c.output.as<int16_t>()[i] = (int16_t)(rand() % 257);
+		}
+		for (size_t i=0; (op.needs & NEEDS_OPERAND) && i<n*SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(int16_t); i++) {
+			c.operand.as<int16_t>()[i] = (int16_t)(rand() % 257);
+		}
+	}
+	if (op.needs & NEEDS_SOA) {
+		SWIFFT_InputToSoA(c.nblocks, c.input.data, c.soaInput.data);
+	}
+	for (size_t i=0; (op.needs & NEEDS_POINTERS) && i<n; i++) {
+		c.pointers.as<BitSequence *>()[i] = c.inputAt((int)i);
+		c.pointers.as<BitSequence *>()[n + i] = c.outputAt((int)i);
+	}
+	return true;
+}
+
+//! \brief Returns the benchmarked entry points.
+static std::vector<BenchOp> benchOps() {
+	typedef const BenchContext & C;
+	const size_t I = SWIFFT_INPUT_BLOCK_SIZE, O = SWIFFT_OUTPUT_BLOCK_SIZE;
+	const int IN = NEEDS_INPUT, SG = NEEDS_SIGN, ZS = NEEDS_ZEROS, OUT = NEEDS_OUTPUT, OPD = NEEDS_OPERAND,
+		CMP = NEEDS_COMPACT, FFT = NEEDS_FFTOUT, CST = NEEDS_CONSTANTS, SOA = NEEDS_SOA, UPD = NEEDS_UPDATE,
+		MK = NEEDS_MULTIKEY, SM = NEEDS_SIGN_MASK, US = NEEDS_UNIFORM_SIGN, PTR = NEEDS_POINTERS;
+	std::vector<BenchOp> ops = {
+		{ "SWIFFT_fft", "fft", "unsigned", false, IN | ZS | FFT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->fft.SWIFFT_fft(c.inputAt(i), c.zerosAt(i), SWIFFT_M, c.fftoutAt(i)); } },
+		{ "SWIFFT_fft", "fft", "signed", false, IN | SG | FFT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->fft.SWIFFT_fft(c.inputAt(i), c.signAt(i), SWIFFT_M, c.fftoutAt(i)); } },
+		{ "SWIFFT_fftsum", "fft", "none", false, IN | ZS | FFT | OUT, fftoutBlockSize, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->fft.SWIFFT_fftsum(SWIFFT_PI_key, c.fftoutAt(i), SWIFFT_M, (int16_t *)c.outputAt(i)); } },
+		{ "SWIFFT_fftMultiple", "fft", "unsigned", true, IN | ZS | FFT, I, [](C c) {
+			c.swifft->fft.SWIFFT_fftMultiple(c.nblocks, c.input.data, c.zeros.data, SWIFFT_M, c.fftoutAt(0)); } },
+		{ "SWIFFT_fftMultiple", "fft", "signed", true, IN | SG | FFT, I, [](C c) {
+			c.swifft->fft.SWIFFT_fftMultiple(c.nblocks, c.input.data, c.sign.data, SWIFFT_M, c.fftoutAt(0)); } },
+		{ "SWIFFT_fftsumMultiple", "fft", "none", true, IN | ZS | FFT | OUT, fftoutBlockSize, [](C c) {
+			c.swifft->fft.SWIFFT_fftsumMultiple(c.nblocks, SWIFFT_PI_key, c.fftoutAt(0), SWIFFT_M, (int16_t *)c.output.data); } },
+
+		{ "SWIFFT_ConstSet", "arith", "none", false, OUT | CST, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_ConstSet(c.outputAt(i), *c.constantsAt(i)); } },
+		{ "SWIFFT_ConstAdd", "arith", "none", false, OUT | CST, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_ConstAdd(c.outputAt(i), *c.constantsAt(i)); } },
+		{ "SWIFFT_ConstSub", "arith", "none", false, OUT | CST, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_ConstSub(c.outputAt(i), *c.constantsAt(i)); } },
+		{ "SWIFFT_ConstMul", "arith", "none", false, OUT | CST, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_ConstMul(c.outputAt(i), *c.constantsAt(i)); } },
+		{ "SWIFFT_Set", "arith", "none", false, OUT | OPD, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_Set(c.outputAt(i), c.operandAt(i)); } },
+		{ "SWIFFT_Add", "arith", "none", false, OUT | OPD, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_Add(c.outputAt(i), c.operandAt(i)); } },
+		{ "SWIFFT_Sub", "arith", "none", false, OUT | OPD, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_Sub(c.outputAt(i), c.operandAt(i)); } },
+		{ "SWIFFT_Mul", "arith", "none", false, OUT | OPD, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->arith.SWIFFT_Mul(c.outputAt(i), c.operandAt(i)); } },
+		{ "SWIFFT_ConstSetMultiple", "arith", "none", true, OUT | CST, O, [](C c) {
+			c.swifft->arith.SWIFFT_ConstSetMultiple(c.nblocks, c.output.data, c.constantsAt(0)); } },
+		{ "SWIFFT_ConstAddMultiple", "arith", "none", true, OUT | CST, O, [](C c) {
+			c.swifft->arith.SWIFFT_ConstAddMultiple(c.nblocks, c.output.data, c.constantsAt(0)); } },
+		{ "SWIFFT_ConstSubMultiple", "arith", "none", true, OUT | CST, O, [](C c) {
+			c.swifft->arith.SWIFFT_ConstSubMultiple(c.nblocks, c.output.data, c.constantsAt(0)); } },
+		{ "SWIFFT_ConstMulMultiple", "arith", "none", true, OUT | CST, O, [](C c) {
+			c.swifft->arith.SWIFFT_ConstMulMultiple(c.nblocks, c.output.data, c.constantsAt(0)); } },
+		{ "SWIFFT_SetMultiple", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_SetMultiple(c.nblocks, c.output.data, c.operand.data); } },
+		{ "SWIFFT_AddMultiple", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_AddMultiple(c.nblocks, c.output.data, c.operand.data); } },
+		{ "SWIFFT_SubMultiple", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_SubMultiple(c.nblocks, c.output.data, c.operand.data); } },
+		{ "SWIFFT_MulMultiple", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_MulMultiple(c.nblocks, c.output.data, c.operand.data); } },
+		{ "SWIFFT_SumMultiple", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_SumMultiple(c.nblocks, c.operand.data, c.output.data); } },
+		{ "SWIFFT_LinearCombination", "arith", "none", true, OUT | OPD | CST, O, [](C c) {
+			c.swifft->arith.SWIFFT_LinearCombination(c.nblocks, c.constantsAt(0), c.operand.data, c.output.data); } },
+		{ "SWIFFT_AddMultipleStrided", "arith", "none", true, OUT | OPD, O, [](C c) {
+			c.swifft->arith.SWIFFT_AddMultipleStrided(c.nblocks, c.output.data, O, c.operand.data, O); } },
+
+		{ "SWIFFT_Compact", "hash", "none", false, OUT | CMP, O, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_Compact(c.outputAt(i), c.compactAt(i)); } },
+		{ "SWIFFT_CompactMultiple", "hash", "none", true, OUT | CMP, O, [](C c) {
+			c.swifft->hash.SWIFFT_CompactMultiple(c.nblocks, c.output.data, c.compact.data); } },
+		{ "SWIFFT_CompactMultipleStrided", "hash", "none", true, OUT | CMP, O, [](C c) {
+			c.swifft->hash.SWIFFT_CompactMultipleStrided(c.nblocks, c.output.data, O, c.compact.data, SWIFFT_COMPACT_BLOCK_SIZE); } },
+		{ "SWIFFT_Compute", "hash", "unsigned", false, IN | OUT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_Compute(c.inputAt(i), c.outputAt(i)); } },
+		{ "SWIFFT_ComputeSigned", "hash", "signed", false, IN | SG | OUT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeSigned(c.inputAt(i), c.signAt(i), c.outputAt(i)); } },
+		{ "SWIFFT_ComputeSparse", "hash", "unsigned", false, IN | OUT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeSparse(c.inputAt(i), c.outputAt(i)); } },
+		// on 32-byte inputs, for comparison with SWIFFT_Compute on the zero-padded blocks
+		{ "SWIFFT_ComputeShort", "hash", "unsigned", false, IN | OUT, 8 * SWIFFT_SHORT_COLUMNS, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeShort(SWIFFT_SHORT_COLUMNS, c.inputAt(i), c.outputAt(i)); } },
+		{ "SWIFFT_ComputeWithKey", "hash", "unsigned", false, IN | OUT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeWithKey(c.key, c.inputAt(i), c.outputAt(i)); } },
+		{ "SWIFFT_ComputeWithKeySigned", "hash", "signed", false, IN | SG | OUT, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeWithKeySigned(c.key, c.inputAt(i), c.signAt(i), c.outputAt(i)); } },
+		{ "SWIFFT_ComputeMultiKey", "hash", "unsigned", false, IN | MK, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeMultiKey(benchKeys, c.keys, c.inputAt(i), c.multiOutputAt(i)); } },
+		{ "SWIFFT_ComputeMultiKeySigned", "hash", "signed", false, IN | SG | MK, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeMultiKeySigned(benchKeys, c.keys, c.inputAt(i), c.signAt(i), c.multiOutputAt(i)); } },
+		{ "SWIFFT_Update", "hash", "unsigned", false, OUT | UPD, updateLength, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_Update(c.outputAt(i),
+				c.oldBytes.data + i * updateLength, c.newBytes.data + i * updateLength, 0, updateLength); } },
+		{ "SWIFFT_UpdateSigned", "hash", "signed", false, OUT | UPD, updateLength, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_UpdateSigned(c.outputAt(i),
+				c.oldBytes.data + i * updateLength, c.oldBytes.data + i * updateLength,
+				c.newBytes.data + i * updateLength, c.newBytes.data + i * updateLength, 0, updateLength); } },
+		{ "SWIFFT_ComputeCompact", "hash", "unsigned", false, IN | CMP, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeCompact(c.inputAt(i), c.compactAt(i)); } },
+		{ "SWIFFT_ComputeCompactSigned", "hash", "signed", false, IN | SG | CMP, I, [](C c) {
+			for (int i=0; i<c.nblocks; i++) c.swifft->hash.SWIFFT_ComputeCompactSigned(c.inputAt(i), c.signAt(i), c.compactAt(i)); } },
+		{ "SWIFFT_ComputeMultiple", "hash", "unsigned", true, IN | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultiple(c.nblocks, c.input.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultipleSigned", "hash", "signed", true, IN | SG | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleSigned(c.nblocks, c.input.data, c.sign.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultipleSignMask", "hash", "signed", true, IN | SM | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleSignMask(c.nblocks, c.input.data, c.signMask.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultipleUniformSign", "hash", "signed", true, IN | US | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleUniformSign(c.nblocks, c.input.data, c.signs.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultipleStrided", "hash", "unsigned", true, IN | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleStrided(c.nblocks, c.input.data, I, c.output.data, O); } },
+		{ "SWIFFT_ComputeMultipleSignedStrided", "hash", "signed", true, IN | SG | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleSignedStrided(c.nblocks, c.input.data, I, c.sign.data, I, c.output.data, O); } },
+		{ "SWIFFT_ComputeMultipleGather", "hash", "unsigned", true, IN | OUT | PTR, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleGather(c.nblocks, c.inputPointers(), c.outputPointers()); } },
+		{ "SWIFFT_ComputeSparseMultiple", "hash", "unsigned", true, IN | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeSparseMultiple(c.nblocks, c.input.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultipleSoA", "hash", "unsigned", true, IN | SOA, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultipleSoA(c.nblocks, c.soaInput.data, c.soaOutput.data); } },
+		{ "SWIFFT_ComputeCompactMultiple", "hash", "unsigned", true, IN | CMP, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeCompactMultiple(c.nblocks, c.input.data, c.compact.data); } },
+		{ "SWIFFT_ComputeCompactMultipleSigned", "hash", "signed", true, IN | SG | CMP, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeCompactMultipleSigned(c.nblocks, c.input.data, c.sign.data, c.compact.data); } },
+		{ "SWIFFT_ComputeWithKeyMultiple", "hash", "unsigned", true, IN | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeWithKeyMultiple(c.nblocks, c.key, c.input.data, c.output.data); } },
+		{ "SWIFFT_ComputeWithKeyMultipleSigned", "hash", "signed", true, IN | SG | OUT, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeWithKeyMultipleSigned(c.nblocks, c.key, c.input.data, c.sign.data, c.output.data); } },
+		{ "SWIFFT_ComputeMultiKeyMultiple", "hash", "unsigned", true, IN | MK, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultiKeyMultiple(c.nblocks, benchKeys, c.keys, c.input.data, c.multiOutput.data); } },
+		{ "SWIFFT_ComputeMultiKeyMultipleSigned", "hash", "signed", true, IN | SG | MK, I, [](C c) {
+			c.swifft->hash.SWIFFT_ComputeMultiKeyMultipleSigned(c.nblocks, benchKeys, c.keys, c.input.data, c.sign.data, c.multiOutput.data); } },
+		{ "SWIFFT_UpdateMultiple", "hash", "unsigned", true, OUT | UPD, updateLength, [](C c) {
+			c.swifft->hash.SWIFFT_UpdateMultiple(c.nblocks, c.output.data, c.oldBytes.data, c.newBytes.data, 0, updateLength); } },
+	};
+	return ops;
+}
+
+//! \brief The options of a benchmark run.
+struct BenchOptions {
+	bool json = false;                  ///< Whether to report in JSON rather than CSV
+	std::vector<std::string> isets;     ///< The instruction-sets to run, or empty for all supported
+	std::vector<std::string> ops;       ///< Substrings of the names of the entry points to run, or empty for all
+	std::vector<int> threads;           ///< The numbers of threads, or empty for powers of 2 up to one per CPU
+	std::vector<int> blocks;            ///< The batch sizes, or empty for powers of 4 up to beyond the LLC
+	long maxBlocks = 1 << 24;           ///< The largest batch size
+	size_t llcBytes = 0;                ///< The size of the last-level cache, or 0 to detect it
+	int samples = 11;                   ///< The number of timed samples per configuration
+	double minSampleNanos = 2e5;        ///< The minimum time of a sample, repeating the entry point as needed
+	int tablePages = SWIFFT_POOL_PAGES_DEFAULT; ///< The pages backing the tables, one of SWIFFT_POOL_PAGES_*
+};
+
+//! \brief The measurements of a configuration.
+struct BenchResult {
+	const char *iset;
+	const BenchOp *op;
+	int threads;
+	int nblocks;
+	int repeats;                        ///< The runs of the entry point per sample
+	std::vector<double> cycles;         ///< The sorted cycles per run, per sample
+	std::vector<double> nanos;          ///< The sorted nanoseconds per run, per sample
+	double dtlbMisses;                  ///< The data-TLB load misses per run over all samples, or -1 if not counted
+};
+
+//! \brief A counter of the data-TLB load misses of the calling thread, if the kernel exposes it.
+struct BenchDtlbCounter {
+	int fd;
+	BenchDtlbCounter() : fd(-1) {
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~BenchDtlbCounter() { if (fd >= 0) close(fd); }
+	BenchDtlbCounter(const BenchDtlbCounter &) = delete;
+	BenchDtlbCounter & operator=(const BenchDtlbCounter &) = delete;
+	void start() {
+#ifdef __linux__
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+	//! \returns the misses since start, or -1 if not counted.
+	double stop() {
+		uint64_t count = 0;
+#ifdef __linux__
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) {
+				return (double)count;
+			}
+		}
+#endif
+		return -1;
+	}
+};
+
+//! \brief Returns the nearest-rank percentile of sorted values.
+static double percentile(const std::vector<double> &sorted, double p) {
+	size_t rank = (size_t)(p / 100 * sorted.size() + 0.999999);
+	return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+//! \brief Returns the time in nanoseconds from a monotonic clock.
+static double nanos() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! \brief Measures an entry point over a batch.
+static BenchResult measure(const BenchOptions &options, const char *iset, const BenchOp &op, int threads, const BenchContext &c) {
+	BenchResult result = { iset, &op, threads, c.nblocks, 1, {}, {}, -1 };
+	BenchDtlbCounter dtlb;
+	double t0 = nanos();
+	op.run(c); // warm up
+	double t = nanos() - t0;
+	result.repeats = (t >= options.minSampleNanos) ? 1 : (int)(options.minSampleNanos / std::max(t, 1.0)) + 1;
+	dtlb.start();
+	for (int s=0; s<options.samples; s++) {
+		double n0 = nanos();
+		uint64_t c0 = rdtsc_start();
+		for (int r=0; r<result.repeats; r++) {
+			op.run(c);
+		}
+		uint64_t c1 = rdtsc_stop();
+		double n1 = nanos();
+		result.cycles.push_back((double)(c1 - c0) / result.repeats);
+		result.nanos.push_back((n1 - n0) / result.repeats);
+	}
+	double misses = dtlb.stop();
+	result.dtlbMisses = (misses < 0) ? -1 : misses / ((double)options.samples * result.repeats);
+	std::sort(result.cycles.begin(), result.cycles.end());
+	std::sort(result.nanos.begin(), result.nanos.end());
+	return result;
+}
+
+static const double percentiles[] = { 50, 90, 99 };
+
+//! \brief Writes the header of a CSV report.
+static void writeCsvHeader(std::ostream &os) {
+	os << "iset,op,api,sign,threads,blocks,bytes_per_block,footprint_bytes,samples,repeats";
+	for (double p : percentiles) os << ",cycles_per_block_p" << p;
+	for (double p : percentiles) os << ",cycles_per_byte_p" << p;
+	for (double p : percentiles) os << ",gb_per_sec_p" << p;
+	os << ",dtlb_misses_per_block\n";
+}
+
+//! \brief Writes a result as a record of a report.
+static void writeResult(std::ostream &os, bool json, bool first, const BenchResult &r) {
+	const double bytes = (double)r.op->blockBytes * r.nblocks;
+	std::ostringstream fields;
+	auto field = [&fields, json](const char *name, const std::string &value, bool quote) {
+		if (json) {
+			fields << (fields.tellp() > 0 ? ", " : "") << "\"" << name << "\": " << (quote ? "\"" : "") << value << (quote ? "\"" : "");
+		}
+		else {
+			fields << (fields.tellp() > 0 ? "," : "") << value;
+		}
+	};
+	auto number = [](double x) { std::ostringstream s; s.precision(6); s << x; return s.str(); };
+	field("iset", r.iset, true);
+	field("op", r.op->name, true);
+	field("api", r.op->api, true);
+	field("sign", r.op->sign, true);
+	field("threads", number(r.threads), false);
+	field("blocks", number(r.nblocks), false);
+	field("bytes_per_block", number((double)r.op->blockBytes), false);
+	field("footprint_bytes", number((double)footprint(*r.op, r.nblocks)), false);
+	field("samples", number((double)r.cycles.size()), false);
+	field("repeats", number(r.repeats), false);
+	for (double p : percentiles) field(("cycles_per_block_p" + number(p)).c_str(), number(percentile(r.cycles, p) / r.nblocks), false);
+	for (double p : percentiles) field(("cycles_per_byte_p" + number(p)).c_str(), number(percentile(r.cycles, p) / bytes), false);
+	for (double p : percentiles) field(("gb_per_sec_p" + number(p)).c_str(), number(bytes / percentile(r.nanos, p)), false);
+	field("dtlb_misses_per_block", (r.dtlbMisses < 0) ? (json ? "null" : "") : number(r.dtlbMisses / r.nblocks), false);
+	if (json) {
+		os << (first ? "" : ",\n") << "    { " << fields.str() << " }";
+	}
+	else {
+		os << fields.str() << "\n";
+	}
+	os.flush();
+}
+
+//! \brief Returns the size in bytes of the last-level cache, or a guess if it cannot be detected.
+static size_t detectLlcBytes() {
+	long size = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+	size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	if (size <= 0) {
+		size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	}
+#endif
+	return (size > 0) ? (size_t)size : (size_t)32 << 20;
+}
+
+//! \brief Returns the batch sizes of an entry point: powers of 4 up to the first one whose
+//! buffers exceed the last-level cache.
+static std::vector<int> batchSizes(const BenchOptions &options, const BenchOp &op, size_t llcBytes) {
+	std::vector<int> sizes;
+	if (!options.blocks.empty()) {
+		return options.blocks;
+	}
+	for (long n=1; n<=options.maxBlocks; n*=4) {
+		sizes.push_back((int)n);
+		if (footprint(op, n) > llcBytes) {
+			break;
+		}
+	}
+	return sizes;
+}
+
+//! \brief Parses a comma-separated list.
+static std::vector<std::string> parseList(const std::string &s) {
+	std::vector<std::string> items;
+	std::istringstream is(s);
+	std::string item;
+	while (std::getline(is, item, ',')) {
+		if (!item.empty()) {
+			items.push_back(item);
+		}
+	}
+	return items;
+}
+
+//! \brief Parses a comma-separated list of positive numbers.
+//! \returns whether all items are positive numbers.
+static bool parseNumbers(const std::string &s, std::vector<int> &numbers) {
+	for (const std::string &item : parseList(s)) {
+		char *end;
+		long n = strtol(item.c_str(), &end, 10);
+		if (*end != '\0' || n <= 0 || n > (1L << 30)) {
+			return false;
+		}
+		numbers.push_back((int)n);
+	}
+	return true;
+}
+
+static const char *usage =
+	"usage: swifft_bench [options]\n"
+	"  --format=csv|json       the report format (default: csv)\n"
+	"  --isets=AVX,...         the instruction-sets (default: all supported)\n"
+	"  --ops=NAME,...          the entry points whose names contain any of these (default: all)\n"
+	"  --threads=N,...         the numbers of threads of the functions for multiple blocks\n"
+	"                          (default: powers of 2 and one per CPU)\n"
+	"  --blocks=N,...          the batch sizes (default: powers of 4 up to beyond the LLC)\n"
+	"  --max-blocks=N          the largest default batch size (default: 16777216)\n"
+	"  --llc-bytes=N           the size of the last-level cache (default: detected)\n"
+	"  --samples=N             the timed samples per configuration (default: 11)\n"
+	"  --min-sample-nanos=N    the minimum time of a sample (default: 200000)\n"
+	"  --table-pages=default|thp|hugetlb\n"
+	"                          the pages backing the tables the kernels read (default: default)\n";
+
+//! \brief Parses the command-line options.
+//! \returns whether they are valid.
+static bool parseOptions(int argc, char *argv[], BenchOptions &options) {
+	for (int i=1; i<argc; i++) {
+		std::string arg = argv[i];
+		size_t eq = arg.find('=');
+		std::string name = arg.substr(0, eq), value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+		std::vector<int> numbers;
+		if (name == "--format" && (value == "csv" || value == "json")) {
+			options.json = (value == "json");
+		}
+		else if (name == "--isets") {
+			options.isets = parseList(value);
+		}
+		else if (name == "--ops") {
+			options.ops = parseList(value);
+		}
+		else if (name == "--threads" && parseNumbers(value, options.threads)) {
+		}
+		else if (name == "--blocks" && parseNumbers(value, options.blocks)) {
+		}
+		else if (name == "--max-blocks" && parseNumbers(value, numbers) && numbers.size() == 1) {
+			options.maxBlocks = numbers[0];
+		}
+		else if (name == "--llc-bytes" && parseNumbers(value, numbers) && numbers.size() == 1) {
+			options.llcBytes = numbers[0];
+		}
+		else if (name == "--samples" && parseNumbers(value, numbers) && numbers.size() == 1) {
+			options.samples = numbers[0];
+		}
+		else if (name == "--min-sample-nanos" && parseNumbers(value, numbers) && numbers.size() == 1) {
+			options.minSampleNanos = numbers[0];
+		}
+		else if (name == "--table-pages" && (value == "default" || value == "thp" || value == "hugetlb")) {
+			options.tablePages = (value == "thp") ? SWIFFT_POOL_PAGES_THP : (value == "hugetlb") ? SWIFFT_POOL_PAGES_HUGETLB : SWIFFT_POOL_PAGES_DEFAULT;
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! \brief Returns whether a name is selected by a list, where an empty list selects all.
+static bool selected(const std::vector<std::string> &list, const std::string &name, bool exact) {
+	return list.empty() || std::any_of(list.begin(), list.end(), [&name, exact](const std::string &item) {
+		return exact ? name == item : name.find(item) != std::string::npos;
+	});
+}
+
+static int run(int argc, char *argv[]) {
+	BenchOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		std::cerr << usage;
+		return (argc == 2 && std::string(argv[1]) == "--help") ? 0 : 1;
+	}
+	if (SWIFFT_SetTablePages(options.tablePages) != 0) {
+		std::cerr << "swifft_bench: the tables could not be backed by the pages" << std::endl;
+		return 1;
+	}
+	const size_t llcBytes = (options.llcBytes > 0) ? options.llcBytes : detectLlcBytes();
+	std::vector<int> threads = options.threads;
+	if (threads.empty()) {
+		int ncpus = std::max((int)std::thread::hardware_concurrency(), 1);
+		for (int t=1; t<ncpus; t*=2) {
+			threads.push_back(t);
+		}
+		threads.push_back(ncpus);
+	}
+
+	swifft_key_t key;
+	SWIFFT_InitKeyPI(&key);
+	BenchBuffer keys;
+	if (!keys.allocate(benchKeys * sizeof(swifft_key_t))) {
+		std::cerr << "swifft_bench: out of memory" << std::endl;
+		return 1;
+	}
+	for (int k=0; k<benchKeys; k++) {
+		SWIFFT_InitKeyFromSeed(keys.as<swifft_key_t>() + k, &k, sizeof(k));
+	}
+	const std::vector<BenchOp> ops = benchOps();
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	std::ostream &os = std::cout;
+	bool first = true;
+	if (options.json) {
+		os << "{\n  \"library\": \"LibSWIFFT\", \"version\": \"" << SWIFFT_version() << "\", \"llc_bytes\": " << llcBytes
+			<< ", \"table_pages\": " << options.tablePages << ",\n  \"results\": [\n";
+	}
+	else {
+		writeCsvHeader(os);
+	}
+	srand(1);
+	for (const BenchIset &iset : benchIsets) {
+		if (!iset.isSupported() || !selected(options.isets, iset.name, true)) {
+			continue;
+		}
+		swifft_object_t swifft;
+		iset.initObject(&swifft);
+		for (const BenchOp &op : ops) {
+			if (!selected(options.ops, op.name, false)) {
+				continue;
+			}
+			for (int nblocks : batchSizes(options, op, llcBytes)) {
+				BenchContext c;
+				c.swifft = &swifft;
+				c.key = &key;
+				c.keys = keys.as<swifft_key_t>();
+				c.nblocks = nblocks;
+				SWIFFT_SetExecutor(NULL);
+				if (!allocate(c, op)) {
+					std::cerr << "swifft_bench: skipping " << op.name << " of " << nblocks << " blocks: out of memory" << std::endl;
+					continue;
+				}
+				for (int t : threads) {
+					if (!op.multiple && t != threads[0]) {
+						break;
+					}
+					swifft_executor_t *pool = NULL;
+					if (op.multiple && t > 1) {
+						pool = SWIFFT_CreateThreadPool(t);
+						if (pool == NULL) {
+							std::cerr << "swifft_bench: skipping " << t << " threads: no thread pool" << std::endl;
+							continue;
+						}
+					}
+					SWIFFT_SetExecutor(pool);
+					writeResult(os, options.json, first, measure(options, iset.name, op, op.multiple ? t : 1, c));
+					first = false;
+					SWIFFT_DestroyThreadPool(pool);
+				}
+			}
+		}
+	}
+	if (options.json) {
+		os << (first ? "" : "\n") << "  ]\n}\n";
+	}
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_SetTablePages(SWIFFT_POOL_PAGES_DEFAULT);
+	return 0;
+}
+
+} // end namespace LibSwifft
+
+int main(int argc, char *argv[])
+{
+	return LibSwifft::run(argc, argv);
+}
@@ -1,5 +1,16 @@
+# The baseline machine settings of the architecture, which every CPU running the library supports.
+# The per-instruction-set sources are compiled with these and their own flags only, so that a
+# binary dispatching at runtime never runs instructions the CPU lacks.
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64|arm64|ARM64)$")
+	set(SWIFFT_BASELINE_COMPILE_FLAGS -march=armv8-a)
+else()
+	set(SWIFFT_BASELINE_COMPILE_FLAGS -mavx)
+endif()
+
+# The machine settings of the shared code, the tests, the benchmark and the tools, portable by
+# default. Setting them to -march=native builds for the build machine only.
 if(NOT DEFINED SWIFFT_MACHINE_COMPILE_FLAGS)
-	set(SWIFFT_MACHINE_COMPILE_FLAGS -march=native)
+	set(SWIFFT_MACHINE_COMPILE_FLAGS ${SWIFFT_BASELINE_COMPILE_FLAGS})
 endif()
 
 set(SWIFFT_DEFAULT_FILE_COMPILE_FLAGS "${SWIFFT_MACHINE_COMPILE_FLAGS}")
@@ -12,3 +23,24 @@ if(SWIFFT_ENABLE_OPENMP)
                 set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_EXE_LINKER_FLAGS}")
         endif()
 endif()
+
+if(SWIFFT_ENABLE_SMALL_FFT_TABLE)
+        set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DSWIFFT_DEFAULT_FFT_TABLE_MODE=SWIFFT_FFT_TABLE_SMALL")
+endif()
+
+if(SWIFFT_ENABLE_STATS OR SWIFFT_ENABLE_STATS_CYCLES)
+        set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DSWIFFT_ENABLE_STATS")
+endif()
+
+if(SWIFFT_ENABLE_STATS_CYCLES)
+        set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DSWIFFT_ENABLE_STATS_CYCLES")
+endif()
+
+if(SWIFFT_ENABLE_NUMA)
+        find_path(SWIFFT_NUMA_INCLUDE_DIR numa.h)
+        find_library(SWIFFT_NUMA_LIBRARY numa)
+        if(NOT SWIFFT_NUMA_INCLUDE_DIR OR NOT SWIFFT_NUMA_LIBRARY)
+                message(FATAL_ERROR "SWIFFT_ENABLE_NUMA requires libnuma")
+        endif()
+        set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DSWIFFT_ENABLE_NUMA")
+endif()
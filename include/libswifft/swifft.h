@@ -31,6 +31,19 @@ LIBSWIFFT_BEGIN_EXTERN_C
 #include "libswifft/swifft_api.inl"
 #undef LIBSWIFFT_API
 
+//! \brief Sets the FFT table mode used by the FFT phase of SWIFFT for all instruction-sets.
+//! Both modes compute the same FFT-output. The small table avoids cache misses and evicting
+//! application data when hashing large working sets, at the cost of an extra lookup.
+//! This setting is not synchronized, so it should be made before hashing from multiple threads.
+//!
+//! \param[in] mode the FFT table mode, either SWIFFT_FFT_TABLE_LARGE or SWIFFT_FFT_TABLE_SMALL.
+void SWIFFT_SetFftTableMode(int mode);
+
+//! \brief Gets the FFT table mode used by the FFT phase of SWIFFT.
+//!
+//! \returns the FFT table mode, either SWIFFT_FFT_TABLE_LARGE or SWIFFT_FFT_TABLE_SMALL.
+int SWIFFT_GetFftTableMode(void);
+
 LIBSWIFFT_END_EXTERN_C
 
 #endif /* __LIBSWIFFT_SWIFFT_H__ */
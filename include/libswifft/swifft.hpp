@@ -5,12 +5,34 @@
  */
 /*! \file include/libswifft/swifft.hpp
  * \brief LibSWIFFT public C++ API
+ *
+ * Arithmetic expressions of SWIFFT output data structures and 16-bit values,
+ * e.g. `a += b*c - d`, are evaluated by expression templates in one pass over
+ * the elements, rather than one pass per operator. The range of each
+ * sub-expression is known at compile time, so that an operand is reduced mod
+ * 257 only where needed to avoid 16-bit overflow, and the result is
+ * reduced once.
  */
 
 #ifndef __LIBSWIFFT_SWIFFT_HPP__
 #define __LIBSWIFFT_SWIFFT_HPP__
 
 #include "libswifft/swifft.h"
+#include "libswifft/swifft_cache.h"
+#include "libswifft/swifft_pool.h"
+#include "libswifft/swifft_queue.h"
+#include "libswifft/swifft_stream.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include "libswifft/swifft_avx.h"
+#include "libswifft/swifft_avx2.h"
+#include "libswifft/swifft_avx512.h"
+#include "libswifft/swifft_avx512bw.h"
+#elif defined(__aarch64__)
+#include "libswifft/swifft_neon.h"
+#endif
+#include <future>
+#include <new>
+#include <stdexcept>
 #include <string.h>
 
 namespace LibSwifft {
@@ -27,6 +49,8 @@ struct SWIFFT_ALIGN SwifftCompact;
 SwifftCompact& Copy(SwifftCompact &dst, const SwifftCompact &src);
 SwifftCompact & Set(SwifftCompact &lhs, const BitSequence value);
 
+template <class E> struct SwifftExpr;
+
 //! \brief An auto-memory-aligned SWIFFT input data structure.
 struct SWIFFT_ALIGN SwifftInput {
 	//! \brief The input data structure.
@@ -60,6 +84,26 @@ struct SWIFFT_ALIGN SwifftOutput {
 	//! \param[in] value the value to set to.
 	//! \returns this SWIFFT output.
 	LIBSWIFFT_INLINE SwifftOutput & operator=(const int16_t value) { Set(*this, value); return *this; }
+	//! \brief Set all 16-bit elements to the value of an arithmetic expression, reduced mod 257.
+	//!
+	//! \param[in] expr the expression, which may refer to this SWIFFT output.
+	//! \returns this SWIFFT output.
+	template <class E> SwifftOutput & operator=(const SwifftExpr<E> &expr);
+	//! \brief Adds an arithmetic expression to this SWIFFT output, element-wise.
+	//!
+	//! \param[in] expr the expression, which may refer to this SWIFFT output.
+	//! \returns this SWIFFT output.
+	template <class E> SwifftOutput & operator+=(const SwifftExpr<E> &expr);
+	//! \brief Subtracts an arithmetic expression from this SWIFFT output, element-wise.
+	//!
+	//! \param[in] expr the expression, which may refer to this SWIFFT output.
+	//! \returns this SWIFFT output.
+	template <class E> SwifftOutput & operator-=(const SwifftExpr<E> &expr);
+	//! \brief Multiplies this SWIFFT output by an arithmetic expression, element-wise.
+	//!
+	//! \param[in] expr the expression, which may refer to this SWIFFT output.
+	//! \returns this SWIFFT output.
+	template <class E> SwifftOutput & operator*=(const SwifftExpr<E> &expr);
 
 };
 
@@ -189,6 +233,73 @@ LIBSWIFFT_INLINE SwifftCompact & Set(SwifftCompact &lhs, BitSequence value) {
 	return lhs;
 }
 
+//! \brief Computes the compact-form of the SWIFFT of an input data structure.
+//!
+//! \param[out] compact the SWIFFT compact-form.
+//! \param[in] input the SWIFFT input.
+//! \returns the SWIFFT compact-form.
+LIBSWIFFT_INLINE SwifftCompact & Compute(SwifftCompact &compact, const SwifftInput &input) {
+	SWIFFT_ComputeCompact(input.data, compact.data);
+	return compact;
+}
+
+//! \brief Computes the compact-form of the SWIFFT of an input data structure with sign bits.
+//!
+//! \param[out] compact the SWIFFT compact-form.
+//! \param[in] input the SWIFFT input.
+//! \param[in] sign the sign bits.
+//! \returns the SWIFFT compact-form.
+LIBSWIFFT_INLINE SwifftCompact & Compute(SwifftCompact &compact, const SwifftInput &input, const SwifftInput &sign) {
+	SWIFFT_ComputeCompactSigned(input.data, sign.data, compact.data);
+	return compact;
+}
+
+//! \brief Computes the compact-forms of the SWIFFT of multiple input data structures.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[out] compact the SWIFFT compact-forms, one per block.
+//! \param[in] input the SWIFFT inputs, one per block.
+//! \returns the SWIFFT compact-forms.
+LIBSWIFFT_INLINE SwifftCompact * ComputeMultiple(int nblocks, SwifftCompact *compact, const SwifftInput *input) {
+	SWIFFT_ComputeCompactMultiple(nblocks, input[0].data, compact[0].data);
+	return compact;
+}
+
+//! \brief Computes the compact-forms of the SWIFFT of multiple input data structures with sign bits.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[out] compact the SWIFFT compact-forms, one per block.
+//! \param[in] input the SWIFFT inputs, one per block.
+//! \param[in] sign the sign bits, one per block.
+//! \returns the SWIFFT compact-forms.
+LIBSWIFFT_INLINE SwifftCompact * ComputeMultiple(int nblocks, SwifftCompact *compact, const SwifftInput *input, const SwifftInput *sign) {
+	SWIFFT_ComputeCompactMultipleSigned(nblocks, input[0].data, sign[0].data, compact[0].data);
+	return compact;
+}
+
+//! \brief Sums multiple SWIFFT output data structures, element-wise.
+//!
+//! \param[out] result the sum.
+//! \param[in] nblocks the number of blocks to sum.
+//! \param[in] outputs the SWIFFT outputs, one per block.
+//! \returns the sum.
+LIBSWIFFT_INLINE SwifftOutput & SumMultiple(SwifftOutput &result, int nblocks, const SwifftOutput *outputs) {
+	SWIFFT_SumMultiple(nblocks, outputs[0].data, result.data);
+	return result;
+}
+
+//! \brief Computes a linear combination of multiple SWIFFT output data structures, element-wise.
+//!
+//! \param[out] result the linear combination.
+//! \param[in] nblocks the number of blocks to combine.
+//! \param[in] coeffs the coefficients, one per block.
+//! \param[in] outputs the SWIFFT outputs, one per block.
+//! \returns the linear combination.
+LIBSWIFFT_INLINE SwifftOutput & LinearCombination(SwifftOutput &result, int nblocks, const int16_t *coeffs, const SwifftOutput *outputs) {
+	SWIFFT_LinearCombination(nblocks, coeffs, outputs[0].data, result.data);
+	return result;
+}
+
 //! \brief Adds a value to each 16-bit element of a SWIFFT output data structure.
 //!
 //! \param[in,out] lhs the SWIFFT output.
@@ -248,6 +359,592 @@ LIBSWIFFT_INLINE SwifftOutput & operator*=(SwifftOutput &lhs, const SwifftOutput
 	return lhs;
 }
 
+#if defined(__AVX512BW__)
+#define LIBSWIFFT_EXPR_LANES 32 ///< The number of 16-bit elements an expression evaluates at a time
+#elif defined(__AVX2__)
+#define LIBSWIFFT_EXPR_LANES 16 ///< The number of 16-bit elements an expression evaluates at a time
+#else
+#define LIBSWIFFT_EXPR_LANES 8  ///< The number of 16-bit elements an expression evaluates at a time
+#endif
+
+//! \brief A vector of 16-bit elements evaluated by an expression at a time.
+typedef int16_t SwifftExprVec __attribute__ ((vector_size (LIBSWIFFT_EXPR_LANES*sizeof(int16_t)), may_alias));
+
+#define SWIFFT_EXPR_ADD 0       ///< The operator of a SwifftBinaryExpr adding its operands
+#define SWIFFT_EXPR_SUB 1       ///< The operator of a SwifftBinaryExpr subtracting its operands
+#define SWIFFT_EXPR_MUL 2       ///< The operator of a SwifftBinaryExpr multiplying its operands
+
+#define SWIFFT_EXPR_KEEP 0      ///< The mode of an operand used as is
+#define SWIFFT_EXPR_QREDUCE 1   ///< The mode of an operand reduced by a SWIFFT_qReduce
+#define SWIFFT_EXPR_CENTER 2    ///< The mode of an operand reduced to the range {-128,..,128}
+
+//! \brief Returns floor(x/256).
+constexpr long SwifftExprFloor256(long x) { return (x >= 0) ? x / 256 : -((255 - x) / 256); }
+//! \brief Returns the lower bound of an operand in the range [lo,hi] after its reduction by a mode.
+constexpr long SwifftExprModeLo(int mode, long lo, long hi) {
+	return (mode == SWIFFT_EXPR_KEEP) ? lo : (mode == SWIFFT_EXPR_QREDUCE) ? -SwifftExprFloor256(hi) : -128;
+}
+//! \brief Returns the upper bound of an operand in the range [lo,hi] after its reduction by a mode.
+constexpr long SwifftExprModeHi(int mode, long lo, long hi) {
+	return (mode == SWIFFT_EXPR_KEEP) ? hi : (mode == SWIFFT_EXPR_QREDUCE) ? 255 - SwifftExprFloor256(lo) : 128;
+}
+//! \brief Returns the minimum of four values.
+constexpr long SwifftExprMin4(long a, long b, long c, long d) {
+	return (a < b ? a : b) < (c < d ? c : d) ? (a < b ? a : b) : (c < d ? c : d);
+}
+//! \brief Returns the maximum of four values.
+constexpr long SwifftExprMax4(long a, long b, long c, long d) {
+	return -SwifftExprMin4(-a, -b, -c, -d);
+}
+//! \brief Returns the lower bound of an operator applied to operands in the ranges [lo1,hi1] and [lo2,hi2].
+constexpr long SwifftExprOpLo(int op, long lo1, long hi1, long lo2, long hi2) {
+	return (op == SWIFFT_EXPR_ADD) ? lo1 + lo2 : (op == SWIFFT_EXPR_SUB) ? lo1 - hi2 :
+		SwifftExprMin4(lo1*lo2, lo1*hi2, hi1*lo2, hi1*hi2);
+}
+//! \brief Returns the upper bound of an operator applied to operands in the ranges [lo1,hi1] and [lo2,hi2].
+constexpr long SwifftExprOpHi(int op, long lo1, long hi1, long lo2, long hi2) {
+	return (op == SWIFFT_EXPR_ADD) ? hi1 + hi2 : (op == SWIFFT_EXPR_SUB) ? hi1 - lo2 :
+		SwifftExprMax4(lo1*lo2, lo1*hi2, hi1*lo2, hi1*hi2);
+}
+//! \brief Returns the modes of a pair of operands, with the left one in the high 4 bits, by
+//! increasing cost; the last pair fits any operator.
+constexpr int SwifftExprCandidate(int k) {
+	return (k == 0) ? 0x00 : (k == 1) ? 0x01 : (k == 2) ? 0x10 : (k == 3) ? 0x11 :
+		(k == 4) ? 0x02 : (k == 5) ? 0x20 : (k == 6) ? 0x12 : (k == 7) ? 0x21 : 0x22;
+}
+//! \brief Returns whether an operator applied to operands in the ranges [lo1,hi1] and [lo2,hi2],
+//! reduced by a pair of modes, fits in 16 bits.
+constexpr bool SwifftExprFits(int op, int modes, long lo1, long hi1, long lo2, long hi2) {
+	return SwifftExprOpLo(op, SwifftExprModeLo(modes >> 4, lo1, hi1), SwifftExprModeHi(modes >> 4, lo1, hi1),
+			SwifftExprModeLo(modes & 15, lo2, hi2), SwifftExprModeHi(modes & 15, lo2, hi2)) >= -32768 &&
+		SwifftExprOpHi(op, SwifftExprModeLo(modes >> 4, lo1, hi1), SwifftExprModeHi(modes >> 4, lo1, hi1),
+			SwifftExprModeLo(modes & 15, lo2, hi2), SwifftExprModeHi(modes & 15, lo2, hi2)) <= 32767;
+}
+//! \brief Returns the cheapest pair of modes, from the k-th on, with which an operator applied to
+//! operands in the ranges [lo1,hi1] and [lo2,hi2] fits in 16 bits.
+constexpr int SwifftExprChoose(int op, long lo1, long hi1, long lo2, long hi2, int k = 0) {
+	return (k == 8 || SwifftExprFits(op, SwifftExprCandidate(k), lo1, hi1, lo2, hi2)) ?
+		SwifftExprCandidate(k) : SwifftExprChoose(op, lo1, hi1, lo2, hi2, k + 1);
+}
+
+//! \brief Reduces a vector of an operand by a mode, see SWIFFT_EXPR_*.
+template <int mode> struct SwifftExprReduce;
+template <> struct SwifftExprReduce<SWIFFT_EXPR_KEEP> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x) { return x; }
+};
+template <> struct SwifftExprReduce<SWIFFT_EXPR_QREDUCE> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x) { return (x & 255) - (x >> 8); }
+};
+template <> struct SwifftExprReduce<SWIFFT_EXPR_CENTER> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x) {
+		SwifftExprVec tmp = SwifftExprReduce<SWIFFT_EXPR_QREDUCE>::apply(SwifftExprReduce<SWIFFT_EXPR_QREDUCE>::apply(x));
+		return tmp - ((tmp > 128) & 257);
+	}
+};
+
+//! \brief Applies an operator to vectors of its operands, see SWIFFT_EXPR_*.
+template <int op> struct SwifftExprApply;
+template <> struct SwifftExprApply<SWIFFT_EXPR_ADD> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x, SwifftExprVec y) { return x + y; }
+};
+template <> struct SwifftExprApply<SWIFFT_EXPR_SUB> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x, SwifftExprVec y) { return x - y; }
+};
+template <> struct SwifftExprApply<SWIFFT_EXPR_MUL> {
+	static LIBSWIFFT_INLINE SwifftExprVec apply(SwifftExprVec x, SwifftExprVec y) { return x * y; }
+};
+
+//! \brief An arithmetic expression of SWIFFT output data structures and 16-bit values.
+//! An expression E has the range [E::lo,E::hi] of its elements and evaluates their i-th vector by
+//! E::eval(i); its value is that of its elements mod 257.
+template <class E>
+struct SwifftExpr {
+	//! \brief Returns this expression as its concrete type.
+	LIBSWIFFT_INLINE const E & self() const { return static_cast<const E &>(*this); }
+};
+
+//! \brief An expression referring to a SWIFFT output data structure, whose elements are in
+//! the range {0,..,256} as produced by this library.
+struct SwifftOutputExpr : public SwifftExpr<SwifftOutputExpr> {
+	static constexpr long lo = 0;     ///< The lower bound of the elements
+	static constexpr long hi = 256;   ///< The upper bound of the elements
+	//! \brief The elements of the SWIFFT output.
+	const SwifftExprVec *data;
+	LIBSWIFFT_INLINE SwifftOutputExpr(const SwifftOutput &output) : data((const SwifftExprVec *)output.data) {}
+	LIBSWIFFT_INLINE SwifftExprVec eval(int i) const { return data[i]; }
+};
+
+//! \brief An expression of a 16-bit value, reduced to the range {0,..,256}.
+struct SwifftValueExpr : public SwifftExpr<SwifftValueExpr> {
+	static constexpr long lo = 0;     ///< The lower bound of the elements
+	static constexpr long hi = 256;   ///< The upper bound of the elements
+	//! \brief The reduced value in each element.
+	SwifftExprVec value;
+	LIBSWIFFT_INLINE SwifftValueExpr(const int16_t v) {
+		int r = v % 257;
+		for (int i=0; i<LIBSWIFFT_EXPR_LANES; i++) {
+			value[i] = (int16_t)(r < 0 ? r + 257 : r);
+		}
+	}
+	LIBSWIFFT_INLINE SwifftExprVec eval(int) const { return value; }
+};
+
+//! \brief An expression of an operator applied to two operand expressions, each reduced by the
+//! cheapest mode with which the operator does not overflow.
+template <int op, class L, class R>
+struct SwifftBinaryExpr : public SwifftExpr<SwifftBinaryExpr<op, L, R> > {
+	static constexpr int modes = SwifftExprChoose(op, L::lo, L::hi, R::lo, R::hi); ///< The modes of the operands
+	static constexpr long lo = SwifftExprOpLo(op,
+		SwifftExprModeLo(modes >> 4, L::lo, L::hi), SwifftExprModeHi(modes >> 4, L::lo, L::hi),
+		SwifftExprModeLo(modes & 15, R::lo, R::hi), SwifftExprModeHi(modes & 15, R::lo, R::hi)); ///< The lower bound of the elements
+	static constexpr long hi = SwifftExprOpHi(op,
+		SwifftExprModeLo(modes >> 4, L::lo, L::hi), SwifftExprModeHi(modes >> 4, L::lo, L::hi),
+		SwifftExprModeLo(modes & 15, R::lo, R::hi), SwifftExprModeHi(modes & 15, R::lo, R::hi)); ///< The upper bound of the elements
+	const L lhs; ///< The left operand
+	const R rhs; ///< The right operand
+	LIBSWIFFT_INLINE SwifftBinaryExpr(const L &l, const R &r) : lhs(l), rhs(r) {}
+	LIBSWIFFT_INLINE SwifftExprVec eval(int i) const {
+		return SwifftExprApply<op>::apply(
+			SwifftExprReduce<(modes >> 4)>::apply(lhs.eval(i)),
+			SwifftExprReduce<(modes & 15)>::apply(rhs.eval(i)));
+	}
+};
+
+template <class E>
+LIBSWIFFT_INLINE SwifftOutput & SwifftOutput::operator=(const SwifftExpr<E> &expr) {
+	const E &e = expr.self();
+	SwifftExprVec *v = (SwifftExprVec *)data;
+	for (int i=0; i<(int)(SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(SwifftExprVec)); i++) {
+		// reduced as by SWIFFT_modP, mapping -1 to 256
+		SwifftExprVec tmp = SwifftExprReduce<SWIFFT_EXPR_QREDUCE>::apply(SwifftExprReduce<SWIFFT_EXPR_QREDUCE>::apply(e.eval(i)));
+		v[i] = tmp ^ ((tmp == -1) & -257);
+	}
+	return *this;
+}
+
+template <class E>
+LIBSWIFFT_INLINE SwifftOutput & SwifftOutput::operator+=(const SwifftExpr<E> &expr) {
+	return *this = SwifftBinaryExpr<SWIFFT_EXPR_ADD, SwifftOutputExpr, E>(*this, expr.self());
+}
+
+template <class E>
+LIBSWIFFT_INLINE SwifftOutput & SwifftOutput::operator-=(const SwifftExpr<E> &expr) {
+	return *this = SwifftBinaryExpr<SWIFFT_EXPR_SUB, SwifftOutputExpr, E>(*this, expr.self());
+}
+
+template <class E>
+LIBSWIFFT_INLINE SwifftOutput & SwifftOutput::operator*=(const SwifftExpr<E> &expr) {
+	return *this = SwifftBinaryExpr<SWIFFT_EXPR_MUL, SwifftOutputExpr, E>(*this, expr.self());
+}
+
+//! \brief Defines an operator building an expression from any two of an expression, a SWIFFT
+//! output data structure and a 16-bit value, except two values.
+#define LIBSWIFFT_EXPR_OPERATOR(sym, op) \
+template <class E1, class E2> \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, E1, E2> operator sym(const SwifftExpr<E1> &lhs, const SwifftExpr<E2> &rhs) { \
+	return SwifftBinaryExpr<op, E1, E2>(lhs.self(), rhs.self()); \
+} \
+template <class E> \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, E, SwifftOutputExpr> operator sym(const SwifftExpr<E> &lhs, const SwifftOutput &rhs) { \
+	return SwifftBinaryExpr<op, E, SwifftOutputExpr>(lhs.self(), rhs); \
+} \
+template <class E> \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, SwifftOutputExpr, E> operator sym(const SwifftOutput &lhs, const SwifftExpr<E> &rhs) { \
+	return SwifftBinaryExpr<op, SwifftOutputExpr, E>(lhs, rhs.self()); \
+} \
+template <class E> \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, E, SwifftValueExpr> operator sym(const SwifftExpr<E> &lhs, const int16_t rhs) { \
+	return SwifftBinaryExpr<op, E, SwifftValueExpr>(lhs.self(), rhs); \
+} \
+template <class E> \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, SwifftValueExpr, E> operator sym(const int16_t lhs, const SwifftExpr<E> &rhs) { \
+	return SwifftBinaryExpr<op, SwifftValueExpr, E>(lhs, rhs.self()); \
+} \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, SwifftOutputExpr, SwifftOutputExpr> operator sym(const SwifftOutput &lhs, const SwifftOutput &rhs) { \
+	return SwifftBinaryExpr<op, SwifftOutputExpr, SwifftOutputExpr>(lhs, rhs); \
+} \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, SwifftOutputExpr, SwifftValueExpr> operator sym(const SwifftOutput &lhs, const int16_t rhs) { \
+	return SwifftBinaryExpr<op, SwifftOutputExpr, SwifftValueExpr>(lhs, rhs); \
+} \
+LIBSWIFFT_INLINE SwifftBinaryExpr<op, SwifftValueExpr, SwifftOutputExpr> operator sym(const int16_t lhs, const SwifftOutput &rhs) { \
+	return SwifftBinaryExpr<op, SwifftValueExpr, SwifftOutputExpr>(lhs, rhs); \
+}
+
+LIBSWIFFT_EXPR_OPERATOR(+, SWIFFT_EXPR_ADD)
+LIBSWIFFT_EXPR_OPERATOR(-, SWIFFT_EXPR_SUB)
+LIBSWIFFT_EXPR_OPERATOR(*, SWIFFT_EXPR_MUL)
+
+#undef LIBSWIFFT_EXPR_OPERATOR
+
+//! \brief A batch of SWIFFT data structures, in memory from the pool of swifft_pool.h.
+//! A batch is movable but not copyable, and returns its memory to the pool of the thread destroying it.
+template <class T>
+struct SwifftBatch {
+	//! \brief The data structures, aligned to SWIFFT_ALIGNMENT.
+	T *data;
+	//! \brief The number of data structures.
+	int size;
+
+	//! \brief Constructs a batch of uninitialized data structures.
+	//!
+	//! \param[in] nblocks the number of data structures.
+	//! \throws std::bad_alloc if the memory of the batch could not be allocated.
+	explicit SwifftBatch(int nblocks) : data(NULL), size(nblocks) {
+		if (nblocks < 0 || (data = static_cast<T *>(SWIFFT_PoolAlloc(sizeof(T) * (size_t)nblocks))) == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+	//! \brief Constructs a batch taking the data structures of another, which is left empty.
+	SwifftBatch(SwifftBatch &&other) noexcept : data(other.data), size(other.size) {
+		other.data = NULL;
+		other.size = 0;
+	}
+	//! \brief Replaces the data structures of this batch by those of another, which is left empty.
+	SwifftBatch & operator=(SwifftBatch &&other) noexcept {
+		if (this != &other) {
+			SWIFFT_PoolFree(data);
+			data = other.data;
+			size = other.size;
+			other.data = NULL;
+			other.size = 0;
+		}
+		return *this;
+	}
+	//! \brief Destroys the batch, returning its memory to the pool.
+	~SwifftBatch() { SWIFFT_PoolFree(data); }
+	SwifftBatch(const SwifftBatch &) = delete;
+	SwifftBatch & operator=(const SwifftBatch &) = delete;
+
+	LIBSWIFFT_INLINE T & operator[](int i) { return data[i]; }
+	LIBSWIFFT_INLINE const T & operator[](int i) const { return data[i]; }
+	LIBSWIFFT_INLINE T * begin() { return data; }
+	LIBSWIFFT_INLINE const T * begin() const { return data; }
+	LIBSWIFFT_INLINE T * end() { return data + size; }
+	LIBSWIFFT_INLINE const T * end() const { return data + size; }
+};
+
+typedef SwifftBatch<SwifftInput> SwifftInputBatch;     ///< A batch of SWIFFT inputs
+typedef SwifftBatch<SwifftOutput> SwifftOutputBatch;   ///< A batch of SWIFFT outputs
+typedef SwifftBatch<SwifftCompact> SwifftCompactBatch; ///< A batch of SWIFFT compact-forms
+
+//! \brief Checks that batches have the same number of data structures.
+//!
+//! \throws std::invalid_argument if they do not.
+template <class T, class U>
+LIBSWIFFT_INLINE void SwifftCheckBatchSizes(const SwifftBatch<T> &lhs, const SwifftBatch<U> &rhs) {
+	if (lhs.size != rhs.size) {
+		throw std::invalid_argument("batches of different sizes");
+	}
+}
+
+//! \brief Computes the SWIFFT of a batch of input data structures.
+//!
+//! \param[out] output the SWIFFT outputs, one per input.
+//! \param[in] input the SWIFFT inputs.
+//! \returns the SWIFFT outputs.
+//! \throws std::invalid_argument if the batches are of different sizes.
+LIBSWIFFT_INLINE SwifftOutputBatch & Compute(SwifftOutputBatch &output, const SwifftInputBatch &input) {
+	SwifftCheckBatchSizes(output, input);
+	SWIFFT_ComputeMultiple(input.size, input.data[0].data, output.data[0].data);
+	return output;
+}
+
+//! \brief Computes the SWIFFT of a batch of input data structures with sign bits.
+//!
+//! \param[out] output the SWIFFT outputs, one per input.
+//! \param[in] input the SWIFFT inputs.
+//! \param[in] sign the sign bits, one per input.
+//! \returns the SWIFFT outputs.
+//! \throws std::invalid_argument if the batches are of different sizes.
+LIBSWIFFT_INLINE SwifftOutputBatch & Compute(SwifftOutputBatch &output, const SwifftInputBatch &input, const SwifftInputBatch &sign) {
+	SwifftCheckBatchSizes(output, input);
+	SwifftCheckBatchSizes(input, sign);
+	SWIFFT_ComputeMultipleSigned(input.size, input.data[0].data, sign.data[0].data, output.data[0].data);
+	return output;
+}
+
+//! \brief Computes the compact-forms of the SWIFFT of a batch of input data structures.
+//!
+//! \param[out] compact the SWIFFT compact-forms, one per input.
+//! \param[in] input the SWIFFT inputs.
+//! \returns the SWIFFT compact-forms.
+//! \throws std::invalid_argument if the batches are of different sizes.
+LIBSWIFFT_INLINE SwifftCompactBatch & Compute(SwifftCompactBatch &compact, const SwifftInputBatch &input) {
+	SwifftCheckBatchSizes(compact, input);
+	SWIFFT_ComputeCompactMultiple(input.size, input.data[0].data, compact.data[0].data);
+	return compact;
+}
+
+//! \brief Computes the compact-forms of the SWIFFT of a batch of input data structures with sign bits.
+//!
+//! \param[out] compact the SWIFFT compact-forms, one per input.
+//! \param[in] input the SWIFFT inputs.
+//! \param[in] sign the sign bits, one per input.
+//! \returns the SWIFFT compact-forms.
+//! \throws std::invalid_argument if the batches are of different sizes.
+LIBSWIFFT_INLINE SwifftCompactBatch & Compute(SwifftCompactBatch &compact, const SwifftInputBatch &input, const SwifftInputBatch &sign) {
+	SwifftCheckBatchSizes(compact, input);
+	SwifftCheckBatchSizes(input, sign);
+	SWIFFT_ComputeCompactMultipleSigned(input.size, input.data[0].data, sign.data[0].data, compact.data[0].data);
+	return compact;
+}
+
+//! \brief Compacts a batch of SWIFFT output data structures.
+//!
+//! \param[out] compact the SWIFFT compact-forms, one per output.
+//! \param[in] output the SWIFFT outputs.
+//! \returns the SWIFFT compact-forms.
+//! \throws std::invalid_argument if the batches are of different sizes.
+LIBSWIFFT_INLINE SwifftCompactBatch & Compact(SwifftCompactBatch &compact, const SwifftOutputBatch &output) {
+	SwifftCheckBatchSizes(compact, output);
+	SWIFFT_CompactMultiple(output.size, output.data[0].data, compact.data[0].data);
+	return compact;
+}
+
+//! \brief Sums a batch of SWIFFT output data structures, element-wise.
+//!
+//! \param[out] result the sum.
+//! \param[in] outputs the SWIFFT outputs.
+//! \returns the sum.
+LIBSWIFFT_INLINE SwifftOutput & Sum(SwifftOutput &result, const SwifftOutputBatch &outputs) {
+	return SumMultiple(result, outputs.size, outputs.data);
+}
+
+//! \brief Defines an in-place operator on batches of SWIFFT output data structures, element-wise,
+//! block by block, throwing std::invalid_argument if the batches are of different sizes.
+#define LIBSWIFFT_BATCH_OPERATOR(sym, opname) \
+LIBSWIFFT_INLINE SwifftOutputBatch & operator sym##=(SwifftOutputBatch &lhs, const SwifftOutputBatch &rhs) { \
+	SwifftCheckBatchSizes(lhs, rhs); \
+	SWIFFT_##opname##Multiple(lhs.size, lhs.data[0].data, rhs.data[0].data); \
+	return lhs; \
+}
+
+LIBSWIFFT_BATCH_OPERATOR(+, Add)
+LIBSWIFFT_BATCH_OPERATOR(-, Sub)
+LIBSWIFFT_BATCH_OPERATOR(*, Mul)
+
+#undef LIBSWIFFT_BATCH_OPERATOR
+
+//! \brief Selects the functions for short inputs dispatched to the best instruction-set at runtime.
+struct SwifftIsetBest {
+	//! \brief Calls SWIFFT_ComputeShort.
+	static LIBSWIFFT_INLINE int ComputeShort(int m, const BitSequence *input, BitSequence *output) {
+		return SWIFFT_ComputeShort(m, input, output);
+	}
+	//! \brief Calls SWIFFT_ComputeShortSigned.
+	static LIBSWIFFT_INLINE int ComputeShortSigned(int m, const BitSequence *input, const BitSequence *sign,
+		BitSequence *output) {
+		return SWIFFT_ComputeShortSigned(m, input, sign, output);
+	}
+};
+
+//! \brief Defines a struct named SwifftIset followed by the name of an instruction-set, selecting its
+//! functions for short inputs, which may be called only if its SWIFFT_IsSupported_ function returns non-zero.
+#define LIBSWIFFT_ISET_TAG(iset) \
+struct SwifftIset##iset { \
+	static LIBSWIFFT_INLINE int ComputeShort(int m, const BitSequence *input, BitSequence *output) { \
+		return SWIFFT_ComputeShort_##iset(m, input, output); \
+	} \
+	static LIBSWIFFT_INLINE int ComputeShortSigned(int m, const BitSequence *input, const BitSequence *sign, \
+		BitSequence *output) { \
+		return SWIFFT_ComputeShortSigned_##iset(m, input, sign, output); \
+	} \
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+LIBSWIFFT_ISET_TAG(AVX)
+LIBSWIFFT_ISET_TAG(AVX2)
+LIBSWIFFT_ISET_TAG(AVX512)
+LIBSWIFFT_ISET_TAG(AVX512BW)
+#elif defined(__aarch64__)
+LIBSWIFFT_ISET_TAG(NEON)
+#endif
+
+#undef LIBSWIFFT_ISET_TAG
+
+//! \brief SWIFFT of short inputs of M 8-byte columns, by the kernel of an instruction-set unrolled for M.
+//! The result is the same as that of hashing the input padded with zeros to 256 bytes, at a cost
+//! that grows with M rather than that of the full block.
+//!
+//! \tparam ISet SwifftIsetBest, or one of SwifftIsetAVX2 and the like for an instruction-set supported by the running CPU.
+//! \tparam M the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS up to 32.
+template <class ISet, int M>
+struct Swifft {
+	static_assert(M > 0 && M <= SWIFFT_INPUT_BLOCK_SIZE / 8 && M % SWIFFT_SHORT_COLUMNS == 0,
+		"M must be a multiple of SWIFFT_SHORT_COLUMNS up to 32");
+
+	//! \brief The size in bytes of the input.
+	enum { INPUT_SIZE = 8 * M };
+
+	//! \brief Computes the SWIFFT of a short input.
+	//!
+	//! \param[out] output the SWIFFT output.
+	//! \param[in] input the input of INPUT_SIZE bytes, with no alignment requirement.
+	//! \returns the SWIFFT output.
+	static LIBSWIFFT_INLINE SwifftOutput & Compute(SwifftOutput &output, const BitSequence *input) {
+		ISet::ComputeShort(M, input, output.data);
+		return output;
+	}
+	//! \brief Computes the SWIFFT of a short input with sign bits.
+	//!
+	//! \param[out] output the SWIFFT output.
+	//! \param[in] input the input of INPUT_SIZE bytes, with no alignment requirement.
+	//! \param[in] sign the sign bits of INPUT_SIZE bytes, with no alignment requirement.
+	//! \returns the SWIFFT output.
+	static LIBSWIFFT_INLINE SwifftOutput & Compute(SwifftOutput &output, const BitSequence *input,
+		const BitSequence *sign) {
+		ISet::ComputeShortSigned(M, input, sign, output.data);
+		return output;
+	}
+};
+
+//! \brief A SWIFFT streaming hasher of messages of any length.
+struct SwifftHasher {
+	//! \brief The streaming context.
+	swifft_stream_t stream;
+
+	//! \brief Constructs a hasher for a new message.
+	LIBSWIFFT_INLINE SwifftHasher() { SWIFFT_StreamInit(&stream); }
+	//! \brief Restarts the hasher for a new message.
+	//!
+	//! \returns this hasher.
+	LIBSWIFFT_INLINE SwifftHasher & Reset() { SWIFFT_StreamInit(&stream); return *this; }
+	//! \brief Adds a span of bytes to the message.
+	//!
+	//! \param[in] data the bytes, with no alignment requirement.
+	//! \param[in] len the number of bytes.
+	//! \returns this hasher.
+	LIBSWIFFT_INLINE SwifftHasher & Update(const void *data, size_t len) { SWIFFT_StreamUpdate(&stream, data, len); return *this; }
+	//! \brief Completes the message and computes its digest.
+	//! The hasher must be reset before it is used for another message.
+	//!
+	//! \param[out] digest the digest of the message.
+	LIBSWIFFT_INLINE void Final(SwifftCompact &digest) { SWIFFT_StreamFinal(&stream, digest.data); }
+};
+
+
+//! \brief An asynchronous queue of batches of SWIFFT blocks to hash one at a time, completing futures in order.
+struct SwifftQueue {
+	//! \brief The queue.
+	swifft_queue_t *queue;
+
+	//! \brief Constructs a queue and its thread.
+	//!
+	//! \param[in] depth the maximum number of pending batches, or 0 for SWIFFT_QUEUE_DEFAULT_DEPTH.
+	//! \throws std::bad_alloc if the resources of the queue could not be allocated.
+	explicit SwifftQueue(int depth = 0) : queue(SWIFFT_CreateQueue(depth)) {
+		if (queue == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+	//! \brief Destroys the queue, after waiting for its pending batches to complete.
+	~SwifftQueue() { SWIFFT_DestroyQueue(queue); }
+	SwifftQueue(const SwifftQueue &) = delete;
+	SwifftQueue & operator=(const SwifftQueue &) = delete;
+
+	//! \brief Submits the SWIFFT of multiple input data structures, waiting while the queue is full.
+	//! The data structures must remain valid until the returned future is ready.
+	//!
+	//! \param[in] nblocks the number of blocks to operate on.
+	//! \param[out] output the SWIFFT outputs, one per block.
+	//! \param[in] input the SWIFFT inputs, one per block.
+	//! \param[in] sign the sign bits, one per block, or NULL for all-zero ones.
+	//! \returns the future ready when the batch has completed.
+	LIBSWIFFT_INLINE std::future<void> Submit(int nblocks, SwifftOutput *output, const SwifftInput *input,
+		const SwifftInput *sign = NULL) {
+		return Submit(nblocks, output->data, input->data, (sign != NULL) ? sign->data : NULL, 0);
+	}
+	//! \brief Submits the compact-forms of the SWIFFT of multiple input data structures, waiting while
+	//! the queue is full. The data structures must remain valid until the returned future is ready.
+	//!
+	//! \param[in] nblocks the number of blocks to operate on.
+	//! \param[out] compact the SWIFFT compact-forms, one per block.
+	//! \param[in] input the SWIFFT inputs, one per block.
+	//! \param[in] sign the sign bits, one per block, or NULL for all-zero ones.
+	//! \returns the future ready when the batch has completed.
+	LIBSWIFFT_INLINE std::future<void> Submit(int nblocks, SwifftCompact *compact, const SwifftInput *input,
+		const SwifftInput *sign = NULL) {
+		return Submit(nblocks, compact->data, input->data, (sign != NULL) ? sign->data : NULL, 1);
+	}
+	//! \brief Waits for all the submitted batches to complete.
+	LIBSWIFFT_INLINE void WaitAll() { SWIFFT_QueueWaitAll(queue); }
+
+private:
+	//! \brief Makes ready the future of a completed batch.
+	static void Complete(void *context, int64_t ticket) {
+		(void)ticket;
+		std::promise<void> *promise = static_cast<std::promise<void> *>(context);
+		promise->set_value();
+		delete promise;
+	}
+	//! \brief Submits a batch, waiting while the queue is full.
+	std::future<void> Submit(int nblocks, BitSequence *output, const BitSequence *input, const BitSequence *sign, int compact) {
+		std::promise<void> *promise = new std::promise<void>();
+		std::future<void> future = promise->get_future();
+		swifft_batch_t batch = { nblocks, input, sign, output, compact, Complete, promise };
+		if (SWIFFT_QueueSubmit(queue, &batch) < 0) {
+			promise->set_exception(std::make_exception_ptr(std::invalid_argument("negative number of blocks")));
+			delete promise;
+		}
+		return future;
+	}
+};
+
+//! \brief A memo cache of the hash values of recently hashed blocks, usable by several threads at once.
+struct SwifftCache {
+	//! \brief The cache.
+	swifft_cache_t *cache;
+
+	//! \brief Constructs an empty cache.
+	//!
+	//! \param[in] size the number of entries, or 0 for SWIFFT_CACHE_DEFAULT_SIZE.
+	//! \throws std::bad_alloc if the memory of the cache could not be allocated.
+	explicit SwifftCache(size_t size = 0) : cache(SWIFFT_CreateCache(size)) {
+		if (cache == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+	~SwifftCache() { SWIFFT_DestroyCache(cache); }
+	SwifftCache(const SwifftCache &) = delete;
+	SwifftCache & operator=(const SwifftCache &) = delete;
+
+	//! \brief Computes the SWIFFT of multiple input data structures, looking up each in the cache first.
+	//!
+	//! \param[in] nblocks the number of blocks to operate on.
+	//! \param[out] output the SWIFFT outputs, one per block.
+	//! \param[in] input the SWIFFT inputs, one per block.
+	//! \param[in] sign the sign bits, one per block, or NULL for all-zero ones.
+	//! \returns the SWIFFT outputs.
+	LIBSWIFFT_INLINE SwifftOutput * ComputeMultiple(int nblocks, SwifftOutput *output, const SwifftInput *input,
+		const SwifftInput *sign = NULL) {
+		if (sign == NULL) {
+			SWIFFT_CacheComputeMultiple(cache, nblocks, input[0].data, output[0].data);
+		} else {
+			SWIFFT_CacheComputeMultipleSigned(cache, nblocks, input[0].data, sign[0].data, output[0].data);
+		}
+		return output;
+	}
+	//! \brief Computes the compact-forms of the SWIFFT of multiple input data structures, looking up
+	//! each in the cache first.
+	//!
+	//! \param[in] nblocks the number of blocks to operate on.
+	//! \param[out] compact the SWIFFT compact-forms, one per block.
+	//! \param[in] input the SWIFFT inputs, one per block.
+	//! \param[in] sign the sign bits, one per block, or NULL for all-zero ones.
+	//! \returns the SWIFFT compact-forms.
+	LIBSWIFFT_INLINE SwifftCompact * ComputeMultiple(int nblocks, SwifftCompact *compact, const SwifftInput *input,
+		const SwifftInput *sign = NULL) {
+		if (sign == NULL) {
+			SWIFFT_CacheComputeCompactMultiple(cache, nblocks, input[0].data, compact[0].data);
+		} else {
+			SWIFFT_CacheComputeCompactMultipleSigned(cache, nblocks, input[0].data, sign[0].data, compact[0].data);
+		}
+		return compact;
+	}
+	//! \brief Empties the cache, which no thread may be using.
+	LIBSWIFFT_INLINE void Clear() { SWIFFT_ClearCache(cache); }
+};
+
 } // end namespace LibSwifft
 
 #endif // __LIBSWIFFT_SWIFFT_HPP__
@@ -130,3 +130,81 @@ void LIBSWIFFT_API(SWIFFT_SubMultiple)(int nblocks, BitSequence * output,
 //! \param[in] operand the hash value to multiply by.
 void LIBSWIFFT_API(SWIFFT_MulMultiple)(int nblocks, BitSequence * output,
 	const BitSequence * operand);
+
+//! \brief Sums SWIFFT hash values of multiple blocks, element-wise.
+//! The hash values are accumulated with deferred reductions, and in parallel for many blocks.
+//!
+//! \param[in] nblocks the number of blocks to sum.
+//! \param[in] outputs the hash values of SWIFFT to sum.
+//! \param[out] result the sum of the hash values, or all zeros for no blocks.
+void LIBSWIFFT_API(SWIFFT_SumMultiple)(int nblocks, const BitSequence * outputs, BitSequence * result);
+
+//! \brief Computes a linear combination of SWIFFT hash values of multiple blocks, element-wise.
+//! The products are accumulated with deferred reductions, and in parallel for many blocks.
+//!
+//! \param[in] nblocks the number of blocks to combine.
+//! \param[in] coeffs the coefficient of each hash value, taken mod-257.
+//! \param[in] outputs the hash values of SWIFFT to combine.
+//! \param[out] result the linear combination of the hash values, or all zeros for no blocks.
+void LIBSWIFFT_API(SWIFFT_LinearCombination)(int nblocks, const int16_t * coeffs,
+	const BitSequence * outputs, BitSequence * result);
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_AddMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to add.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to add, possibly 0.
+void LIBSWIFFT_API(SWIFFT_AddMultipleStrided)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_AddMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to add.
+void LIBSWIFFT_API(SWIFFT_AddMultipleGather)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_SubMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to subtract.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to subtract, possibly 0.
+void LIBSWIFFT_API(SWIFFT_SubMultipleStrided)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_SubMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to subtract.
+void LIBSWIFFT_API(SWIFFT_SubMultipleGather)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_MulMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to multiply by.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to multiply by, possibly 0.
+void LIBSWIFFT_API(SWIFFT_MulMultipleStrided)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_MulMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to multiply by.
+void LIBSWIFFT_API(SWIFFT_MulMultipleGather)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
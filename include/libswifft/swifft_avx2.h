@@ -7,16 +7,15 @@
  * \brief LibSWIFFT public C API for AVX2
  *
  * See "include/libswifft/swifft_iset.inl" for code expanded here with SWIFFT_ISET set to AVX2.
+ *
+ * These functions are built into the library for x86 targets. At runtime, call them
+ * only if SWIFFT_IsSupported_AVX2() returns non-zero.
  */
 #ifndef __LIBSWIFFT_SWIFFT_AVX2_H_
 #define __LIBSWIFFT_SWIFFT_AVX2_H_
 
-#if defined(__AVX2__)
-	#undef SWIFFT_ISET
-        #define SWIFFT_ISET() AVX2
-        #include "libswifft/swifft_iset.inl"
-#else
-        #pragma message "LibSWIFFT API for AVX2 is disabled"
-#endif
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX2
+#include "libswifft/swifft_iset.inl"
 
 #endif /* __LIBSWIFFT_SWIFFT_AVX2_H_ */
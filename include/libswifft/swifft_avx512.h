@@ -7,16 +7,15 @@
  * \brief LibSWIFFT public C API for AVX512
  *
  * See "include/libswifft/swifft_iset.inl" for code expanded here with SWIFFT_ISET set to AVX512.
+ *
+ * These functions are built into the library for x86 targets. At runtime, call them
+ * only if SWIFFT_IsSupported_AVX512() returns non-zero.
  */
 #ifndef __LIBSWIFFT_SWIFFT_AVX512_H_
 #define __LIBSWIFFT_SWIFFT_AVX512_H_
 
-#if defined(__AVX512F__)
-	#undef SWIFFT_ISET
-        #define SWIFFT_ISET() AVX512
-        #include "libswifft/swifft_iset.inl"
-#else
-        #pragma message "LibSWIFFT API for AVX512 is disabled"
-#endif
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX512
+#include "libswifft/swifft_iset.inl"
 
 #endif /* __LIBSWIFFT_SWIFFT_AVX512_H_ */
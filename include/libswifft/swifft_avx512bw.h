@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2020 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_avx512bw.h
+ * \brief LibSWIFFT public C API for AVX512BW
+ *
+ * See "include/libswifft/swifft_iset.inl" for code expanded here with SWIFFT_ISET set to AVX512BW.
+ *
+ * These functions are built into the library for x86 targets. At runtime, call them
+ * only if SWIFFT_IsSupported_AVX512BW() returns non-zero.
+ */
+#ifndef __LIBSWIFFT_SWIFFT_AVX512BW_H_
+#define __LIBSWIFFT_SWIFFT_AVX512BW_H_
+
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX512BW
+#include "libswifft/swifft_iset.inl"
+
+#endif /* __LIBSWIFFT_SWIFFT_AVX512BW_H_ */
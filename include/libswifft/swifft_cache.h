@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_cache.h
+ * \brief LibSWIFFT memo cache public C API
+ *
+ * A memo cache holds the hash values of recently hashed blocks, so that hashing
+ * a batch in which blocks repeat, e.g. all-zero pages or common headers in a
+ * deduplicating pipeline, runs the kernel only on the blocks not found in it.
+ * Each block and its sign bits are fingerprinted to pick a set of
+ * SWIFFT_CACHE_WAYS entries, and an entry is found only if its stored block
+ * and sign bits equal those looked up, so a fingerprint collision costs a
+ * miss, never a wrong hash value.
+ *
+ * A cache may be used by several threads at once with no lock. A thread finds
+ * an entry only when no other thread is replacing it, and skips inserting into
+ * an entry another thread is replacing. When built with SWIFFT_ENABLE_STATS,
+ * the hits and misses are counted in the statistics of swifft_stats.h.
+ *
+ * The entries cost about 700 bytes each, while hashing a block costs roughly
+ * a thousand cycles, so a cache pays off when a good share of the blocks
+ * repeat within the number of blocks it holds.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_CACHE_H__
+#define __LIBSWIFFT_SWIFFT_CACHE_H__
+
+#include "libswifft/swifft_common.h"
+
+#define SWIFFT_CACHE_WAYS 4            ///< The number of entries of a set of a cache
+#define SWIFFT_CACHE_DEFAULT_SIZE 4096 ///< The number of entries of a cache created with size 0
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief A memo cache of the hash values of recently hashed blocks.
+typedef struct swifft_cache swifft_cache_t;
+
+//! \brief Creates an empty cache.
+//!
+//! \param[in] size the number of entries, rounded up to a power of 2 of at least SWIFFT_CACHE_WAYS,
+//! or 0 for SWIFFT_CACHE_DEFAULT_SIZE.
+//! \returns the cache, or NULL if its memory could not be allocated.
+swifft_cache_t *SWIFFT_CreateCache(size_t size);
+
+//! \brief Destroys a cache, which no thread may be using.
+//!
+//! \param[in] cache the cache, or NULL.
+void SWIFFT_DestroyCache(swifft_cache_t *cache);
+
+//! \brief Empties a cache, which no thread may be using.
+//!
+//! \param[in,out] cache the cache.
+void SWIFFT_ClearCache(swifft_cache_t *cache);
+
+//! \brief Computes the result of multiple SWIFFT operations, looking up each block in a cache first.
+//! The result is the same as that of SWIFFT_ComputeMultiple.
+//!
+//! \param[in,out] cache the cache, into which the blocks not found are inserted.
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_CacheComputeMultiple(swifft_cache_t *cache, int nblocks, const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with sign bits, looking up each block and
+//! its sign bits in a cache first. The result is the same as that of SWIFFT_ComputeMultipleSigned.
+//!
+//! \param[in,out] cache the cache, into which the blocks not found are inserted.
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_CacheComputeMultipleSigned(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * output);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, looking up each block in a
+//! cache first. The result is the same as that of SWIFFT_ComputeCompactMultiple.
+//!
+//! \param[in,out] cache the cache, into which the blocks not found are inserted.
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] compact the resulting blocks of compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_CacheComputeCompactMultiple(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	BitSequence * compact);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations with sign bits, looking up each
+//! block and its sign bits in a cache first. The result is the same as that of
+//! SWIFFT_ComputeCompactMultipleSigned.
+//!
+//! \param[in,out] cache the cache, into which the blocks not found are inserted.
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] compact the resulting blocks of compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_CacheComputeCompactMultipleSigned(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_CACHE_H__ */
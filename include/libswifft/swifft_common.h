@@ -9,6 +9,7 @@
 #ifndef __LIBSWIFFT_SWIFFT_COMMON_H__
 #define __LIBSWIFFT_SWIFFT_COMMON_H__
 
+#include <stddef.h> // for size_t
 #include <stdint.h> // for int16_t
 #include "libswifft/common.h"
 
@@ -33,4 +34,39 @@ typedef unsigned char BitSequence; ///< Basic buffer type
 //! The size in bytes of SWIFFT compact-form.
 #define SWIFFT_COMPACT_BLOCK_SIZE 64
 
+//! The size in bytes of a SWIFFT sign-mask, a bit per input byte marking where its sign byte is 0xFF.
+#define SWIFFT_SIGN_MASK_BLOCK_SIZE 32
+
+//! The number of 8-byte columns of which the number of columns of a short SWIFFT input is a multiple.
+#define SWIFFT_SHORT_COLUMNS 4
+
+//! FFT table mode looking up each pair of input and sign bytes in a 1 MB table.
+#define SWIFFT_FFT_TABLE_LARGE 0
+
+//! FFT table mode looking up input bytes, masked by sign bytes, twice in a 4 KB table that fits in L1.
+#define SWIFFT_FFT_TABLE_SMALL 1
+
+//! The number of blocks of a structure-of-arrays batch, where byte j of each block of the batch is
+//! at j*SWIFFT_SOA_BLOCKS plus the index of the block, and so are the 16-bit output elements.
+#define SWIFFT_SOA_BLOCKS 32
+
+//! The size in bytes of a structure-of-arrays batch of SWIFFT input.
+#define SWIFFT_SOA_INPUT_BATCH_SIZE (SWIFFT_SOA_BLOCKS*SWIFFT_INPUT_BLOCK_SIZE)
+
+//! The size in bytes of a structure-of-arrays batch of SWIFFT output.
+#define SWIFFT_SOA_OUTPUT_BATCH_SIZE (SWIFFT_SOA_BLOCKS*SWIFFT_OUTPUT_BLOCK_SIZE)
+
+//! The number of structure-of-arrays batches holding a number of blocks.
+#define SWIFFT_SOA_BATCHES(nblocks) (((nblocks) + SWIFFT_SOA_BLOCKS - 1) / SWIFFT_SOA_BLOCKS)
+
+//! The number of elements of a SWIFFT key, one per FFT-output element of an input block.
+#define SWIFFT_KEY_SIZE (SWIFFT_INPUT_BLOCK_SIZE*8)
+
+//! \brief A SWIFFT key, holding its elements in the layout used by the compute kernels.
+//! Use SWIFFT_ALIGN on its declarations, or an aligned allocation, like for the other data structures.
+typedef struct {
+	//! \brief The elements, centered to [-128,128], in the layout of the FFT-output.
+	SWIFFT_ALIGN int16_t elements[SWIFFT_KEY_SIZE];
+} swifft_key_t;
+
 #endif /* __LIBSWIFFT_SWIFFT_COMMON_H__ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_executor.h
+ * \brief LibSWIFFT executor public C API
+ *
+ * The functions for multiple blocks, i.e. `SWIFFT_*Multiple*`, split their
+ * blocks into ranges and submit them to the current executor, to be run in
+ * parallel. The executor may be the built-in work-stealing thread pool, the
+ * OpenMP one when built with OpenMP, or one provided by the caller, e.g. to
+ * share the threads of its own scheduler. Without an executor, the blocks are
+ * processed by the calling thread.
+ *
+ * Each kind of operation has its own parallelization parameters: the number of
+ * blocks up to which it runs on the calling thread, since for fewer blocks the
+ * cost of waking up threads exceeds the gain, and the number of blocks per
+ * range. These may be set at runtime, possibly to values measured on the
+ * running machine by SWIFFT_CalibrateParallelization.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_EXECUTOR_H__
+#define __LIBSWIFFT_SWIFFT_EXECUTOR_H__
+
+#include "libswifft/common.h"
+
+#define SWIFFT_PARALLEL_FFT 0      ///< The operation kind of SWIFFT_fftMultiple
+#define SWIFFT_PARALLEL_FFTSUM 1   ///< The operation kind of SWIFFT_fftsumMultiple
+#define SWIFFT_PARALLEL_COMPUTE 2  ///< The operation kind of SWIFFT_Compute*Multiple* and SWIFFT_UpdateMultiple
+#define SWIFFT_PARALLEL_COMPACT 3  ///< The operation kind of SWIFFT_CompactMultiple
+#define SWIFFT_PARALLEL_ARITH 4    ///< The operation kind of SWIFFT_{,Const}{Set,Add,Sub,Mul}Multiple, SWIFFT_SumMultiple and SWIFFT_LinearCombination
+#define SWIFFT_PARALLEL_NOPS 5     ///< The number of operation kinds
+
+//! The time in nanoseconds of processing a range that SWIFFT_CalibrateParallelization aims for.
+#define SWIFFT_CALIBRATION_RANGE_NANOS 5000
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The parallelization parameters of a kind of operation.
+typedef struct {
+	//! \brief The maximum number of blocks to process on the calling thread.
+	int threshold;
+	//! \brief The number of blocks per range submitted to the executor.
+	int grain;
+} swifft_parallelization_t;
+
+//! \brief The measurements and resulting parallelization parameters of a calibration.
+typedef struct {
+	//! \brief The time in nanoseconds to process a block on the calling thread, per operation kind.
+	double blockNanos[SWIFFT_PARALLEL_NOPS];
+	//! \brief The time in nanoseconds of the executor running an empty job, or 0 if there is no executor.
+	double dispatchNanos;
+	//! \brief The resulting parallelization parameters, per operation kind.
+	swifft_parallelization_t parallelization[SWIFFT_PARALLEL_NOPS];
+} swifft_calibration_t;
+
+//! \brief A job processing the blocks in the range [begin, end).
+typedef void (*swifft_job_t)(void *context, int begin, int end);
+
+//! \brief An executor of jobs over ranges of blocks.
+typedef struct {
+	//! \brief Runs a job over ranges covering the blocks [0, nblocks) exactly once, and returns
+	//! when all ranges are done. Ranges may run concurrently and should start at multiples of
+	//! grain, which is a hint of the number of blocks worth processing together.
+	void (*ParallelFor)(void *self, int nblocks, int grain, swifft_job_t job, void *context);
+	//! \brief The state of the executor, passed to ParallelFor.
+	void *self;
+} swifft_executor_t;
+
+//! \brief Sets the executor used by the functions for multiple blocks.
+//! It should be set while none of these functions is running, and must remain valid while set.
+//!
+//! \param[in] executor the executor, or NULL to process the blocks by the calling thread.
+void SWIFFT_SetExecutor(const swifft_executor_t *executor);
+
+//! \brief Returns the executor used by the functions for multiple blocks.
+//!
+//! \returns the executor, or NULL if the blocks are processed by the calling thread.
+const swifft_executor_t *SWIFFT_GetExecutor(void);
+
+//! \brief Returns the executor used by default, which is the OpenMP one when built with OpenMP.
+//!
+//! \returns the executor, or NULL if the blocks are processed by the calling thread by default.
+const swifft_executor_t *SWIFFT_GetDefaultExecutor(void);
+
+//! \brief Sets the parallelization parameters of a kind of operation.
+//! They should be set while none of the functions for multiple blocks is running.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*; others are ignored.
+//! \param[in] parallelization the parameters, or NULL for the default ones. A threshold below 0 is
+//! taken as 0 and a grain below 1 as 1.
+void SWIFFT_SetParallelization(int op, const swifft_parallelization_t *parallelization);
+
+//! \brief Gets the parallelization parameters of a kind of operation.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \param[out] parallelization the parameters.
+//! \returns 0 on success, or -1 if op is not a kind of operation.
+int SWIFFT_GetParallelization(int op, swifft_parallelization_t *parallelization);
+
+//! \brief Measures the cost of processing blocks by each kind of operation and of running a job by
+//! the current executor, and sets the parallelization parameters accordingly. A threshold is set to
+//! where processing on the calling thread takes about twice the cost of the executor, and a grain
+//! to where a range takes about SWIFFT_CALIBRATION_RANGE_NANOS. This takes a few milliseconds.
+//!
+//! \param[out] calibration the measurements and resulting parameters, or NULL.
+//! \returns 0 on success, or -1 if memory for the measurements could not be allocated.
+int SWIFFT_CalibrateParallelization(swifft_calibration_t *calibration);
+
+//! \brief Creates a persistent work-stealing thread pool executor.
+//! The thread running ParallelFor takes part in it, and a nested or concurrent ParallelFor runs
+//! on its calling thread, avoiding oversubscription.
+//!
+//! \param[in] nthreads the number of threads, including the calling one, or 0 for one per CPU.
+//! \returns the executor, or NULL if its resources could not be allocated.
+swifft_executor_t *SWIFFT_CreateThreadPool(int nthreads);
+
+//! \brief Destroys a thread pool executor, after unsetting it if it is set.
+//!
+//! \param[in] pool the executor created by SWIFFT_CreateThreadPool, or NULL.
+void SWIFFT_DestroyThreadPool(swifft_executor_t *pool);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_EXECUTOR_H__ */
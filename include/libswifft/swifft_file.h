@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_file.h
+ * \brief LibSWIFFT file-hashing public C API
+ *
+ * This API computes the tree-hash digest, as defined in swifft_tree.h, of the
+ * contents of a file. A regular file is memory-mapped and hashed in place, with
+ * hints to the kernel to read ahead and to back the mapping with huge pages
+ * where possible. Other inputs, e.g. pipes, or files requested to be read, are
+ * read in large aligned chunks by a separate thread, overlapping the reading of
+ * each chunk with the hashing of the previous one. The batches of the tree are
+ * hashed in parallel using the current executor, so that setting one, e.g. by
+ * SWIFFT_SetExecutor(SWIFFT_CreateThreadPool(0)), is key to hashing as fast as
+ * the storage reads.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_FILE_H__
+#define __LIBSWIFFT_SWIFFT_FILE_H__
+
+#include <stdint.h> // for uint64_t
+#include "libswifft/swifft_common.h"
+
+#define SWIFFT_FILE_READ_SIZE (16 << 20)   ///< The size in bytes of the chunks an input that is not mapped is read in
+#define SWIFFT_FILE_NO_MAP 1               ///< Read the file rather than memory-map it
+#define SWIFFT_FILE_DIRECT 2               ///< Read the file bypassing the page cache (O_DIRECT) where possible; implies SWIFFT_FILE_NO_MAP
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief How a file was hashed.
+typedef struct {
+	//! \brief The number of bytes hashed.
+	uint64_t bytes;
+	//! \brief Whether the file was memory-mapped, rather than read.
+	int mapped;
+	//! \brief Whether the file was read bypassing the page cache.
+	int direct;
+} swifft_file_info_t;
+
+//! \brief Computes the tree-hash digest of the contents of a file descriptor, from its current
+//! offset to its end, after which it is left. A mapped file must not be truncated while hashed.
+//!
+//! \param[in] fd the file descriptor, open for reading.
+//! \param[in] flags a combination of SWIFFT_FILE_* flags, or 0.
+//! \param[out] digest the digest of the contents.
+//! \param[out] info how the file was hashed, or NULL.
+//! \returns 0 on success, or -1 with errno set if the file could not be read or memory for
+//! processing it could not be allocated.
+int SWIFFT_TreeHashFd(int fd, int flags, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE], swifft_file_info_t *info);
+
+//! \brief Computes the tree-hash digest of the contents of a file.
+//!
+//! \param[in] path the path of the file.
+//! \param[in] flags a combination of SWIFFT_FILE_* flags, or 0.
+//! \param[out] digest the digest of the contents.
+//! \param[out] info how the file was hashed, or NULL.
+//! \returns 0 on success, or -1 with errno set if the file could not be opened or read, or memory
+//! for processing it could not be allocated.
+int SWIFFT_TreeHashFile(const char *path, int flags, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE], swifft_file_info_t *info);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_FILE_H__ */
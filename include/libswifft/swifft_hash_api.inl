@@ -36,6 +36,38 @@ void LIBSWIFFT_API(SWIFFT_CompactMultiple)(int nblocks, const BitSequence output
 void LIBSWIFFT_API(SWIFFT_Compute)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
 
+//! \brief Computes the result of a SWIFFT operation, faster the more all-zero 8-byte columns the
+//! input has. The result is the same as that of SWIFFT_Compute.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeSparse)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation on a short input, transforming only its columns.
+//! The result is the same as that of SWIFFT_Compute on the input padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int LIBSWIFFT_API(SWIFFT_ComputeShort)(int m, const BitSequence * input,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation on a short input with sign bits, transforming only
+//! its columns. The result is the same as that of SWIFFT_ComputeSigned on the input and sign bits
+//! padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[in] sign the sign bits corresponding to the input, of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int LIBSWIFFT_API(SWIFFT_ComputeShortSigned)(int m, const BitSequence * input, const BitSequence * sign,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
 //! \brief Computes the result of a SWIFFT operation.
 //! The result is composable with other hash values.
 //!
@@ -46,6 +78,57 @@ void LIBSWIFFT_API(SWIFFT_ComputeSigned)(const BitSequence input[SWIFFT_INPUT_BL
 	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
 
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeWithKey)(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeWithKeySigned)(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int LIBSWIFFT_API(SWIFFT_Update)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len);
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input and sign bits changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] oldSign the old sign bits corresponding to the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] newSign the new sign bits corresponding to the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int LIBSWIFFT_API(SWIFFT_UpdateSigned)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * oldSign,
+	const BitSequence * newBytes, const BitSequence * newSign, size_t offset, size_t len);
+
 //! \brief Computes the result of multiple SWIFFT operations.
 //! The result is composable with other hash values.
 //!
@@ -54,6 +137,63 @@ void LIBSWIFFT_API(SWIFFT_ComputeSigned)(const BitSequence input[SWIFFT_INPUT_BL
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void LIBSWIFFT_API(SWIFFT_ComputeMultiple)(int nblocks, const BitSequence * input, BitSequence * output);
 
+//! \brief Computes the result of multiple SWIFFT operations, faster the more all-zero 8-byte columns
+//! the inputs have. The result is the same as that of SWIFFT_ComputeMultiple.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeSparseMultiple)(int nblocks, const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations in the structure-of-arrays layout, which
+//! is faster than SWIFFT_ComputeMultiple for AVX512BW. The result is that of SWIFFT_ComputeMultiple
+//! in the same layout, as converted by SWIFFT_InputToSoA and SWIFFT_OutputFromSoA.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] soaInput the batches of input, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! \param[out] soaOutput the resulting batches of hash values, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! The hash value of a padding block is that of its input.
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleSoA)(int nblocks, const BitSequence * soaInput, BitSequence * soaOutput);
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_Compute followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeCompact)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_ComputeSigned followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeCompactSigned)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultiple followed by SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeCompactMultiple)(int nblocks, const BitSequence * input, BitSequence * compact);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultipleSigned followed by
+//! SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeCompactMultipleSigned)(int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact);
+
 //! \brief Computes the result of multiple SWIFFT operations.
 //! The result is composable with other hash values.
 //!
@@ -63,3 +203,194 @@ void LIBSWIFFT_API(SWIFFT_ComputeMultiple)(int nblocks, const BitSequence * inpu
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void LIBSWIFFT_API(SWIFFT_ComputeMultipleSigned)(int nblocks, const BitSequence * input,
 	const BitSequence * sign, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with sign bits given as sign-masks.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned with sign bytes of 0xFF where
+//! the bits of the sign-masks are set and 0 elsewhere, while reading an eighth as many sign bytes.
+//! It saves memory rather than time: the sign bytes are expanded into a buffer that the FFT phase
+//! then reads, which costs slightly more than SWIFFT_ComputeMultipleSigned on sign bytes in cache.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signMask the sign-masks corresponding to blocks of input, each of 32 bytes (256 bit),
+//! whose bit j of byte i is for input byte 8*i+j.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleSignMask)(int nblocks, const BitSequence * input,
+	const BitSequence * signMask, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a uniform sign byte per block.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned with all the sign bytes of each
+//! block equal to its uniform sign byte, while reading one sign byte per block.
+//! Like SWIFFT_ComputeMultipleSignMask, it saves memory rather than time, unless all the sign bytes
+//! of a group of blocks are zero, which computes as SWIFFT_ComputeMultiple does.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the uniform sign bytes corresponding to blocks of input, one per block.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleUniformSign)(int nblocks, const BitSequence * input,
+	const BitSequence * signs, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeWithKeyMultiple)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeWithKeyMultipleSigned)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output);
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKey.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultiKey)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], BitSequence * output);
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKeySigned.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultiKeySigned)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence * output);
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultiKeyMultiple)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultipleSigned.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultiKeyMultipleSigned)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output);
+
+//! \brief Updates the results of multiple SWIFFT operations after the same range of each input changed.
+//! The cost per block is the same as that of SWIFFT_Update.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input, per block.
+//! \param[in] oldBytes the old bytes of the range, len bytes per block.
+//! \param[in] newBytes the new bytes of the range, len bytes per block.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int LIBSWIFFT_API(SWIFFT_UpdateMultiple)(int nblocks, BitSequence * output,
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleStrided)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * output, size_t outStride);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[in] sign the first block of sign bits, of 256 bytes (2048 bit).
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleSignedStrided)(size_t nblocks, const BitSequence * input, size_t inStride,
+	const BitSequence * sign, size_t signStride, BitSequence * output, size_t outStride);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void LIBSWIFFT_API(SWIFFT_ComputeCompactMultipleStrided)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * compact, size_t compactStride);
+
+//! \brief Compacts hash values of SWIFFT at fixed strides.
+//! The result is the same as that of SWIFFT_CompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] output the first hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive hash values, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void LIBSWIFFT_API(SWIFFT_CompactMultipleStrided)(size_t nblocks, const BitSequence * output, size_t outStride,
+	BitSequence * compact, size_t compactStride);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleGather)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * outputs);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the addresses of the blocks of sign bits, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeMultipleSignedGather)(size_t nblocks, const BitSequence * const * inputs,
+	const BitSequence * const * signs, BitSequence * const * outputs);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_ComputeCompactMultipleGather)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * compacts);
+
+//! \brief Compacts hash values of SWIFFT at the addresses of arrays.
+//! The result is the same as that of SWIFFT_CompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void LIBSWIFFT_API(SWIFFT_CompactMultipleGather)(size_t nblocks, const BitSequence * const * outputs,
+	BitSequence * const * compacts);
@@ -10,7 +10,7 @@
 
 #undef SWIFFT_ISET_NAME
 #ifndef SWIFFT_ISET
-        #error "SWIFFT_ISET() must be defined as AVX, AVX2, or AVX512"
+        #error "SWIFFT_ISET() must be defined as AVX, AVX2, AVX512, AVX512BW, or NEON"
 #endif
 #define SWIFFT_ISET_NAME(name) LIBSWIFFT_CONCAT(name,SWIFFT_ISET()) ///< Adds a suffix SWIFFT_ISET, a macro which must be defined prior to including
 
@@ -97,6 +97,38 @@ void SWIFFT_ISET_NAME(SWIFFT_Mul_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_ISET_NAME(SWIFFT_Compute_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
         BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
 
+//! \brief Computes the result of a SWIFFT operation, faster the more all-zero 8-byte columns the
+//! input has. The result is the same as that of SWIFFT_Compute.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeSparse_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation on a short input, transforming only its columns.
+//! The result is the same as that of SWIFFT_Compute on the input padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int SWIFFT_ISET_NAME(SWIFFT_ComputeShort_)(int m, const BitSequence * input,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation on a short input with sign bits, transforming only
+//! its columns. The result is the same as that of SWIFFT_ComputeSigned on the input and sign bits
+//! padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[in] sign the sign bits corresponding to the input, of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int SWIFFT_ISET_NAME(SWIFFT_ComputeShortSigned_)(int m, const BitSequence * input, const BitSequence * sign,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
 //! \brief Computes the result of a SWIFFT operation.
 //! The result is composable with other hash values.
 //!
@@ -107,6 +139,57 @@ void SWIFFT_ISET_NAME(SWIFFT_ComputeSigned_)(const BitSequence input[SWIFFT_INPU
         const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
         BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
 
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKey_)(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeySigned_)(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]);
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_Update_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len);
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input and sign bits changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] oldSign the old sign bits corresponding to the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] newSign the new sign bits corresponding to the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_UpdateSigned_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * oldSign,
+	const BitSequence * newBytes, const BitSequence * newSign, size_t offset, size_t len);
+
 //! \brief Computes the FFT phase of SWIFFT for multiple blocks.
 //!
 //! \param[in] nblocks the number of blocks to operate on.
@@ -199,6 +282,82 @@ void SWIFFT_ISET_NAME(SWIFFT_SubMultiple_)(int nblocks, BitSequence * output,
 void SWIFFT_ISET_NAME(SWIFFT_MulMultiple_)(int nblocks, BitSequence * output,
         const BitSequence * operand);
 
+//! \brief Sums SWIFFT hash values of multiple blocks, element-wise.
+//!
+//! \param[in] nblocks the number of blocks to sum.
+//! \param[in] outputs the hash values of SWIFFT to sum, per block.
+//! \param[out] result the sum of the hash values, or all zeros for no blocks.
+void SWIFFT_ISET_NAME(SWIFFT_SumMultiple_)(int nblocks, const BitSequence * outputs, BitSequence * result);
+
+//! \brief Computes a linear combination of SWIFFT hash values of multiple blocks, element-wise.
+//!
+//! \param[in] nblocks the number of blocks to combine.
+//! \param[in] coeffs the coefficient of each hash value, taken mod-257.
+//! \param[in] outputs the hash values of SWIFFT to combine, per block.
+//! \param[out] result the linear combination of the hash values, or all zeros for no blocks.
+void SWIFFT_ISET_NAME(SWIFFT_LinearCombination_)(int nblocks, const int16_t * coeffs,
+        const BitSequence * outputs, BitSequence * result);
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_AddMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to add.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to add, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_AddMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_AddMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to add.
+void SWIFFT_ISET_NAME(SWIFFT_AddMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_SubMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to subtract.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to subtract, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_SubMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_SubMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to subtract.
+void SWIFFT_ISET_NAME(SWIFFT_SubMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_MulMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to multiply by.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to multiply by, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_MulMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride);
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_MulMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to multiply by.
+void SWIFFT_ISET_NAME(SWIFFT_MulMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands);
+
 //! \brief Computes the result of multiple SWIFFT operations.
 //! The result is composable with other hash values.
 //!
@@ -207,6 +366,63 @@ void SWIFFT_ISET_NAME(SWIFFT_MulMultiple_)(int nblocks, BitSequence * output,
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple_)(int nblocks, const BitSequence * input, BitSequence * output);
 
+//! \brief Computes the result of multiple SWIFFT operations, faster the more all-zero 8-byte columns
+//! the inputs have. The result is the same as that of SWIFFT_ComputeMultiple.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeSparseMultiple_)(int nblocks, const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations in the structure-of-arrays layout, which
+//! is faster than SWIFFT_ComputeMultiple for AVX512BW. The result is that of SWIFFT_ComputeMultiple
+//! in the same layout, as converted by SWIFFT_InputToSoA and SWIFFT_OutputFromSoA.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] soaInput the batches of input, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! \param[out] soaOutput the resulting batches of hash values, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! The hash value of a padding block is that of its input.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSoA_)(int nblocks, const BitSequence * soaInput, BitSequence * soaOutput);
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_Compute followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompact_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_ComputeSigned followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactSigned_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultiple followed by SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultiple_)(int nblocks, const BitSequence * input, BitSequence * compact);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultipleSigned followed by
+//! SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleSigned_)(int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact);
+
 //! \brief Computes the result of multiple SWIFFT operations.
 //! The result is composable with other hash values.
 //!
@@ -217,4 +433,191 @@ void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple_)(int nblocks, const BitSequence *
 void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSigned_)(int nblocks, const BitSequence * input,
         const BitSequence * sign, BitSequence * output);
 
+//! \brief Computes the result of multiple SWIFFT operations with sign bits given as sign-masks.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ with sign bytes of 0xFF where
+//! the bits of the sign-masks are set and 0 elsewhere, while reading an eighth as many sign bytes.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signMask the sign-masks corresponding to blocks of input, each of 32 bytes (256 bit),
+//! whose bit j of byte i is for input byte 8*i+j.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignMask_)(int nblocks, const BitSequence * input,
+	const BitSequence * signMask, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a uniform sign byte per block.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ with all the sign bytes of each
+//! block equal to its uniform sign byte, while reading one sign byte per block.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the uniform sign bytes corresponding to blocks of input, one per block.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleUniformSign_)(int nblocks, const BitSequence * input,
+	const BitSequence * signs, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultiple_)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultipleSigned_)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output);
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKey.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKey_)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], BitSequence * output);
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKeySigned.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeySigned_)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence * output);
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultiple_)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, BitSequence * output);
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultipleSigned.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultipleSigned_)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output);
+
+//! \brief Updates the results of multiple SWIFFT operations after the same range of each input changed.
+//! The cost per block is the same as that of SWIFFT_Update.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input, per block.
+//! \param[in] oldBytes the old bytes of the range, len bytes per block.
+//! \param[in] newBytes the new bytes of the range, len bytes per block.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_UpdateMultiple_)(int nblocks, BitSequence * output,
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * output, size_t outStride);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[in] sign the first block of sign bits, of 256 bytes (2048 bit).
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	const BitSequence * sign, size_t signStride, BitSequence * output, size_t outStride);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * compact, size_t compactStride);
+
+//! \brief Compacts hash values of SWIFFT at fixed strides.
+//! The result is the same as that of SWIFFT_CompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] output the first hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive hash values, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_ISET_NAME(SWIFFT_CompactMultipleStrided_)(size_t nblocks, const BitSequence * output, size_t outStride,
+	BitSequence * compact, size_t compactStride);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleGather_)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * outputs);
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the addresses of the blocks of sign bits, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedGather_)(size_t nblocks, const BitSequence * const * inputs,
+	const BitSequence * const * signs, BitSequence * const * outputs);
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleGather_)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * compacts);
+
+//! \brief Compacts hash values of SWIFFT at the addresses of arrays.
+//! The result is the same as that of SWIFFT_CompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_CompactMultipleGather_)(size_t nblocks, const BitSequence * const * outputs,
+	BitSequence * const * compacts);
+
 LIBSWIFFT_END_EXTERN_C
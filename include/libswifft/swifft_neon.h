@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_neon.h
+ * \brief LibSWIFFT public C API for NEON
+ *
+ * See "include/libswifft/swifft_iset.inl" for code expanded here with SWIFFT_ISET set to NEON.
+ *
+ * These functions are built into the library for AArch64 targets. At runtime, call them
+ * only if SWIFFT_IsSupported_NEON() returns non-zero.
+ */
+#ifndef __LIBSWIFFT_SWIFFT_NEON_H_
+#define __LIBSWIFFT_SWIFFT_NEON_H_
+
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() NEON
+#include "libswifft/swifft_iset.inl"
+
+#endif /* __LIBSWIFFT_SWIFFT_NEON_H_ */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_numa.h
+ * \brief LibSWIFFT NUMA public C API
+ *
+ * On a machine with several NUMA nodes, e.g. sockets, a thread reading memory
+ * on another node pays for crossing the interconnect. When built with
+ * SWIFFT_ENABLE_NUMA, each thread looks up the FFT table, multipliers and key
+ * in a replica on the node it runs on, made on first use, rather than in the
+ * static data on one node. A NUMA-aware thread pool spreads its threads over
+ * the nodes, binding each to the CPUs of its node or pinning it to one CPU, and
+ * gives each thread the ranges of blocks whose input is on its node, as placed
+ * by first touch or moved, and stealing from threads on the same node first.
+ * Input not placed yet is split as the pool's threads would place it by first
+ * touch, in consecutive ranges in the order of the threads.
+ *
+ * Without SWIFFT_ENABLE_NUMA, or on a machine with one node, the pool behaves
+ * as the one created by SWIFFT_CreateThreadPool, possibly with pinned threads.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_NUMA_H__
+#define __LIBSWIFFT_SWIFFT_NUMA_H__
+
+#include "libswifft/swifft_executor.h"
+
+#define SWIFFT_NUMA_PIN 1   ///< Pin each worker thread of a NUMA-aware pool to one CPU, rather than to the CPUs of its node
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Returns the number of NUMA nodes of the CPUs the calling thread may run on.
+//!
+//! \returns the number of nodes, or 1 when not built with SWIFFT_ENABLE_NUMA.
+int SWIFFT_NumaNodes(void);
+
+//! \brief Creates a persistent work-stealing thread pool executor that is NUMA-aware.
+//! The worker threads are spread over the nodes in proportion to their CPUs. The thread running
+//! ParallelFor takes part in it as a thread of the node it runs on, and is neither bound nor pinned.
+//! It is destroyed by SWIFFT_DestroyThreadPool.
+//!
+//! \param[in] nthreads the number of threads, including the calling one, or 0 for one per CPU.
+//! \param[in] flags a combination of SWIFFT_NUMA_* flags, or 0.
+//! \returns the executor, or NULL if its resources could not be allocated.
+swifft_executor_t *SWIFFT_CreateNumaThreadPool(int nthreads, int flags);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_NUMA_H__ */
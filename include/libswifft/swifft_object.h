@@ -44,33 +44,44 @@ typedef struct {
 #undef SWIFFT_ISET
 #include "libswifft/swifft_object_iset.inl"
 
-#if defined(__AVX__)
-        #include "libswifft/swifft_avx.h"
-        #undef SWIFFT_ISET
-        #define SWIFFT_ISET() AVX
-        #include "libswifft/swifft_object_iset.inl"
-#else
-        #pragma message "LibSWIFFT API for AVX is disabled"
-#endif
+#if defined(__x86_64__) || defined(__i386__)
 
-#if defined(__AVX2__)
-        #include "libswifft/swifft_avx2.h"
-        #undef SWIFFT_ISET
-        #define SWIFFT_ISET() AVX2
-        #include "libswifft/swifft_object_iset.inl"
-#else
-        #pragma message "LibSWIFFT API for AVX2 is disabled"
-#endif
+#include "libswifft/swifft_avx.h"
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX
+#include "libswifft/swifft_object_iset.inl"
+
+#include "libswifft/swifft_avx2.h"
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX2
+#include "libswifft/swifft_object_iset.inl"
+
+#include "libswifft/swifft_avx512.h"
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX512
+#include "libswifft/swifft_object_iset.inl"
+
+#include "libswifft/swifft_avx512bw.h"
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() AVX512BW
+#include "libswifft/swifft_object_iset.inl"
+
+#elif defined(__aarch64__)
+
+#include "libswifft/swifft_neon.h"
+#undef SWIFFT_ISET
+#define SWIFFT_ISET() NEON
+#include "libswifft/swifft_object_iset.inl"
 
-#if defined(__AVX512F__)
-        #include "libswifft/swifft_avx512.h"
-        #undef SWIFFT_ISET
-        #define SWIFFT_ISET() AVX512
-        #include "libswifft/swifft_object_iset.inl"
-#else
-        #pragma message "LibSWIFFT API for AVX512 is disabled"
 #endif
 
+#undef SWIFFT_ISET
+
+//! \brief Initializes a SWIFFT object using the most advanced instruction set supported by the running CPU.
+//!
+//! \param[out] swifft the SWIFFT object to initialize.
+void SWIFFT_InitBestObject(swifft_object_t *swifft);
+
 LIBSWIFFT_END_EXTERN_C
 
 #endif /* __LIBSWIFFT_SWIFFT_OBJECT_H__ */
@@ -21,6 +21,16 @@
 
 LIBSWIFFT_BEGIN_EXTERN_C
 
+//! \brief Initializes a SWIFFT object.
+//!
+//! \param[out] swifft the SWIFFT object to initialize.
 void SWIFFT_ISET_NAME(SWIFFT_InitObject)(swifft_object_t *swifft);
 
+#ifdef SWIFFT_ISET
+//! \brief Checks whether the running CPU supports the instruction set.
+//!
+//! \returns non-zero if the instruction set is supported, zero otherwise.
+int SWIFFT_ISET_NAME(SWIFFT_IsSupported)(void);
+#endif
+
 LIBSWIFFT_END_EXTERN_C
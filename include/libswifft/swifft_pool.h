@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_pool.h
+ * \brief LibSWIFFT memory pool public C API
+ *
+ * The pool allocates memory for batches of blocks in chunks of power-of-2
+ * sizes, and keeps freed chunks in free lists of the thread freeing them, up
+ * to SWIFFT_POOL_MAX_CACHED chunks per size, so that a thread hashing batches
+ * of similar sizes over and over allocates no memory in steady state, and
+ * takes no lock nor atomic read-modify-write to reuse a chunk. The free lists
+ * of a thread are released when it exits or calls SWIFFT_PoolTrim.
+ *
+ * Chunks of at least SWIFFT_POOL_HUGE_SIZE bytes may be backed by huge pages,
+ * which cover a large batch with fewer TLB entries, as set by
+ * SWIFFT_SetPoolPages for the chunks allocated from then on. Likewise, the
+ * tables the kernels read may be backed by huge pages, as set by
+ * SWIFFT_SetTablePages.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_POOL_H__
+#define __LIBSWIFFT_SWIFFT_POOL_H__
+
+#include <stddef.h> // for size_t
+#include "libswifft/swifft_common.h"
+
+#define SWIFFT_POOL_PAGES_DEFAULT 0      ///< Chunks are backed by pages of the default size
+#define SWIFFT_POOL_PAGES_THP 1          ///< Large chunks are mapped aligned to huge pages and advised to be backed by transparent huge pages
+#define SWIFFT_POOL_PAGES_HUGETLB 2      ///< Large chunks are mapped with MAP_HUGETLB, falling back to SWIFFT_POOL_PAGES_THP if no huge pages are reserved
+
+#define SWIFFT_POOL_HUGE_SIZE (2 << 20)  ///< The size in bytes of a huge page, and of the smallest chunk that may be backed by huge pages
+#define SWIFFT_POOL_MAX_CACHED 4         ///< The maximum number of free chunks of each size a thread keeps
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Allocates memory from the pool, reusing a free chunk of the calling thread if it has one.
+//!
+//! \param[in] size the size in bytes.
+//! \returns the memory, aligned to SWIFFT_ALIGNMENT, or NULL if it could not be allocated.
+void *SWIFFT_PoolAlloc(size_t size);
+
+//! \brief Frees memory to the pool, as a free chunk of the calling thread, whichever thread
+//! allocated it.
+//!
+//! \param[in] ptr the memory, allocated by SWIFFT_PoolAlloc, or NULL.
+void SWIFFT_PoolFree(void *ptr);
+
+//! \brief Releases the free chunks of the calling thread.
+void SWIFFT_PoolTrim(void);
+
+//! \brief Returns the total size in bytes of the free chunks of the calling thread.
+size_t SWIFFT_PoolCachedBytes(void);
+
+//! \brief Sets the pages backing the chunks allocated from now on.
+//!
+//! \param[in] pages one of SWIFFT_POOL_PAGES_*.
+//! \returns 0 on success, or -1 if pages is not one of SWIFFT_POOL_PAGES_*.
+int SWIFFT_SetPoolPages(int pages);
+
+//! \brief Returns the pages backing the chunks allocated from now on, one of SWIFFT_POOL_PAGES_*.
+int SWIFFT_GetPoolPages(void);
+
+//! \brief Copies the tables the kernels read, the FFT table, multipliers and keys, into memory backed
+//! by the given pages, and has the kernels read the copy from then on. With huge pages, the 1 MB FFT
+//! table the FFT phase looks up at random takes one TLB entry rather than one per 4 KB page.
+//! When built with SWIFFT_ENABLE_NUMA, this applies to threads first using the tables after the call,
+//! along with the replicas per node, if not made yet, so it is best called at start-up.
+//!
+//! \param[in] pages one of SWIFFT_POOL_PAGES_*, where SWIFFT_POOL_PAGES_DEFAULT reads the static tables.
+//! \returns 0 on success, or -1 if pages is not one of SWIFFT_POOL_PAGES_* or the copy could not be mapped.
+int SWIFFT_SetTablePages(int pages);
+
+//! \brief Returns the pages backing the tables the kernels read, one of SWIFFT_POOL_PAGES_*.
+int SWIFFT_GetTablePages(void);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_POOL_H__ */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_queue.h
+ * \brief LibSWIFFT asynchronous queue public C API
+ *
+ * A queue hashes batches of blocks submitted to it on a thread of its own, so
+ * that the submitting thread may go on, e.g. to read the next batch while the
+ * previous one is hashed. The queue is asynchronous but serial: its thread
+ * computes one batch at a time, in the order they were submitted, so batches
+ * never run concurrently with each other. Each batch is computed by the
+ * functions for multiple blocks, and so is split into ranges run by the
+ * current executor, which is where the parallelism of a queue comes from.
+ * Batches too small to be split are thus not sped up by a deeper queue. The
+ * queue holds a bounded number of pending batches, including the one being
+ * computed, beyond which submitting waits, or fails when trying, to apply
+ * back-pressure.
+ *
+ * For example, with a depth of 2, a reader may fill one buffer while the other
+ * one is hashed, and reuse a buffer once its batch has completed.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_QUEUE_H__
+#define __LIBSWIFFT_SWIFFT_QUEUE_H__
+
+#include <stdint.h> // for int64_t
+#include "libswifft/swifft_common.h"
+
+#define SWIFFT_QUEUE_DEFAULT_DEPTH 2   ///< The depth of a queue created with depth 0
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief A callback run when a batch has completed, on the thread of the queue.
+//! It must not submit to or wait on its queue.
+typedef void (*swifft_completion_t)(void *context, int64_t ticket);
+
+//! \brief A batch of blocks to hash.
+typedef struct {
+	//! \brief The number of blocks.
+	int nblocks;
+	//! \brief The blocks of input, each of 256 bytes (2048 bit).
+	const BitSequence *input;
+	//! \brief The blocks of sign bits corresponding to the blocks of input, or NULL for all-zero ones.
+	const BitSequence *sign;
+	//! \brief The resulting blocks, each a hash value of 128 bytes (1024 bit), or a compacted one of
+	//! 64 bytes (512 bit) if compact is nonzero.
+	BitSequence *output;
+	//! \brief Whether to compact the resulting hash values.
+	int compact;
+	//! \brief The callback run when the batch has completed, or NULL.
+	swifft_completion_t callback;
+	//! \brief The context passed to the callback.
+	void *context;
+} swifft_batch_t;
+
+//! \brief A queue of batches of blocks to hash.
+typedef struct swifft_queue swifft_queue_t;
+
+//! \brief Creates a queue and its thread.
+//!
+//! \param[in] depth the maximum number of pending batches, or 0 for SWIFFT_QUEUE_DEFAULT_DEPTH.
+//! \returns the queue, or NULL if its resources could not be allocated.
+swifft_queue_t *SWIFFT_CreateQueue(int depth);
+
+//! \brief Destroys a queue, after waiting for its pending batches to complete.
+//!
+//! \param[in] queue the queue created by SWIFFT_CreateQueue, or NULL.
+void SWIFFT_DestroyQueue(swifft_queue_t *queue);
+
+//! \brief Submits a batch to a queue, waiting while the queue is full.
+//! The buffers of the batch must remain valid until it has completed.
+//!
+//! \param[in] queue the queue.
+//! \param[in] batch the batch, which is copied.
+//! \returns the ticket of the batch, counting the batches submitted to the queue from 0, or -1 if
+//! the number of blocks is negative.
+int64_t SWIFFT_QueueSubmit(swifft_queue_t *queue, const swifft_batch_t *batch);
+
+//! \brief Submits a batch to a queue, unless the queue is full.
+//! The buffers of the batch must remain valid until it has completed.
+//!
+//! \param[in] queue the queue.
+//! \param[in] batch the batch, which is copied.
+//! \returns the ticket of the batch, or -1 if the queue is full or the number of blocks is negative.
+int64_t SWIFFT_QueueTrySubmit(swifft_queue_t *queue, const swifft_batch_t *batch);
+
+//! \brief Tests whether a batch of a queue has completed, including running its callback.
+//!
+//! \param[in] queue the queue.
+//! \param[in] ticket the ticket of the batch.
+//! \returns 1 if the batch has completed, or 0 otherwise.
+int SWIFFT_QueuePoll(swifft_queue_t *queue, int64_t ticket);
+
+//! \brief Waits for a batch of a queue, and those submitted before it, to complete.
+//!
+//! \param[in] queue the queue.
+//! \param[in] ticket the ticket of the batch.
+void SWIFFT_QueueWait(swifft_queue_t *queue, int64_t ticket);
+
+//! \brief Waits for all the batches submitted to a queue to complete.
+//!
+//! \param[in] queue the queue.
+void SWIFFT_QueueWaitAll(swifft_queue_t *queue);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_QUEUE_H__ */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_runtime_key.h
+ * \brief LibSWIFFT runtime key public C API
+ *
+ * This API builds a SWIFFT key at runtime, for use with SWIFFT_ComputeWithKey*,
+ * rather than the PI key fixed at build time and used by SWIFFT_Compute*. The
+ * key elements are normalized like those of the PI key and stored once in each
+ * layout the compute kernels read, so computing with a runtime key is as fast
+ * as computing with the PI key.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_RUNTIME_KEY_H__
+#define __LIBSWIFFT_SWIFFT_RUNTIME_KEY_H__
+
+#include <stddef.h> // for size_t
+#include "libswifft/swifft_common.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Initializes a SWIFFT key from its elements, in the layout of the FFT-output.
+//!
+//! \param[out] key the key.
+//! \param[in] elements the elements, each taken modulo 257.
+void SWIFFT_InitKey(swifft_key_t *key, const int16_t elements[SWIFFT_KEY_SIZE]);
+
+//! \brief Initializes a SWIFFT key to the PI key used by SWIFFT_Compute*.
+//!
+//! \param[out] key the key.
+void SWIFFT_InitKeyPI(swifft_key_t *key);
+
+//! \brief Initializes a SWIFFT key from seed material, deterministically.
+//! The seed is expanded by SWIFFT_StreamHash of the seed and a counter, whose digests are split
+//! into 16-bit words that are rejection-sampled to elements of Z_257. SWIFFT is not a vetted
+//! pseudo-random function, so where the key must be indistinguishable from random, expand the
+//! seed using a standard extendable-output function and use SWIFFT_InitKey instead.
+//!
+//! \param[out] key the key.
+//! \param[in] seed the bytes of the seed material.
+//! \param[in] len the number of bytes.
+void SWIFFT_InitKeyFromSeed(swifft_key_t *key, const void *seed, size_t len);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_RUNTIME_KEY_H__ */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_soa.h
+ * \brief LibSWIFFT structure-of-arrays public C API
+ *
+ * This API converts blocks between the array-of-structures layout of the main
+ * API, where each block is contiguous, and the structure-of-arrays layout of
+ * SWIFFT_ComputeMultipleSoA, where blocks are grouped into batches of
+ * SWIFFT_SOA_BLOCKS and byte j of each block of a batch is at
+ * j*SWIFFT_SOA_BLOCKS plus the index of the block in the batch. In the output
+ * layout, the same holds for the 16-bit elements.
+ *
+ * The last batch is padded with all-zero blocks, so nblocks blocks take
+ * SWIFFT_SOA_BATCHES(nblocks) batches.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_SOA_H__
+#define __LIBSWIFFT_SWIFFT_SOA_H__
+
+#include "libswifft/swifft_common.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Converts blocks of input to structure-of-arrays batches.
+//!
+//! \param[in] nblocks the number of blocks.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] soaInput the batches, each of SWIFFT_SOA_INPUT_BATCH_SIZE bytes.
+void SWIFFT_InputToSoA(int nblocks, const BitSequence * input, BitSequence * soaInput);
+
+//! \brief Converts structure-of-arrays batches to blocks of input.
+//!
+//! \param[in] nblocks the number of blocks.
+//! \param[in] soaInput the batches, each of SWIFFT_SOA_INPUT_BATCH_SIZE bytes.
+//! \param[out] input the blocks of input, each of 256 bytes (2048 bit).
+void SWIFFT_InputFromSoA(int nblocks, const BitSequence * soaInput, BitSequence * input);
+
+//! \brief Converts blocks of output to structure-of-arrays batches.
+//!
+//! \param[in] nblocks the number of blocks.
+//! \param[in] output the blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[out] soaOutput the batches, each of SWIFFT_SOA_OUTPUT_BATCH_SIZE bytes.
+void SWIFFT_OutputToSoA(int nblocks, const BitSequence * output, BitSequence * soaOutput);
+
+//! \brief Converts structure-of-arrays batches to blocks of output.
+//!
+//! \param[in] nblocks the number of blocks.
+//! \param[in] soaOutput the batches, each of SWIFFT_SOA_OUTPUT_BATCH_SIZE bytes.
+//! \param[out] output the blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_OutputFromSoA(int nblocks, const BitSequence * soaOutput, BitSequence * output);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_SOA_H__ */
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_stats.h
+ * \brief LibSWIFFT statistics public C API
+ *
+ * When built with SWIFFT_ENABLE_STATS, the entry points of LibSWIFFT count their
+ * calls, blocks and bytes per kind of operation, and, when also built with
+ * SWIFFT_ENABLE_STATS_CYCLES, the TSC cycles they take. Each thread counts in
+ * its own cache-line of counters, which SWIFFT_GetStats aggregates. Otherwise,
+ * no counting code is compiled in and SWIFFT_GetStats reports no statistics.
+ *
+ * An operation is counted once per outermost entry point of its kind, so that
+ * e.g. SWIFFT_ComputeMultiple counts its blocks once under SWIFFT_PARALLEL_COMPUTE
+ * rather than once more per block it computes, while SWIFFT_ComputeCompact
+ * counts its compaction under SWIFFT_PARALLEL_COMPACT too. Hence, the cycles of
+ * a kind include those of the other kinds running within it. The FFT and
+ * FFT-sum phases of a hash computation are counted separately only where they
+ * run as separate steps, e.g. in SWIFFT_Compute, and not within the kernels of
+ * the functions for multiple blocks. The blocks a memo cache
+ * computes are counted as those of the functions it calls.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_STATS_H__
+#define __LIBSWIFFT_SWIFFT_STATS_H__
+
+#include <stdint.h> // for uint64_t
+#include "libswifft/common.h"
+#include "libswifft/swifft_executor.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The statistics of a kind of operation.
+typedef struct {
+	//! \brief The number of calls.
+	uint64_t calls;
+	//! \brief The number of blocks processed.
+	uint64_t blocks;
+	//! \brief The number of bytes of input read.
+	uint64_t bytes;
+	//! \brief The TSC cycles taken by the calling threads, or 0 unless built with SWIFFT_ENABLE_STATS_CYCLES.
+	uint64_t cycles;
+	//! \brief The number of runs over multiple blocks processed on the calling thread.
+	uint64_t serialRuns;
+	//! \brief The number of runs over multiple blocks submitted to the executor.
+	uint64_t parallelRuns;
+} swifft_op_stats_t;
+
+//! \brief The statistics of all kinds of operation.
+typedef struct {
+	//! \brief The statistics per kind of operation, indexed by SWIFFT_PARALLEL_*.
+	swifft_op_stats_t op[SWIFFT_PARALLEL_NOPS];
+	//! \brief The number of blocks looked up in a memo cache of swifft_cache.h and found, or
+	//! repeating another block not found in the same run.
+	uint64_t cacheHits;
+	//! \brief The number of blocks looked up in a memo cache of swifft_cache.h and computed.
+	uint64_t cacheMisses;
+} swifft_stats_t;
+
+//! \brief Gets the statistics aggregated over all threads since the last SWIFFT_ResetStats.
+//! Counts of operations running concurrently may or may not be included.
+//!
+//! \param[out] stats the statistics, all zero if not built with SWIFFT_ENABLE_STATS.
+//! \returns 0 on success, or -1 if not built with SWIFFT_ENABLE_STATS.
+int SWIFFT_GetStats(swifft_stats_t *stats);
+
+//! \brief Resets the statistics of all threads to zero.
+void SWIFFT_ResetStats(void);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_STATS_H__ */
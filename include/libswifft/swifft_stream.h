@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_stream.h
+ * \brief LibSWIFFT streaming public C API
+ *
+ * This API hashes a message of any length, given in any number of byte spans,
+ * into a SWIFFT compact-form digest of SWIFFT_COMPACT_BLOCK_SIZE bytes.
+ *
+ * The message is padded with a 0x80 byte, zero bytes and its 64-bit big-endian
+ * bit-length to a multiple of SWIFFT_STREAM_CHUNK_SIZE bytes, then split into
+ * chunks. Starting with an all-zero state of SWIFFT_COMPACT_BLOCK_SIZE bytes,
+ * each chunk replaces the state with the compact-form of the SWIFFT of the
+ * state followed by the chunk. The digest is the final state.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_STREAM_H__
+#define __LIBSWIFFT_SWIFFT_STREAM_H__
+
+#include <stddef.h> // for size_t
+#include "libswifft/swifft_common.h"
+
+//! The size in bytes of a message chunk, completing the state to a SWIFFT input block.
+#define SWIFFT_STREAM_CHUNK_SIZE (SWIFFT_INPUT_BLOCK_SIZE - SWIFFT_COMPACT_BLOCK_SIZE)
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief A SWIFFT streaming context.
+typedef struct {
+	//! \brief The state, in compact-form.
+	SWIFFT_ALIGN BitSequence state[SWIFFT_COMPACT_BLOCK_SIZE];
+	//! \brief The buffer of a partial chunk.
+	BitSequence buffer[SWIFFT_STREAM_CHUNK_SIZE];
+	//! \brief The number of bytes in the buffer.
+	size_t buffered;
+	//! \brief The number of bytes of the message so far.
+	uint64_t length;
+} swifft_stream_t;
+
+//! \brief Initializes a SWIFFT streaming context for a new message.
+//!
+//! \param[out] stream the SWIFFT streaming context.
+void SWIFFT_StreamInit(swifft_stream_t *stream);
+
+//! \brief Adds a span of bytes to the message.
+//! Full chunks are read directly from the span, and at most one partial chunk is buffered.
+//!
+//! \param[in,out] stream the SWIFFT streaming context.
+//! \param[in] data the bytes, with no alignment requirement.
+//! \param[in] len the number of bytes.
+void SWIFFT_StreamUpdate(swifft_stream_t *stream, const void *data, size_t len);
+
+//! \brief Completes the message and computes its digest.
+//! The context must be initialized again before it is used for another message.
+//!
+//! \param[in,out] stream the SWIFFT streaming context.
+//! \param[out] digest the digest of the message.
+void SWIFFT_StreamFinal(swifft_stream_t *stream, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief Computes the digest of a message given in one span of bytes.
+//!
+//! \param[in] data the bytes of the message, with no alignment requirement.
+//! \param[in] len the number of bytes.
+//! \param[out] digest the digest of the message.
+void SWIFFT_StreamHash(const void *data, size_t len, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_STREAM_H__ */
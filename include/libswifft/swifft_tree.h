@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file include/libswifft/swifft_tree.h
+ * \brief LibSWIFFT tree-hash public C API
+ *
+ * This API hashes a message of any length into a SWIFFT compact-form digest of
+ * SWIFFT_COMPACT_BLOCK_SIZE bytes using a 4-ary tree, so that the blocks of each
+ * level of the tree are hashed in parallel using the multiple-blocks API.
+ *
+ * The tree is defined as follows:
+ * - Level 0 nodes are the compact-forms of the SWIFFT of the blocks of the
+ *   message, the last block padded with zero bytes. An empty message has one
+ *   all-zero block.
+ * - While a level has more than one node, its nodes are packed 4 per block, the
+ *   last block padded with all-zero nodes, and level L+1 nodes are the
+ *   compact-forms of the SWIFFT of these blocks plus the constant L+1.
+ * - The digest is the compact-form of the SWIFFT, plus the constant -1, of the
+ *   block consisting of the single node of the last level, the 64-bit big-endian
+ *   bit-length of the message and zero bytes.
+ *
+ * The constants added before compacting separate the levels from each other.
+ */
+
+#ifndef __LIBSWIFFT_SWIFFT_TREE_H__
+#define __LIBSWIFFT_SWIFFT_TREE_H__
+
+#include <stddef.h> // for size_t
+#include "libswifft/swifft_common.h"
+
+//! Log base-4 of the number of blocks of the message that the tree-hash processes at a time.
+//! This affects memory use and the granularity of parallelism, but not the digest.
+#define SWIFFT_TREE_LOG4_BATCH 6
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Computes the tree-hash digest of a message.
+//! The blocks of the message are read in place, with no alignment requirement.
+//!
+//! \param[in] data the bytes of the message.
+//! \param[in] len the number of bytes.
+//! \param[out] digest the digest of the message.
+//! \returns 0 on success, or -1 if memory for processing the message could not be allocated.
+int SWIFFT_TreeHash(const void *data, size_t len, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+//! \brief The state of an incremental tree-hash of a message.
+typedef struct swifft_tree swifft_tree_t;
+
+//! \brief Creates the state of an incremental tree-hash of a new message.
+//! It holds back up to a batch of SWIFFT_TREE_BATCH blocks of the message, about 1 MB.
+//!
+//! \returns the state, or NULL if it could not be allocated.
+swifft_tree_t *SWIFFT_TreeCreate(void);
+
+//! \brief Destroys the state of an incremental tree-hash.
+//!
+//! \param[in] tree the state created by SWIFFT_TreeCreate, or NULL.
+void SWIFFT_TreeDestroy(swifft_tree_t *tree);
+
+//! \brief Restarts an incremental tree-hash for a new message.
+//!
+//! \param[in,out] tree the state.
+void SWIFFT_TreeReset(swifft_tree_t *tree);
+
+//! \brief Adds a span of bytes to the message of an incremental tree-hash.
+//! Each batch of the message followed by more of it in the span is read in place, and the rest is
+//! copied, so large spans are best.
+//!
+//! \param[in,out] tree the state.
+//! \param[in] data the bytes, with no alignment requirement.
+//! \param[in] len the number of bytes.
+void SWIFFT_TreeUpdate(swifft_tree_t *tree, const void *data, size_t len);
+
+//! \brief Completes the message of an incremental tree-hash and computes its digest, the same as
+//! that of SWIFFT_TreeHash of the whole message. The state must be reset before it is used for
+//! another message.
+//!
+//! \param[in,out] tree the state.
+//! \param[out] digest the digest of the message.
+void SWIFFT_TreeFinal(swifft_tree_t *tree, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE]);
+
+LIBSWIFFT_END_EXTERN_C
+
+#endif /* __LIBSWIFFT_SWIFFT_TREE_H__ */
@@ -9,7 +9,13 @@
 #ifndef __LIBSWIFFT_SWIFFT_VER_H_
 #define __LIBSWIFFT_SWIFFT_VER_H_
 
+#include "libswifft/common.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
 //! \brief Returns the version of LibSWIFFT
 const char * SWIFFT_version();
 
+LIBSWIFFT_END_EXTERN_C
+
 #endif /* __LIBSWIFFT_SWIFFT_VER_H_ */
@@ -6,13 +6,17 @@
 /*! \file src/swifft.c
  * \brief LibSWIFFT public C implementation
  *
- * Implementation using the best instruction set available at build time.
+ * Implementation dispatching to the most advanced instruction set supported by
+ * the running CPU, resolved once at load time.
  */
 
 #include "libswifft/swifft.h"
 #include "libswifft/swifft_avx.h"
 #include "libswifft/swifft_avx2.h"
 #include "libswifft/swifft_avx512.h"
+#include "libswifft/swifft_avx512bw.h"
+#include "libswifft/swifft_neon.h"
+#include "libswifft/swifft_object.h"
 
 #undef SWIFFT_ISET
 #define SWIFFT_ISET() SWIFFT_INSTRUCTION_SET
@@ -23,15 +27,40 @@ LIBSWIFFT_BEGIN_EXTERN_C
 
 SWIFFT_ALIGN const BitSequence SWIFFT_sign0[SWIFFT_INPUT_BLOCK_SIZE] = {0};
 
+#ifndef SWIFFT_DEFAULT_FFT_TABLE_MODE
+	//! The FFT table mode in effect until SWIFFT_SetFftTableMode is called
+	#define SWIFFT_DEFAULT_FFT_TABLE_MODE SWIFFT_FFT_TABLE_LARGE
+#endif
+int SWIFFT_fftTableMode = SWIFFT_DEFAULT_FFT_TABLE_MODE;
+
+void SWIFFT_SetFftTableMode(int mode)
+{
+	SWIFFT_fftTableMode = (mode == SWIFFT_FFT_TABLE_SMALL) ? SWIFFT_FFT_TABLE_SMALL : SWIFFT_FFT_TABLE_LARGE;
+}
+
+int SWIFFT_GetFftTableMode(void)
+{
+	return SWIFFT_fftTableMode;
+}
+
+//! \brief The SWIFFT object the SWIFFT_* functions dispatch to.
+static swifft_object_t SWIFFT_best;
+
+//! \brief Resolves SWIFFT_best, before any constructor of default priority may call into the library.
+__attribute__((constructor(101))) static void SWIFFT_InitBest(void)
+{
+	SWIFFT_InitBestObject(&SWIFFT_best);
+}
+
 void SWIFFT_fft(const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
 {
-	SWIFFT_ISET_NAME(SWIFFT_fft_)(input, sign, m, fftout);
+	SWIFFT_best.fft.SWIFFT_fft(input, sign, m, fftout);
 }
 
 void SWIFFT_fftsum(const int16_t * LIBSWIFFT_RESTRICT ikey,
 	const int16_t * LIBSWIFFT_RESTRICT ifftout, int m, int16_t * LIBSWIFFT_RESTRICT iout)
 {
-	SWIFFT_ISET_NAME(SWIFFT_fftsum_)(ikey, ifftout, m, iout);
+	SWIFFT_best.fft.SWIFFT_fftsum(ikey, ifftout, m, iout);
 }
 
 //! \brief Converts from base-257 to base-256.
@@ -63,7 +92,18 @@ LIBSWIFFT_STATIC_ASSERT(8 * SWIFFT_W == SWIFFT_N, SWIFFT_N_must_be_8_times_SWIFF
 #ifdef __SSE2__
 	#include <string.h>
 	#include "transpose_8x8_16_sse2.inl"
-	LIBSWIFFT_STATIC_ASSERT(sizeof(Z1vec) == sizeof(__m128i), Z1vec_and___m128i_must_have_the_same_size);
+	typedef __m128i swifft_compact_vec_t;                    ///< The 128-bit vector compaction operates on
+	#define SWIFFT_COMPACT_TRANSPOSE transpose_8x8_16_sse2   ///< Transposes 8x8 16-bit elements in place
+	#define SWIFFT_COMPACT_PACKUS16(a, b) _mm_packus_epi16(a, b)   ///< Packs 16-bit elements to 8-bit ones with unsigned saturation
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#include <string.h>
+	#include "transpose_8x8_16_neon.inl"
+	typedef int16x8_t swifft_compact_vec_t;                  ///< The 128-bit vector compaction operates on
+	#define SWIFFT_COMPACT_TRANSPOSE transpose_8x8_16_neon   ///< Transposes 8x8 16-bit elements in place
+	#define SWIFFT_COMPACT_PACKUS16(a, b) ((int16x8_t)vcombine_u8(vqmovun_s16(a), vqmovun_s16(b)))   ///< Packs 16-bit elements to 8-bit ones with unsigned saturation
+#endif
+#ifdef SWIFFT_COMPACT_TRANSPOSE
+	LIBSWIFFT_STATIC_ASSERT(sizeof(Z1vec) == sizeof(swifft_compact_vec_t), Z1vec_and_swifft_compact_vec_t_must_have_the_same_size);
 	LIBSWIFFT_STATIC_ASSERT(sizeof(BitSequence)*SWIFFT_OUTPUT_BLOCK_SIZE == sizeof(Z1vec)*SWIFFT_OUTPUT_Z1_SIZE, output_and_transposed_arrays_must_have_the_same_size);
 #endif
 
@@ -75,6 +115,7 @@ LIBSWIFFT_STATIC_ASSERT(8 * SWIFFT_W == SWIFFT_N, SWIFFT_N_must_be_8_times_SWIFF
 void SWIFFT_Compact(const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPACT);
 	//
 	// The 8*8 output int16_ts needs to be transposed before and after
 	// SIMD base change.
@@ -82,10 +123,10 @@ void SWIFFT_Compact(const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	// but then a transpose like operation would have to be performed
 	// by the normal (Non-SIMD) version.
 	//
-#ifdef __SSE2__
-	__m128i transposed[SWIFFT_OUTPUT_Z1_SIZE];
+#ifdef SWIFFT_COMPACT_TRANSPOSE
+	swifft_compact_vec_t transposed[SWIFFT_OUTPUT_Z1_SIZE];
 	memcpy(transposed, output, sizeof(BitSequence)*SWIFFT_OUTPUT_BLOCK_SIZE);
-	transpose_8x8_16_sse2(transposed);
+	SWIFFT_COMPACT_TRANSPOSE(transposed);
 	ToBase256((Z1vec *) transposed, SWIFFT_OUTPUT_Z1_SIZE);
 	int16_t * tin = ((int16_t *) transposed) + ((SWIFFT_COMPACT_TRANSPOSE_SIZE - 1) * SWIFFT_COMPACT_TRANSPOSE_SIZE);
 	int carry = 0;
@@ -95,14 +136,14 @@ void SWIFFT_Compact(const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 		carry |= ((*tin>>8)<<i);
 		*tin &= 255;
 	}
-	transpose_8x8_16_sse2(transposed);
-	__m128i * ztin = transposed;
-	__m128i * cout = (__m128i *) compact;
+	SWIFFT_COMPACT_TRANSPOSE(transposed);
+	swifft_compact_vec_t * ztin = transposed;
+	swifft_compact_vec_t * cout = (swifft_compact_vec_t *) compact;
 	for (i=0; i<SWIFFT_OUTPUT_Z1_SIZE/2; i++) {
-		__m128i a = *ztin++;
-		__m128i b = *ztin++;
+		swifft_compact_vec_t a = *ztin++;
+		swifft_compact_vec_t b = *ztin++;
 		// compact 16-bit elements to 8-bit ones: saturation is avoided
-		*cout++ = _mm_packus_epi16(a, b);
+		*cout++ = SWIFFT_COMPACT_PACKUS16(a, b);
 	}
 	// ignore carry
 #else
@@ -137,6 +178,7 @@ void SWIFFT_Compact(const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	}
 	// ignore carry
 #endif
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPACT, 1, SWIFFT_OUTPUT_BLOCK_SIZE);
 }
 
 //! \brief Sets a constant value at each SWIFFT hash value element.
@@ -146,7 +188,7 @@ void SWIFFT_Compact(const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_ConstSet(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const int16_t operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstSet_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstSet(output, operand);
 }
 
 //! \brief Adds a constant value to each SWIFFT hash value element.
@@ -156,7 +198,7 @@ void SWIFFT_ConstSet(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_ConstAdd(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const int16_t operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstAdd_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstAdd(output, operand);
 }
 
 //! \brief Subtracts a constant value from each SWIFFT hash value element.
@@ -166,7 +208,7 @@ void SWIFFT_ConstAdd(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_ConstSub(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const int16_t operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstSub_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstSub(output, operand);
 }
 
 //! \brief Multiply a constant value into each SWIFFT hash value element.
@@ -176,7 +218,7 @@ void SWIFFT_ConstSub(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_ConstMul(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const int16_t operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstMul_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstMul(output, operand);
 }
 
 //! \brief Sets a SWIFFT hash value to another, element-wise.
@@ -186,7 +228,7 @@ void SWIFFT_ConstMul(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_Set(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const BitSequence operand[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_Set_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_Set(output, operand);
 }
 
 //! \brief Adds a SWIFFT hash value to another, element-wise.
@@ -196,7 +238,7 @@ void SWIFFT_Set(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_Add(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const BitSequence operand[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_Add_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_Add(output, operand);
 }
 
 //! \brief Subtracts a SWIFFT hash value from another, element-wise.
@@ -206,7 +248,7 @@ void SWIFFT_Add(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_Sub(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const BitSequence operand[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_Sub_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_Sub(output, operand);
 }
 
 //! \brief Multiplies a SWIFFT hash value from another, element-wise.
@@ -216,7 +258,7 @@ void SWIFFT_Sub(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_Mul(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	const BitSequence operand[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_Mul_)(output, operand);
+	SWIFFT_best.arith.SWIFFT_Mul(output, operand);
 }
 
 //! \brief Computes the result of a SWIFFT operation.
@@ -227,7 +269,7 @@ void SWIFFT_Mul(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 void SWIFFT_Compute(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_Compute_)(input, output);
+	SWIFFT_best.hash.SWIFFT_Compute(input, output);
 }
 
 //! \brief Computes the result of a SWIFFT operation.
@@ -240,7 +282,7 @@ void SWIFFT_ComputeSigned(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
 	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_ComputeSigned_)(input, sign, output);
+	SWIFFT_best.hash.SWIFFT_ComputeSigned(input, sign, output);
 }
 
 //! \brief Computes the FFT phase of SWIFFT for multiple blocks.
@@ -252,7 +294,7 @@ void SWIFFT_ComputeSigned(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
 //! \param[out] fftout the blocks of FFT-output elements, totaling N*m.
 void SWIFFT_fftMultiple(int nblocks, const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
 {
-	SWIFFT_ISET_NAME(SWIFFT_fftMultiple_)(nblocks, input, sign, m, fftout);
+	SWIFFT_best.fft.SWIFFT_fftMultiple(nblocks, input, sign, m, fftout);
 }
 
 //! \brief Computes the FFT-sum phase of SWIFFT for multiple blocks.
@@ -265,7 +307,7 @@ void SWIFFT_fftMultiple(int nblocks, const BitSequence * LIBSWIFFT_RESTRICT inpu
 void SWIFFT_fftsumMultiple(int nblocks, const int16_t * LIBSWIFFT_RESTRICT ikey,
         const int16_t * LIBSWIFFT_RESTRICT ifftout, int m, int16_t * LIBSWIFFT_RESTRICT iout)
 {
-	SWIFFT_ISET_NAME(SWIFFT_fftsumMultiple_)(nblocks, ikey, ifftout, m, iout);
+	SWIFFT_best.fft.SWIFFT_fftsumMultiple(nblocks, ikey, ifftout, m, iout);
 }
 
 //! \brief Compacts a hash value of SWIFFT for multiple blocks.
@@ -277,7 +319,7 @@ void SWIFFT_fftsumMultiple(int nblocks, const int16_t * LIBSWIFFT_RESTRICT ikey,
 void SWIFFT_CompactMultiple(int nblocks, const BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
         BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
 {
-	SWIFFT_ISET_NAME(SWIFFT_CompactMultiple_)(nblocks, output, compact);
+	SWIFFT_best.hash.SWIFFT_CompactMultiple(nblocks, output, compact);
 }
 
 //! \brief Sets a constant value at each SWIFFT hash value element for multiple blocks.
@@ -288,7 +330,7 @@ void SWIFFT_CompactMultiple(int nblocks, const BitSequence output[SWIFFT_OUTPUT_
 void SWIFFT_ConstSetMultiple(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstSetMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstSetMultiple(nblocks, output, operand);
 }
 
 //! \brief Adds a constant value to each SWIFFT hash value element for multiple blocks.
@@ -299,7 +341,7 @@ void SWIFFT_ConstSetMultiple(int nblocks, BitSequence * output,
 void SWIFFT_ConstAddMultiple(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstAddMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstAddMultiple(nblocks, output, operand);
 }
 
 //! \brief Subtracts a constant value from each SWIFFT hash value element for multiple blocks.
@@ -310,7 +352,7 @@ void SWIFFT_ConstAddMultiple(int nblocks, BitSequence * output,
 void SWIFFT_ConstSubMultiple(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstSubMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstSubMultiple(nblocks, output, operand);
 }
 
 //! \brief Multiply a constant value into each SWIFFT hash value element for multiple blocks.
@@ -321,7 +363,7 @@ void SWIFFT_ConstSubMultiple(int nblocks, BitSequence * output,
 void SWIFFT_ConstMulMultiple(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ConstMulMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_ConstMulMultiple(nblocks, output, operand);
 }
 
 //! \brief Sets a SWIFFT hash value to another, element-wise, for multiple blocks.
@@ -332,7 +374,7 @@ void SWIFFT_ConstMulMultiple(int nblocks, BitSequence * output,
 void SWIFFT_SetMultiple(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_SetMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_SetMultiple(nblocks, output, operand);
 }
 
 //! \brief Adds a SWIFFT hash value to another, element-wise, for multiple blocks.
@@ -343,7 +385,7 @@ void SWIFFT_SetMultiple(int nblocks, BitSequence * output,
 void SWIFFT_AddMultiple(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_AddMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_AddMultiple(nblocks, output, operand);
 }
 
 //! \brief Subtracts a SWIFFT hash value from another, element-wise, for multiple blocks.
@@ -354,7 +396,7 @@ void SWIFFT_AddMultiple(int nblocks, BitSequence * output,
 void SWIFFT_SubMultiple(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_SubMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_SubMultiple(nblocks, output, operand);
 }
 
 //! \brief Multiplies a SWIFFT hash value from another, element-wise, for multiple blocks.
@@ -365,7 +407,107 @@ void SWIFFT_SubMultiple(int nblocks, BitSequence * output,
 void SWIFFT_MulMultiple(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
-	SWIFFT_ISET_NAME(SWIFFT_MulMultiple_)(nblocks, output, operand);
+	SWIFFT_best.arith.SWIFFT_MulMultiple(nblocks, output, operand);
+}
+
+//! \brief Sums SWIFFT hash values of multiple blocks, element-wise.
+//!
+//! \param[in] nblocks the number of blocks to sum.
+//! \param[in] outputs the hash values of SWIFFT to sum, per block.
+//! \param[out] result the sum of the hash values, or all zeros for no blocks.
+void SWIFFT_SumMultiple(int nblocks, const BitSequence * outputs, BitSequence * result)
+{
+	SWIFFT_best.arith.SWIFFT_SumMultiple(nblocks, outputs, result);
+}
+
+//! \brief Computes a linear combination of SWIFFT hash values of multiple blocks, element-wise.
+//!
+//! \param[in] nblocks the number of blocks to combine.
+//! \param[in] coeffs the coefficient of each hash value, taken mod-257.
+//! \param[in] outputs the hash values of SWIFFT to combine, per block.
+//! \param[out] result the linear combination of the hash values, or all zeros for no blocks.
+void SWIFFT_LinearCombination(int nblocks, const int16_t * coeffs, const BitSequence * outputs,
+	BitSequence * result)
+{
+	SWIFFT_best.arith.SWIFFT_LinearCombination(nblocks, coeffs, outputs, result);
+}
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_AddMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to add.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to add, possibly 0.
+void SWIFFT_AddMultipleStrided(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	SWIFFT_best.arith.SWIFFT_AddMultipleStrided(nblocks, output, outStride, operand, operandStride);
+}
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_AddMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to add.
+void SWIFFT_AddMultipleGather(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	SWIFFT_best.arith.SWIFFT_AddMultipleGather(nblocks, outputs, operands);
+}
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_SubMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to subtract.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to subtract, possibly 0.
+void SWIFFT_SubMultipleStrided(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	SWIFFT_best.arith.SWIFFT_SubMultipleStrided(nblocks, output, outStride, operand, operandStride);
+}
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_SubMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to subtract.
+void SWIFFT_SubMultipleGather(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	SWIFFT_best.arith.SWIFFT_SubMultipleGather(nblocks, outputs, operands);
+}
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_MulMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to multiply by.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to multiply by, possibly 0.
+void SWIFFT_MulMultipleStrided(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	SWIFFT_best.arith.SWIFFT_MulMultipleStrided(nblocks, output, outStride, operand, operandStride);
+}
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_MulMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to multiply by.
+void SWIFFT_MulMultipleGather(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	SWIFFT_best.arith.SWIFFT_MulMultipleGather(nblocks, outputs, operands);
 }
 
 //! \brief Computes the result of multiple SWIFFT operations.
@@ -376,7 +518,7 @@ void SWIFFT_MulMultiple(int nblocks, BitSequence * output,
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void SWIFFT_ComputeMultiple(int nblocks, const BitSequence * input, BitSequence * output)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple_)(nblocks, input, output);
+	SWIFFT_best.hash.SWIFFT_ComputeMultiple(nblocks, input, output);
 }
 
 //! \brief Computes the result of multiple SWIFFT operations.
@@ -389,7 +531,427 @@ void SWIFFT_ComputeMultiple(int nblocks, const BitSequence * input, BitSequence
 void SWIFFT_ComputeMultipleSigned(int nblocks, const BitSequence * input,
 	const BitSequence * sign, BitSequence * output)
 {
-	SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSigned_)(nblocks, input, sign, output);
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleSigned(nblocks, input, sign, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with sign bits given as sign-masks.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned with sign bytes of 0xFF where
+//! the bits of the sign-masks are set and 0 elsewhere, while reading an eighth as many sign bytes.
+//! It saves memory rather than time: the sign bytes are expanded into a buffer that the FFT phase
+//! then reads, which costs slightly more than SWIFFT_ComputeMultipleSigned on sign bytes in cache.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signMask the sign-masks corresponding to blocks of input, each of 32 bytes (256 bit),
+//! whose bit j of byte i is for input byte 8*i+j.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultipleSignMask(int nblocks, const BitSequence * input,
+	const BitSequence * signMask, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleSignMask(nblocks, input, signMask, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a uniform sign byte per block.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned with all the sign bytes of each
+//! block equal to its uniform sign byte, while reading one sign byte per block.
+//! Like SWIFFT_ComputeMultipleSignMask, it saves memory rather than time, unless all the sign bytes
+//! of a group of blocks are zero, which computes as SWIFFT_ComputeMultiple does.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the uniform sign bytes corresponding to blocks of input, one per block.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultipleUniformSign(int nblocks, const BitSequence * input,
+	const BitSequence * signs, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleUniformSign(nblocks, input, signs, output);
+}
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ComputeWithKey(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_best.hash.SWIFFT_ComputeWithKey(key, input, output);
+}
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ComputeWithKeySigned(const swifft_key_t *key, const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_best.hash.SWIFFT_ComputeWithKeySigned(key, input, sign, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeWithKeyMultiple(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeWithKeyMultiple(nblocks, key, input, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeWithKeyMultipleSigned(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeWithKeyMultipleSigned(nblocks, key, input, sign, output);
+}
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKey.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultiKey(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultiKey(nkeys, keys, input, output);
+}
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys, running the FFT
+//! phase once for all of them. The result per key is the same as that of SWIFFT_ComputeWithKeySigned.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultiKeySigned(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultiKeySigned(nkeys, keys, input, sign, output);
+}
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultiKeyMultiple(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultiKeyMultiple(nblocks, nkeys, keys, input, output);
+}
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys, running
+//! the FFT phase once per block. The results of block i are at output plus i*nkeys hash values, one
+//! per key, each the same as that of SWIFFT_ComputeWithKeyMultipleSigned.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultiKeyMultipleSigned(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultiKeyMultipleSigned(nblocks, nkeys, keys, input, sign, output);
+}
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_Update(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len)
+{
+	return SWIFFT_best.hash.SWIFFT_Update(output, oldBytes, newBytes, offset, len);
+}
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input and sign bits changed.
+//! The input is recomputed in aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for
+//! AVX512, so the cost is proportional to the number of groups the range overlaps, rather than to the
+//! size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] oldSign the old sign bits corresponding to the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] newSign the new sign bits corresponding to the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_UpdateSigned(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * oldSign,
+	const BitSequence * newBytes, const BitSequence * newSign, size_t offset, size_t len)
+{
+	return SWIFFT_best.hash.SWIFFT_UpdateSigned(output, oldBytes, oldSign, newBytes, newSign, offset, len);
+}
+
+//! \brief Updates the results of multiple SWIFFT operations after the same range of each input changed.
+//! The cost per block is the same as that of SWIFFT_Update.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input, per block.
+//! \param[in] oldBytes the old bytes of the range, len bytes per block.
+//! \param[in] newBytes the new bytes of the range, len bytes per block.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_UpdateMultiple(int nblocks, BitSequence * output,
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len)
+{
+	return SWIFFT_best.hash.SWIFFT_UpdateMultiple(nblocks, output, oldBytes, newBytes, offset, len);
+}
+
+//! \brief Computes the result of a SWIFFT operation, faster the more all-zero 8-byte columns the
+//! input has. The result is the same as that of SWIFFT_Compute.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ComputeSparse(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_best.hash.SWIFFT_ComputeSparse(input, output);
+}
+
+//! \brief Computes the result of a SWIFFT operation on a short input, transforming only its columns.
+//! The result is the same as that of SWIFFT_Compute on the input padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int SWIFFT_ComputeShort(int m, const BitSequence * input, BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	return SWIFFT_best.hash.SWIFFT_ComputeShort(m, input, output);
+}
+
+//! \brief Computes the result of a SWIFFT operation on a short input with sign bits, transforming only
+//! its columns. The result is the same as that of SWIFFT_ComputeSigned on the input and sign bits
+//! padded with zeros to 256 bytes.
+//!
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS from it up to 32.
+//! \param[in] input the input of 8*m bytes.
+//! \param[in] sign the sign bits corresponding to the input, of 8*m bytes.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \returns 0 on success, or -1 if m is not valid.
+int SWIFFT_ComputeShortSigned(int m, const BitSequence * input, const BitSequence * sign,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	return SWIFFT_best.hash.SWIFFT_ComputeShortSigned(m, input, sign, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations, faster the more all-zero 8-byte columns
+//! the inputs have. The result is the same as that of SWIFFT_ComputeMultiple.
+//! The key multiply-accumulate is skipped for each all-zero column, but the FFT only for all-zero
+//! aligned groups of 8 bytes for AVX and NEON, 16 for AVX2 and 32 for AVX512.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeSparseMultiple(int nblocks, const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeSparseMultiple(nblocks, input, output);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations in the structure-of-arrays layout, which
+//! is faster than SWIFFT_ComputeMultiple for AVX512BW. The result is that of SWIFFT_ComputeMultiple
+//! in the same layout, as converted by SWIFFT_InputToSoA and SWIFFT_OutputFromSoA.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] soaInput the batches of input, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! \param[out] soaOutput the resulting batches of hash values, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! The hash value of a padding block is that of its input.
+void SWIFFT_ComputeMultipleSoA(int nblocks, const BitSequence * soaInput, BitSequence * soaOutput)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleSoA(nblocks, soaInput, soaOutput);
+}
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_Compute followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ComputeCompact(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompact(input, compact);
+}
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The result is the same as that of SWIFFT_ComputeSigned followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ComputeCompactSigned(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompactSigned(input, sign, compact);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultiple followed by SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ComputeCompactMultiple(int nblocks, const BitSequence * input, BitSequence * compact)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompactMultiple(nblocks, input, compact);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations, without storing the hash
+//! values. The result is the same as that of SWIFFT_ComputeMultipleSigned followed by
+//! SWIFFT_CompactMultiple.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ComputeCompactMultipleSigned(int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompactMultipleSigned(nblocks, input, sign, compact);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ComputeMultipleStrided(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * output, size_t outStride)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleStrided(nblocks, input, inStride, output, outStride);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[in] sign the first block of sign bits, of 256 bytes (2048 bit).
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ComputeMultipleSignedStrided(size_t nblocks, const BitSequence * input, size_t inStride,
+	const BitSequence * sign, size_t signStride, BitSequence * output, size_t outStride)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleSignedStrided(nblocks, input, inStride, sign, signStride, output, outStride);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_ComputeCompactMultipleStrided(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * compact, size_t compactStride)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompactMultipleStrided(nblocks, input, inStride, compact, compactStride);
+}
+
+//! \brief Compacts hash values of SWIFFT at fixed strides.
+//! The result is the same as that of SWIFFT_CompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] output the first hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive hash values, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_CompactMultipleStrided(size_t nblocks, const BitSequence * output, size_t outStride,
+	BitSequence * compact, size_t compactStride)
+{
+	SWIFFT_best.hash.SWIFFT_CompactMultipleStrided(nblocks, output, outStride, compact, compactStride);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultipleGather(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * outputs)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleGather(nblocks, inputs, outputs);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the addresses of the blocks of sign bits, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ComputeMultipleSignedGather(size_t nblocks, const BitSequence * const * inputs,
+	const BitSequence * const * signs, BitSequence * const * outputs)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeMultipleSignedGather(nblocks, inputs, signs, outputs);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ComputeCompactMultipleGather(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * compacts)
+{
+	SWIFFT_best.hash.SWIFFT_ComputeCompactMultipleGather(nblocks, inputs, compacts);
+}
+
+//! \brief Compacts hash values of SWIFFT at the addresses of arrays.
+//! The result is the same as that of SWIFFT_CompactMultiple on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_CompactMultipleGather(size_t nblocks, const BitSequence * const * outputs,
+	BitSequence * const * compacts)
+{
+	SWIFFT_best.hash.SWIFFT_CompactMultipleGather(nblocks, outputs, compacts);
 }
 
 LIBSWIFFT_END_EXTERN_C
@@ -8,69 +8,241 @@
  */
 #include <stddef.h> // for size_t
 #include <string.h> // for memcpy
+#if defined(__aarch64__)
+	#include <arm_neon.h>
+#else
+	#include <immintrin.h>
+#endif
 #include "libswifft/swifft_iset.inl"
+#include "libswifft/swifft_soa.h"
 #include "swifft_ops.inl"
 
-#ifndef SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD
-	#define SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD 8
+#ifndef SWIFFT_LOG2_INTERLEAVE
+	//! Log base-2 of the number of blocks SWIFFT_ComputeMultiple* compute interleaved
+	#define SWIFFT_LOG2_INTERLEAVE 2
+#endif
+#define SWIFFT_INTERLEAVE (1 << SWIFFT_LOG2_INTERLEAVE) ///< Number of blocks SWIFFT_ComputeMultiple* compute interleaved
+#ifndef SWIFFT_MADD_FFTSUM
+	//! Whether to compute the FFT-sum with 32-bit multiply-accumulate (VPMADDWD) - enabled by default for AVX512BW
+	#if defined(__AVX512BW__) && (SWIFFT_LOG2_O == 2)
+		#define SWIFFT_MADD_FFTSUM 1
+	#else
+		#define SWIFFT_MADD_FFTSUM 0
+	#endif
+#endif
+#ifndef SWIFFT_FFT_PREFETCH
+	//! Whether SWIFFT_fft_ prefetches the large FFT table entries of the next group of columns while transforming the current one - disabled by default, being slower where the table stays in the L2 cache, as out-of-order execution already overlaps the gathers
+	#define SWIFFT_FFT_PREFETCH 0
+#endif
+#ifndef SWIFFT_SOA_KERNEL
+	//! Whether SWIFFT_ComputeMultipleSoA computes with one block per 16-bit lane, rather than by converting batches to blocks - enabled by default along with SWIFFT_MADD_FFTSUM, whose reduction it uses
+	#define SWIFFT_SOA_KERNEL SWIFFT_MADD_FFTSUM
 #endif
 
 LIBSWIFFT_BEGIN_EXTERN_C
 
-//! \brief Computes the FFT phase of SWIFFT.
+//! \brief Gathers the FFT table entries of row k of a group of SWIFFT_O 8-element columns.
+//! The entries are combined in registers, avoiding a store-forwarding stall from lane-wise writes.
 //!
-//! \param[in] input the blocks of input, each of 256 bytes (2048 bits).
-//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bits).
-//! \param[in] m number of 8-elements in the input.
-//! \param[out] fftout the blocks of FFT-output elements, totaling SWIFFT_N*m.
-void SWIFFT_ISET_NAME(SWIFFT_fft_)(const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
+//! \param[in] Tabl the FFT table.
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] u the sign bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] k the row.
+//! \returns the wide SWIFFT vector whose SWIFFT vector j is the table entry for row k of column j.
+static inline ZOvec SWIFFT_gather(const Z1vec *Tabl, const BitSequence *t, const BitSequence *u, int k)
 {
-	int i,j,k;
-	Z1vec *out = (Z1vec *) fftout;
-	const Z1vec *Mult = (const Z1vec *) SWIFFT_multipliers;
-	const Z1vec *Tabl = (const Z1vec *) SWIFFT_fftTable;
+#if SWIFFT_O == 1
+	return Tabl[SWIFFT_INT16(u[k],t[k])];
+#else
+	__m256i lo = _mm256_set_m128i((__m128i)Tabl[SWIFFT_INT16(u[8+k],t[8+k])], (__m128i)Tabl[SWIFFT_INT16(u[k],t[k])]);
+	#if SWIFFT_O == 2
+	return (ZOvec)lo;
+	#else
+	__m256i hi = _mm256_set_m128i((__m128i)Tabl[SWIFFT_INT16(u[24+k],t[24+k])], (__m128i)Tabl[SWIFFT_INT16(u[16+k],t[16+k])]);
+	return (ZOvec)_mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+	#endif
+#endif
+}
 
-	const BitSequence *t = input;
-	const BitSequence *u = sign;
-	ZOvec v[8];
+//! \brief Gathers the small FFT table entries of row k of a group of SWIFFT_O 8-element columns,
+//! for the input bits selected by a mask of the sign bits.
+//!
+//! \param[in] Tabl the FFT table, of which only the first SWIFFT_V*SWIFFT_W elements are used.
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] u the sign bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] k the row.
+//! \param[in] flip 0xFF to select the input bits with a clear sign bit, 0 to select those with a set one.
+//! \returns the wide SWIFFT vector whose SWIFFT vector j is the table entry for row k of column j.
+static inline ZOvec SWIFFT_gatherMasked(const Z1vec *Tabl, const BitSequence *t, const BitSequence *u, int k, BitSequence flip)
+{
+#define SWIFFT_MASKED(j) (t[(j)+k] & (u[(j)+k] ^ flip))
+#if SWIFFT_O == 1
+	return Tabl[SWIFFT_MASKED(0)];
+#else
+	__m256i lo = _mm256_set_m128i((__m128i)Tabl[SWIFFT_MASKED(8)], (__m128i)Tabl[SWIFFT_MASKED(0)]);
+	#if SWIFFT_O == 2
+	return (ZOvec)lo;
+	#else
+	__m256i hi = _mm256_set_m128i((__m128i)Tabl[SWIFFT_MASKED(24)], (__m128i)Tabl[SWIFFT_MASKED(16)]);
+	return (ZOvec)_mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+	#endif
+#endif
+#undef SWIFFT_MASKED
+}
 
-	for (i=0; i<(m>>SWIFFT_LOG2_O); i++) {
-		for (j=0; j<SWIFFT_O; j++,t+=8,u+=8) {
-			// no need for SWIFFT_safeMult because multipliers do not hit an edge case
-			((Z1vec *)&v[0])[j] = Tabl[SWIFFT_INT16(u[0],t[0])];
-			for (k=1; k<8; k++) {
-				((Z1vec *)&v[k])[j] = Tabl[SWIFFT_INT16(u[k],t[k])] * Mult[k];
-			}
-		}
+//! \brief Gathers the FFT table entries of row k of a group of SWIFFT_O 8-element columns
+//! in the given FFT table mode.
+//! The signed table entry of an input byte x and a sign byte w is the unsigned table entry of
+//! the input bits with a clear sign bit, x&~w, minus that of the ones with a set sign bit, x&w,
+//! so the small table mode composes it from the first SWIFFT_V entries and centers the difference.
+//!
+//! \param[in] Tabl the FFT table.
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] u the sign bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] k the row.
+//! \param[in] small whether to use the small table mode.
+//! \returns the wide SWIFFT vector whose SWIFFT vector j is the table entry for row k of column j.
+static inline ZOvec SWIFFT_gatherMode(const Z1vec *Tabl, const BitSequence *t, const BitSequence *u, int k, int small)
+{
+	if (!small) {
+		return SWIFFT_gather(Tabl, t, u, k);
+	}
+	ZOvec ZO_128 = ZOCONST(128), ZO_M128 = ZOCONST(-128), ZO_257 = ZOCONST(257);
+	ZOvec x = SWIFFT_gatherMasked(Tabl, t, u, k, 0xFF) - SWIFFT_gatherMasked(Tabl, t, u, k, 0);
+	// centering from the range [-256,256] to [-128,128], as the entries of the large table are
+	return x - ((x > ZO_128) & ZO_257) + ((x < ZO_M128) & ZO_257);
+}
+
+//! \brief Broadcasts a SWIFFT vector into each SWIFFT vector of a wide SWIFFT vector.
+//!
+//! \param[in] x the SWIFFT vector.
+//! \returns the wide SWIFFT vector.
+static inline ZOvec SWIFFT_broadcast(Z1vec x)
+{
+#if SWIFFT_O == 1
+	return x;
+#elif SWIFFT_O == 2
+	return (ZOvec)_mm256_broadcastsi128_si256((__m128i)x);
+#else
+	return (ZOvec)_mm512_broadcast_i32x4((__m128i)x);
+#endif
+}
 
-		SWIFFT_AddSub(v[0],v[1]);
-		SWIFFT_AddSub(v[2],v[3]);
-		SWIFFT_AddSub(v[4],v[5]);
-		SWIFFT_AddSub(v[6],v[7]);
+//! \brief Computes the butterflies of the FFT phase of SWIFFT, after the multipliers are applied.
+//! Each element of the wide SWIFFT vectors is transformed independently of the others.
+//!
+//! \param[in,out] v the rows of the FFT, replaced by the rows of the FFT-output.
+static inline void SWIFFT_fftButterflies(ZOvec v[8])
+{
+	int k;
 
-		v[2] = SWIFFT_qReduce(v[2]);
-		v[3] = SWIFFT_shift(v[3],4);
-		v[6] = SWIFFT_qReduce(v[6]);
-		v[7] = SWIFFT_shift(v[7],4);
+	SWIFFT_AddSub(v[0],v[1]);
+	SWIFFT_AddSub(v[2],v[3]);
+	SWIFFT_AddSub(v[4],v[5]);
+	SWIFFT_AddSub(v[6],v[7]);
 
-		SWIFFT_AddSub(v[0],v[2]);
-		SWIFFT_AddSub(v[1],v[3]);
-		SWIFFT_AddSub(v[4],v[6]);
-		SWIFFT_AddSub(v[5],v[7]);
+	v[2] = SWIFFT_qReduce(v[2]);
+	v[3] = SWIFFT_shift(v[3],4);
+	v[6] = SWIFFT_qReduce(v[6]);
+	v[7] = SWIFFT_shift(v[7],4);
 
-		v[4] = SWIFFT_qReduce(v[4]);
-		v[5] = SWIFFT_shift(v[5],2);
-		v[6] = SWIFFT_shift(v[6],4);
-		v[7] = SWIFFT_shift(v[7],6);
+	SWIFFT_AddSub(v[0],v[2]);
+	SWIFFT_AddSub(v[1],v[3]);
+	SWIFFT_AddSub(v[4],v[6]);
+	SWIFFT_AddSub(v[5],v[7]);
 
-		SWIFFT_AddSub(v[0],v[4]);
-		SWIFFT_AddSub(v[1],v[5]);
-		SWIFFT_AddSub(v[2],v[6]);
-		SWIFFT_AddSub(v[3],v[7]);
+	v[4] = SWIFFT_qReduce(v[4]);
+	v[5] = SWIFFT_shift(v[5],2);
+	v[6] = SWIFFT_shift(v[6],4);
+	v[7] = SWIFFT_shift(v[7],6);
 
-		for (k=0; k<8; k++) {
-			v[k] = SWIFFT_qReduce(v[k]);
+	SWIFFT_AddSub(v[0],v[4]);
+	SWIFFT_AddSub(v[1],v[5]);
+	SWIFFT_AddSub(v[2],v[6]);
+	SWIFFT_AddSub(v[3],v[7]);
+
+	#pragma GCC unroll 8
+	for (k=0; k<8; k++) {
+		v[k] = SWIFFT_qReduce(v[k]);
+	}
+}
+
+//! \brief Computes the FFT phase of SWIFFT for a group of SWIFFT_O 8-element columns.
+//!
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] u the sign bytes of the group, 8*SWIFFT_O of them.
+//! \param[out] v the FFT-output, where row k of column j of the group is SWIFFT vector j of v[k].
+//! \param[in] small whether to use the small table mode.
+static inline void SWIFFT_fftGroup(const BitSequence * LIBSWIFFT_RESTRICT t, const BitSequence * LIBSWIFFT_RESTRICT u, ZOvec v[8], int small)
+{
+	int k;
+	const Z1vec *Mult = (const Z1vec *) SWIFFT_TABLE(multipliers);
+	const Z1vec *Tabl = (const Z1vec *) SWIFFT_TABLE(fftTable);
+
+	v[0] = SWIFFT_gatherMode(Tabl, t, u, 0, small);
+	#pragma GCC unroll 8
+	for (k=1; k<8; k++) {
+		// no need for SWIFFT_safeMult because multipliers do not hit an edge case
+		v[k] = SWIFFT_gatherMode(Tabl, t, u, k, small) * SWIFFT_broadcast(Mult[k]);
+	}
+
+	SWIFFT_fftButterflies(v);
+}
+
+#define SWIFFT_GROUP_SIZE (8*SWIFFT_O) ///< The number of input bytes transformed together by SWIFFT_fftGroup
+
+//! \brief Prefetches the FFT table entries of a group of SWIFFT_O 8-element columns in the large
+//! table mode, whose random rows would otherwise miss the cache one at a time.
+//!
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them.
+//! \param[in] u the sign bytes of the group, 8*SWIFFT_O of them.
+static inline void SWIFFT_prefetchGroup(const BitSequence *t, const BitSequence *u)
+{
+	const Z1vec *Tabl = (const Z1vec *) SWIFFT_TABLE(fftTable);
+	int j;
+	#pragma GCC unroll 32
+	for (j=0; j<SWIFFT_GROUP_SIZE; j++) {
+		__builtin_prefetch(&Tabl[SWIFFT_INT16(u[j],t[j])]);
+	}
+}
+
+//! \brief Tests whether the input bytes of a group of columns are all zero, in which case the
+//! FFT-output of the group is zero, whatever the sign bits are.
+//!
+//! \param[in] t the input bytes of the group, 8*SWIFFT_O of them, with no alignment requirement.
+//! \returns whether all the bytes are zero.
+static inline int SWIFFT_isZeroGroup(const BitSequence *t)
+{
+#if SWIFFT_LOG2_O == 0
+	uint64_t x;
+	memcpy(&x, t, sizeof(x));
+	return x == 0;
+#elif SWIFFT_LOG2_O == 1
+	__m128i x = _mm_loadu_si128((const __m128i *)t);
+	return _mm_testz_si128(x, x);
+#else
+	__m256i x = _mm256_loadu_si256((const __m256i *)t);
+	return _mm256_testz_si256(x, x);
+#endif
+}
+
+//! \brief Computes the FFT phase of SWIFFT over m columns, as SWIFFT_fft_ does with no counting.
+//! Inlined with a constant m, its loop is unrolled for that m.
+static LIBSWIFFT_INLINE void SWIFFT_fftColumns(const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
+{
+	int i,j,k;
+	Z1vec *out = (Z1vec *) fftout;
+
+	const BitSequence *t = input;
+	const BitSequence *u = sign;
+	const int small = (SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL);
+	ZOvec v[8];
+
+	for (i=0; i<(m>>SWIFFT_LOG2_O); i++,t+=8*SWIFFT_O,u+=8*SWIFFT_O) {
+		if (SWIFFT_FFT_PREFETCH && !small && i+1<(m>>SWIFFT_LOG2_O)) {
+			SWIFFT_prefetchGroup(t+8*SWIFFT_O, u+8*SWIFFT_O);
 		}
+		SWIFFT_fftGroup(t, u, v, small);
 
 		for (j=0; j<SWIFFT_O; j++,out+=8) {
 			for (k=0; k<8; k++) {
@@ -80,7 +252,57 @@ void SWIFFT_ISET_NAME(SWIFFT_fft_)(const BitSequence * LIBSWIFFT_RESTRICT input,
 	}
 }
 
-void SWIFFT_ISET_NAME(SWIFFT_fftsum_)(const int16_t * LIBSWIFFT_RESTRICT ikey,
+//! \brief Computes the FFT phase of SWIFFT.
+//!
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bits).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bits).
+//! \param[in] m number of 8-elements in the input.
+//! \param[out] fftout the blocks of FFT-output elements, totaling SWIFFT_N*m.
+void SWIFFT_ISET_NAME(SWIFFT_fft_)(const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_FFT);
+	SWIFFT_fftColumns(input, sign, m, fftout);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_FFT, 1, (uint64_t)m * 8);
+}
+
+#if SWIFFT_MADD_FFTSUM
+//! \brief Multiplies two pairs of FFT-output and key wide SWIFFT vectors and accumulates in 32 bits.
+//! The products are exact, so no overflow adjustment is needed, and the 32-bit accumulators have
+//! ample room for summing over all columns.
+//!
+//! \param[in,out] acc the accumulators, for the low and high halves of each 128-bit lane.
+//! \param[in] f0 the FFT-output wide SWIFFT vector of the first column.
+//! \param[in] f1 the FFT-output wide SWIFFT vector of the second column.
+//! \param[in] k0 the key wide SWIFFT vector of the first column.
+//! \param[in] k1 the key wide SWIFFT vector of the second column.
+static inline void SWIFFT_maddPair(__m512i acc[2], ZOvec f0, ZOvec f1, ZOvec k0, ZOvec k1)
+{
+	// reducing fftout to the range of SWIFFT_safeMult
+	__m512i g0 = (__m512i)SWIFFT_qReduce(f0), g1 = (__m512i)SWIFFT_qReduce(f1);
+	__m512i flo = _mm512_unpacklo_epi16(g0, g1), fhi = _mm512_unpackhi_epi16(g0, g1);
+	__m512i klo = _mm512_unpacklo_epi16((__m512i)k0, (__m512i)k1), khi = _mm512_unpackhi_epi16((__m512i)k0, (__m512i)k1);
+	acc[0] = _mm512_add_epi32(acc[0], _mm512_madd_epi16(flo, klo));
+	acc[1] = _mm512_add_epi32(acc[1], _mm512_madd_epi16(fhi, khi));
+}
+
+//! \brief Reduces a pair of 32-bit accumulators of SWIFFT_maddPair to a wide SWIFFT vector of
+//! output elements in the range {0,..,SWIFFT_P-1}.
+//!
+//! \param[in] acc the accumulators, for the low and high halves of each 128-bit lane.
+//! \returns the wide SWIFFT vector of output elements.
+static inline ZOvec SWIFFT_maddReduce(const __m512i acc[2])
+{
+	__m512i m255 = _mm512_set1_epi32(255);
+	// (x mod 256) - floor(x/256) brings the sums into the 16-bit range
+	__m512i lo = _mm512_sub_epi32(_mm512_and_si512(acc[0], m255), _mm512_srai_epi32(acc[0], 8));
+	__m512i hi = _mm512_sub_epi32(_mm512_and_si512(acc[1], m255), _mm512_srai_epi32(acc[1], 8));
+	return SWIFFT_modP((ZOvec)_mm512_packs_epi32(lo, hi));
+}
+#endif
+
+//! \brief Computes the FFT-sum phase of SWIFFT over m columns, as SWIFFT_fftsum_ does with no counting.
+//! Inlined with a constant m, its loop is unrolled for that m.
+static LIBSWIFFT_INLINE void SWIFFT_fftsumColumns(const int16_t * LIBSWIFFT_RESTRICT ikey,
 	const int16_t * LIBSWIFFT_RESTRICT ifftout, int m, int16_t * LIBSWIFFT_RESTRICT iout)
 {
 	int i,j;
@@ -88,6 +310,24 @@ void SWIFFT_ISET_NAME(SWIFFT_fftsum_)(const int16_t * LIBSWIFFT_RESTRICT ikey,
 	const ZOvec *fftout = (const ZOvec *)ifftout;
 	ZOvec *out = (ZOvec *)iout;
 
+#if SWIFFT_MADD_FFTSUM
+	__m512i acc[8 >> SWIFFT_LOG2_O][2];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i+1<m; i+=2,fftout+=2*(8>>SWIFFT_LOG2_O),key+=2*(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			SWIFFT_maddPair(acc[j], fftout[j], fftout[(8>>SWIFFT_LOG2_O)+j], key[j], key[(8>>SWIFFT_LOG2_O)+j]);
+		}
+	}
+	if (i < m) {
+		ZOvec zero = {0};
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			SWIFFT_maddPair(acc[j], fftout[j], zero, key[j], zero);
+		}
+	}
+	for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+		out[j] = SWIFFT_maddReduce(acc[j]);
+	}
+#else
 	ZOvec v[8 >> SWIFFT_LOG2_O] = {0};
 	for (i=0; i<m; i++,fftout+=(8>>SWIFFT_LOG2_O),key+=(8>>SWIFFT_LOG2_O)) {
 		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
@@ -98,6 +338,156 @@ void SWIFFT_ISET_NAME(SWIFFT_fftsum_)(const int16_t * LIBSWIFFT_RESTRICT ikey,
 	for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
 		out[j] = SWIFFT_modP(v[j]);
 	}
+#endif
+}
+
+void SWIFFT_ISET_NAME(SWIFFT_fftsum_)(const int16_t * LIBSWIFFT_RESTRICT ikey,
+	const int16_t * LIBSWIFFT_RESTRICT ifftout, int m, int16_t * LIBSWIFFT_RESTRICT iout)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_FFTSUM);
+	SWIFFT_fftsumColumns(ikey, ifftout, m, iout);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_FFTSUM, 1, (uint64_t)m * SWIFFT_N * sizeof(int16_t));
+}
+
+//! \brief Computes the result of a SWIFFT operation, skipping the all-zero columns.
+//! A column whose 8 input bytes are all zero contributes nothing. The FFT is computed a group of
+//! SWIFFT_O columns at a time, so it is skipped only for groups whose 8*SWIFFT_O bytes are all zero,
+//! while the multiply-accumulate is skipped for each all-zero column. The FFT-outputs of the other
+//! columns are stored consecutively, then summed as in SWIFFT_fftsum_ with their key columns.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] iout the output elements, 64 double-bytes (1024 bits).
+//! \param[in] small whether to use the small table mode.
+static inline void SWIFFT_computeSparse(const BitSequence * LIBSWIFFT_RESTRICT input,
+	int16_t * LIBSWIFFT_RESTRICT iout, int small)
+{
+	int i,j,k,m = 0;
+	const ZOvec *keys[SWIFFT_M];
+	SWIFFT_ALIGN int16_t ifftout[SWIFFT_N*SWIFFT_M];
+	Z1vec *out = (Z1vec *)ifftout;
+	const BitSequence *t = input;
+	ZOvec v[8];
+
+	for (i=0; i<(SWIFFT_M>>SWIFFT_LOG2_O); i++,t+=SWIFFT_GROUP_SIZE) {
+		if (SWIFFT_isZeroGroup(t)) {
+			continue;
+		}
+		SWIFFT_fftGroup(t, SWIFFT_sign0, v, small);
+		for (j=0; j<SWIFFT_O; j++) {
+			// stored either way, and kept only for a nonzero column, with no branch to mispredict
+			uint64_t x;
+			memcpy(&x, t + 8*j, sizeof(x));
+			for (k=0; k<8; k++) {
+				out[k] = ((Z1vec *)&v[k])[j];
+			}
+			keys[m] = (const ZOvec *)(SWIFFT_TABLE(PI_key) + (i * SWIFFT_O + j) * SWIFFT_N);
+			out += 8 * (x != 0);
+			m += (x != 0);
+		}
+	}
+
+	const ZOvec *fftout = (const ZOvec *)ifftout;
+	ZOvec *zout = (ZOvec *)iout;
+#if SWIFFT_MADD_FFTSUM
+	__m512i acc[8 >> SWIFFT_LOG2_O][2];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i+1<m; i+=2,fftout+=2*(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			SWIFFT_maddPair(acc[j], fftout[j], fftout[(8>>SWIFFT_LOG2_O)+j], keys[i][j], keys[i+1][j]);
+		}
+	}
+	if (i < m) {
+		ZOvec zero = {0};
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			SWIFFT_maddPair(acc[j], fftout[j], zero, keys[i][j], zero);
+		}
+	}
+	for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+		zout[j] = SWIFFT_maddReduce(acc[j]);
+	}
+#else
+	ZOvec sum[8 >> SWIFFT_LOG2_O] = {0};
+	for (i=0; i<m; i++,fftout+=(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			sum[j] += SWIFFT_qReduce(SWIFFT_safeMult(fftout[j], keys[i][j]));
+		}
+	}
+	for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+		zout[j] = SWIFFT_modP(sum[j]);
+	}
+#endif
+}
+
+//! \brief Computes the results of SWIFFT_INTERLEAVE consecutive SWIFFT operations.
+//! The blocks are processed together, SWIFFT_O columns at a time, so that each key vector is
+//! loaded once for all of them and the butterflies of different blocks may execute concurrently.
+//!
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[in] ikey the SWIFFT key in the layout of SWIFFT_PI_key.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[in] small whether to use the small table mode.
+static inline void SWIFFT_computeInterleaved(const BitSequence * LIBSWIFFT_RESTRICT input,
+	const BitSequence * LIBSWIFFT_RESTRICT sign, size_t signStride,
+	const int16_t * LIBSWIFFT_RESTRICT ikey, BitSequence * LIBSWIFFT_RESTRICT output, int small)
+{
+	int b,i,j,k;
+	ZOvec v[8];
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_INTERLEAVE][SWIFFT_N*SWIFFT_M];
+	for (i=0; i<(SWIFFT_M>>SWIFFT_LOG2_O); i++) {
+		for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+			SWIFFT_fftGroup(
+				input + b * SWIFFT_INPUT_BLOCK_SIZE + i * 8 * SWIFFT_O,
+				sign + b * signStride + i * 8 * SWIFFT_O,
+				v, small);
+			Z1vec *out = ((Z1vec *)fftout[b]) + i * 8 * SWIFFT_O;
+			for (j=0; j<SWIFFT_O; j++,out+=8) {
+				for (k=0; k<8; k++) {
+					out[k] = ((Z1vec *)&v[k])[j];
+				}
+			}
+		}
+	}
+
+	const ZOvec *key = (const ZOvec *)ikey;
+#if SWIFFT_MADD_FFTSUM
+	__m512i acc[SWIFFT_INTERLEAVE][8 >> SWIFFT_LOG2_O][2];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i<SWIFFT_M; i+=2,key+=2*(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			ZOvec k0 = key[j], k1 = key[(8>>SWIFFT_LOG2_O)+j];
+			for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+				const ZOvec *f = ((const ZOvec *)fftout[b]) + i * (8>>SWIFFT_LOG2_O);
+				SWIFFT_maddPair(acc[b][j], f[j], f[(8>>SWIFFT_LOG2_O)+j], k0, k1);
+			}
+		}
+	}
+	for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+		ZOvec *out = (ZOvec *)(output + b * SWIFFT_OUTPUT_BLOCK_SIZE);
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			out[j] = SWIFFT_maddReduce(acc[b][j]);
+		}
+	}
+#else
+	ZOvec acc[SWIFFT_INTERLEAVE][8 >> SWIFFT_LOG2_O];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i<SWIFFT_M; i++,key+=(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			ZOvec kv = key[j];
+			for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+				// reducing fftout to avoid overflow
+				acc[b][j] += SWIFFT_qReduce(SWIFFT_safeMult(((const ZOvec *)fftout[b])[i * (8>>SWIFFT_LOG2_O) + j], kv));
+			}
+		}
+	}
+	for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+		ZOvec *out = (ZOvec *)(output + b * SWIFFT_OUTPUT_BLOCK_SIZE);
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			out[j] = SWIFFT_modP(acc[b][j]);
+		}
+	}
+#endif
 }
 
 //! \brief Sets a constant value at each SWIFFT hash value element.
@@ -125,7 +515,9 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstAdd_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_S
 	const int16_t operand)
 {
 	size_t i;
-	const ZOvec zoperand = ZOCONST(operand);
+	// reducing the operand so that the results do not overflow
+	ZOvec zoperand = ZOCONST(operand);
+	zoperand = SWIFFT_modP(zoperand);
 	ZOvec *zoutput = (ZOvec *)output;
 	size_t size = SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec);
 	for (i=0; i<size; i++,zoutput++) {
@@ -141,7 +533,9 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstSub_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_S
 	const int16_t operand)
 {
 	size_t i;
-	const ZOvec zoperand = ZOCONST(operand);
+	// reducing the operand so that the results do not overflow
+	ZOvec zoperand = ZOCONST(operand);
+	zoperand = SWIFFT_modP(zoperand);
 	ZOvec *zoutput = (ZOvec *)output;
 	size_t size = SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec);
 	for (i=0; i<size; i++,zoutput++) {
@@ -157,11 +551,13 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstMul_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_S
 	const int16_t operand)
 {
 	size_t i;
-	const ZOvec zoperand = ZOCONST(operand);
+	// centering the factors so that their products do not overflow
+	ZOvec zoperand = ZOCONST(operand);
+	zoperand = SWIFFT_center(zoperand);
 	ZOvec *zoutput = (ZOvec *)output;
 	size_t size = SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec);
 	for (i=0; i<size; i++,zoutput++) {
-		*zoutput = SWIFFT_modP(*zoutput * zoperand);
+		*zoutput = SWIFFT_modP(SWIFFT_center(*zoutput) * zoperand);
 	}
 }
 
@@ -219,7 +615,8 @@ void SWIFFT_ISET_NAME(SWIFFT_Mul_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 	ZOvec *zoutput = (ZOvec *)output;
 	size_t size = SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec);
 	for (i=0; i<size; i++,zoperand++,zoutput++) {
-		*zoutput = SWIFFT_modP(*zoutput * *zoperand);
+		// centering the factors so that their products do not overflow
+		*zoutput = SWIFFT_modP(SWIFFT_center(*zoutput) * SWIFFT_center(*zoperand));
 	}
 }
 
@@ -228,15 +625,16 @@ void SWIFFT_ISET_NAME(SWIFFT_Mul_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
 //!
 //! \param[in] input the input of 256 bytes (2048 bit).
 //! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[in] ikey the SWIFFT key in the layout of SWIFFT_PI_key.
 //! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
 static inline void SWIFFT_compute(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
-	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE], const int16_t *ikey,
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
 	// do FFT and linear combination of FFT coefficients
 	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M];
 	SWIFFT_ISET_NAME(SWIFFT_fft_)(input, sign, SWIFFT_M, fftout);
-	SWIFFT_ISET_NAME(SWIFFT_fftsum_)(SWIFFT_PI_key, fftout, SWIFFT_M, (int16_t *)output);
+	SWIFFT_ISET_NAME(SWIFFT_fftsum_)(ikey, fftout, SWIFFT_M, (int16_t *)output);
 }
 
 //! \brief Computes the result of a SWIFFT operation.
@@ -247,7 +645,36 @@ static inline void SWIFFT_compute(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZ
 void SWIFFT_ISET_NAME(SWIFFT_Compute_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_compute(input, SWIFFT_sign0, output);
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, SWIFFT_sign0, SWIFFT_TABLE(PI_key), output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKey_)(const swifft_key_t *key,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, SWIFFT_sign0, key->elements, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of a SWIFFT operation, faster the more all-zero 8-byte columns the
+//! input has. The result is the same as that of SWIFFT_Compute_.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeSparse_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_computeSparse(input, (int16_t *)output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
 }
 
 //! \brief Computes the result of a SWIFFT operation.
@@ -260,7 +687,253 @@ void SWIFFT_ISET_NAME(SWIFFT_ComputeSigned_)(const BitSequence input[SWIFFT_INPU
 	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
 	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
 {
-	SWIFFT_compute(input, sign, output);
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, sign, SWIFFT_TABLE(PI_key), output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of a SWIFFT operation with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeySigned_)(const swifft_key_t *key,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, sign, key->elements, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The hash value is compacted while in L1, and the result is the same as that of SWIFFT_Compute_
+//! followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompact_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, SWIFFT_sign0, SWIFFT_TABLE(PI_key), output);
+	SWIFFT_Compact(output, compact);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the compacted result of a SWIFFT operation.
+//! The hash value is compacted while in L1, and the result is the same as that of
+//! SWIFFT_ComputeSigned_ followed by SWIFFT_Compact.
+//!
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactSigned_)(const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE],
+	const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence compact[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_compute(input, sign, SWIFFT_TABLE(PI_key), output);
+	SWIFFT_Compact(output, compact);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of a SWIFFT operation on the first m columns of an input, the rest
+//! being zero, which contribute nothing to the FFT-sum. Inlined with a constant m, the transform is
+//! unrolled for that m.
+//!
+//! \param[in] input the input of 8*m bytes.
+//! \param[in] sign the sign bits corresponding to the input, of 8*m bytes.
+//! \param[in] m the number of 8-byte columns of the input, a multiple of SWIFFT_SHORT_COLUMNS.
+//! \param[out] output the resulting hash value of SWIFFT, of size 128 bytes (1024 bit).
+static LIBSWIFFT_INLINE void SWIFFT_computeShort(const BitSequence * LIBSWIFFT_RESTRICT input,
+	const BitSequence * LIBSWIFFT_RESTRICT sign, int m, BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M];
+	SWIFFT_fftColumns(input, sign, m, fftout);
+	SWIFFT_fftsumColumns(SWIFFT_TABLE(PI_key), fftout, m, (int16_t *)output);
+}
+
+//! \brief Computes the result of a SWIFFT operation on a short input by the instance of
+//! SWIFFT_computeShort for its number of columns.
+//!
+//! \returns 0 on success, or -1 if m is not valid.
+static int SWIFFT_computeShortColumns(int m, const BitSequence *input, const BitSequence *sign,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	switch (m) {
+	case 4: SWIFFT_computeShort(input, sign, 4, output); break;
+	case 8: SWIFFT_computeShort(input, sign, 8, output); break;
+	case 12: SWIFFT_computeShort(input, sign, 12, output); break;
+	case 16: SWIFFT_computeShort(input, sign, 16, output); break;
+	case 20: SWIFFT_computeShort(input, sign, 20, output); break;
+	case 24: SWIFFT_computeShort(input, sign, 24, output); break;
+	case 28: SWIFFT_computeShort(input, sign, 28, output); break;
+	case 32: SWIFFT_computeShort(input, sign, 32, output); break;
+	default: return -1;
+	}
+	return 0;
+}
+
+LIBSWIFFT_STATIC_ASSERT((SWIFFT_SHORT_COLUMNS % SWIFFT_O) == 0, SWIFFT_SHORT_COLUMNS_must_be_a_multiple_of_SWIFFT_O);
+LIBSWIFFT_STATIC_ASSERT(SWIFFT_SHORT_COLUMNS == 4, SWIFFT_computeShortColumns_must_list_each_valid_m);
+
+int SWIFFT_ISET_NAME(SWIFFT_ComputeShort_)(int m, const BitSequence * input,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	int result;
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	result = SWIFFT_computeShortColumns(m, input, SWIFFT_sign0, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, (uint64_t)m * 8);
+	return result;
+}
+
+int SWIFFT_ISET_NAME(SWIFFT_ComputeShortSigned_)(int m, const BitSequence * input, const BitSequence * sign,
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE])
+{
+	int result;
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	result = SWIFFT_computeShortColumns(m, input, sign, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, (uint64_t)m * 8);
+	return result;
+}
+
+//! \brief Adds to, or subtracts from, a hash value the SWIFFT of the groups of an input covering a range.
+//! Only these groups are transformed, using SWIFFT_fft_ and SWIFFT_fftsum_ limited to their columns.
+//!
+//! \param[in,out] output the hash value of SWIFFT to modify, of size 128 bytes (1024 bit).
+//! \param[in] input the input of 256 bytes (2048 bit), of which only the groups are read.
+//! \param[in] sign the sign bits corresponding to the input, of which only the groups are read.
+//! \param[in] begin the offset of the first group, a multiple of SWIFFT_GROUP_SIZE.
+//! \param[in] end the offset past the last group, a multiple of SWIFFT_GROUP_SIZE.
+//! \param[in] subtract whether to subtract rather than add.
+static inline void SWIFFT_updateGroups(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign,
+	size_t begin, size_t end, int subtract)
+{
+	int m = (int)((end - begin) / 8);
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M];
+	SWIFFT_ALIGN BitSequence delta[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_ISET_NAME(SWIFFT_fft_)(input + begin, sign + begin, m, fftout);
+	SWIFFT_ISET_NAME(SWIFFT_fftsum_)(SWIFFT_TABLE(PI_key) + (begin / 8) * SWIFFT_N, fftout, m, (int16_t *)delta);
+	if (subtract) {
+		SWIFFT_ISET_NAME(SWIFFT_Sub_)(output, delta);
+	}
+	else {
+		SWIFFT_ISET_NAME(SWIFFT_Add_)(output, delta);
+	}
+}
+
+//! \brief Returns whether a range of offset and len bytes lies within an input block.
+static LIBSWIFFT_INLINE int SWIFFT_isUpdateRange(size_t offset, size_t len)
+{
+	return offset <= SWIFFT_INPUT_BLOCK_SIZE && len <= SWIFFT_INPUT_BLOCK_SIZE - offset;
+}
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input changed.
+//! By linearity, the difference of the results is the SWIFFT of the input bits that changed, with
+//! sign bits set where a bit changed from 1 to 0, and zero bits elsewhere. The input is recomputed in
+//! aligned groups of SWIFFT_GROUP_SIZE bytes, so the cost is proportional to the number of groups the
+//! range overlaps, rather than to the size of the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_Update_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len)
+{
+	size_t i;
+	size_t begin = offset / SWIFFT_GROUP_SIZE * SWIFFT_GROUP_SIZE;
+	size_t end = (offset + len + SWIFFT_GROUP_SIZE - 1) / SWIFFT_GROUP_SIZE * SWIFFT_GROUP_SIZE;
+	SWIFFT_ALIGN BitSequence input[SWIFFT_INPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE];
+	if (!SWIFFT_isUpdateRange(offset, len)) {
+		return -1;
+	}
+	if (len == 0) {
+		return 0;
+	}
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	memset(input + begin, 0, end - begin);
+	memset(sign + begin, 0, end - begin);
+	for (i=0; i<len; i++) {
+		input[offset + i] = oldBytes[i] ^ newBytes[i];
+		sign[offset + i] = oldBytes[i] & ~newBytes[i];
+	}
+	SWIFFT_updateGroups(output, input, sign, begin, end, 0);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, len);
+	return 0;
+}
+
+//! \brief Updates the result of a SWIFFT operation after a range of its input and sign bits changed.
+//! The SWIFFT of the old range is subtracted and that of the new range added, each computed with
+//! zero bits outside the range. The input is recomputed in aligned groups of SWIFFT_GROUP_SIZE bytes,
+//! so the cost is proportional to the number of groups the range overlaps, rather than to the size of
+//! the block.
+//!
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input.
+//! \param[in] oldBytes the old bytes of the range.
+//! \param[in] oldSign the old sign bits corresponding to the old bytes of the range.
+//! \param[in] newBytes the new bytes of the range.
+//! \param[in] newSign the new sign bits corresponding to the new bytes of the range.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_UpdateSigned_)(BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE],
+	const BitSequence * oldBytes, const BitSequence * oldSign,
+	const BitSequence * newBytes, const BitSequence * newSign, size_t offset, size_t len)
+{
+	size_t begin = offset / SWIFFT_GROUP_SIZE * SWIFFT_GROUP_SIZE;
+	size_t end = (offset + len + SWIFFT_GROUP_SIZE - 1) / SWIFFT_GROUP_SIZE * SWIFFT_GROUP_SIZE;
+	SWIFFT_ALIGN BitSequence input[SWIFFT_INPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE];
+	if (!SWIFFT_isUpdateRange(offset, len)) {
+		return -1;
+	}
+	if (len == 0) {
+		return 0;
+	}
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	memset(input + begin, 0, end - begin);
+	memset(sign + begin, 0, end - begin);
+	memcpy(input + offset, oldBytes, len);
+	memcpy(sign + offset, oldSign, len);
+	SWIFFT_updateGroups(output, input, sign, begin, end, 1);
+	memcpy(input + offset, newBytes, len);
+	memcpy(sign + offset, newSign, len);
+	SWIFFT_updateGroups(output, input, sign, begin, end, 0);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, len);
+	return 0;
+}
+
+//! \brief The arguments of SWIFFT_fftMultiple_ for a range of blocks.
+typedef struct {
+	const BitSequence *input;     ///< The blocks of input
+	const BitSequence *sign;      ///< The blocks of sign bits
+	int m;                        ///< The number of 8-elements in the input
+	int16_t *fftout;              ///< The blocks of FFT-output elements
+} swifft_fft_args_t;
+
+//! \brief Runs SWIFFT_fftMultiple_ on a range of blocks.
+static void SWIFFT_fftRange(void *context, int begin, int end)
+{
+	const swifft_fft_args_t *args = (const swifft_fft_args_t *)context;
+	int i;
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_fft_)(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->m,
+			args->fftout + i * SWIFFT_N * SWIFFT_M
+		);
+	}
 }
 
 //! \brief Computes the FFT phase of SWIFFT for multiple blocks.
@@ -272,16 +945,31 @@ void SWIFFT_ISET_NAME(SWIFFT_ComputeSigned_)(const BitSequence input[SWIFFT_INPU
 //! \param[out] fftout the blocks of FFT-output elements, totaling nblocks*N*m.
 void SWIFFT_ISET_NAME(SWIFFT_fftMultiple_)(int nblocks, const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign, int m, int16_t * LIBSWIFFT_RESTRICT fftout)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_FFT);
+	swifft_fft_args_t args = { input, sign, m, fftout };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_FFT, nblocks, 1, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_fftRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_FFT, nblocks, (uint64_t)nblocks * m * 8);
+}
+
+//! \brief The arguments of SWIFFT_fftsumMultiple_ for a range of blocks.
+typedef struct {
+	const int16_t *ikey;          ///< The SWIFFT key
+	const int16_t *ifftout;       ///< The blocks of FFT-output elements
+	int m;                        ///< The number of 8-elements in the input
+	int16_t *iout;                ///< The blocks of output elements
+} swifft_fftsum_args_t;
+
+//! \brief Runs SWIFFT_fftsumMultiple_ on a range of blocks.
+static void SWIFFT_fftsumRange(void *context, int begin, int end)
+{
+	const swifft_fftsum_args_t *args = (const swifft_fftsum_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_fft_)(
-			input + i * SWIFFT_INPUT_BLOCK_SIZE,
-			sign + i * SWIFFT_INPUT_BLOCK_SIZE,
-			m,
-			fftout + i * SWIFFT_N * SWIFFT_M
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_fftsum_)(
+			args->ikey,
+			args->ifftout + i * SWIFFT_N * SWIFFT_M,
+			args->m,
+			args->iout + i * (SWIFFT_OUTPUT_BLOCK_SIZE / sizeof(int16_t))
 		);
 	}
 }
@@ -296,16 +984,158 @@ void SWIFFT_ISET_NAME(SWIFFT_fftMultiple_)(int nblocks, const BitSequence * LIBS
 void SWIFFT_ISET_NAME(SWIFFT_fftsumMultiple_)(int nblocks, const int16_t * LIBSWIFFT_RESTRICT ikey,
         const int16_t * LIBSWIFFT_RESTRICT ifftout, int m, int16_t * LIBSWIFFT_RESTRICT iout)
 {
-	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_FFTSUM);
+	swifft_fftsum_args_t args = { ikey, ifftout, m, iout };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_FFTSUM, nblocks, 1, ifftout, SWIFFT_N * SWIFFT_M * sizeof(int16_t), SWIFFT_fftsumRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_FFTSUM, nblocks, (uint64_t)nblocks * m * SWIFFT_N * sizeof(int16_t));
+}
+
+#if SWIFFT_O == 1 && defined(__aarch64__)
+	#define SWIFFT_NEON_ZIP_lo vzip1q_s   ///< The NEON zip of the low halves, as _mm_unpacklo_epi* does
+	#define SWIFFT_NEON_ZIP_hi vzip2q_s   ///< The NEON zip of the high halves, as _mm_unpackhi_epi* does
+	#define SWIFFT_NEON_16 int16x8_t     ///< The NEON vector of 16-bit lanes
+	#define SWIFFT_NEON_32 int32x4_t     ///< The NEON vector of 32-bit lanes
+	#define SWIFFT_NEON_64 int64x2_t     ///< The NEON vector of 64-bit lanes
+	#define SWIFFT_UNPACK(hl, w, a, b) ((ZOvec)LIBSWIFFT_CONCAT(SWIFFT_NEON_ZIP_##hl, w)((SWIFFT_NEON_##w)(a), (SWIFFT_NEON_##w)(b)))
+	#define SWIFFT_UNPACK16(hl, a, b) SWIFFT_UNPACK(hl, 16, a, b)
+	#define SWIFFT_PACKUS16(a, b) ((ZOvec)vcombine_u8(vqmovun_s16((int16x8_t)(a)), vqmovun_s16((int16x8_t)(b))))
+#elif SWIFFT_O == 1
+	#define SWIFFT_UNPACK(hl, w, a, b) ((ZOvec)_mm_unpack##hl##_epi##w((__m128i)(a), (__m128i)(b)))
+	#define SWIFFT_UNPACK16(hl, a, b) SWIFFT_UNPACK(hl, 16, a, b)
+	#define SWIFFT_PACKUS16(a, b) ((ZOvec)_mm_packus_epi16((__m128i)(a), (__m128i)(b)))
+#elif SWIFFT_O == 2
+	#define SWIFFT_UNPACK(hl, w, a, b) ((ZOvec)_mm256_unpack##hl##_epi##w((__m256i)(a), (__m256i)(b)))
+	#define SWIFFT_UNPACK16(hl, a, b) SWIFFT_UNPACK(hl, 16, a, b)
+	#define SWIFFT_PACKUS16(a, b) ((ZOvec)_mm256_packus_epi16((__m256i)(a), (__m256i)(b)))
+#else
+	#define SWIFFT_UNPACK(hl, w, a, b) ((ZOvec)_mm512_unpack##hl##_epi##w((__m512i)(a), (__m512i)(b)))
+	#if defined(__AVX512BW__)
+		#define SWIFFT_UNPACK16(hl, a, b) SWIFFT_UNPACK(hl, 16, a, b)
+		#define SWIFFT_PACKUS16(a, b) ((ZOvec)_mm512_packus_epi16((__m512i)(a), (__m512i)(b)))
+	#else
+		//! Applies a 256-bit operation to each half of two 512-bit vectors, for 16-bit operations missing without AVX512BW
+		#define SWIFFT_BY_HALVES(f, a, b) ((ZOvec)_mm512_inserti64x4(_mm512_castsi256_si512( \
+			f(_mm512_castsi512_si256((__m512i)(a)), _mm512_castsi512_si256((__m512i)(b)))), \
+			f(_mm512_extracti64x4_epi64((__m512i)(a), 1), _mm512_extracti64x4_epi64((__m512i)(b), 1)), 1))
+		#define SWIFFT_UNPACK16(hl, a, b) SWIFFT_BY_HALVES(_mm256_unpack##hl##_epi16, a, b)
+		#define SWIFFT_PACKUS16(a, b) SWIFFT_BY_HALVES(_mm256_packus_epi16, a, b)
+	#endif
 #endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_fftsum_)(
-			ikey,
-			ifftout + i * SWIFFT_N * SWIFFT_M,
-			m,
-			iout + i * (SWIFFT_OUTPUT_BLOCK_SIZE / sizeof(int16_t))
+
+//! \brief Transposes the 8x8 matrix of 16-bit elements held in each 128-bit lane of 8 wide SWIFFT
+//! vectors, like transpose_8x8_16_sse2 does for one lane.
+//!
+//! \param[in,out] v the rows of the matrices, replaced by their columns.
+static inline void SWIFFT_transposeLanes(ZOvec v[8])
+{
+	ZOvec a03b03 = SWIFFT_UNPACK16(lo, v[0], v[1]);
+	ZOvec c03d03 = SWIFFT_UNPACK16(lo, v[2], v[3]);
+	ZOvec e03f03 = SWIFFT_UNPACK16(lo, v[4], v[5]);
+	ZOvec g03h03 = SWIFFT_UNPACK16(lo, v[6], v[7]);
+	ZOvec a47b47 = SWIFFT_UNPACK16(hi, v[0], v[1]);
+	ZOvec c47d47 = SWIFFT_UNPACK16(hi, v[2], v[3]);
+	ZOvec e47f47 = SWIFFT_UNPACK16(hi, v[4], v[5]);
+	ZOvec g47h47 = SWIFFT_UNPACK16(hi, v[6], v[7]);
+
+	ZOvec a01b01c01d01 = SWIFFT_UNPACK(lo, 32, a03b03, c03d03);
+	ZOvec a23b23c23d23 = SWIFFT_UNPACK(hi, 32, a03b03, c03d03);
+	ZOvec e01f01g01h01 = SWIFFT_UNPACK(lo, 32, e03f03, g03h03);
+	ZOvec e23f23g23h23 = SWIFFT_UNPACK(hi, 32, e03f03, g03h03);
+	ZOvec a45b45c45d45 = SWIFFT_UNPACK(lo, 32, a47b47, c47d47);
+	ZOvec a67b67c67d67 = SWIFFT_UNPACK(hi, 32, a47b47, c47d47);
+	ZOvec e45f45g45h45 = SWIFFT_UNPACK(lo, 32, e47f47, g47h47);
+	ZOvec e67f67g67h67 = SWIFFT_UNPACK(hi, 32, e47f47, g47h47);
+
+	v[0] = SWIFFT_UNPACK(lo, 64, a01b01c01d01, e01f01g01h01);
+	v[1] = SWIFFT_UNPACK(hi, 64, a01b01c01d01, e01f01g01h01);
+	v[2] = SWIFFT_UNPACK(lo, 64, a23b23c23d23, e23f23g23h23);
+	v[3] = SWIFFT_UNPACK(hi, 64, a23b23c23d23, e23f23g23h23);
+	v[4] = SWIFFT_UNPACK(lo, 64, a45b45c45d45, e45f45g45h45);
+	v[5] = SWIFFT_UNPACK(hi, 64, a45b45c45d45, e45f45g45h45);
+	v[6] = SWIFFT_UNPACK(lo, 64, a67b67c67d67, e67f67g67h67);
+	v[7] = SWIFFT_UNPACK(hi, 64, a67b67c67d67, e67f67g67h67);
+}
+
+//! \brief Compacts the hash values of SWIFFT_O blocks, one per 128-bit lane.
+//! The result is the same as that of SWIFFT_Compact for each block.
+//!
+//! \param[in] output the hash values of SWIFFT, of size 128 bytes (1024 bit) per block, with no alignment requirement.
+//! \param[out] compact the compacted hash values of SWIFFT, of size 64 bytes (512 bit) per block, with no alignment requirement.
+static inline void SWIFFT_compactGroup(const BitSequence *output, BitSequence *compact)
+{
+	ZOvec ZO_255 = ZOCONST(255), ZO_8 = ZOCONST(8);
+	ZOvec v[8];
+	int i,j;
+
+	// row i of block l goes to lane l of v[i]
+	for (i=0; i<8; i++) {
+		const BitSequence *row = output + i * 16;
+#if SWIFFT_O == 1 && defined(__aarch64__)
+		v[i] = (ZOvec)vld1q_u8(row);
+#elif SWIFFT_O == 1
+		v[i] = (ZOvec)_mm_loadu_si128((const __m128i *)row);
+#elif SWIFFT_O == 2
+		v[i] = (ZOvec)_mm256_loadu2_m128i((const __m128i *)(row + SWIFFT_OUTPUT_BLOCK_SIZE), (const __m128i *)row);
+#else
+		v[i] = (ZOvec)_mm512_inserti64x4(_mm512_castsi256_si512(
+			_mm256_loadu2_m128i((const __m128i *)(row + SWIFFT_OUTPUT_BLOCK_SIZE), (const __m128i *)row)),
+			_mm256_loadu2_m128i((const __m128i *)(row + 3 * SWIFFT_OUTPUT_BLOCK_SIZE), (const __m128i *)(row + 2 * SWIFFT_OUTPUT_BLOCK_SIZE)), 1);
+#endif
+	}
+
+	// the base change of ToBase256, for 8 numbers per block at once
+	SWIFFT_transposeLanes(v);
+	for (i=7; i>0; i--) {
+		for (j=i-1; j<7; j++) {
+			ZOvec x = v[j] + v[j+1];
+			v[j] = x & ZO_255;
+			v[j+1] += (x >> ZO_8);
+		}
+	}
+	// ignore carry
+	v[7] &= ZO_255;
+	SWIFFT_transposeLanes(v);
+
+	for (i=0; i<4; i++) {
+		// compact 16-bit elements to 8-bit ones: saturation is avoided
+		ZOvec x = SWIFFT_PACKUS16(v[2*i], v[2*i+1]);
+		BitSequence *cout = compact + i * 16;
+#if SWIFFT_O == 1 && defined(__aarch64__)
+		vst1q_u8(cout, (uint8x16_t)x);
+#elif SWIFFT_O == 1
+		_mm_storeu_si128((__m128i *)cout, (__m128i)x);
+#elif SWIFFT_O == 2
+		_mm256_storeu2_m128i((__m128i *)(cout + SWIFFT_COMPACT_BLOCK_SIZE), (__m128i *)cout, (__m256i)x);
+#else
+		_mm256_storeu2_m128i((__m128i *)(cout + SWIFFT_COMPACT_BLOCK_SIZE), (__m128i *)cout,
+			_mm512_castsi512_si256((__m512i)x));
+		_mm256_storeu2_m128i((__m128i *)(cout + 3 * SWIFFT_COMPACT_BLOCK_SIZE), (__m128i *)(cout + 2 * SWIFFT_COMPACT_BLOCK_SIZE),
+			_mm512_extracti64x4_epi64((__m512i)x, 1));
+#endif
+	}
+}
+
+//! \brief The arguments of SWIFFT_CompactMultiple_ for a range of blocks.
+typedef struct {
+	const BitSequence *output;    ///< The hash values
+	BitSequence *compact;         ///< The compacted hash values
+} swifft_compact_args_t;
+
+//! \brief Runs SWIFFT_CompactMultiple_ on a range of blocks, SWIFFT_O blocks at a time as long as possible.
+static void SWIFFT_CompactRange(void *context, int begin, int end)
+{
+	const swifft_compact_args_t *args = (const swifft_compact_args_t *)context;
+	int i;
+	for (i=begin; i+SWIFFT_O<=end; i+=SWIFFT_O) {
+		SWIFFT_compactGroup(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->compact + i * SWIFFT_COMPACT_BLOCK_SIZE
+		);
+	}
+	for (; i<end; i++) {
+		SWIFFT_Compact(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->compact + i * SWIFFT_COMPACT_BLOCK_SIZE
 		);
 	}
 }
@@ -319,14 +1149,27 @@ void SWIFFT_ISET_NAME(SWIFFT_fftsumMultiple_)(int nblocks, const int16_t * LIBSW
 void SWIFFT_ISET_NAME(SWIFFT_CompactMultiple_)(int nblocks, const BitSequence * output,
         BitSequence * compact)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPACT);
+	swifft_compact_args_t args = { output, compact };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPACT, nblocks, 1, output, SWIFFT_OUTPUT_BLOCK_SIZE, SWIFFT_CompactRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPACT, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief The arguments of SWIFFT_Const{Set,Add,Sub,Mul}Multiple_ for a range of blocks.
+typedef struct {
+	BitSequence *output;          ///< The hash values to modify
+	const int16_t *operand;       ///< The constant values, per block
+} swifft_const_args_t;
+
+//! \brief Runs SWIFFT_ConstSetMultiple_ on a range of blocks.
+static void SWIFFT_ConstSetRange(void *context, int begin, int end)
+{
+	const swifft_const_args_t *args = (const swifft_const_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_Compact(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			compact + i * SWIFFT_COMPACT_BLOCK_SIZE
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_ConstSet_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand[i]
 		);
 	}
 }
@@ -339,14 +1182,21 @@ void SWIFFT_ISET_NAME(SWIFFT_CompactMultiple_)(int nblocks, const BitSequence *
 void SWIFFT_ISET_NAME(SWIFFT_ConstSetMultiple_)(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_const_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_ConstSetRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_ConstAddMultiple_ on a range of blocks.
+static void SWIFFT_ConstAddRange(void *context, int begin, int end)
+{
+	const swifft_const_args_t *args = (const swifft_const_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_ConstSet_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand[i]
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_ConstAdd_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand[i]
 		);
 	}
 }
@@ -359,14 +1209,21 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstSetMultiple_)(int nblocks, BitSequence * outpu
 void SWIFFT_ISET_NAME(SWIFFT_ConstAddMultiple_)(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_const_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_ConstAddRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_ConstSubMultiple_ on a range of blocks.
+static void SWIFFT_ConstSubRange(void *context, int begin, int end)
+{
+	const swifft_const_args_t *args = (const swifft_const_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_ConstAdd_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand[i]
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_ConstSub_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand[i]
 		);
 	}
 }
@@ -379,14 +1236,21 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstAddMultiple_)(int nblocks, BitSequence * outpu
 void SWIFFT_ISET_NAME(SWIFFT_ConstSubMultiple_)(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_const_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_ConstSubRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_ConstMulMultiple_ on a range of blocks.
+static void SWIFFT_ConstMulRange(void *context, int begin, int end)
+{
+	const swifft_const_args_t *args = (const swifft_const_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_ConstSub_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand[i]
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_ConstMul_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand[i]
 		);
 	}
 }
@@ -399,14 +1263,27 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstSubMultiple_)(int nblocks, BitSequence * outpu
 void SWIFFT_ISET_NAME(SWIFFT_ConstMulMultiple_)(int nblocks, BitSequence * output,
         const int16_t * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_const_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_ConstMulRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief The arguments of SWIFFT_{Set,Add,Sub,Mul}Multiple_ for a range of blocks.
+typedef struct {
+	BitSequence *output;          ///< The hash values to modify
+	const BitSequence *operand;   ///< The hash values to operate with
+} swifft_arith_args_t;
+
+//! \brief Runs SWIFFT_SetMultiple_ on a range of blocks.
+static void SWIFFT_SetRange(void *context, int begin, int end)
+{
+	const swifft_arith_args_t *args = (const swifft_arith_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_ConstMul_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand[i]
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_Set_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
 		);
 	}
 }
@@ -419,14 +1296,21 @@ void SWIFFT_ISET_NAME(SWIFFT_ConstMulMultiple_)(int nblocks, BitSequence * outpu
 void SWIFFT_ISET_NAME(SWIFFT_SetMultiple_)(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_arith_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_SetRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_AddMultiple_ on a range of blocks.
+static void SWIFFT_AddRange(void *context, int begin, int end)
+{
+	const swifft_arith_args_t *args = (const swifft_arith_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_Set_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_Add_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
 		);
 	}
 }
@@ -439,14 +1323,21 @@ void SWIFFT_ISET_NAME(SWIFFT_SetMultiple_)(int nblocks, BitSequence * output,
 void SWIFFT_ISET_NAME(SWIFFT_AddMultiple_)(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_arith_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_AddRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_SubMultiple_ on a range of blocks.
+static void SWIFFT_SubRange(void *context, int begin, int end)
+{
+	const swifft_arith_args_t *args = (const swifft_arith_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_Add_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_Sub_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
 		);
 	}
 }
@@ -459,14 +1350,21 @@ void SWIFFT_ISET_NAME(SWIFFT_AddMultiple_)(int nblocks, BitSequence * output,
 void SWIFFT_ISET_NAME(SWIFFT_SubMultiple_)(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_arith_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_SubRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_MulMultiple_ on a range of blocks.
+static void SWIFFT_MulRange(void *context, int begin, int end)
+{
+	const swifft_arith_args_t *args = (const swifft_arith_args_t *)context;
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_Sub_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_Mul_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
 		);
 	}
 }
@@ -479,14 +1377,186 @@ void SWIFFT_ISET_NAME(SWIFFT_SubMultiple_)(int nblocks, BitSequence * output,
 void SWIFFT_ISET_NAME(SWIFFT_MulMultiple_)(int nblocks, BitSequence * output,
         const BitSequence * operand)
 {
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	swifft_arith_args_t args = { output, operand };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, 1, SWIFFT_MulRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! The number of blocks SWIFFT_SumMultiple_ adds between reductions of its accumulator: starting
+//! from a SWIFFT_qReduce'd accumulator in {-127,..,383}, adding as many elements in {0,..,256}
+//! keeps it in 16 bits.
+#define SWIFFT_SUM_LAZY_STEPS ((32767 - 383) / 256)
+//! The number of blocks SWIFFT_LinearCombination_ adds between reductions of its accumulator:
+//! products of centered coefficients in {-128,..,128} and SWIFFT_qReduce'd elements in {-1,..,255}
+//! are SWIFFT_qReduce'd to {-127,..,383}, and added to a SWIFFT_qReduce'd accumulator in the same range.
+#define SWIFFT_LINCOMB_LAZY_STEPS ((32767 - 383) / 383)
+//! The minimum number of blocks reduced to one partial result, as a unit of parallelism.
+#define SWIFFT_SUM_CHUNK 64
+//! The maximum number of partial results of SWIFFT_{SumMultiple,LinearCombination}_.
+#define SWIFFT_SUM_MAX_PARTIALS 64
+
+//! \brief The arguments of SWIFFT_{SumMultiple,LinearCombination}_ for a range of blocks.
+typedef struct {
+	const BitSequence *outputs;   ///< The hash values to combine
+	const int16_t *coeffs;        ///< The coefficients, per hash value, or NULL for all ones
+	BitSequence *partials;        ///< The partial results, per chunk of blocks
+	int nblocks;                  ///< The number of hash values
+	int chunk;                    ///< The number of blocks per partial result
+} swifft_sum_args_t;
+
+//! \brief Returns a value reduced mod-257 to the range {-128,..,128}.
+static inline int16_t SWIFFT_centerValue(int16_t value)
+{
+	int r = value % SWIFFT_P;
+	r += (r < 0) ? SWIFFT_P : 0;
+	return (int16_t)((r > SWIFFT_P/2) ? r - SWIFFT_P : r);
+}
+
+//! \brief Combines hash values, with coefficients or with all ones, into a partial result.
+//! The accumulator is held in registers and reduced only every SWIFFT_{SUM,LINCOMB}_LAZY_STEPS blocks.
+//!
+//! \param[in] outputs the hash values to combine.
+//! \param[in] coeffs the coefficients, per hash value, or NULL for all ones.
+//! \param[in] n the number of hash values.
+//! \param[out] result the combined hash value.
+static void SWIFFT_combine(const BitSequence * LIBSWIFFT_RESTRICT outputs, const int16_t *coeffs, int n,
+	BitSequence * LIBSWIFFT_RESTRICT result)
+{
+	const int nvecs = SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec);
+	const int steps = (coeffs == NULL) ? SWIFFT_SUM_LAZY_STEPS : SWIFFT_LINCOMB_LAZY_STEPS;
+	const ZOvec zero = ZOCONST(0);
+	ZOvec acc[SWIFFT_OUTPUT_BLOCK_SIZE/sizeof(ZOvec)];
+	int i, j, k = 0;
+	for (j=0; j<nvecs; j++) {
+		acc[j] = zero;
+	}
+	for (i=0; i<n; i++) {
+		const ZOvec *zoutput = (const ZOvec *)(outputs + (size_t)i * SWIFFT_OUTPUT_BLOCK_SIZE);
+		if (coeffs == NULL) {
+			for (j=0; j<nvecs; j++) {
+				acc[j] += zoutput[j];
+			}
+		}
+		else {
+			ZOvec zcoeff = ZOCONST(SWIFFT_centerValue(coeffs[i]));
+			for (j=0; j<nvecs; j++) {
+				acc[j] += SWIFFT_qReduce(zcoeff * SWIFFT_qReduce(zoutput[j]));
+			}
+		}
+		if (++k == steps) {
+			for (j=0; j<nvecs; j++) {
+				acc[j] = SWIFFT_qReduce(acc[j]);
+			}
+			k = 0;
+		}
+	}
+	for (j=0; j<nvecs; j++) {
+		((ZOvec *)result)[j] = SWIFFT_modP(acc[j]);
+	}
+}
+
+//! \brief Runs SWIFFT_{SumMultiple,LinearCombination}_ on a range of blocks, one partial result
+//! per chunk of blocks. A chunk is reduced by the range holding its first block, so that each
+//! partial result is written once even by an executor whose ranges do not start at chunks.
+static void SWIFFT_CombineRange(void *context, int begin, int end)
+{
+	const swifft_sum_args_t *args = (const swifft_sum_args_t *)context;
+	int c;
+	for (c=(begin+args->chunk-1)/args->chunk; c*args->chunk<end; c++) {
+		int first = c * args->chunk;
+		int n = (first + args->chunk < args->nblocks) ? args->chunk : args->nblocks - first;
+		SWIFFT_combine(
+			args->outputs + (size_t)first * SWIFFT_OUTPUT_BLOCK_SIZE,
+			(args->coeffs == NULL) ? NULL : args->coeffs + first,
+			n,
+			args->partials + (size_t)c * SWIFFT_OUTPUT_BLOCK_SIZE
+		);
+	}
+}
+
+//! \brief Combines hash values, with coefficients or with all ones, as a two-level tree: chunks of
+//! blocks are reduced to partial results in parallel, and the partial results are then summed.
+//!
+//! \param[in] nblocks the number of hash values.
+//! \param[in] coeffs the coefficients, per hash value, or NULL for all ones.
+//! \param[in] outputs the hash values to combine.
+//! \param[out] result the combined hash value.
+static void SWIFFT_CombineMultiple(int nblocks, const int16_t * coeffs, const BitSequence * outputs,
+	BitSequence * result)
+{
+	SWIFFT_ALIGN BitSequence partials[SWIFFT_SUM_MAX_PARTIALS*SWIFFT_OUTPUT_BLOCK_SIZE];
+	int chunk = (nblocks + SWIFFT_SUM_MAX_PARTIALS - 1) / SWIFFT_SUM_MAX_PARTIALS;
+	chunk = (chunk + SWIFFT_SUM_CHUNK - 1) / SWIFFT_SUM_CHUNK * SWIFFT_SUM_CHUNK;
+	if (nblocks <= chunk) {
+		SWIFFT_combine(outputs, coeffs, (nblocks > 0) ? nblocks : 0, result);
+		return;
+	}
+	swifft_sum_args_t args = { outputs, coeffs, partials, nblocks, chunk };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_ARITH, nblocks, chunk, SWIFFT_CombineRange, &args);
+	SWIFFT_combine(partials, NULL, (nblocks + chunk - 1) / chunk, result);
+}
+
+//! \brief Sums SWIFFT hash values of multiple blocks, element-wise.
+//! The hash values are accumulated with deferred reductions, and in parallel for many blocks.
+//!
+//! \param[in] nblocks the number of blocks to sum.
+//! \param[in] outputs the hash values of SWIFFT to sum, per block.
+//! \param[out] result the sum of the hash values, or all zeros for no blocks.
+void SWIFFT_ISET_NAME(SWIFFT_SumMultiple_)(int nblocks, const BitSequence * outputs, BitSequence * result)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	SWIFFT_CombineMultiple(nblocks, NULL, outputs, result);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes a linear combination of SWIFFT hash values of multiple blocks, element-wise.
+//! The products are accumulated with deferred reductions, and in parallel for many blocks.
+//!
+//! \param[in] nblocks the number of blocks to combine.
+//! \param[in] coeffs the coefficient of each hash value, taken mod-257.
+//! \param[in] outputs the hash values of SWIFFT to combine, per block.
+//! \param[out] result the linear combination of the hash values, or all zeros for no blocks.
+void SWIFFT_ISET_NAME(SWIFFT_LinearCombination_)(int nblocks, const int16_t * coeffs,
+	const BitSequence * outputs, BitSequence * result)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	SWIFFT_CombineMultiple(nblocks, coeffs, outputs, result);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief The arguments of SWIFFT_Compute{,WithKey}Multiple{,Signed}_ for a range of blocks.
+typedef struct {
+	const BitSequence *input;     ///< The blocks of input
+	const BitSequence *sign;      ///< The blocks of sign bits, or SWIFFT_sign0 for all blocks
+	size_t signStride;            ///< The distance in bytes between consecutive blocks of sign bits, possibly 0
+	const int16_t *ikey;          ///< The key in the layout of SWIFFT_PI_key, or NULL for the PI key of the running thread
+	BitSequence *output;          ///< The resulting blocks of hash values, or of compacted ones
+	int small;                    ///< Whether the FFT table mode is SWIFFT_FFT_TABLE_SMALL
+} swifft_compute_args_t;
+
+//! \brief Runs SWIFFT_Compute{,WithKey}Multiple{,Signed}_ on a range of blocks, interleaved as long as possible.
+static void SWIFFT_ComputeRange(void *context, int begin, int end)
+{
+	const swifft_compute_args_t *args = (const swifft_compute_args_t *)context;
+	const int16_t *ikey = (args->ikey != NULL) ? args->ikey : SWIFFT_TABLE(PI_key);
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_ISET_NAME(SWIFFT_Mul_)(
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
-			operand + i * SWIFFT_OUTPUT_BLOCK_SIZE
+	for (i=begin; i+SWIFFT_INTERLEAVE<=end; i+=SWIFFT_INTERLEAVE) {
+		SWIFFT_computeInterleaved(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * args->signStride,
+			args->signStride,
+			ikey,
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->small
+		);
+	}
+	for (; i<end; i++) {
+		SWIFFT_compute(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * args->signStride,
+			ikey,
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE
 		);
 	}
 }
@@ -499,17 +1569,10 @@ void SWIFFT_ISET_NAME(SWIFFT_MulMultiple_)(int nblocks, BitSequence * output,
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple_)(int nblocks, const BitSequence * input, BitSequence * output)
 {
-	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
-#endif
-	for (i=0; i<nblocks; i++) {
-		SWIFFT_compute(
-			input + i * SWIFFT_INPUT_BLOCK_SIZE,
-			SWIFFT_sign0,
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE
-		);
-	}
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, SWIFFT_sign0, 0, NULL, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
 }
 
 //! \brief Computes the result of multiple SWIFFT operations.
@@ -521,18 +1584,1014 @@ void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple_)(int nblocks, const BitSequence *
 //! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
 void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSigned_)(int nblocks, const BitSequence * input,
 	const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, sign, SWIFFT_INPUT_BLOCK_SIZE, NULL, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! The compact forms of sign bits of SWIFFT_ComputeMultiple{SignMask,UniformSign}_
+enum {
+	SWIFFT_SIGN_FORM_MASK,     ///< SWIFFT_SIGN_MASK_BLOCK_SIZE bytes per block, a bit per input byte
+	SWIFFT_SIGN_FORM_UNIFORM   ///< One byte per block, the sign byte of all its input bytes
+};
+
+//! \brief Expands a sign-mask to the sign bytes of a block, 0xFF where its bit is set and 0 elsewhere.
+//!
+//! \param[in] mask the sign-mask of SWIFFT_SIGN_MASK_BLOCK_SIZE bytes, whose bit j of byte i is for input byte 8*i+j.
+//! \param[out] sign the sign bytes of 256 bytes (2048 bit).
+static inline void SWIFFT_expandSignMask(const BitSequence * LIBSWIFFT_RESTRICT mask, BitSequence * LIBSWIFFT_RESTRICT sign)
 {
 	int i;
-#ifdef _OPENMP
-	#pragma omp parallel for schedule(static) private(i) if(nblocks > SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD)
+#if defined(__AVX512BW__)
+	for (i=0; i<SWIFFT_SIGN_MASK_BLOCK_SIZE; i+=8) {
+		uint64_t m;
+		memcpy(&m, mask + i, sizeof(m));
+		_mm512_store_si512((__m512i *)(sign + i * 8), _mm512_movm_epi8((__mmask64)m));
+	}
+#else
+	for (i=0; i<SWIFFT_SIGN_MASK_BLOCK_SIZE; i++) {
+		// moving bit j to byte j, then adding 0x7F sets the high bit of the non-zero bytes, with no carry
+		uint64_t x = (mask[i] * UINT64_C(0x0101010101010101)) & UINT64_C(0x8040201008040201);
+		x = (((x + UINT64_C(0x7F7F7F7F7F7F7F7F)) & UINT64_C(0x8080808080808080)) >> 7) * 0xFF;
+		memcpy(sign + i * 8, &x, sizeof(x)); // byte j is stored at offset j on the little-endian targets
+	}
 #endif
-	for (i=0; i<nblocks; i++) {
+}
+
+//! \brief Expands the compact sign bits of consecutive blocks to sign bytes.
+//! When all the blocks have the same sign bits, they are expanded once, or not at all if zero.
+//!
+//! \param[in] form the compact form of the sign bits, one of SWIFFT_SIGN_FORM_*.
+//! \param[in] signs the compact sign bits of the blocks.
+//! \param[in] nblocks the number of blocks, at most SWIFFT_INTERLEAVE.
+//! \param[out] sign a buffer for the sign bytes of the blocks, of nblocks*256 bytes.
+//! \param[out] signStride the distance in bytes between consecutive blocks of sign bytes, possibly 0.
+//! \returns the sign bytes of the blocks.
+static inline const BitSequence *SWIFFT_expandSigns(int form, const BitSequence * LIBSWIFFT_RESTRICT signs,
+	int nblocks, BitSequence * LIBSWIFFT_RESTRICT sign, size_t *signStride)
+{
+	const size_t size = (form == SWIFFT_SIGN_FORM_MASK) ? SWIFFT_SIGN_MASK_BLOCK_SIZE : 1;
+	int b, uniform = 1;
+	for (b=1; b<nblocks && uniform; b++) {
+		uniform = (memcmp(signs, signs + b * size, size) == 0);
+	}
+	*signStride = uniform ? 0 : SWIFFT_INPUT_BLOCK_SIZE;
+	if (uniform) {
+		if (memcmp(signs, SWIFFT_sign0, size) == 0) {
+			return SWIFFT_sign0;
+		}
+		nblocks = 1;
+	}
+	for (b=0; b<nblocks; b++) {
+		if (form == SWIFFT_SIGN_FORM_MASK) {
+			SWIFFT_expandSignMask(signs + b * size, sign + b * SWIFFT_INPUT_BLOCK_SIZE);
+		}
+		else {
+			memset(sign + b * SWIFFT_INPUT_BLOCK_SIZE, signs[b], SWIFFT_INPUT_BLOCK_SIZE);
+		}
+	}
+	return sign;
+}
+
+//! \brief The arguments of SWIFFT_ComputeMultiple{SignMask,UniformSign}_ for a range of blocks.
+typedef struct {
+	const BitSequence *input;     ///< The blocks of input
+	const BitSequence *signs;     ///< The compact sign bits of the blocks
+	int form;                     ///< The compact form of the sign bits, one of SWIFFT_SIGN_FORM_*
+	BitSequence *output;          ///< The resulting blocks of hash values
+	int small;                    ///< Whether the FFT table mode is SWIFFT_FFT_TABLE_SMALL
+} swifft_sign_form_args_t;
+
+//! \brief Runs SWIFFT_ComputeMultiple{SignMask,UniformSign}_ on a range of blocks, interleaved as
+//! long as possible. The sign bytes of each interleaved group are expanded to a buffer in L1, which
+//! the FFT phase then reads as it does any sign bytes.
+static void SWIFFT_ComputeSignFormRange(void *context, int begin, int end)
+{
+	const swifft_sign_form_args_t *args = (const swifft_sign_form_args_t *)context;
+	const size_t size = (args->form == SWIFFT_SIGN_FORM_MASK) ? SWIFFT_SIGN_MASK_BLOCK_SIZE : 1;
+	const int16_t *ikey = SWIFFT_TABLE(PI_key);
+	SWIFFT_ALIGN BitSequence buffer[SWIFFT_INTERLEAVE*SWIFFT_INPUT_BLOCK_SIZE];
+	const BitSequence *sign;
+	size_t signStride;
+	int i;
+	for (i=begin; i+SWIFFT_INTERLEAVE<=end; i+=SWIFFT_INTERLEAVE) {
+		sign = SWIFFT_expandSigns(args->form, args->signs + i * size, SWIFFT_INTERLEAVE, buffer, &signStride);
+		SWIFFT_computeInterleaved(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			sign,
+			signStride,
+			ikey,
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->small
+		);
+	}
+	for (; i<end; i++) {
+		sign = SWIFFT_expandSigns(args->form, args->signs + i * size, 1, buffer, &signStride);
 		SWIFFT_compute(
-			input + i * SWIFFT_INPUT_BLOCK_SIZE,
-			sign + i * SWIFFT_INPUT_BLOCK_SIZE,
-			output + i * SWIFFT_OUTPUT_BLOCK_SIZE
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			sign,
+			ikey,
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE
+		);
+	}
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with sign bits given as sign-masks.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ with sign bytes of 0xFF where
+//! the bits of the sign-masks are set and 0 elsewhere.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signMask the sign-masks corresponding to blocks of input, each of 32 bytes (256 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignMask_)(int nblocks, const BitSequence * input,
+	const BitSequence * signMask, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_sign_form_args_t args = { input, signMask, SWIFFT_SIGN_FORM_MASK, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeSignFormRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a uniform sign byte per block.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ with all the sign bytes of each
+//! block equal to its uniform sign byte.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the uniform sign bytes corresponding to blocks of input, one per block.
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleUniformSign_)(int nblocks, const BitSequence * input,
+	const BitSequence * signs, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_sign_form_args_t args = { input, signs, SWIFFT_SIGN_FORM_UNIFORM, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeSignFormRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+LIBSWIFFT_STATIC_ASSERT(SWIFFT_INTERLEAVE % SWIFFT_O == 0, SWIFFT_INTERLEAVE_must_be_a_multiple_of_SWIFFT_O);
+
+//! \brief Runs SWIFFT_ComputeCompactMultiple{,Signed}_ on a range of blocks, interleaved as long as
+//! possible. Each interleaved group of hash values is compacted from a buffer that stays in L1.
+static void SWIFFT_ComputeCompactRange(void *context, int begin, int end)
+{
+	const swifft_compute_args_t *args = (const swifft_compute_args_t *)context;
+	const int16_t *ikey = (args->ikey != NULL) ? args->ikey : SWIFFT_TABLE(PI_key);
+	SWIFFT_ALIGN BitSequence output[SWIFFT_INTERLEAVE*SWIFFT_OUTPUT_BLOCK_SIZE];
+	int i,j;
+	for (i=begin; i+SWIFFT_INTERLEAVE<=end; i+=SWIFFT_INTERLEAVE) {
+		SWIFFT_computeInterleaved(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * args->signStride,
+			args->signStride,
+			ikey,
+			output,
+			args->small
+		);
+		for (j=0; j<SWIFFT_INTERLEAVE; j+=SWIFFT_O) {
+			SWIFFT_compactGroup(output + j * SWIFFT_OUTPUT_BLOCK_SIZE, args->output + (i+j) * SWIFFT_COMPACT_BLOCK_SIZE);
+		}
+	}
+	for (; i<end; i++) {
+		SWIFFT_compute(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * args->signStride,
+			ikey,
+			output
+		);
+		SWIFFT_Compact(output, args->output + i * SWIFFT_COMPACT_BLOCK_SIZE);
+	}
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations.
+//! The hash values are compacted while in L1, and the result is the same as that of
+//! SWIFFT_ComputeMultiple_ followed by SWIFFT_CompactMultiple_.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultiple_)(int nblocks, const BitSequence * input, BitSequence * compact)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, SWIFFT_sign0, 0, NULL, compact, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeCompactRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations.
+//! The hash values are compacted while in L1, and the result is the same as that of
+//! SWIFFT_ComputeMultipleSigned_ followed by SWIFFT_CompactMultiple_.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] compact the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleSigned_)(int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, sign, SWIFFT_INPUT_BLOCK_SIZE, NULL, compact, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeCompactRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+#ifndef SWIFFT_STRIDED_SLICE
+	//! The largest number of blocks a strided or gather function runs in one SWIFFT_ParallelForData, whose count is an int
+	#define SWIFFT_STRIDED_SLICE (1 << 30)
+#endif
+
+LIBSWIFFT_STATIC_ASSERT(SWIFFT_STRIDED_SLICE % SWIFFT_INTERLEAVE == 0, SWIFFT_STRIDED_SLICE_must_be_a_multiple_of_SWIFFT_INTERLEAVE);
+
+//! \brief The blocks of a strided or gather function, at a fixed stride or at the addresses of an array.
+typedef struct {
+	const BitSequence *base;           ///< The first block, when ptrs is NULL
+	size_t stride;                     ///< The distance in bytes between consecutive blocks, possibly 0, when ptrs is NULL
+	const BitSequence *const *ptrs;    ///< The addresses of the blocks, or NULL for blocks at a fixed stride
+} swifft_blocks_t;
+
+//! \brief Returns the address of a block of some blocks.
+//!
+//! \param[in] blocks the blocks.
+//! \param[in] i the index of the block.
+//! \returns the address of the block.
+static inline const BitSequence *SWIFFT_blockAt(const swifft_blocks_t *blocks, size_t i)
+{
+	return (blocks->ptrs != NULL) ? blocks->ptrs[i] : blocks->base + i * blocks->stride;
+}
+
+//! \brief Returns a group of n consecutive blocks of some blocks, each of size bytes, in place if
+//! they are already consecutive in memory, or else copied to a buffer.
+//!
+//! \param[in] blocks the blocks.
+//! \param[in] i the index of the first block of the group.
+//! \param[in] n the number of blocks of the group.
+//! \param[in] size the size in bytes of a block.
+//! \param[out] buffer the buffer of n blocks to copy the group to if needed.
+//! \returns the address of the first block of the consecutive group.
+static inline const BitSequence *SWIFFT_groupBlocks(const swifft_blocks_t *blocks, size_t i, int n, size_t size,
+	BitSequence * LIBSWIFFT_RESTRICT buffer)
+{
+	int b;
+	if (blocks->ptrs == NULL && blocks->stride == size) {
+		return blocks->base + i * size;
+	}
+	for (b=0; b<n; b++) {
+		memcpy(buffer + b * size, SWIFFT_blockAt(blocks, i + b), size);
+	}
+	return buffer;
+}
+
+//! \brief Copies a group of n consecutive blocks, each of size bytes, to their places in some blocks.
+//!
+//! \param[in] buffer the n consecutive blocks.
+//! \param[in] n the number of blocks of the group.
+//! \param[in] size the size in bytes of a block.
+//! \param[in] blocks the blocks to copy to.
+//! \param[in] i the index of the first block of the group.
+static inline void SWIFFT_scatterBlocks(const BitSequence * LIBSWIFFT_RESTRICT buffer, int n, size_t size,
+	const swifft_blocks_t *blocks, size_t i)
+{
+	int b;
+	for (b=0; b<n; b++) {
+		memcpy((BitSequence *)SWIFFT_blockAt(blocks, i + b), buffer + b * size, size);
+	}
+}
+
+//! \brief Runs a job over nblocks blocks as SWIFFT_ParallelForData does, in slices of at most
+//! SWIFFT_STRIDED_SLICE blocks, letting the job know the index of the first block of each slice.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \param[in] nblocks the number of blocks.
+//! \param[in] unit the number of blocks the grain of the kind of operation is rounded up to a multiple of.
+//! \param[in] data the blocks the job mainly reads.
+//! \param[out] first the index of the first block of the running slice, which the job reads.
+//! \param[in] job the job.
+//! \param[in] context the context of the job.
+static void SWIFFT_ParallelForSlices(int op, size_t nblocks, int unit, const swifft_blocks_t *data,
+	size_t *first, swifft_job_t job, void *context)
+{
+	for (*first=0; *first<nblocks; *first+=SWIFFT_STRIDED_SLICE) {
+		size_t n = nblocks - *first;
+		SWIFFT_ParallelForData(op, (int)((n < SWIFFT_STRIDED_SLICE) ? n : SWIFFT_STRIDED_SLICE), unit,
+			(data->ptrs == NULL) ? data->base + *first * data->stride : NULL,
+			(data->ptrs == NULL) ? data->stride : 0, job, context);
+	}
+}
+
+//! \brief The arguments of the strided and gather compute and compact functions for a slice of blocks.
+typedef struct {
+	swifft_blocks_t input;        ///< The blocks of input, or of hash values to compact
+	swifft_blocks_t sign;         ///< The blocks of sign bits, not read when compacting
+	swifft_blocks_t output;       ///< The resulting blocks of hash values, or of compacted ones
+	size_t first;                 ///< The index of the first block of the running slice
+	int compact;                  ///< Whether to compact the hash values
+	int small;                    ///< Whether the FFT table mode is SWIFFT_FFT_TABLE_SMALL
+} swifft_strided_args_t;
+
+//! \brief Runs the strided and gather compute functions on a range of blocks of a slice, interleaved
+//! as long as possible. The input and sign bits of each interleaved group are read in place if they
+//! are consecutive in memory, or else copied to a buffer that stays in L1, as are the hash values,
+//! which are then compacted or copied to their places, so no block needs any alignment.
+static void SWIFFT_ComputeStridedRange(void *context, int begin, int end)
+{
+	const swifft_strided_args_t *args = (const swifft_strided_args_t *)context;
+	const int16_t *ikey = SWIFFT_TABLE(PI_key);
+	const int uniform = (args->sign.ptrs == NULL && args->sign.stride == 0);
+	SWIFFT_ALIGN BitSequence input[SWIFFT_INTERLEAVE*SWIFFT_INPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence sign[SWIFFT_INTERLEAVE*SWIFFT_INPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence output[SWIFFT_INTERLEAVE*SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence compact[SWIFFT_INTERLEAVE*SWIFFT_COMPACT_BLOCK_SIZE];
+	size_t i, last = args->first + end;
+	int j;
+	for (i=args->first+begin; i+SWIFFT_INTERLEAVE<=last; i+=SWIFFT_INTERLEAVE) {
+		SWIFFT_computeInterleaved(
+			SWIFFT_groupBlocks(&args->input, i, SWIFFT_INTERLEAVE, SWIFFT_INPUT_BLOCK_SIZE, input),
+			uniform ? args->sign.base : SWIFFT_groupBlocks(&args->sign, i, SWIFFT_INTERLEAVE, SWIFFT_INPUT_BLOCK_SIZE, sign),
+			uniform ? 0 : SWIFFT_INPUT_BLOCK_SIZE,
+			ikey,
+			output,
+			args->small
 		);
+		if (args->compact) {
+			for (j=0; j<SWIFFT_INTERLEAVE; j+=SWIFFT_O) {
+				SWIFFT_compactGroup(output + j * SWIFFT_OUTPUT_BLOCK_SIZE, compact + j * SWIFFT_COMPACT_BLOCK_SIZE);
+			}
+			SWIFFT_scatterBlocks(compact, SWIFFT_INTERLEAVE, SWIFFT_COMPACT_BLOCK_SIZE, &args->output, i);
+		}
+		else {
+			SWIFFT_scatterBlocks(output, SWIFFT_INTERLEAVE, SWIFFT_OUTPUT_BLOCK_SIZE, &args->output, i);
+		}
+	}
+	for (; i<last; i++) {
+		SWIFFT_compute(SWIFFT_blockAt(&args->input, i), SWIFFT_blockAt(&args->sign, i), ikey, output);
+		if (args->compact) {
+			SWIFFT_Compact(output, compact);
+			SWIFFT_scatterBlocks(compact, 1, SWIFFT_COMPACT_BLOCK_SIZE, &args->output, i);
+		}
+		else {
+			SWIFFT_scatterBlocks(output, 1, SWIFFT_OUTPUT_BLOCK_SIZE, &args->output, i);
+		}
+	}
+}
+
+//! \brief Runs the strided and gather compact functions on a range of blocks of a slice, SWIFFT_O
+//! blocks at a time as long as possible, with the compacted hash values copied to their places.
+static void SWIFFT_CompactStridedRange(void *context, int begin, int end)
+{
+	const swifft_strided_args_t *args = (const swifft_strided_args_t *)context;
+	SWIFFT_ALIGN BitSequence output[SWIFFT_O*SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence compact[SWIFFT_O*SWIFFT_COMPACT_BLOCK_SIZE];
+	size_t i, last = args->first + end;
+	for (i=args->first+begin; i+SWIFFT_O<=last; i+=SWIFFT_O) {
+		SWIFFT_compactGroup(SWIFFT_groupBlocks(&args->input, i, SWIFFT_O, SWIFFT_OUTPUT_BLOCK_SIZE, output), compact);
+		SWIFFT_scatterBlocks(compact, SWIFFT_O, SWIFFT_COMPACT_BLOCK_SIZE, &args->output, i);
+	}
+	for (; i<last; i++) {
+		memcpy(output, SWIFFT_blockAt(&args->input, i), SWIFFT_OUTPUT_BLOCK_SIZE);
+		SWIFFT_Compact(output, compact);
+		SWIFFT_scatterBlocks(compact, 1, SWIFFT_COMPACT_BLOCK_SIZE, &args->output, i);
+	}
+}
+
+//! \brief Runs a strided or gather compute or compact function.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] args the arguments, whose first field is set per slice.
+//! \param[in] compute whether to compute, rather than only compact.
+static void SWIFFT_runStrided(size_t nblocks, swifft_strided_args_t *args, int compute)
+{
+	const int op = compute ? SWIFFT_PARALLEL_COMPUTE : SWIFFT_PARALLEL_COMPACT;
+	SWIFFT_STATS_BEGIN(op);
+	args->small = (SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL);
+	SWIFFT_ParallelForSlices(op, nblocks, compute ? SWIFFT_INTERLEAVE : 1, &args->input, &args->first,
+		compute ? SWIFFT_ComputeStridedRange : SWIFFT_CompactStridedRange, args);
+	SWIFFT_STATS_END(op, nblocks, (uint64_t)nblocks * (compute ? SWIFFT_INPUT_BLOCK_SIZE : SWIFFT_OUTPUT_BLOCK_SIZE));
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * output, size_t outStride)
+{
+	swifft_strided_args_t args = { { input, inStride, NULL }, { SWIFFT_sign0, 0, NULL }, { output, outStride, NULL }, 0, 0, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[in] sign the first block of sign bits, of 256 bytes (2048 bit).
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[out] output the first resulting block of hash values of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive resulting blocks.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	const BitSequence * sign, size_t signStride, BitSequence * output, size_t outStride)
+{
+	swifft_strided_args_t args = { { input, inStride, NULL }, { sign, signStride, NULL }, { output, outStride, NULL }, 0, 0, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at fixed strides.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the first block of input, of 256 bytes (2048 bit).
+//! \param[in] inStride the distance in bytes between consecutive blocks of input, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleStrided_)(size_t nblocks, const BitSequence * input, size_t inStride,
+	BitSequence * compact, size_t compactStride)
+{
+	swifft_strided_args_t args = { { input, inStride, NULL }, { SWIFFT_sign0, 0, NULL }, { compact, compactStride, NULL }, 0, 1, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Compacts hash values of SWIFFT at fixed strides.
+//! The result is the same as that of SWIFFT_CompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] output the first hash value of SWIFFT, of size 128 bytes (1024 bit).
+//! \param[in] outStride the distance in bytes between consecutive hash values, possibly 0.
+//! \param[out] compact the first compacted hash value of SWIFFT, of size 64 bytes (512 bit).
+//! \param[in] compactStride the distance in bytes between consecutive compacted hash values.
+void SWIFFT_ISET_NAME(SWIFFT_CompactMultipleStrided_)(size_t nblocks, const BitSequence * output, size_t outStride,
+	BitSequence * compact, size_t compactStride)
+{
+	swifft_strided_args_t args = { { output, outStride, NULL }, { NULL, 0, NULL }, { compact, compactStride, NULL }, 0, 1, 0 };
+	SWIFFT_runStrided(nblocks, &args, 0);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleGather_)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * outputs)
+{
+	swifft_strided_args_t args = { { NULL, 0, inputs }, { SWIFFT_sign0, 0, NULL }, { NULL, 0, (const BitSequence * const *)outputs }, 0, 0, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeMultipleSigned_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] signs the addresses of the blocks of sign bits, each of 256 bytes (2048 bit).
+//! \param[in] outputs the addresses of the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedGather_)(size_t nblocks, const BitSequence * const * inputs,
+	const BitSequence * const * signs, BitSequence * const * outputs)
+{
+	swifft_strided_args_t args = { { NULL, 0, inputs }, { NULL, 0, signs }, { NULL, 0, (const BitSequence * const *)outputs }, 0, 0, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Computes the compacted results of multiple SWIFFT operations on blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_ComputeCompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] inputs the addresses of the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleGather_)(size_t nblocks, const BitSequence * const * inputs,
+	BitSequence * const * compacts)
+{
+	swifft_strided_args_t args = { { NULL, 0, inputs }, { SWIFFT_sign0, 0, NULL }, { NULL, 0, (const BitSequence * const *)compacts }, 0, 1, 0 };
+	SWIFFT_runStrided(nblocks, &args, 1);
+}
+
+//! \brief Compacts hash values of SWIFFT at the addresses of arrays.
+//! The result is the same as that of SWIFFT_CompactMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT, each of size 128 bytes (1024 bit).
+//! \param[in] compacts the addresses of the compacted hash values of SWIFFT, each of size 64 bytes (512 bit).
+void SWIFFT_ISET_NAME(SWIFFT_CompactMultipleGather_)(size_t nblocks, const BitSequence * const * outputs,
+	BitSequence * const * compacts)
+{
+	swifft_strided_args_t args = { { NULL, 0, outputs }, { NULL, 0, NULL }, { NULL, 0, (const BitSequence * const *)compacts }, 0, 1, 0 };
+	SWIFFT_runStrided(nblocks, &args, 0);
+}
+
+//! \brief The arguments of the strided and gather {Add,Sub,Mul} functions for a slice of blocks.
+typedef struct {
+	swifft_blocks_t output;       ///< The hash values to modify
+	swifft_blocks_t operand;      ///< The hash values to operate with
+	size_t first;                 ///< The index of the first block of the running slice
+	void (*op)(BitSequence *output, const BitSequence *operand);  ///< The element-wise operation on one block
+} swifft_arith_strided_args_t;
+
+//! \brief Runs the strided and gather {Add,Sub,Mul} functions on a range of blocks of a slice.
+//! Blocks aligned to SWIFFT_ALIGNMENT are operated on in place, and others via aligned copies.
+static void SWIFFT_ArithStridedRange(void *context, int begin, int end)
+{
+	const swifft_arith_strided_args_t *args = (const swifft_arith_strided_args_t *)context;
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_ALIGN BitSequence operand[SWIFFT_OUTPUT_BLOCK_SIZE];
+	size_t i, last = args->first + end;
+	for (i=args->first+begin; i<last; i++) {
+		BitSequence *out = (BitSequence *)SWIFFT_blockAt(&args->output, i);
+		const BitSequence *opd = SWIFFT_blockAt(&args->operand, i);
+		if (((uintptr_t)out | (uintptr_t)opd) % SWIFFT_ALIGNMENT == 0) {
+			args->op(out, opd);
+			continue;
+		}
+		memcpy(output, out, SWIFFT_OUTPUT_BLOCK_SIZE);
+		memcpy(operand, opd, SWIFFT_OUTPUT_BLOCK_SIZE);
+		args->op(output, operand);
+		memcpy(out, output, SWIFFT_OUTPUT_BLOCK_SIZE);
+	}
+}
+
+//! \brief Runs a strided or gather {Add,Sub,Mul} function.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] args the arguments, whose first field is set per slice.
+static void SWIFFT_runArithStrided(size_t nblocks, swifft_arith_strided_args_t *args)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_ARITH);
+	SWIFFT_ParallelForSlices(SWIFFT_PARALLEL_ARITH, nblocks, 1, &args->output, &args->first, SWIFFT_ArithStridedRange, args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_ARITH, nblocks, (uint64_t)nblocks * SWIFFT_OUTPUT_BLOCK_SIZE);
+}
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_AddMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to add.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to add, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_AddMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	swifft_arith_strided_args_t args = { { output, outStride, NULL }, { operand, operandStride, NULL }, 0, SWIFFT_ISET_NAME(SWIFFT_Add_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+//! \brief Adds SWIFFT hash values to others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_AddMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to add.
+void SWIFFT_ISET_NAME(SWIFFT_AddMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	swifft_arith_strided_args_t args = { { NULL, 0, (const BitSequence * const *)outputs }, { NULL, 0, operands }, 0, SWIFFT_ISET_NAME(SWIFFT_Add_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_SubMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to subtract.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to subtract, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_SubMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	swifft_arith_strided_args_t args = { { output, outStride, NULL }, { operand, operandStride, NULL }, 0, SWIFFT_ISET_NAME(SWIFFT_Sub_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+//! \brief Subtracts SWIFFT hash values from others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_SubMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to subtract.
+void SWIFFT_ISET_NAME(SWIFFT_SubMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	swifft_arith_strided_args_t args = { { NULL, 0, (const BitSequence * const *)outputs }, { NULL, 0, operands }, 0, SWIFFT_ISET_NAME(SWIFFT_Sub_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at fixed strides.
+//! The result is the same as that of SWIFFT_MulMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the first hash value of SWIFFT to modify.
+//! \param[in] outStride the distance in bytes between consecutive hash values to modify.
+//! \param[in] operand the first hash value to multiply by.
+//! \param[in] operandStride the distance in bytes between consecutive hash values to multiply by, possibly 0.
+void SWIFFT_ISET_NAME(SWIFFT_MulMultipleStrided_)(size_t nblocks, BitSequence * output, size_t outStride,
+	const BitSequence * operand, size_t operandStride)
+{
+	swifft_arith_strided_args_t args = { { output, outStride, NULL }, { operand, operandStride, NULL }, 0, SWIFFT_ISET_NAME(SWIFFT_Mul_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+//! \brief Multiplies SWIFFT hash values by others, element-wise, for multiple blocks at the addresses of arrays.
+//! The result is the same as that of SWIFFT_MulMultiple_ on the blocks, and no block needs any alignment.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] outputs the addresses of the hash values of SWIFFT to modify.
+//! \param[in] operands the addresses of the hash values to multiply by.
+void SWIFFT_ISET_NAME(SWIFFT_MulMultipleGather_)(size_t nblocks, BitSequence * const * outputs,
+	const BitSequence * const * operands)
+{
+	swifft_arith_strided_args_t args = { { NULL, 0, (const BitSequence * const *)outputs }, { NULL, 0, operands }, 0, SWIFFT_ISET_NAME(SWIFFT_Mul_) };
+	SWIFFT_runArithStrided(nblocks, &args);
+}
+
+
+#if SWIFFT_SOA_KERNEL
+//! \brief Computes the result of SWIFFT operations on a structure-of-arrays batch, one block per
+//! 16-bit lane. The FFT table entries are looked up in registers and the FFT-sum is accumulated for
+//! pairs of columns in 32 bits, for one element of each row at a time.
+//!
+//! \param[in] soaInput the batch of input, of SWIFFT_SOA_INPUT_BATCH_SIZE bytes.
+//! \param[out] soaOutput the resulting batch of hash values, of SWIFFT_SOA_OUTPUT_BATCH_SIZE bytes.
+static void SWIFFT_computeSoA(const BitSequence * LIBSWIFFT_RESTRICT soaInput, BitSequence * LIBSWIFFT_RESTRICT soaOutput)
+{
+	int i,j,k,c;
+	const __m512i *Tabl = (const __m512i *) SWIFFT_TABLE(fftTableSoA);
+	const int32_t *keyPaired = (const int32_t *) SWIFFT_TABLE(PI_keyPaired);
+	__m512i *out = (__m512i *) soaOutput;
+
+	for (j=0; j<8; j++) {
+		__m512i acc[8][2];
+		memset(acc, 0, sizeof(acc));
+		for (i=0; i<SWIFFT_M; i+=2) {
+			ZOvec v[2][8];
+			for (c=0; c<2; c++) {
+				const BitSequence *t = soaInput + (i+c) * 8 * SWIFFT_SOA_BLOCKS;
+				#pragma GCC unroll 8
+				for (k=0; k<8; k++) {
+					__m512i x = _mm512_cvtepu8_epi16(_mm256_load_si256((const __m256i *)(t + k * SWIFFT_SOA_BLOCKS)));
+					// the table entry of a byte is the sum of those of its low 5 bits and its high 3 bits
+					v[c][k] = (ZOvec)_mm512_add_epi16(
+						_mm512_permutexvar_epi16(x, Tabl[(k*8+j)*2]),
+						_mm512_permutexvar_epi16(_mm512_srli_epi16(x, 5), Tabl[(k*8+j)*2+1]));
+				}
+				SWIFFT_fftButterflies(v[c]);
+			}
+			#pragma GCC unroll 8
+			for (k=0; k<8; k++) {
+				__m512i key = _mm512_set1_epi32(keyPaired[(i>>1)*SWIFFT_N + k*8+j]);
+				__m512i flo = _mm512_unpacklo_epi16((__m512i)v[0][k], (__m512i)v[1][k]);
+				__m512i fhi = _mm512_unpackhi_epi16((__m512i)v[0][k], (__m512i)v[1][k]);
+				acc[k][0] = _mm512_add_epi32(acc[k][0], _mm512_madd_epi16(flo, key));
+				acc[k][1] = _mm512_add_epi32(acc[k][1], _mm512_madd_epi16(fhi, key));
+			}
+		}
+		for (k=0; k<8; k++) {
+			out[k*8+j] = (__m512i)SWIFFT_maddReduce(acc[k]);
+		}
+	}
+}
+#else
+//! \brief Computes the result of SWIFFT operations on a structure-of-arrays batch, by converting
+//! it to blocks and back.
+//!
+//! \param[in] soaInput the batch of input, of SWIFFT_SOA_INPUT_BATCH_SIZE bytes.
+//! \param[out] soaOutput the resulting batch of hash values, of SWIFFT_SOA_OUTPUT_BATCH_SIZE bytes.
+static void SWIFFT_computeSoA(const BitSequence * LIBSWIFFT_RESTRICT soaInput, BitSequence * LIBSWIFFT_RESTRICT soaOutput)
+{
+	SWIFFT_ALIGN BitSequence input[SWIFFT_SOA_INPUT_BATCH_SIZE];
+	SWIFFT_ALIGN BitSequence output[SWIFFT_SOA_OUTPUT_BATCH_SIZE];
+	const int small = (SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL);
+	int i;
+	SWIFFT_InputFromSoA(SWIFFT_SOA_BLOCKS, soaInput, input);
+	for (i=0; i<SWIFFT_SOA_BLOCKS; i+=SWIFFT_INTERLEAVE) {
+		SWIFFT_computeInterleaved(input + i * SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_sign0, 0, SWIFFT_TABLE(PI_key),
+			output + i * SWIFFT_OUTPUT_BLOCK_SIZE, small);
+	}
+	SWIFFT_OutputToSoA(SWIFFT_SOA_BLOCKS, output, soaOutput);
+}
+#endif
+
+//! \brief The arguments of SWIFFT_ComputeMultipleSoA_ for a range of blocks.
+typedef struct {
+	const BitSequence *soaInput;  ///< The batches of input
+	BitSequence *soaOutput;       ///< The resulting batches of hash values
+} swifft_soa_args_t;
+
+//! \brief Runs SWIFFT_ComputeMultipleSoA_ on a range of blocks, a multiple of SWIFFT_SOA_BLOCKS.
+static void SWIFFT_ComputeSoARange(void *context, int begin, int end)
+{
+	const swifft_soa_args_t *args = (const swifft_soa_args_t *)context;
+	int b;
+	for (b=begin/SWIFFT_SOA_BLOCKS; b<end/SWIFFT_SOA_BLOCKS; b++) {
+		SWIFFT_computeSoA(
+			args->soaInput + (size_t)b * SWIFFT_SOA_INPUT_BATCH_SIZE,
+			args->soaOutput + (size_t)b * SWIFFT_SOA_OUTPUT_BATCH_SIZE
+		);
+	}
+}
+
+//! \brief Computes the result of multiple SWIFFT operations in the structure-of-arrays layout.
+//! The result is that of SWIFFT_ComputeMultiple_ in the same layout.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] soaInput the batches of input, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! \param[out] soaOutput the resulting batches of hash values, SWIFFT_SOA_BATCHES(nblocks) of them.
+//! The hash value of a padding block is that of its input.
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSoA_)(int nblocks, const BitSequence * soaInput, BitSequence * soaOutput)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_soa_args_t args = { soaInput, soaOutput };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, SWIFFT_SOA_BATCHES(nblocks) * SWIFFT_SOA_BLOCKS,
+		SWIFFT_SOA_BLOCKS, soaInput, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeSoARange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Runs SWIFFT_ComputeSparseMultiple_ on a range of blocks.
+static void SWIFFT_ComputeSparseRange(void *context, int begin, int end)
+{
+	const swifft_compute_args_t *args = (const swifft_compute_args_t *)context;
+	int i;
+	for (i=begin; i<end; i++) {
+		SWIFFT_computeSparse(
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			(int16_t *)(args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE),
+			args->small
+		);
+	}
+}
+
+//! \brief Computes the result of multiple SWIFFT operations, faster the more all-zero 8-byte columns
+//! the inputs have. The result is the same as that of SWIFFT_ComputeMultiple_.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeSparseMultiple_)(int nblocks, const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, SWIFFT_sign0, 0, NULL, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, 1, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeSparseRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultiple_)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, SWIFFT_sign0, 0, key->elements, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the result of multiple SWIFFT operations with a given key.
+//! The result is composable with other hash values computed with the same key.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] key the SWIFFT key.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting blocks of hash values of SWIFFT, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultipleSigned_)(int nblocks, const swifft_key_t *key,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_compute_args_t args = { input, sign, SWIFFT_INPUT_BLOCK_SIZE, key->elements, output, SWIFFT_fftTableMode == SWIFFT_FFT_TABLE_SMALL };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, SWIFFT_INTERLEAVE, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+
+//! \brief Computes the FFT-sum phase of SWIFFT against SWIFFT_INTERLEAVE keys at once.
+//! Each FFT-output vector is loaded once for all the keys, and the multiply-accumulates of different
+//! keys may execute concurrently.
+//!
+//! \param[in] keys the SWIFFT_INTERLEAVE consecutive SWIFFT keys.
+//! \param[in] ifftout the FFT-output elements of a block, totaling SWIFFT_N*SWIFFT_M.
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+static inline void SWIFFT_fftsumInterleaved(const swifft_key_t * LIBSWIFFT_RESTRICT keys,
+	const int16_t * LIBSWIFFT_RESTRICT ifftout, BitSequence * LIBSWIFFT_RESTRICT output)
+{
+	int b,i,j;
+	const ZOvec *fftout = (const ZOvec *)ifftout;
+#if SWIFFT_MADD_FFTSUM
+	__m512i acc[SWIFFT_INTERLEAVE][8 >> SWIFFT_LOG2_O][2];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i<SWIFFT_M; i+=2,fftout+=2*(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			ZOvec f0 = fftout[j], f1 = fftout[(8>>SWIFFT_LOG2_O)+j];
+			for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+				const ZOvec *key = ((const ZOvec *)keys[b].elements) + i * (8>>SWIFFT_LOG2_O);
+				SWIFFT_maddPair(acc[b][j], f0, f1, key[j], key[(8>>SWIFFT_LOG2_O)+j]);
+			}
+		}
+	}
+	for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+		ZOvec *out = (ZOvec *)(output + b * SWIFFT_OUTPUT_BLOCK_SIZE);
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			out[j] = SWIFFT_maddReduce(acc[b][j]);
+		}
+	}
+#else
+	ZOvec acc[SWIFFT_INTERLEAVE][8 >> SWIFFT_LOG2_O];
+	memset(acc, 0, sizeof(acc));
+	for (i=0; i<SWIFFT_M; i++,fftout+=(8>>SWIFFT_LOG2_O)) {
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			ZOvec f = fftout[j];
+			for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+				// reducing fftout to avoid overflow
+				acc[b][j] += SWIFFT_qReduce(SWIFFT_safeMult(f, ((const ZOvec *)keys[b].elements)[i * (8>>SWIFFT_LOG2_O) + j]));
+			}
+		}
+	}
+	for (b=0; b<SWIFFT_INTERLEAVE; b++) {
+		ZOvec *out = (ZOvec *)(output + b * SWIFFT_OUTPUT_BLOCK_SIZE);
+		for (j=0; j<(8>>SWIFFT_LOG2_O); j++) {
+			out[j] = SWIFFT_modP(acc[b][j]);
+		}
+	}
+#endif
+}
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys.
+//! The FFT phase runs once, and its output stays in L1 while the FFT-sum phase runs against each
+//! key, SWIFFT_INTERLEAVE keys at a time.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+static inline void SWIFFT_computeMultiKey(int nkeys, const swifft_key_t *keys,
+	const BitSequence * LIBSWIFFT_RESTRICT input, const BitSequence * LIBSWIFFT_RESTRICT sign,
+	BitSequence * LIBSWIFFT_RESTRICT output)
+{
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M];
+	int k;
+	SWIFFT_ISET_NAME(SWIFFT_fft_)(input, sign, SWIFFT_M, fftout);
+	for (k=0; k+SWIFFT_INTERLEAVE<=nkeys; k+=SWIFFT_INTERLEAVE) {
+		SWIFFT_fftsumInterleaved(keys + k, fftout, output + k * SWIFFT_OUTPUT_BLOCK_SIZE);
+	}
+	for (; k<nkeys; k++) {
+		SWIFFT_ISET_NAME(SWIFFT_fftsum_)(keys[k].elements, fftout, SWIFFT_M,
+			(int16_t *)(output + k * SWIFFT_OUTPUT_BLOCK_SIZE));
+	}
+}
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys.
+//! The result per key is the same as that of SWIFFT_ComputeWithKey_.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKey_)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_computeMultiKey(nkeys, keys, input, SWIFFT_sign0, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the results of a SWIFFT operation with each of several keys.
+//! The result per key is the same as that of SWIFFT_ComputeWithKeySigned_.
+//!
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the input of 256 bytes (2048 bit).
+//! \param[in] sign the sign bits corresponding to the input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, one per key, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeySigned_)(int nkeys, const swifft_key_t *keys,
+	const BitSequence input[SWIFFT_INPUT_BLOCK_SIZE], const BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE],
+	BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	SWIFFT_computeMultiKey(nkeys, keys, input, sign, output);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, 1, SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief The arguments of SWIFFT_ComputeMultiKeyMultiple{,Signed}_ for a range of blocks.
+typedef struct {
+	int nkeys;                    ///< The number of keys
+	const swifft_key_t *keys;     ///< The keys
+	const BitSequence *input;     ///< The blocks of input
+	const BitSequence *sign;      ///< The blocks of sign bits, or SWIFFT_sign0 for all blocks
+	size_t signStride;            ///< The distance in bytes between consecutive blocks of sign bits, possibly 0
+	BitSequence *output;          ///< The resulting hash values, nkeys per block
+} swifft_multikey_args_t;
+
+//! \brief Runs SWIFFT_ComputeMultiKeyMultiple{,Signed}_ on a range of blocks.
+static void SWIFFT_ComputeMultiKeyRange(void *context, int begin, int end)
+{
+	const swifft_multikey_args_t *args = (const swifft_multikey_args_t *)context;
+	int i;
+	for (i=begin; i<end; i++) {
+		SWIFFT_computeMultiKey(
+			args->nkeys,
+			args->keys,
+			args->input + i * SWIFFT_INPUT_BLOCK_SIZE,
+			args->sign + i * args->signStride,
+			args->output + (size_t)i * args->nkeys * SWIFFT_OUTPUT_BLOCK_SIZE
+		);
+	}
+}
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys.
+//! The results of block i are at output plus i*nkeys hash values, one per key, each the same as
+//! that of SWIFFT_ComputeWithKeyMultiple_.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultiple_)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_multikey_args_t args = { nkeys, keys, input, SWIFFT_sign0, 0, output };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, 1, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeMultiKeyRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief Computes the results of multiple SWIFFT operations with each of several keys.
+//! The results of block i are at output plus i*nkeys hash values, one per key, each the same as
+//! that of SWIFFT_ComputeWithKeyMultipleSigned_.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in] nkeys the number of keys.
+//! \param[in] keys the SWIFFT keys.
+//! \param[in] input the blocks of input, each of 256 bytes (2048 bit).
+//! \param[in] sign the blocks of sign bits corresponding to blocks of input of 256 bytes (2048 bit).
+//! \param[out] output the resulting hash values of SWIFFT, nkeys per block, each of size 128 bytes (1024 bit).
+void SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultipleSigned_)(int nblocks, int nkeys, const swifft_key_t *keys,
+	const BitSequence * input, const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_multikey_args_t args = { nkeys, keys, input, sign, SWIFFT_INPUT_BLOCK_SIZE, output };
+	SWIFFT_ParallelForData(SWIFFT_PARALLEL_COMPUTE, nblocks, 1, input, SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_ComputeMultiKeyRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE);
+}
+
+//! \brief The arguments of SWIFFT_UpdateMultiple_ for a range of blocks.
+typedef struct {
+	BitSequence *output;          ///< The blocks of hash values
+	const BitSequence *oldBytes;  ///< The old bytes of the range, per block
+	const BitSequence *newBytes;  ///< The new bytes of the range, per block
+	size_t offset;                ///< The offset of the range in the input
+	size_t len;                   ///< The length of the range
+} swifft_update_args_t;
+
+//! \brief Runs SWIFFT_UpdateMultiple_ on a range of blocks.
+static void SWIFFT_UpdateRange(void *context, int begin, int end)
+{
+	const swifft_update_args_t *args = (const swifft_update_args_t *)context;
+	int i;
+	for (i=begin; i<end; i++) {
+		SWIFFT_ISET_NAME(SWIFFT_Update_)(
+			args->output + i * SWIFFT_OUTPUT_BLOCK_SIZE,
+			args->oldBytes + i * args->len,
+			args->newBytes + i * args->len,
+			args->offset,
+			args->len
+		);
+	}
+}
+
+//! \brief Updates the results of multiple SWIFFT operations after the same range of each input changed.
+//! The cost per block is the same as that of SWIFFT_Update.
+//!
+//! \param[in] nblocks the number of blocks to operate on.
+//! \param[in,out] output the hash value of SWIFFT of the old input, replaced by that of the new input, per block.
+//! \param[in] oldBytes the old bytes of the range, len bytes per block.
+//! \param[in] newBytes the new bytes of the range, len bytes per block.
+//! \param[in] offset the offset of the range in the input.
+//! \param[in] len the length of the range, such that offset+len is at most 256.
+//! \returns 0 on success, or -1 if offset+len exceeds 256, in which case output is unchanged.
+int SWIFFT_ISET_NAME(SWIFFT_UpdateMultiple_)(int nblocks, BitSequence * output,
+	const BitSequence * oldBytes, const BitSequence * newBytes, size_t offset, size_t len)
+{
+	if (!SWIFFT_isUpdateRange(offset, len)) {
+		return -1;
 	}
+	SWIFFT_STATS_BEGIN(SWIFFT_PARALLEL_COMPUTE);
+	swifft_update_args_t args = { output, oldBytes, newBytes, offset, len };
+	SWIFFT_ParallelFor(SWIFFT_PARALLEL_COMPUTE, nblocks, 1, SWIFFT_UpdateRange, &args);
+	SWIFFT_STATS_END(SWIFFT_PARALLEL_COMPUTE, nblocks, (uint64_t)nblocks * len);
+	return 0;
 }
 
 LIBSWIFFT_END_EXTERN_C
@@ -15,5 +15,5 @@
 	#define SWIFFT_LOG2_O 0
 	#include "swifft.inl"
 #else
-        #pragma message "Disabling generation of LibSWIFFT API for AVX"
+	#error "LibSWIFFT API for AVX must be compiled with -mavx"
 #endif
@@ -15,5 +15,5 @@
 	#define SWIFFT_LOG2_O 1
 	#include "swifft.inl"
 #else
-        #pragma message "Disabling generation of LibSWIFFT API for AVX2"
+	#error "LibSWIFFT API for AVX2 must be compiled with -mavx2"
 #endif
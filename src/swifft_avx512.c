@@ -15,5 +15,5 @@
 	#define SWIFFT_LOG2_O 2
 	#include "swifft.inl"
 #else
-	#pragma message "Disabling generation of LibSWIFFT API for AVX512"
+	#error "LibSWIFFT API for AVX512 must be compiled with -mavx512f"
 #endif
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_cache.c
+ * \brief LibSWIFFT memo cache public C implementation
+ *
+ * Each entry is guarded by a version, as in a sequence lock: a writer claims an
+ * entry by turning its even version odd, and releases it by making it even
+ * again, while a reader copies an entry and keeps the copy only if the version
+ * was even and did not change meanwhile. Blocks are looked up in runs of
+ * SWIFFT_CACHE_CHUNK, and the ones not found in a run are computed together by
+ * the gather functions, once per distinct block, and then inserted.
+ */
+
+#include <stdlib.h> // for aligned_alloc, free
+#include <string.h> // for memcmp, memcpy, memset
+#include "libswifft/swifft_cache.h"
+#include "libswifft/swifft.h"
+#include "swifft_impl.inl"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+#define SWIFFT_CACHE_CHUNK 64               ///< The number of blocks looked up before computing the ones not found
+#define SWIFFT_CACHE_LANES 8                ///< The number of 64-bit lanes a block is fingerprinted in
+#define SWIFFT_CACHE_K0 0x9E3779B97F4A7C15ULL ///< The multiplier mixing the input words into the fingerprint
+#define SWIFFT_CACHE_K1 0xC2B2AE3D27D4EB4FULL ///< The multiplier mixing the sign words into the fingerprint
+
+//! \brief An entry of a cache.
+typedef struct {
+	uint64_t version;                             ///< Even when stable, odd while being replaced, 0 if never written
+	uint64_t fingerprint;                         ///< The fingerprint of the block and its sign bits
+	BitSequence input[SWIFFT_INPUT_BLOCK_SIZE];   ///< The block of input
+	BitSequence sign[SWIFFT_INPUT_BLOCK_SIZE];    ///< The sign bits of the block
+	BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE]; ///< The hash value of the block
+} __attribute__((aligned(64))) swifft_cache_entry_t;
+
+//! \brief The state of a cache.
+struct swifft_cache {
+	swifft_cache_entry_t *entries; ///< The entries, SWIFFT_CACHE_WAYS per set
+	size_t mask;                   ///< The number of sets less 1, the sets being a power of 2
+};
+
+static __thread unsigned SWIFFT_cacheVictim = 0; ///< Picks the way a thread replaces in a full set
+
+//! \brief Fingerprints a block and its sign bits, in independent lanes that vectorize.
+//!
+//! \param[in] input the block of input, with no alignment requirement.
+//! \param[in] sign the sign bits of the block, with no alignment requirement.
+//! \returns the fingerprint.
+static inline uint64_t SWIFFT_CacheFingerprint(const BitSequence *input, const BitSequence *sign)
+{
+	uint64_t h[SWIFFT_CACHE_LANES], x = 0;
+	int i, l;
+	for (l=0; l<SWIFFT_CACHE_LANES; l++) {
+		h[l] = l;
+	}
+	for (i=0; i<SWIFFT_INPUT_BLOCK_SIZE; i+=8*SWIFFT_CACHE_LANES) {
+		for (l=0; l<SWIFFT_CACHE_LANES; l++) {
+			uint64_t a, b;
+			memcpy(&a, input + i + 8 * l, sizeof(a));
+			memcpy(&b, sign + i + 8 * l, sizeof(b));
+			h[l] = ((h[l] ^ a) * SWIFFT_CACHE_K0 ^ b) * SWIFFT_CACHE_K1;
+		}
+	}
+	for (l=0; l<SWIFFT_CACHE_LANES; l++) {
+		x = (x ^ h[l] ^ (h[l] >> 29)) * SWIFFT_CACHE_K0;
+	}
+	return x ^ (x >> 32);
+}
+
+//! \brief Looks up a block and its sign bits in a cache.
+//!
+//! \param[in] cache the cache.
+//! \param[in] fingerprint the fingerprint of the block and its sign bits.
+//! \param[in] input the block of input.
+//! \param[in] sign the sign bits of the block.
+//! \param[out] output the hash value of the block if found, or garbage otherwise.
+//! \returns whether the block was found.
+static int SWIFFT_CacheLookup(const swifft_cache_t *cache, uint64_t fingerprint, const BitSequence *input,
+	const BitSequence *sign, BitSequence *output)
+{
+	const swifft_cache_entry_t *set = cache->entries + (fingerprint & cache->mask) * SWIFFT_CACHE_WAYS;
+	int w;
+	for (w=0; w<SWIFFT_CACHE_WAYS; w++) {
+		const swifft_cache_entry_t *entry = &set[w];
+		uint64_t version = __atomic_load_n(&entry->version, __ATOMIC_ACQUIRE);
+		if (version == 0 || (version & 1) ||
+			__atomic_load_n(&entry->fingerprint, __ATOMIC_RELAXED) != fingerprint ||
+			memcmp(entry->input, input, SWIFFT_INPUT_BLOCK_SIZE) != 0 ||
+			memcmp(entry->sign, sign, SWIFFT_INPUT_BLOCK_SIZE) != 0) {
+			continue;
+		}
+		memcpy(output, entry->output, SWIFFT_OUTPUT_BLOCK_SIZE);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&entry->version, __ATOMIC_RELAXED) == version) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//! \brief Inserts a block, its sign bits and its hash value into a cache, unless another thread is
+//! replacing the entry picked for it.
+//!
+//! \param[in,out] cache the cache.
+//! \param[in] fingerprint the fingerprint of the block and its sign bits.
+//! \param[in] input the block of input.
+//! \param[in] sign the sign bits of the block.
+//! \param[in] output the hash value of the block.
+static void SWIFFT_CacheInsert(swifft_cache_t *cache, uint64_t fingerprint, const BitSequence *input,
+	const BitSequence *sign, const BitSequence *output)
+{
+	swifft_cache_entry_t *set = cache->entries + (fingerprint & cache->mask) * SWIFFT_CACHE_WAYS;
+	swifft_cache_entry_t *entry;
+	uint64_t version;
+	int w;
+	for (w=0; w<SWIFFT_CACHE_WAYS && __atomic_load_n(&set[w].version, __ATOMIC_RELAXED) != 0; w++) {
+	}
+	if (w == SWIFFT_CACHE_WAYS) {
+		w = (SWIFFT_cacheVictim++) % SWIFFT_CACHE_WAYS;
+	}
+	entry = &set[w];
+	version = __atomic_load_n(&entry->version, __ATOMIC_RELAXED);
+	if ((version & 1) || !__atomic_compare_exchange_n(&entry->version, &version, version + 1, 0,
+		__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return;
+	}
+	// the odd version must be visible before any of the fields change
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&entry->fingerprint, fingerprint, __ATOMIC_RELAXED);
+	memcpy(entry->input, input, SWIFFT_INPUT_BLOCK_SIZE);
+	memcpy(entry->sign, sign, SWIFFT_INPUT_BLOCK_SIZE);
+	memcpy(entry->output, output, SWIFFT_OUTPUT_BLOCK_SIZE);
+	__atomic_store_n(&entry->version, version + 2, __ATOMIC_RELEASE);
+}
+
+//! \brief Computes the hash values of a run of blocks, looking up each block in a cache first and
+//! computing each distinct one not found once.
+//!
+//! \param[in,out] cache the cache.
+//! \param[in] nblocks the number of blocks, at most SWIFFT_CACHE_CHUNK.
+//! \param[in] input the blocks of input.
+//! \param[in] sign the blocks of sign bits.
+//! \param[in] signStride the distance in bytes between consecutive blocks of sign bits, possibly 0.
+//! \param[out] output the resulting blocks of hash values, aligned as for SWIFFT_ComputeMultiple.
+static void SWIFFT_CacheComputeChunk(swifft_cache_t *cache, int nblocks, const BitSequence *input,
+	const BitSequence *sign, size_t signStride, BitSequence *output)
+{
+	const BitSequence *inputs[SWIFFT_CACHE_CHUNK], *signs[SWIFFT_CACHE_CHUNK];
+	BitSequence *outputs[SWIFFT_CACHE_CHUNK];
+	uint64_t fingerprints[SWIFFT_CACHE_CHUNK];
+	int dups[2 * SWIFFT_CACHE_CHUNK], nmisses = 0, ndups = 0, i, j;
+	for (i=0; i<nblocks; i++) {
+		const BitSequence *in = input + (size_t)i * SWIFFT_INPUT_BLOCK_SIZE;
+		const BitSequence *sg = sign + (size_t)i * signStride;
+		BitSequence *out = output + (size_t)i * SWIFFT_OUTPUT_BLOCK_SIZE;
+		uint64_t fingerprint = SWIFFT_CacheFingerprint(in, sg);
+		if (SWIFFT_CacheLookup(cache, fingerprint, in, sg, out)) {
+			continue;
+		}
+		for (j=0; j<nmisses; j++) {
+			if (fingerprints[j] == fingerprint && memcmp(inputs[j], in, SWIFFT_INPUT_BLOCK_SIZE) == 0 &&
+				memcmp(signs[j], sg, SWIFFT_INPUT_BLOCK_SIZE) == 0) {
+				break;
+			}
+		}
+		if (j < nmisses) {
+			// a repeat of a block not found, to be copied once that one is computed
+			dups[ndups++] = i;
+			dups[ndups++] = j;
+			continue;
+		}
+		inputs[nmisses] = in;
+		signs[nmisses] = sg;
+		outputs[nmisses] = out;
+		fingerprints[nmisses] = fingerprint;
+		nmisses++;
+	}
+	if (nmisses > 0) {
+		if (signStride == 0) {
+			SWIFFT_ComputeMultipleGather(nmisses, inputs, outputs);
+		} else {
+			SWIFFT_ComputeMultipleSignedGather(nmisses, inputs, signs, outputs);
+		}
+	}
+	for (i=0; i<ndups; i+=2) {
+		memcpy(output + (size_t)dups[i] * SWIFFT_OUTPUT_BLOCK_SIZE, outputs[dups[i+1]], SWIFFT_OUTPUT_BLOCK_SIZE);
+	}
+	for (i=0; i<nmisses; i++) {
+		SWIFFT_CacheInsert(cache, fingerprints[i], inputs[i], signs[i], outputs[i]);
+	}
+	SWIFFT_STATS_CACHE(nblocks - nmisses, nmisses);
+}
+
+//! \brief Runs SWIFFT_CacheComputeChunk over the runs of the blocks, compacting the hash values
+//! of each run if compact is not NULL.
+static void SWIFFT_CacheRun(swifft_cache_t *cache, int nblocks, const BitSequence *input,
+	const BitSequence *sign, size_t signStride, BitSequence *output, BitSequence *compact)
+{
+	SWIFFT_ALIGN BitSequence chunkOutput[SWIFFT_CACHE_CHUNK * SWIFFT_OUTPUT_BLOCK_SIZE];
+	int b, n;
+	for (b=0; b<nblocks; b+=n) {
+		n = (nblocks - b < SWIFFT_CACHE_CHUNK) ? nblocks - b : SWIFFT_CACHE_CHUNK;
+		BitSequence *out = (compact == NULL) ? output + (size_t)b * SWIFFT_OUTPUT_BLOCK_SIZE : chunkOutput;
+		SWIFFT_CacheComputeChunk(cache, n, input + (size_t)b * SWIFFT_INPUT_BLOCK_SIZE,
+			sign + (size_t)b * signStride, signStride, out);
+		if (compact != NULL) {
+			SWIFFT_CompactMultiple(n, chunkOutput, compact + (size_t)b * SWIFFT_COMPACT_BLOCK_SIZE);
+		}
+	}
+}
+
+swifft_cache_t *SWIFFT_CreateCache(size_t size)
+{
+	swifft_cache_t *cache;
+	size_t nentries = SWIFFT_CACHE_WAYS;
+	if (size == 0) {
+		size = SWIFFT_CACHE_DEFAULT_SIZE;
+	}
+	while (nentries < size) {
+		if (nentries > ((size_t)-1 >> 1) / sizeof(swifft_cache_entry_t)) {
+			return NULL;
+		}
+		nentries <<= 1;
+	}
+	cache = (swifft_cache_t *)malloc(sizeof(swifft_cache_t));
+	if (cache == NULL) {
+		return NULL;
+	}
+	cache->entries = (swifft_cache_entry_t *)aligned_alloc(64, nentries * sizeof(swifft_cache_entry_t));
+	if (cache->entries == NULL) {
+		free(cache);
+		return NULL;
+	}
+	cache->mask = nentries / SWIFFT_CACHE_WAYS - 1;
+	SWIFFT_ClearCache(cache);
+	return cache;
+}
+
+void SWIFFT_DestroyCache(swifft_cache_t *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+	free(cache->entries);
+	free(cache);
+}
+
+void SWIFFT_ClearCache(swifft_cache_t *cache)
+{
+	memset(cache->entries, 0, (cache->mask + 1) * SWIFFT_CACHE_WAYS * sizeof(swifft_cache_entry_t));
+}
+
+void SWIFFT_CacheComputeMultiple(swifft_cache_t *cache, int nblocks, const BitSequence * input, BitSequence * output)
+{
+	SWIFFT_CacheRun(cache, nblocks, input, SWIFFT_sign0, 0, output, NULL);
+}
+
+void SWIFFT_CacheComputeMultipleSigned(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * output)
+{
+	SWIFFT_CacheRun(cache, nblocks, input, sign, SWIFFT_INPUT_BLOCK_SIZE, output, NULL);
+}
+
+void SWIFFT_CacheComputeCompactMultiple(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	BitSequence * compact)
+{
+	SWIFFT_CacheRun(cache, nblocks, input, SWIFFT_sign0, 0, NULL, compact);
+}
+
+void SWIFFT_CacheComputeCompactMultipleSigned(swifft_cache_t *cache, int nblocks, const BitSequence * input,
+	const BitSequence * sign, BitSequence * compact)
+{
+	SWIFFT_CacheRun(cache, nblocks, input, sign, SWIFFT_INPUT_BLOCK_SIZE, NULL, compact);
+}
+
+LIBSWIFFT_END_EXTERN_C
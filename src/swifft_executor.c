@@ -0,0 +1,841 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_executor.c
+ * \brief LibSWIFFT executor public C implementation
+ *
+ * The thread pool splits the blocks into chunks of grain blocks, and gives each
+ * participating thread an equal range of chunks to start with. A thread takes
+ * chunks from the front of its own range, and when it runs out, steals the back
+ * half of the range of another thread. Each range is a pair of chunk indices
+ * packed into one atomic word, so that taking and stealing are single CAS ops.
+ *
+ * A NUMA-aware pool orders the chunks by the node their memory is on, sampled
+ * at up to SWIFFT_NUMA_MAX_SAMPLES pages, and gives each thread an equal range
+ * of the chunks of its node, so a range covers positions in that order rather
+ * than chunks. A thread steals from the threads of its node before the others.
+ */
+
+#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE // for cpu_set_t, pthread_attr_setaffinity_np
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <limits.h> // for INT_MAX
+#include <stdlib.h> // for aligned_alloc, calloc, malloc, free
+#include <string.h> // for memset
+#include <time.h> // for clock_gettime
+#include <unistd.h> // for sysconf
+#include "libswifft/swifft_executor.h"
+#include "libswifft/swifft_numa.h"
+#include "libswifft/swifft.h"
+#include "swifft_impl.inl"
+
+#define SWIFFT_POOL_RANGE(begin, end) (((uint64_t)(uint32_t)(begin) << 32) | (uint32_t)(end)) ///< Packs a range of chunks
+#define SWIFFT_POOL_BEGIN(range) ((int)((range) >> 32))                                      ///< Unpacks the begin of a range of chunks
+#define SWIFFT_POOL_END(range) ((int)(uint32_t)(range))                                       ///< Unpacks the end of a range of chunks
+#define SWIFFT_CACHE_LINE_SIZE 64                                                          ///< The size in bytes of a cache line
+#define SWIFFT_NUMA_MAX_SAMPLES 1024                                                       ///< The maximum number of pages a NUMA-aware pool looks up the nodes of per ParallelFor
+
+#ifndef SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD
+	//! Default maximum number of blocks SWIFFT_fftMultiple and SWIFFT_ComputeMultiple* process on the calling thread
+	#define SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD 8
+#endif
+#ifndef SWIFFT_BLOCKS_PARALLELIZATION_GRAIN
+	//! Default number of blocks SWIFFT_fftMultiple and SWIFFT_ComputeMultiple* submit to the executor per range
+	#define SWIFFT_BLOCKS_PARALLELIZATION_GRAIN 8
+#endif
+#ifndef SWIFFT_FFTSUM_PARALLELIZATION_THRESHOLD
+	//! Default maximum number of blocks SWIFFT_fftsumMultiple processes on the calling thread
+	#define SWIFFT_FFTSUM_PARALLELIZATION_THRESHOLD 32
+#endif
+#ifndef SWIFFT_FFTSUM_PARALLELIZATION_GRAIN
+	//! Default number of blocks SWIFFT_fftsumMultiple submits to the executor per range
+	#define SWIFFT_FFTSUM_PARALLELIZATION_GRAIN 16
+#endif
+#ifndef SWIFFT_COMPACT_PARALLELIZATION_THRESHOLD
+	//! Default maximum number of blocks SWIFFT_CompactMultiple processes on the calling thread
+	#define SWIFFT_COMPACT_PARALLELIZATION_THRESHOLD 128
+#endif
+#ifndef SWIFFT_COMPACT_PARALLELIZATION_GRAIN
+	//! Default number of blocks SWIFFT_CompactMultiple submits to the executor per range
+	#define SWIFFT_COMPACT_PARALLELIZATION_GRAIN 64
+#endif
+#ifndef SWIFFT_ARITH_PARALLELIZATION_THRESHOLD
+	//! Default maximum number of blocks SWIFFT_{,Const}{Set,Add,Sub,Mul}Multiple process on the calling thread
+	#define SWIFFT_ARITH_PARALLELIZATION_THRESHOLD 1024
+#endif
+#ifndef SWIFFT_ARITH_PARALLELIZATION_GRAIN
+	//! Default number of blocks SWIFFT_{,Const}{Set,Add,Sub,Mul}Multiple submit to the executor per range
+	#define SWIFFT_ARITH_PARALLELIZATION_GRAIN 256
+#endif
+
+#define SWIFFT_CALIBRATION_NBLOCKS 64   ///< The number of blocks SWIFFT_CalibrateParallelization measures an operation on
+#define SWIFFT_CALIBRATION_NREPEATS 8   ///< The number of measurements SWIFFT_CalibrateParallelization takes the minimum of
+#define SWIFFT_CALIBRATION_MAX_THRESHOLD (1 << 20) ///< The maximum threshold SWIFFT_CalibrateParallelization sets
+#define SWIFFT_CALIBRATION_MAX_GRAIN (1 << 16)     ///< The maximum grain SWIFFT_CalibrateParallelization sets
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The range of chunks of a participating thread, on its own cache line.
+typedef struct {
+	_Alignas(SWIFFT_CACHE_LINE_SIZE) _Atomic uint64_t range;
+} swifft_pool_slot_t;
+
+//! \brief A thread pool executor.
+typedef struct {
+	swifft_executor_t executor;   ///< The executor, pointing to this pool
+	int nthreads;                 ///< The number of participating threads, including the calling one
+	pthread_t *threads;           ///< The nthreads-1 worker threads
+	swifft_pool_slot_t *slots;    ///< The ranges of chunks, per participating thread
+	pthread_mutex_t submit;       ///< Held while running a ParallelFor
+	pthread_mutex_t mutex;        ///< Protects the fields below
+	pthread_cond_t wake;          ///< Signals a new generation or stopping
+	pthread_cond_t done;          ///< Signals active reaching 0
+	unsigned generation;          ///< The number of ParallelFor runs so far
+	int active;                   ///< The number of worker threads still running the current generation
+	int stop;                     ///< Whether the workers should exit
+	swifft_job_t job;             ///< The job of the current generation
+	void *context;                ///< The context of the job
+	int nblocks;                  ///< The number of blocks of the job
+	int grain;                    ///< The number of blocks per chunk
+	const int *order;             ///< The chunk at each position of the current job, or NULL if it is the position
+	int nnodes;                   ///< The number of NUMA nodes of the threads, more than 1 only for a NUMA-aware pool
+	int *nodeIds;                 ///< The NUMA nodes of the threads, nnodes of them, or NULL
+	int *slotNodes;               ///< The index in nodeIds of the node of each participating thread, or NULL
+	int *nodeCounts;              ///< The number of chunks of the current job per node, nnodes+1 of them, or NULL
+	int *chunkNodes;              ///< The index in nodeIds of the node of each chunk of the current job, or NULL
+	int *chunkOrder;              ///< The chunks ordered by node, norder of them, or NULL
+	int norder;                   ///< The number of chunks chunkNodes and chunkOrder have room for
+	size_t pageSize;              ///< The size in bytes of a page of memory
+} swifft_pool_t;
+
+//! \brief The arguments of a starting worker thread.
+typedef struct {
+	swifft_pool_t *pool;          ///< The pool
+	int index;                    ///< The index of the worker's slot
+} swifft_pool_worker_t;
+
+#ifdef _OPENMP
+//! \brief Runs a job over chunks of grain blocks statically scheduled in an OpenMP parallel region.
+static void SWIFFT_OmpParallelFor(void *self, int nblocks, int grain, swifft_job_t job, void *context)
+{
+	int c;
+	int nchunks = (nblocks + grain - 1) / grain;
+	(void)self;
+	#pragma omp parallel for schedule(static) private(c)
+	for (c=0; c<nchunks; c++) {
+		int end = (c + 1) * grain;
+		job(context, c * grain, (end < nblocks) ? end : nblocks);
+	}
+}
+
+//! \brief The OpenMP executor.
+static const swifft_executor_t SWIFFT_ompExecutor = { SWIFFT_OmpParallelFor, NULL };
+	#define SWIFFT_DEFAULT_EXECUTOR (&SWIFFT_ompExecutor)
+#else
+	#define SWIFFT_DEFAULT_EXECUTOR NULL
+#endif
+
+//! \brief The executor used by the functions for multiple blocks.
+static const swifft_executor_t *SWIFFT_executor = SWIFFT_DEFAULT_EXECUTOR;
+
+//! \brief The parallelization parameters used by default, per kind of operation.
+static const swifft_parallelization_t SWIFFT_defaultParallelization[SWIFFT_PARALLEL_NOPS] = {
+	{ SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD, SWIFFT_BLOCKS_PARALLELIZATION_GRAIN },
+	{ SWIFFT_FFTSUM_PARALLELIZATION_THRESHOLD, SWIFFT_FFTSUM_PARALLELIZATION_GRAIN },
+	{ SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD, SWIFFT_BLOCKS_PARALLELIZATION_GRAIN },
+	{ SWIFFT_COMPACT_PARALLELIZATION_THRESHOLD, SWIFFT_COMPACT_PARALLELIZATION_GRAIN },
+	{ SWIFFT_ARITH_PARALLELIZATION_THRESHOLD, SWIFFT_ARITH_PARALLELIZATION_GRAIN },
+};
+
+//! \brief The parallelization parameters used by the functions for multiple blocks, per kind of operation.
+static swifft_parallelization_t SWIFFT_parallelization[SWIFFT_PARALLEL_NOPS] = {
+	{ SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD, SWIFFT_BLOCKS_PARALLELIZATION_GRAIN },
+	{ SWIFFT_FFTSUM_PARALLELIZATION_THRESHOLD, SWIFFT_FFTSUM_PARALLELIZATION_GRAIN },
+	{ SWIFFT_BLOCKS_PARALLELIZATION_THRESHOLD, SWIFFT_BLOCKS_PARALLELIZATION_GRAIN },
+	{ SWIFFT_COMPACT_PARALLELIZATION_THRESHOLD, SWIFFT_COMPACT_PARALLELIZATION_GRAIN },
+	{ SWIFFT_ARITH_PARALLELIZATION_THRESHOLD, SWIFFT_ARITH_PARALLELIZATION_GRAIN },
+};
+
+//! \brief Whether the thread is running chunks of a pool, so nested calls run on it.
+static __thread int SWIFFT_inPool = 0;
+
+void SWIFFT_SetExecutor(const swifft_executor_t *executor)
+{
+	SWIFFT_executor = executor;
+}
+
+const swifft_executor_t *SWIFFT_GetExecutor(void)
+{
+	return SWIFFT_executor;
+}
+
+const swifft_executor_t *SWIFFT_GetDefaultExecutor(void)
+{
+	return SWIFFT_DEFAULT_EXECUTOR;
+}
+
+void SWIFFT_SetParallelization(int op, const swifft_parallelization_t *parallelization)
+{
+	if (op < 0 || op >= SWIFFT_PARALLEL_NOPS) {
+		return;
+	}
+	if (parallelization == NULL) {
+		parallelization = &SWIFFT_defaultParallelization[op];
+	}
+	SWIFFT_parallelization[op].threshold = (parallelization->threshold > 0) ? parallelization->threshold : 0;
+	SWIFFT_parallelization[op].grain = (parallelization->grain > 1) ? parallelization->grain : 1;
+}
+
+int SWIFFT_GetParallelization(int op, swifft_parallelization_t *parallelization)
+{
+	if (op < 0 || op >= SWIFFT_PARALLEL_NOPS) {
+		return -1;
+	}
+	*parallelization = SWIFFT_parallelization[op];
+	return 0;
+}
+
+#ifdef SWIFFT_ENABLE_STATS
+//! \brief A job run by the executor, along with the kinds of operation counted on the submitting thread.
+typedef struct {
+	swifft_job_t job;   ///< The job
+	void *context;      ///< The context of the job
+	int active;         ///< The bitmask of the kinds of operation counted on the submitting thread
+} swifft_stats_job_t;
+
+//! \brief Runs a job submitted to the executor, with the kinds of operation counted on the
+//! submitting thread taken as counted on the running thread too, to avoid counting them twice.
+static void SWIFFT_StatsJob(void *context, int begin, int end)
+{
+	const swifft_stats_job_t *statsJob = (const swifft_stats_job_t *)context;
+	swifft_thread_stats_t *stats = SWIFFT_getThreadStats();
+	int active = (stats != NULL) ? stats->active : 0;
+	if (stats != NULL) {
+		stats->active |= statsJob->active;
+	}
+	statsJob->job(statsJob->context, begin, end);
+	if (stats != NULL) {
+		stats->active = active;
+	}
+}
+#endif
+
+static void SWIFFT_PoolParallelFor(void *self, int nblocks, int grain, swifft_job_t job, void *context);
+static void SWIFFT_PoolRun(swifft_pool_t *pool, int nblocks, int grain, const void *data, size_t stride,
+	swifft_job_t job, void *context);
+
+void SWIFFT_ParallelFor(int op, int nblocks, int unit, swifft_job_t job, void *context)
+{
+	SWIFFT_ParallelForData(op, nblocks, unit, NULL, 0, job, context);
+}
+
+void SWIFFT_ParallelForData(int op, int nblocks, int unit, const void *data, size_t stride, swifft_job_t job, void *context)
+{
+	const swifft_executor_t *executor = SWIFFT_executor;
+	int serial, grain;
+#ifdef SWIFFT_ENABLE_STATS
+	swifft_thread_stats_t *stats = SWIFFT_getThreadStats();
+	swifft_stats_job_t statsJob;
+#endif
+	if (nblocks <= 0) {
+		return;
+	}
+	serial = (executor == NULL || nblocks <= SWIFFT_parallelization[op].threshold);
+#ifdef SWIFFT_ENABLE_STATS
+	if (stats != NULL) {
+		SWIFFT_STATS_ADD(*(serial ? &stats->op[op].serialRuns : &stats->op[op].parallelRuns), 1);
+	}
+#endif
+	if (serial) {
+		job(context, 0, nblocks);
+		return;
+	}
+	grain = (SWIFFT_parallelization[op].grain + unit - 1) / unit * unit;
+#ifdef SWIFFT_ENABLE_STATS
+	statsJob.job = job;
+	statsJob.context = context;
+	statsJob.active = (stats != NULL) ? stats->active : 0;
+	job = SWIFFT_StatsJob;
+	context = &statsJob;
+#endif
+	if (executor->ParallelFor == SWIFFT_PoolParallelFor) {
+		// a pool of this library may place the ranges by the memory they read
+		SWIFFT_PoolRun((swifft_pool_t *)executor->self, nblocks, grain, data, stride, job, context);
+		return;
+	}
+	executor->ParallelFor(executor->self, nblocks, grain, job, context);
+}
+
+//! \brief Returns the time in nanoseconds from a monotonic clock.
+static double SWIFFT_Nanos(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! \brief A job doing nothing, for measuring the cost of an executor.
+static void SWIFFT_EmptyJob(void *context, int begin, int end)
+{
+	(void)context;
+	(void)begin;
+	(void)end;
+}
+
+//! \brief The buffers for measuring the operations.
+typedef struct {
+	BitSequence *input;     ///< SWIFFT_CALIBRATION_NBLOCKS input blocks
+	BitSequence *output;    ///< SWIFFT_CALIBRATION_NBLOCKS output blocks
+	BitSequence *operand;   ///< SWIFFT_CALIBRATION_NBLOCKS output blocks
+	BitSequence *compact;   ///< SWIFFT_CALIBRATION_NBLOCKS compact blocks
+	int16_t *fftout;        ///< SWIFFT_CALIBRATION_NBLOCKS blocks of FFT-output elements
+} swifft_calibration_work_t;
+
+//! \brief Frees the buffers for measuring the operations.
+static void SWIFFT_CalibrationFree(swifft_calibration_work_t *work)
+{
+	free(work->input);
+	free(work->output);
+	free(work->operand);
+	free(work->compact);
+	free(work->fftout);
+}
+
+//! \brief Processes SWIFFT_CALIBRATION_NBLOCKS blocks by a kind of operation.
+static void SWIFFT_CalibrationRun(int op, const swifft_calibration_work_t *work)
+{
+	const int n = SWIFFT_CALIBRATION_NBLOCKS;
+	switch (op) {
+	case SWIFFT_PARALLEL_FFT:
+		SWIFFT_fftMultiple(n, work->input, work->input, SWIFFT_M, work->fftout);
+		break;
+	case SWIFFT_PARALLEL_FFTSUM:
+		SWIFFT_fftsumMultiple(n, SWIFFT_PI_key, work->fftout, SWIFFT_M, (int16_t *)work->output);
+		break;
+	case SWIFFT_PARALLEL_COMPUTE:
+		SWIFFT_ComputeMultiple(n, work->input, work->output);
+		break;
+	case SWIFFT_PARALLEL_COMPACT:
+		SWIFFT_CompactMultiple(n, work->output, work->compact);
+		break;
+	default:
+		SWIFFT_MulMultiple(n, work->output, work->operand);
+		break;
+	}
+}
+
+int SWIFFT_CalibrateParallelization(swifft_calibration_t *calibration)
+{
+	const swifft_executor_t *executor = SWIFFT_executor;
+	const int n = SWIFFT_CALIBRATION_NBLOCKS;
+	swifft_calibration_t result;
+	swifft_calibration_work_t work;
+	int op, r;
+
+	work.input = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, n * SWIFFT_INPUT_BLOCK_SIZE);
+	work.output = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	work.operand = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	work.compact = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, n * SWIFFT_COMPACT_BLOCK_SIZE);
+	work.fftout = (int16_t *)aligned_alloc(SWIFFT_ALIGNMENT, n * SWIFFT_N * SWIFFT_M * sizeof(int16_t));
+	if (work.input == NULL || work.output == NULL || work.operand == NULL || work.compact == NULL || work.fftout == NULL) {
+		SWIFFT_CalibrationFree(&work);
+		return -1;
+	}
+	memset(work.input, 0x5A, n * SWIFFT_INPUT_BLOCK_SIZE);
+	memset(work.operand, 1, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_ComputeMultiple(n, work.input, work.output);
+
+	// each kind of operation is measured on the calling thread, and the executor on an empty job
+	for (op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		double best = 0;
+		swifft_parallelization_t saved = SWIFFT_parallelization[op];
+		SWIFFT_parallelization[op].threshold = INT_MAX;
+		for (r=0; r<=SWIFFT_CALIBRATION_NREPEATS; r++) {
+			double start = SWIFFT_Nanos(), nanos;
+			SWIFFT_CalibrationRun(op, &work);
+			nanos = SWIFFT_Nanos() - start;
+			if (r == 1 || (r > 1 && nanos < best)) {
+				best = nanos; // the first run warms up
+			}
+		}
+		SWIFFT_parallelization[op] = saved;
+		result.blockNanos[op] = (best > 0 ? best : 1) / n;
+	}
+	result.dispatchNanos = 0;
+	if (executor != NULL) {
+		for (r=0; r<=SWIFFT_CALIBRATION_NREPEATS; r++) {
+			double start = SWIFFT_Nanos(), nanos;
+			executor->ParallelFor(executor->self, n, 1, SWIFFT_EmptyJob, NULL);
+			nanos = SWIFFT_Nanos() - start;
+			if (r == 1 || (r > 1 && nanos < result.dispatchNanos)) {
+				result.dispatchNanos = nanos;
+			}
+		}
+	}
+
+	for (op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		double threshold = 2 * result.dispatchNanos / result.blockNanos[op];
+		double grain = SWIFFT_CALIBRATION_RANGE_NANOS / result.blockNanos[op];
+		// without an executor the threshold has no effect, so it is kept
+		result.parallelization[op].threshold = (executor == NULL) ? SWIFFT_parallelization[op].threshold :
+			(threshold < 1) ? 1 : (threshold > SWIFFT_CALIBRATION_MAX_THRESHOLD) ? SWIFFT_CALIBRATION_MAX_THRESHOLD : (int)threshold;
+		result.parallelization[op].grain =
+			(grain < 1) ? 1 : (grain > SWIFFT_CALIBRATION_MAX_GRAIN) ? SWIFFT_CALIBRATION_MAX_GRAIN : (int)grain;
+		SWIFFT_SetParallelization(op, &result.parallelization[op]);
+	}
+	if (calibration != NULL) {
+		*calibration = result;
+	}
+	SWIFFT_CalibrationFree(&work);
+	return 0;
+}
+
+//! \brief Runs a chunk of the current job of a pool.
+static inline void SWIFFT_PoolRunChunk(const swifft_pool_t *pool, int position)
+{
+	int chunk = (pool->order != NULL) ? pool->order[position] : position;
+	int begin = chunk * pool->grain;
+	int end = begin + pool->grain;
+	pool->job(pool->context, begin, (end < pool->nblocks) ? end : pool->nblocks);
+}
+
+//! \brief Steals the back half of the first non-empty range of another thread of a pool, and runs
+//! its first chunk.
+//!
+//! \param[in] pool the pool.
+//! \param[in] index the index of the participating thread.
+//! \param[in] sameNode whether to steal only from the threads on the same node.
+//! \returns whether a range was stolen.
+static int SWIFFT_PoolSteal(swifft_pool_t *pool, int index, int sameNode)
+{
+	int i;
+	for (i=1; i<pool->nthreads; i++) {
+		int v = (index + i) % pool->nthreads;
+		_Atomic uint64_t *victim = &pool->slots[v].range;
+		uint64_t vrange;
+		int begin, end, mid;
+		if (sameNode && pool->slotNodes[v] != pool->slotNodes[index]) {
+			continue;
+		}
+		vrange = atomic_load_explicit(victim, memory_order_acquire);
+		for (;;) {
+			begin = SWIFFT_POOL_BEGIN(vrange);
+			end = SWIFFT_POOL_END(vrange);
+			if (begin >= end) {
+				break;
+			}
+			mid = end - (end - begin + 1) / 2;
+			if (atomic_compare_exchange_weak_explicit(victim, &vrange, SWIFFT_POOL_RANGE(begin, mid),
+				memory_order_acq_rel, memory_order_acquire)) {
+				break;
+			}
+		}
+		if (begin < end) {
+			atomic_store_explicit(&pool->slots[index].range, SWIFFT_POOL_RANGE(mid + 1, end), memory_order_release);
+			SWIFFT_PoolRunChunk(pool, mid);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//! \brief Runs chunks of the current job of a pool, from its own range and then stolen ones,
+//! until none is left to steal.
+//!
+//! \param[in] pool the pool.
+//! \param[in] index the index of the participating thread.
+static void SWIFFT_PoolParticipate(swifft_pool_t *pool, int index)
+{
+	_Atomic uint64_t *own = &pool->slots[index].range;
+	for (;;) {
+		uint64_t range = atomic_load_explicit(own, memory_order_acquire);
+		while (SWIFFT_POOL_BEGIN(range) < SWIFFT_POOL_END(range)) {
+			int begin = SWIFFT_POOL_BEGIN(range);
+			if (atomic_compare_exchange_weak_explicit(own, &range, SWIFFT_POOL_RANGE(begin + 1, SWIFFT_POOL_END(range)),
+				memory_order_acq_rel, memory_order_acquire)) {
+				SWIFFT_PoolRunChunk(pool, begin);
+				range = atomic_load_explicit(own, memory_order_acquire);
+			}
+		}
+		if (!(pool->slotNodes != NULL && SWIFFT_PoolSteal(pool, index, 1)) && !SWIFFT_PoolSteal(pool, index, 0)) {
+			return;
+		}
+	}
+}
+
+//! \brief Runs the generations of a pool on a worker thread, until the pool stops.
+static void *SWIFFT_PoolWorker(void *arg)
+{
+	swifft_pool_worker_t worker = *(swifft_pool_worker_t *)arg;
+	swifft_pool_t *pool = worker.pool;
+	unsigned generation = 0;
+	free(arg);
+	SWIFFT_inPool = 1;
+	pthread_mutex_lock(&pool->mutex);
+	for (;;) {
+		while (!pool->stop && pool->generation == generation) {
+			pthread_cond_wait(&pool->wake, &pool->mutex);
+		}
+		if (pool->stop) {
+			break;
+		}
+		generation = pool->generation;
+		pthread_mutex_unlock(&pool->mutex);
+		SWIFFT_PoolParticipate(pool, worker.index);
+		pthread_mutex_lock(&pool->mutex);
+		if (--pool->active == 0) {
+			pthread_cond_signal(&pool->done);
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+//! \brief Returns the index in the nodes of the threads of a pool of a NUMA node.
+//!
+//! \param[in] pool the pool.
+//! \param[in] node the node.
+//! \returns the index, or -1 if none of the threads is on the node.
+static int SWIFFT_PoolNodeIndex(const swifft_pool_t *pool, int node)
+{
+	int n;
+	for (n=0; n<pool->nnodes; n++) {
+		if (pool->nodeIds[n] == node) {
+			return n;
+		}
+	}
+	return -1;
+}
+
+//! \brief Returns the number of participating threads of a pool on a NUMA node.
+//!
+//! \param[in] pool the pool.
+//! \param[in] n the index of the node in the nodes of the threads.
+//! \returns the number of threads.
+static int SWIFFT_PoolNodeMembers(const swifft_pool_t *pool, int n)
+{
+	int i, nmembers = 0;
+	for (i=0; i<pool->nthreads; i++) {
+		nmembers += (pool->slotNodes[i] == n);
+	}
+	return nmembers;
+}
+
+//! \brief Sets the ranges of a NUMA-aware pool for a job, so that each thread starts with the
+//! chunks whose memory is on its node. The chunks of a node none of the threads is on are
+//! given to the threads of the nodes next to it.
+//!
+//! \param[in] pool the pool.
+//! \param[in] nchunks the number of chunks.
+//! \param[in] grain the number of blocks per chunk.
+//! \param[in] data the memory of block 0.
+//! \param[in] stride the distance in bytes between the memory of consecutive blocks.
+//! \returns 0 on success, or -1 if memory for ordering the chunks could not be allocated.
+static int SWIFFT_PoolPlace(swifft_pool_t *pool, int nchunks, int grain, const void *data, size_t stride)
+{
+	const void *pages[SWIFFT_NUMA_MAX_SAMPLES];
+	int nodes[SWIFFT_NUMA_MAX_SAMPLES];
+	const int nsamples = (nchunks < SWIFFT_NUMA_MAX_SAMPLES) ? nchunks : SWIFFT_NUMA_MAX_SAMPLES;
+	int *counts = pool->nodeCounts;
+	int s, c, n, i, k, begin, last;
+	if (nchunks > pool->norder) {
+		int *chunkNodes = (int *)realloc(pool->chunkNodes, nchunks * sizeof(int));
+		int *chunkOrder = (chunkNodes != NULL) ? (int *)realloc(pool->chunkOrder, nchunks * sizeof(int)) : NULL;
+		if (chunkNodes != NULL) {
+			pool->chunkNodes = chunkNodes;
+		}
+		if (chunkOrder == NULL) {
+			return -1;
+		}
+		pool->chunkOrder = chunkOrder;
+		pool->norder = nchunks;
+	}
+	n = SWIFFT_PoolNodeIndex(pool, SWIFFT_NumaCurrentNode());
+	pool->slotNodes[0] = (n >= 0) ? n : 0;
+
+	// the node of a sampled page is taken as that of the chunks up to the next sampled one
+	for (s=0; s<nsamples; s++) {
+		c = (int)((int64_t)nchunks * s / nsamples);
+		pages[s] = (const void *)(((uintptr_t)data + (size_t)c * grain * stride) & ~(uintptr_t)(pool->pageSize - 1));
+	}
+	SWIFFT_NumaPageNodes(nsamples, pages, nodes);
+	memset(counts, 0, (pool->nnodes + 1) * sizeof(int));
+	for (s=0; s<nsamples; s++) {
+		int end = (int)((int64_t)nchunks * (s + 1) / nsamples);
+		n = (nodes[s] >= 0) ? SWIFFT_PoolNodeIndex(pool, nodes[s]) : -1;
+		for (c=(int)((int64_t)nchunks * s / nsamples); c<end; c++) {
+			// a chunk not placed yet goes where the threads in order would place it by first touch
+			int node = (n >= 0) ? n : pool->slotNodes[(int64_t)c * pool->nthreads / nchunks];
+			pool->chunkNodes[c] = node;
+			counts[node + 1]++;
+		}
+	}
+	for (n=0; n<pool->nnodes; n++) {
+		counts[n + 1] += counts[n];
+	}
+	for (c=0; c<nchunks; c++) {
+		pool->chunkOrder[counts[pool->chunkNodes[c]]++] = c;
+	}
+	// counts[n] is now the end of the positions of node n, and the beginning of those of node n+1
+	last = pool->nnodes - 1;
+	while (last > 0 && SWIFFT_PoolNodeMembers(pool, last) == 0) {
+		last--;
+	}
+	for (i=0; i<pool->nthreads; i++) {
+		atomic_store_explicit(&pool->slots[i].range, 0, memory_order_relaxed);
+	}
+	begin = 0;
+	for (n=0; n<=last; n++) {
+		int end = (n == last) ? nchunks : counts[n];
+		int nmembers = SWIFFT_PoolNodeMembers(pool, n);
+		if (nmembers == 0) {
+			continue;
+		}
+		for (i=0,k=0; i<pool->nthreads; i++) {
+			if (pool->slotNodes[i] == n) {
+				int rbegin = begin + (int)((int64_t)(end - begin) * k / nmembers);
+				int rend = begin + (int)((int64_t)(end - begin) * (k + 1) / nmembers);
+				atomic_store_explicit(&pool->slots[i].range, SWIFFT_POOL_RANGE(rbegin, rend), memory_order_relaxed);
+				k++;
+			}
+		}
+		begin = end;
+	}
+	pool->order = pool->chunkOrder;
+	return 0;
+}
+
+//! \brief Runs a job on a pool, or on the calling thread if the pool is busy or the call is nested.
+//!
+//! \param[in] pool the pool.
+//! \param[in] nblocks the number of blocks.
+//! \param[in] grain the number of blocks per chunk.
+//! \param[in] data the memory of block 0, or NULL if not known.
+//! \param[in] stride the distance in bytes between the memory of consecutive blocks.
+//! \param[in] job the job.
+//! \param[in] context the context of the job.
+static void SWIFFT_PoolRun(swifft_pool_t *pool, int nblocks, int grain, const void *data, size_t stride,
+	swifft_job_t job, void *context)
+{
+	int nchunks = (nblocks + grain - 1) / grain;
+	int i;
+	if (pool->nthreads <= 1 || nchunks <= 1 || SWIFFT_inPool || pthread_mutex_trylock(&pool->submit) != 0) {
+		job(context, 0, nblocks);
+		return;
+	}
+	pool->order = NULL;
+	if (pool->slotNodes == NULL || data == NULL || SWIFFT_PoolPlace(pool, nchunks, grain, data, stride) != 0) {
+		for (i=0; i<pool->nthreads; i++) {
+			int begin = (int)((int64_t)nchunks * i / pool->nthreads);
+			int end = (int)((int64_t)nchunks * (i + 1) / pool->nthreads);
+			atomic_store_explicit(&pool->slots[i].range, SWIFFT_POOL_RANGE(begin, end), memory_order_relaxed);
+		}
+	}
+	pthread_mutex_lock(&pool->mutex);
+	pool->job = job;
+	pool->context = context;
+	pool->nblocks = nblocks;
+	pool->grain = grain;
+	pool->active = pool->nthreads - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->mutex);
+
+	SWIFFT_inPool = 1;
+	SWIFFT_PoolParticipate(pool, 0);
+	SWIFFT_inPool = 0;
+
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->active > 0) {
+		pthread_cond_wait(&pool->done, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	pthread_mutex_unlock(&pool->submit);
+}
+
+//! \brief Runs a job on a pool, or on the calling thread if the pool is busy or the call is nested.
+static void SWIFFT_PoolParallelFor(void *self, int nblocks, int grain, swifft_job_t job, void *context)
+{
+	SWIFFT_PoolRun((swifft_pool_t *)self, nblocks, grain, NULL, 0, job, context);
+}
+
+//! \brief Stops the worker threads of a pool and frees it.
+//!
+//! \param[in] pool the pool.
+//! \param[in] nstarted the number of started worker threads.
+static void SWIFFT_PoolFree(swifft_pool_t *pool, int nstarted)
+{
+	int i;
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->mutex);
+	for (i=0; i<nstarted; i++) {
+		pthread_join(pool->threads[i], NULL);
+	}
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->wake);
+	pthread_mutex_destroy(&pool->mutex);
+	pthread_mutex_destroy(&pool->submit);
+	free(pool->nodeIds);
+	free(pool->slotNodes);
+	free(pool->nodeCounts);
+	free(pool->chunkNodes);
+	free(pool->chunkOrder);
+	free(pool->slots);
+	free(pool->threads);
+	free(pool);
+}
+
+//! \brief Allocates a thread pool, without starting its worker threads.
+//!
+//! \param[in] nthreads the number of threads, including the calling one.
+//! \returns the pool, or NULL if its resources could not be allocated.
+static swifft_pool_t *SWIFFT_PoolAlloc(int nthreads)
+{
+	swifft_pool_t *pool = (swifft_pool_t *)calloc(1, sizeof(swifft_pool_t));
+	int i;
+	if (pool == NULL) {
+		return NULL;
+	}
+	pool->executor.ParallelFor = SWIFFT_PoolParallelFor;
+	pool->executor.self = pool;
+	pool->nthreads = nthreads;
+	pool->nnodes = 1;
+	pool->pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	pool->threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+	pool->slots = (swifft_pool_slot_t *)aligned_alloc(SWIFFT_CACHE_LINE_SIZE, nthreads * sizeof(swifft_pool_slot_t));
+	pthread_mutex_init(&pool->submit, NULL);
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	if (pool->threads == NULL || pool->slots == NULL) {
+		SWIFFT_PoolFree(pool, 0);
+		return NULL;
+	}
+	for (i=0; i<nthreads; i++) {
+		atomic_init(&pool->slots[i].range, 0);
+	}
+	return pool;
+}
+
+//! \brief Starts the worker threads of a pool, or frees it if they could not be started.
+//!
+//! \param[in] pool the pool.
+//! \param[in] affinity the CPUs each worker thread may run on, by slot, or NULL for any.
+//! \returns the executor of the pool, or NULL if the pool was freed.
+static swifft_executor_t *SWIFFT_PoolStart(swifft_pool_t *pool, const cpu_set_t *affinity)
+{
+	int i;
+	for (i=1; i<pool->nthreads; i++) {
+		swifft_pool_worker_t *worker = (swifft_pool_worker_t *)malloc(sizeof(swifft_pool_worker_t));
+		pthread_attr_t attr;
+		int error = pthread_attr_init(&attr);
+		if (worker != NULL) {
+			worker->pool = pool;
+			worker->index = i;
+		}
+		if (error == 0 && affinity != NULL) {
+			error = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &affinity[i]);
+		}
+		if (worker == NULL || error != 0 || pthread_create(&pool->threads[i - 1], &attr, SWIFFT_PoolWorker, worker) != 0) {
+			free(worker);
+			pthread_attr_destroy(&attr);
+			SWIFFT_PoolFree(pool, i - 1);
+			return NULL;
+		}
+		pthread_attr_destroy(&attr);
+	}
+	return &pool->executor;
+}
+
+swifft_executor_t *SWIFFT_CreateThreadPool(int nthreads)
+{
+	swifft_pool_t *pool;
+	if (nthreads <= 0) {
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = (ncpus > 0) ? (int)ncpus : 1;
+	}
+	pool = SWIFFT_PoolAlloc(nthreads);
+	return (pool != NULL) ? SWIFFT_PoolStart(pool, NULL) : NULL;
+}
+
+swifft_executor_t *SWIFFT_CreateNumaThreadPool(int nthreads, int flags)
+{
+	int cpus[CPU_SETSIZE], nodes[CPU_SETSIZE];
+	int ncpus = SWIFFT_NumaCpus(CPU_SETSIZE, cpus, nodes);
+	swifft_pool_t *pool;
+	swifft_executor_t *executor;
+	cpu_set_t *affinity = NULL;
+	int i, j, nnodes = 1;
+	if (nthreads <= 0) {
+		nthreads = ncpus;
+	}
+	for (i=1; i<ncpus; i++) {
+		nnodes += (nodes[i] != nodes[i-1]);
+	}
+	if ((pool = SWIFFT_PoolAlloc(nthreads)) == NULL) {
+		return NULL;
+	}
+	if (nnodes > 1 || (flags & SWIFFT_NUMA_PIN)) {
+		affinity = (cpu_set_t *)calloc(nthreads, sizeof(cpu_set_t));
+		if (affinity == NULL) {
+			SWIFFT_PoolFree(pool, 0);
+			return NULL;
+		}
+	}
+	if (nnodes > 1) {
+		pool->nnodes = nnodes;
+		pool->nodeIds = (int *)malloc(nnodes * sizeof(int));
+		pool->slotNodes = (int *)malloc(nthreads * sizeof(int));
+		pool->nodeCounts = (int *)malloc((nnodes + 1) * sizeof(int));
+		if (pool->nodeIds == NULL || pool->slotNodes == NULL || pool->nodeCounts == NULL) {
+			free(affinity);
+			SWIFFT_PoolFree(pool, 0);
+			return NULL;
+		}
+		for (i=0,j=0; i<ncpus; i++) {
+			if (i == 0 || nodes[i] != nodes[i-1]) {
+				pool->nodeIds[j++] = nodes[i];
+			}
+		}
+	}
+	// the worker threads are spread over the CPUs grouped by node, so over the nodes in proportion
+	for (i=0; i<nthreads && affinity != NULL; i++) {
+		int cpu = (int)((int64_t)ncpus * i / nthreads);
+		if (pool->slotNodes != NULL) {
+			pool->slotNodes[i] = SWIFFT_PoolNodeIndex(pool, nodes[cpu]);
+		}
+		if (flags & SWIFFT_NUMA_PIN) {
+			CPU_SET(cpus[cpu], &affinity[i]);
+			continue;
+		}
+		for (j=0; j<ncpus; j++) {
+			if (nodes[j] == nodes[cpu]) {
+				CPU_SET(cpus[j], &affinity[i]);
+			}
+		}
+	}
+	executor = SWIFFT_PoolStart(pool, affinity);
+	free(affinity);
+	return executor;
+}
+
+void SWIFFT_DestroyThreadPool(swifft_executor_t *pool)
+{
+	if (pool == NULL) {
+		return;
+	}
+	if (SWIFFT_executor == pool) {
+		SWIFFT_executor = NULL;
+	}
+	SWIFFT_PoolFree((swifft_pool_t *)pool->self, ((swifft_pool_t *)pool->self)->nthreads - 1);
+}
+
+LIBSWIFFT_END_EXTERN_C
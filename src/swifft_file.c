@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_file.c
+ * \brief LibSWIFFT file-hashing public C implementation
+ *
+ * An input that is not mapped is read into two buffers in turn by a reader
+ * thread, while the calling thread adds the other buffer to an incremental
+ * tree-hash. The buffers are aligned to pages and read in multiples of their
+ * size, as O_DIRECT requires.
+ */
+
+#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE // for O_DIRECT
+#endif
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h> // for aligned_alloc, free
+#include <string.h> // for memset
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "libswifft/swifft_file.h"
+#include "libswifft/swifft_tree.h"
+
+#define SWIFFT_FILE_ALIGNMENT 4096   ///< The alignment of the read buffers, as O_DIRECT requires
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The state shared by the reader thread and the hashing thread.
+typedef struct {
+	int fd;                        ///< The file descriptor
+	BitSequence *buffers[2];       ///< The read buffers, of SWIFFT_FILE_READ_SIZE bytes each
+	pthread_mutex_t mutex;         ///< Protects the fields below
+	pthread_cond_t cond;           ///< Broadcast when a buffer is filled or emptied
+	size_t lens[2];                ///< The number of bytes read into each buffer
+	int full[2];                   ///< Whether each buffer is read and waiting to be hashed
+	int eof;                       ///< Whether the end of the file was reached
+	int error;                     ///< The errno of a failed read, or 0
+	int stop;                      ///< Whether the hashing thread stopped early
+} swifft_file_reader_t;
+
+//! \brief Reads up to a full buffer from a file, retrying without O_DIRECT if it is refused.
+//!
+//! \param[in] fd the file descriptor.
+//! \param[out] buffer the buffer.
+//! \param[out] len the number of bytes read, less than a full buffer only at the end of the file.
+//! \returns 0 on success, or the errno of a failed read.
+static int SWIFFT_FileRead(int fd, BitSequence *buffer, size_t *len)
+{
+	size_t n = 0;
+	while (n < SWIFFT_FILE_READ_SIZE) {
+		ssize_t r = read(fd, buffer + n, SWIFFT_FILE_READ_SIZE - n);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r < 0 && errno == EINVAL && (fcntl(fd, F_GETFL) & O_DIRECT)) {
+			// e.g. after a short read left an unaligned offset
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+			continue;
+		}
+		if (r < 0) {
+			return errno;
+		}
+		if (r == 0) {
+			break;
+		}
+		n += (size_t)r;
+	}
+	*len = n;
+	return 0;
+}
+
+//! \brief Runs the reader thread, filling the buffers in turn until the end of the file.
+//!
+//! \param[in] arg the shared state.
+//! \returns NULL.
+static void *SWIFFT_FileReader(void *arg)
+{
+	swifft_file_reader_t *reader = (swifft_file_reader_t *)arg;
+	int i, error;
+	size_t len = 0;
+	for (i=0; ; i^=1) {
+		pthread_mutex_lock(&reader->mutex);
+		while (reader->full[i] && !reader->stop) {
+			pthread_cond_wait(&reader->cond, &reader->mutex);
+		}
+		if (reader->stop) {
+			pthread_mutex_unlock(&reader->mutex);
+			break;
+		}
+		pthread_mutex_unlock(&reader->mutex);
+		error = SWIFFT_FileRead(reader->fd, reader->buffers[i], &len);
+		pthread_mutex_lock(&reader->mutex);
+		reader->lens[i] = len;
+		reader->full[i] = (error == 0);
+		reader->eof = (error == 0 && len < SWIFFT_FILE_READ_SIZE);
+		reader->error = error;
+		pthread_cond_broadcast(&reader->cond);
+		pthread_mutex_unlock(&reader->mutex);
+		if (reader->eof || reader->error) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+//! \brief Computes the tree-hash of a file by reading it.
+//!
+//! \param[in] fd the file descriptor.
+//! \param[out] digest the digest.
+//! \param[out] bytes the number of bytes hashed.
+//! \returns 0 on success, or -1 with errno set.
+static int SWIFFT_FileHashRead(int fd, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE], uint64_t *bytes)
+{
+	swifft_file_reader_t reader;
+	swifft_tree_t *tree = SWIFFT_TreeCreate();
+	pthread_t thread;
+	int i, last = 0, error = 0;
+	memset(&reader, 0, sizeof(reader));
+	reader.fd = fd;
+	reader.buffers[0] = (BitSequence *)aligned_alloc(SWIFFT_FILE_ALIGNMENT, SWIFFT_FILE_READ_SIZE);
+	reader.buffers[1] = (BitSequence *)aligned_alloc(SWIFFT_FILE_ALIGNMENT, SWIFFT_FILE_READ_SIZE);
+	pthread_mutex_init(&reader.mutex, NULL);
+	pthread_cond_init(&reader.cond, NULL);
+	if (tree == NULL || reader.buffers[0] == NULL || reader.buffers[1] == NULL) {
+		error = ENOMEM;
+	}
+	else if ((error = pthread_create(&thread, NULL, SWIFFT_FileReader, &reader)) == 0) {
+		*bytes = 0;
+		for (i=0; !last; i^=1) {
+			pthread_mutex_lock(&reader.mutex);
+			while (!reader.full[i] && !reader.error) {
+				pthread_cond_wait(&reader.cond, &reader.mutex);
+			}
+			error = reader.full[i] ? 0 : reader.error;
+			last = (error != 0 || (reader.eof && !reader.full[i ^ 1]));
+			pthread_mutex_unlock(&reader.mutex);
+			if (error != 0) {
+				break;
+			}
+			SWIFFT_TreeUpdate(tree, reader.buffers[i], reader.lens[i]);
+			*bytes += reader.lens[i];
+			pthread_mutex_lock(&reader.mutex);
+			reader.full[i] = 0;
+			pthread_cond_broadcast(&reader.cond);
+			pthread_mutex_unlock(&reader.mutex);
+		}
+		pthread_mutex_lock(&reader.mutex);
+		reader.stop = 1;
+		pthread_cond_broadcast(&reader.cond);
+		pthread_mutex_unlock(&reader.mutex);
+		pthread_join(thread, NULL);
+		if (error == 0) {
+			SWIFFT_TreeFinal(tree, digest);
+		}
+	}
+	pthread_mutex_destroy(&reader.mutex);
+	pthread_cond_destroy(&reader.cond);
+	free(reader.buffers[0]);
+	free(reader.buffers[1]);
+	SWIFFT_TreeDestroy(tree);
+	if (error != 0) {
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+//! \brief Computes the tree-hash of a regular file by mapping it.
+//!
+//! \param[in] fd the file descriptor.
+//! \param[in] offset the offset to hash from.
+//! \param[in] size the size of the file.
+//! \param[out] digest the digest.
+//! \returns 0 on success, 1 if the file could not be mapped, or -1 with errno set.
+static int SWIFFT_FileHashMapped(int fd, off_t offset, off_t size, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	const off_t start = offset / pageSize * pageSize;
+	const size_t len = (size_t)(size - start);
+	void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, start);
+	int result;
+	if (map == MAP_FAILED) {
+		return 1;
+	}
+	madvise(map, len, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+	madvise(map, len, MADV_HUGEPAGE);
+#endif
+	result = SWIFFT_TreeHash((const BitSequence *)map + (offset - start), (size_t)(size - offset), digest);
+	munmap(map, len);
+	if (result != 0) {
+		errno = ENOMEM;
+		return -1;
+	}
+	lseek(fd, size, SEEK_SET);
+	return 0;
+}
+
+int SWIFFT_TreeHashFd(int fd, int flags, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE], swifft_file_info_t *info)
+{
+	swifft_file_info_t local;
+	struct stat st;
+	off_t offset;
+	int fdflags = -1, result;
+	if (info == NULL) {
+		info = &local;
+	}
+	memset(info, 0, sizeof(swifft_file_info_t));
+	if (flags & SWIFFT_FILE_DIRECT) {
+		flags |= SWIFFT_FILE_NO_MAP;
+	}
+	if (!(flags & SWIFFT_FILE_NO_MAP) && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+		(offset = lseek(fd, 0, SEEK_CUR)) >= 0 && offset < st.st_size) {
+		result = SWIFFT_FileHashMapped(fd, offset, st.st_size, digest);
+		if (result <= 0) {
+			info->mapped = (result == 0);
+			info->bytes = (result == 0) ? (uint64_t)(st.st_size - offset) : 0;
+			return result;
+		}
+	}
+	if (flags & SWIFFT_FILE_DIRECT) {
+		fdflags = fcntl(fd, F_GETFL);
+		info->direct = (fdflags >= 0 && fcntl(fd, F_SETFL, fdflags | O_DIRECT) == 0);
+	}
+	result = SWIFFT_FileHashRead(fd, digest, &info->bytes);
+	if (info->direct) {
+		int error = errno;
+		fcntl(fd, F_SETFL, fdflags);
+		errno = error;
+	}
+	return result;
+}
+
+int SWIFFT_TreeHashFile(const char *path, int flags, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE], swifft_file_info_t *info)
+{
+	int fd = open(path, O_RDONLY);
+	int result, error;
+	if (fd < 0) {
+		return -1;
+	}
+	result = SWIFFT_TreeHashFd(fd, flags, digest, info);
+	error = errno;
+	close(fd);
+	errno = error;
+	return result;
+}
+
+LIBSWIFFT_END_EXTERN_C
@@ -8,8 +8,12 @@
  */
 
 #include "libswifft/swifft_common.h"
+#include "libswifft/swifft_executor.h"
 
-#if defined(__AVX512F__)
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+        #define SWIFFT_INSTRUCTION_SET AVX512BW
+        #define SWIFFT_VECTOR_LOG2_SIZE 5
+#elif defined(__AVX512F__)
         #define SWIFFT_INSTRUCTION_SET AVX512
         #define SWIFFT_VECTOR_LOG2_SIZE 5
 #elif defined(__AVX2__)
@@ -18,8 +22,11 @@
 #elif defined(__AVX__)
         #define SWIFFT_INSTRUCTION_SET AVX
         #define SWIFFT_VECTOR_LOG2_SIZE 3
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+        #define SWIFFT_INSTRUCTION_SET NEON
+        #define SWIFFT_VECTOR_LOG2_SIZE 3
 #else
-        #error "AVX, AVX2, or AVX512F must be enabled"
+        #error "AVX, AVX2, or AVX512F must be enabled, or NEON on AArch64"
 #endif
 #define SWIFFT_VECTOR_SIZE (1 << SWIFFT_VECTOR_LOG2_SIZE)
 
@@ -35,15 +42,241 @@
 #define SWIFFT_V (1<<SWIFFT_LOG2_V)            ///< Number of values in a byte
 
 #define SWIFFT_INT16(high,low) (((high) << SWIFFT_LOG2_V) | (low))   ///< Compose a 16-bit value from two 8-bit ones
+
 #define SWIFFT_AddSub(a, b) { b = a - b; a += a - b; }               ///< Replace a pair of numbers with their addition and subtraction
 
 
 LIBSWIFFT_BEGIN_EXTERN_C
 
 extern const BitSequence SWIFFT_sign0[SWIFFT_INPUT_BLOCK_SIZE];
+extern int SWIFFT_fftTableMode;
 
 extern const int16_t SWIFFT_multipliers[SWIFFT_N];
 extern const int16_t SWIFFT_fftTable[SWIFFT_V*SWIFFT_V*SWIFFT_W];
 extern const int16_t SWIFFT_PI_key[SWIFFT_M*SWIFFT_N];
+extern const int16_t SWIFFT_PI_keyPaired[SWIFFT_M*SWIFFT_N];
+extern const int16_t SWIFFT_fftTableSoA[SWIFFT_W*SWIFFT_W*2*SWIFFT_SOA_BLOCKS];
+
+//! \brief The read-only tables used by the kernels, either the static ones or a replica of them.
+typedef struct {
+	const int16_t *multipliers;        ///< SWIFFT_multipliers
+	const int16_t *fftTable;           ///< SWIFFT_fftTable
+	const int16_t *PI_key;             ///< SWIFFT_PI_key
+	const int16_t *PI_keyPaired;       ///< SWIFFT_PI_keyPaired
+	const int16_t *fftTableSoA;        ///< SWIFFT_fftTableSoA
+} swifft_tables_t;
+
+//! The size in bytes of a copy of the tables, each of which is a multiple of SWIFFT_ALIGNMENT
+#define SWIFFT_TABLES_SIZE (sizeof(SWIFFT_multipliers) + sizeof(SWIFFT_fftTable) + sizeof(SWIFFT_PI_key) + \
+	sizeof(SWIFFT_PI_keyPaired) + sizeof(SWIFFT_fftTableSoA))
+
+//! The size in bytes of the huge pages of a copy of the tables, for code including swifft_pool.h
+#define SWIFFT_TABLES_HUGE_SIZE ((SWIFFT_TABLES_SIZE + SWIFFT_POOL_HUGE_SIZE - 1) / SWIFFT_POOL_HUGE_SIZE * SWIFFT_POOL_HUGE_SIZE)
+
+//! \brief The static tables.
+extern const swifft_tables_t SWIFFT_staticTables;
+
+//! \brief The tables used by the kernels where there is no replica, the static ones unless
+//! SWIFFT_SetTablePages set a copy of them.
+extern const swifft_tables_t *SWIFFT_tables;
+
+//! \brief Copies the static tables, the FFT table first.
+//!
+//! \param[out] tables the copies.
+//! \param[out] memory the memory of the copies, of SWIFFT_TABLES_SIZE bytes, aligned to SWIFFT_ALIGNMENT.
+void SWIFFT_CopyTables(swifft_tables_t *tables, void *memory);
+
+//! \brief Maps memory aligned to a huge page, to be backed by huge pages.
+//!
+//! \param[in] size the size in bytes, a multiple of SWIFFT_POOL_HUGE_SIZE.
+//! \param[in] pages one of SWIFFT_POOL_PAGES_THP or SWIFFT_POOL_PAGES_HUGETLB.
+//! \returns the memory, to be unmapped by munmap, or NULL if it could not be mapped.
+void *SWIFFT_MapHugePages(size_t size, int pages);
+
+#ifdef SWIFFT_ENABLE_NUMA
+//! \brief The tables used by the calling thread, or NULL until it first uses them.
+//! The initial-exec model keeps the lookup a single load, also in the shared library.
+extern __thread const swifft_tables_t *SWIFFT_threadTables __attribute__((tls_model("initial-exec")));
+
+//! \brief Sets the tables used by the calling thread to the replica on the node it runs on, or to
+//! the static ones if there is none, replicating the tables on each node on first use.
+//!
+//! \returns the tables.
+const swifft_tables_t *SWIFFT_BindThreadTables(void);
+
+//! \brief Returns the tables used by the calling thread, binding them on first use.
+static inline const swifft_tables_t *SWIFFT_getTables(void)
+{
+	const swifft_tables_t *tables = SWIFFT_threadTables;
+	return (tables != NULL) ? tables : SWIFFT_BindThreadTables();
+}
+
+//! The table of the given name used by the calling thread, e.g. SWIFFT_TABLE(fftTable)
+#define SWIFFT_TABLE(name) (SWIFFT_getTables()->name)
+#else
+//! The table of the given name used by the calling thread, e.g. SWIFFT_TABLE(fftTable)
+#define SWIFFT_TABLE(name) (__atomic_load_n(&SWIFFT_tables, __ATOMIC_ACQUIRE)->name)
+#endif
+
+//! \brief Lists the CPUs the calling thread may run on, grouped by the NUMA node they are on.
+//!
+//! \param[in] maxcpus the maximum number of CPUs to list.
+//! \param[out] cpus the CPUs, maxcpus of them.
+//! \param[out] nodes the nodes of the CPUs, maxcpus of them, all 0 when not built with SWIFFT_ENABLE_NUMA.
+//! \returns the number of CPUs listed, at least 1.
+int SWIFFT_NumaCpus(int maxcpus, int *cpus, int *nodes);
+
+//! \brief Returns the NUMA node the calling thread runs on, or 0 when not built with SWIFFT_ENABLE_NUMA.
+int SWIFFT_NumaCurrentNode(void);
+
+//! \brief Looks up the NUMA nodes of pages of memory.
+//!
+//! \param[in] npages the number of pages.
+//! \param[in] pages the addresses of the pages, aligned to the page size.
+//! \param[out] nodes the nodes of the pages, or -1 for those not allocated yet or not known,
+//! which are all when not built with SWIFFT_ENABLE_NUMA.
+void SWIFFT_NumaPageNodes(int npages, const void **pages, int *nodes);
+
+//! \brief Runs a job over the blocks [0, nblocks) using the current executor, or on the calling
+//! thread if there is none or nblocks is at most the threshold of the kind of operation.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \param[in] nblocks the number of blocks.
+//! \param[in] unit the number of blocks the grain of the kind of operation is rounded up to a multiple of.
+//! \param[in] job the job.
+//! \param[in] context the context of the job.
+void SWIFFT_ParallelFor(int op, int nblocks, int unit, swifft_job_t job, void *context);
+
+//! \brief Runs a job as SWIFFT_ParallelFor does, with a hint of the blocks of memory it mainly reads,
+//! so that a NUMA-aware thread pool runs each range of blocks on the node the memory is on.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \param[in] nblocks the number of blocks.
+//! \param[in] unit the number of blocks the grain of the kind of operation is rounded up to a multiple of.
+//! \param[in] data the memory of block 0.
+//! \param[in] stride the distance in bytes between the memory of consecutive blocks.
+//! \param[in] job the job.
+//! \param[in] context the context of the job.
+void SWIFFT_ParallelForData(int op, int nblocks, int unit, const void *data, size_t stride, swifft_job_t job, void *context);
+
+#ifdef SWIFFT_ENABLE_STATS
+#include "libswifft/swifft_stats.h"
+
+//! \brief The statistics counted by a thread, padded to whole cache lines to avoid false sharing.
+typedef struct swifft_thread_stats {
+	//! \brief The counters, updated only by the owning thread.
+	swifft_op_stats_t op[SWIFFT_PARALLEL_NOPS];
+	//! \brief The counters at the last SWIFFT_ResetStats, updated only under the registry lock.
+	swifft_op_stats_t base[SWIFFT_PARALLEL_NOPS];
+	//! \brief The memo cache hits and misses, updated only by the owning thread.
+	uint64_t cacheHits, cacheMisses;
+	//! \brief The memo cache hits and misses at the last SWIFFT_ResetStats, updated only under the registry lock.
+	uint64_t baseCacheHits, baseCacheMisses;
+	//! \brief The bitmask of the kinds of operation being counted on the thread, by bit SWIFFT_PARALLEL_*.
+	int active;
+	//! \brief The next registered thread statistics.
+	struct swifft_thread_stats *next;
+} __attribute__((aligned(64))) swifft_thread_stats_t;
+
+//! \brief The current scope of counting an operation.
+typedef struct {
+	swifft_thread_stats_t *stats;   ///< The statistics of the thread, or NULL if the kind of operation is already counted
+	uint64_t start;                 ///< The TSC at the start of the scope
+} swifft_stats_scope_t;
+
+extern __thread swifft_thread_stats_t *SWIFFT_threadStats;
+
+//! \brief Allocates and registers the statistics of the calling thread.
+//!
+//! \returns the statistics, or NULL if they could not be allocated.
+swifft_thread_stats_t *SWIFFT_RegisterThreadStats(void);
+
+//! \brief Returns the statistics of the calling thread, registering them on first use.
+//!
+//! \returns the statistics, or NULL if they could not be allocated.
+static inline swifft_thread_stats_t *SWIFFT_getThreadStats(void)
+{
+	swifft_thread_stats_t *stats = SWIFFT_threadStats;
+	return (stats != NULL) ? stats : SWIFFT_RegisterThreadStats();
+}
+
+//! \brief Returns the TSC, or 0 unless built with SWIFFT_ENABLE_STATS_CYCLES.
+static inline uint64_t SWIFFT_statsCycles(void)
+{
+#if defined(SWIFFT_ENABLE_STATS_CYCLES) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+//! \brief Adds to a counter of the calling thread, which is read concurrently by SWIFFT_GetStats.
+#define SWIFFT_STATS_ADD(counter, value) \
+	__atomic_store_n(&(counter), __atomic_load_n(&(counter), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+
+//! \brief Starts counting an operation, unless one of its kind is already counted on the thread.
+//!
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \returns the scope of counting.
+static inline swifft_stats_scope_t SWIFFT_statsBegin(int op)
+{
+	swifft_stats_scope_t scope;
+	scope.stats = SWIFFT_getThreadStats();
+	if (scope.stats != NULL && (scope.stats->active & (1 << op))) {
+		scope.stats = NULL;
+	}
+	if (scope.stats != NULL) {
+		scope.stats->active |= (1 << op);
+	}
+	scope.start = SWIFFT_statsCycles();
+	return scope;
+}
+
+//! \brief Ends counting an operation.
+//!
+//! \param[in] scope the scope of counting, as returned by SWIFFT_statsBegin.
+//! \param[in] op the kind of operation, one of SWIFFT_PARALLEL_*.
+//! \param[in] nblocks the number of blocks processed.
+//! \param[in] nbytes the number of bytes of input read.
+static inline void SWIFFT_statsEnd(swifft_stats_scope_t scope, int op, uint64_t nblocks, uint64_t nbytes)
+{
+	swifft_op_stats_t *counters;
+	if (scope.stats == NULL) {
+		return;
+	}
+	counters = &scope.stats->op[op];
+	SWIFFT_STATS_ADD(counters->calls, 1);
+	SWIFFT_STATS_ADD(counters->blocks, nblocks);
+	SWIFFT_STATS_ADD(counters->bytes, nbytes);
+#ifdef SWIFFT_ENABLE_STATS_CYCLES
+	SWIFFT_STATS_ADD(counters->cycles, SWIFFT_statsCycles() - scope.start);
+#endif
+	scope.stats->active &= ~(1 << op);
+}
+
+//! \brief Counts memo cache hits and misses.
+//!
+//! \param[in] hits the number of blocks found.
+//! \param[in] misses the number of blocks computed.
+static inline void SWIFFT_statsCache(uint64_t hits, uint64_t misses)
+{
+	swifft_thread_stats_t *stats = SWIFFT_getThreadStats();
+	if (stats != NULL) {
+		SWIFFT_STATS_ADD(stats->cacheHits, hits);
+		SWIFFT_STATS_ADD(stats->cacheMisses, misses);
+	}
+}
+
+//! Starts counting an operation of a kind, in a scope ended by SWIFFT_STATS_END in the same block
+#define SWIFFT_STATS_BEGIN(op) swifft_stats_scope_t SWIFFT_statsScope = SWIFFT_statsBegin(op)
+//! Ends counting an operation of a kind, started by SWIFFT_STATS_BEGIN
+#define SWIFFT_STATS_END(op, nblocks, nbytes) SWIFFT_statsEnd(SWIFFT_statsScope, (op), (nblocks), (nbytes))
+//! Counts memo cache hits and misses
+#define SWIFFT_STATS_CACHE(hits, misses) SWIFFT_statsCache((hits), (misses))
+#else
+#define SWIFFT_STATS_BEGIN(op) (void)0
+#define SWIFFT_STATS_END(op, nblocks, nbytes) (void)0
+#define SWIFFT_STATS_CACHE(hits, misses) (void)0
+#endif
 
 LIBSWIFFT_END_EXTERN_C
@@ -159,6 +159,17 @@ static SWIFFT_ALIGN int16_t PI_key[SWIFFT_M*SWIFFT_N] = {
 };
 
 
+//! \brief SWIFFT key paired for the structure-of-arrays kernel.
+//! The key elements multiplying the same output element of two consecutive 8-element columns are
+//! adjacent, so that a single 32-bit broadcast picks up the pair for a multiply-accumulate.
+static SWIFFT_ALIGN int16_t PI_keyPaired[SWIFFT_M*SWIFFT_N];
+//! \brief FFT table for the structure-of-arrays kernel.
+//! For each row k and element j, holds the entries of the FFT table for the low 5 bits and for the
+//! high 3 bits of an input byte, multiplied by the multiplier of row k and element j, so that
+//! the entry for a byte is the sum of two in-register lookups of SWIFFT_SOA_BLOCKS entries.
+static SWIFFT_ALIGN int16_t fftTableSoA[SWIFFT_W*SWIFFT_W*2*SWIFFT_SOA_BLOCKS];
+
+
 //! \brief Centers a mod-257 number around 0.
 //! \param[in] x the mod-257 number.
 //! \returns x - 257 if x > 257/2, x + 257 if x < -257/2, otherwise x.
@@ -240,6 +251,29 @@ static void SWIFFT_Initialize()
 	for (j=0; j<SWIFFT_N*SWIFFT_M; j++) {
 		PI_key[j] = Center(PI_key[j]);
 	}
+
+	for (i = 0; i < SWIFFT_M; ++i)
+	{
+		for (j = 0; j < SWIFFT_N; ++j)
+		{
+			PI_keyPaired[((i >> 1) * SWIFFT_N + j) * 2 + (i & 1)] = PI_key[i * SWIFFT_N + j];
+		}
+	}
+
+	for (k = 0; k < SWIFFT_W; ++k)
+	{
+		for (j = 0; j < SWIFFT_W; ++j)
+		{
+			int16_t *lo = fftTableSoA + ((k * SWIFFT_W + j) * 2) * SWIFFT_SOA_BLOCKS;
+			int16_t *hi = lo + SWIFFT_SOA_BLOCKS;
+			int multiplier = multipliers[(k << SWIFFT_LOG2_W) + j];
+			for (x = 0; x < SWIFFT_SOA_BLOCKS; ++x)
+			{
+				lo[x] = Center(fftTable[(x << SWIFFT_LOG2_W) + j] * multiplier);
+				hi[x] = (x < (SWIFFT_V >> 5)) ? Center(fftTable[((x << 5) << SWIFFT_LOG2_W) + j] * multiplier) : 0;
+			}
+		}
+	}
 }
 
 
@@ -284,5 +318,9 @@ int main(int argc, char **argv)
 	writeArray(out, fftTable, SWIFFT_V*SWIFFT_V*SWIFFT_W, "fftTable[SWIFFT_V*SWIFFT_V*SWIFFT_W]");
 	out << std::endl;
 	writeArray(out, PI_key, SWIFFT_M*SWIFFT_N, "PI_key[SWIFFT_M*SWIFFT_N]");
+	out << std::endl;
+	writeArray(out, PI_keyPaired, SWIFFT_M*SWIFFT_N, "PI_keyPaired[SWIFFT_M*SWIFFT_N]");
+	out << std::endl;
+	writeArray(out, fftTableSoA, SWIFFT_W*SWIFFT_W*2*SWIFFT_SOA_BLOCKS, "fftTableSoA[SWIFFT_W*SWIFFT_W*2*SWIFFT_SOA_BLOCKS]");
 	return 0;
 }
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_numa.c
+ * \brief LibSWIFFT NUMA public C implementation
+ *
+ * The replicas of the tables are made once, on first use by any thread, in one
+ * allocation per node bound to that node, so that where the copying thread runs
+ * does not matter. They live as long as the process, as the static tables do.
+ * A thread binds to the replica of the node it first uses the tables on, which
+ * the threads of a NUMA-aware pool do not leave.
+ */
+
+#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE // for sched_getaffinity, sched_getcpu
+#endif
+#include <sched.h>
+#include "libswifft/swifft_numa.h"
+#include "libswifft/swifft_pool.h"
+#include "swifft_impl.inl"
+
+#ifdef SWIFFT_ENABLE_NUMA
+#include <numa.h>
+#include <numaif.h> // for move_pages
+#include <pthread.h>
+#include <stdlib.h> // for calloc
+#endif
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+#ifdef SWIFFT_ENABLE_NUMA
+
+__thread const swifft_tables_t *SWIFFT_threadTables __attribute__((tls_model("initial-exec"))) = NULL;
+
+static swifft_tables_t *SWIFFT_numaReplicas = NULL;               ///< The replicas, per node, or NULL on a machine with one node
+static int SWIFFT_numaNreplicas = 0;                              ///< The number of entries of SWIFFT_numaReplicas
+static pthread_once_t SWIFFT_numaReplicasOnce = PTHREAD_ONCE_INIT; ///< Makes the replicas once
+
+//! \brief Allocates a replica of the tables on a node, backed by the pages set by SWIFFT_SetTablePages.
+//!
+//! \param[in] node the node.
+//! \returns the memory of the replica, or NULL if it could not be allocated.
+static void *SWIFFT_NumaAllocTables(int node)
+{
+	const int pages = SWIFFT_GetTablePages();
+	void *memory;
+	if (pages == SWIFFT_POOL_PAGES_DEFAULT) {
+		return numa_alloc_onnode(SWIFFT_TABLES_SIZE, node);
+	}
+	memory = SWIFFT_MapHugePages(SWIFFT_TABLES_HUGE_SIZE, pages);
+	if (memory != NULL) {
+		// binding before the replica is first touched
+		numa_tonode_memory(memory, SWIFFT_TABLES_HUGE_SIZE, node);
+	}
+	return memory;
+}
+
+//! \brief Makes the replicas of the tables on each node memory may be allocated on.
+static void SWIFFT_NumaReplicate(void)
+{
+	swifft_tables_t *replicas;
+	int node, nnodes;
+	if (numa_available() < 0 || numa_num_configured_nodes() <= 1) {
+		return;
+	}
+	nnodes = numa_max_node() + 1;
+	replicas = (swifft_tables_t *)calloc(nnodes, sizeof(swifft_tables_t));
+	if (replicas == NULL) {
+		return;
+	}
+	for (node=0; node<nnodes; node++) {
+		void *memory;
+		if (!numa_bitmask_isbitset(numa_all_nodes_ptr, node) || (memory = SWIFFT_NumaAllocTables(node)) == NULL) {
+			replicas[node] = *SWIFFT_tables;
+			continue;
+		}
+		SWIFFT_CopyTables(&replicas[node], memory);
+	}
+	SWIFFT_numaReplicas = replicas;
+	SWIFFT_numaNreplicas = nnodes;
+}
+
+const swifft_tables_t *SWIFFT_BindThreadTables(void)
+{
+	const swifft_tables_t *tables = __atomic_load_n(&SWIFFT_tables, __ATOMIC_ACQUIRE);
+	int node;
+	pthread_once(&SWIFFT_numaReplicasOnce, SWIFFT_NumaReplicate);
+	if (SWIFFT_numaReplicas != NULL && (node = SWIFFT_NumaCurrentNode()) < SWIFFT_numaNreplicas) {
+		tables = &SWIFFT_numaReplicas[node];
+	}
+	SWIFFT_threadTables = tables;
+	return tables;
+}
+
+//! \brief Returns the NUMA node of a CPU, or 0 if it is not known.
+static int SWIFFT_NumaNodeOfCpu(int cpu)
+{
+	int node = (cpu >= 0 && numa_available() >= 0) ? numa_node_of_cpu(cpu) : -1;
+	return (node >= 0) ? node : 0;
+}
+
+void SWIFFT_NumaPageNodes(int npages, const void **pages, int *nodes)
+{
+	int i;
+	if (numa_available() < 0 || move_pages(0, npages, (void **)pages, NULL, nodes, 0) != 0) {
+		for (i=0; i<npages; i++) {
+			nodes[i] = -1;
+		}
+		return;
+	}
+	for (i=0; i<npages; i++) {
+		if (nodes[i] < 0) {
+			nodes[i] = -1; // e.g. -ENOENT for a page not allocated yet
+		}
+	}
+}
+
+#else
+
+//! \brief Returns the NUMA node of a CPU, which is 0 when not built with SWIFFT_ENABLE_NUMA.
+static int SWIFFT_NumaNodeOfCpu(int cpu)
+{
+	(void)cpu;
+	return 0;
+}
+
+void SWIFFT_NumaPageNodes(int npages, const void **pages, int *nodes)
+{
+	int i;
+	(void)pages;
+	for (i=0; i<npages; i++) {
+		nodes[i] = -1;
+	}
+}
+
+#endif
+
+int SWIFFT_NumaCurrentNode(void)
+{
+	return SWIFFT_NumaNodeOfCpu(sched_getcpu());
+}
+
+int SWIFFT_NumaCpus(int maxcpus, int *cpus, int *nodes)
+{
+	cpu_set_t set;
+	int cpu, n = 0, i, j;
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		for (cpu=0; cpu<CPU_SETSIZE && n<maxcpus; cpu++) {
+			if (CPU_ISSET(cpu, &set)) {
+				cpus[n] = cpu;
+				nodes[n] = SWIFFT_NumaNodeOfCpu(cpu);
+				n++;
+			}
+		}
+	}
+	if (n == 0) {
+		cpu = sched_getcpu();
+		cpus[0] = (cpu >= 0) ? cpu : 0;
+		nodes[0] = SWIFFT_NumaNodeOfCpu(cpus[0]);
+		n = 1;
+	}
+	// insertion sort by node, keeping the CPUs of a node in order
+	for (i=1; i<n; i++) {
+		int c = cpus[i], d = nodes[i];
+		for (j=i; j>0 && nodes[j-1]>d; j--) {
+			cpus[j] = cpus[j-1];
+			nodes[j] = nodes[j-1];
+		}
+		cpus[j] = c;
+		nodes[j] = d;
+	}
+	return n;
+}
+
+int SWIFFT_NumaNodes(void)
+{
+	int cpus[CPU_SETSIZE], nodes[CPU_SETSIZE];
+	int i, n = SWIFFT_NumaCpus(CPU_SETSIZE, cpus, nodes), nnodes = 1;
+	for (i=1; i<n; i++) {
+		nnodes += (nodes[i] != nodes[i-1]);
+	}
+	return nnodes;
+}
+
+LIBSWIFFT_END_EXTERN_C
@@ -6,7 +6,8 @@
 /*! \file src/swifft_object.c
  * \brief LibSWIFFT object public C implementation
  *
- * Implementation using the best instruction set available at build time.
+ * Implementation of object initializers for each instruction set, including
+ * one using the best instruction set supported by the running CPU.
  */
 
 #include "libswifft/swifft_object.h"
@@ -15,29 +16,74 @@
 #undef SWIFFT_ISET
 #include "swifft_object.inl"
 
-#if defined(__AVX__)
-	#include "libswifft/swifft_avx.h"
-        #define SWIFFT_ISET() AVX
-        #include "swifft_object.inl"
-        #undef SWIFFT_ISET
-#else
-        #pragma message "LibSWIFFT API for AVX is disabled"
+#if defined(__x86_64__) || defined(__i386__)
+
+#include "libswifft/swifft_avx.h"
+#define SWIFFT_ISET() AVX
+#define SWIFFT_CPU_SUPPORTS() __builtin_cpu_supports("avx")
+#include "swifft_object.inl"
+#undef SWIFFT_CPU_SUPPORTS
+#undef SWIFFT_ISET
+
+#include "libswifft/swifft_avx2.h"
+#define SWIFFT_ISET() AVX2
+#define SWIFFT_CPU_SUPPORTS() __builtin_cpu_supports("avx2")
+#include "swifft_object.inl"
+#undef SWIFFT_CPU_SUPPORTS
+#undef SWIFFT_ISET
+
+#include "libswifft/swifft_avx512.h"
+#define SWIFFT_ISET() AVX512
+#define SWIFFT_CPU_SUPPORTS() __builtin_cpu_supports("avx512f")
+#include "swifft_object.inl"
+#undef SWIFFT_CPU_SUPPORTS
+#undef SWIFFT_ISET
+
+#include "libswifft/swifft_avx512bw.h"
+#define SWIFFT_ISET() AVX512BW
+#define SWIFFT_CPU_SUPPORTS() (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+#include "swifft_object.inl"
+#undef SWIFFT_CPU_SUPPORTS
+#undef SWIFFT_ISET
+
+#elif defined(__aarch64__)
+
+#include <sys/auxv.h> // for getauxval
+#ifndef HWCAP_ASIMD
+	#define HWCAP_ASIMD (1 << 1)   ///< The bit of AT_HWCAP for NEON (Advanced SIMD)
 #endif
 
-#if defined(__AVX2__)
-	#include "libswifft/swifft_avx2.h"
-        #define SWIFFT_ISET() AVX2
-        #include "swifft_object.inl"
-        #undef SWIFFT_ISET
-#else
-        #pragma message "LibSWIFFT API for AVX2 is disabled"
+#include "libswifft/swifft_neon.h"
+#define SWIFFT_ISET() NEON
+#define SWIFFT_CPU_SUPPORTS() ((getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0)
+#include "swifft_object.inl"
+#undef SWIFFT_CPU_SUPPORTS
+#undef SWIFFT_ISET
+
 #endif
 
-#if defined(__AVX512F__)
-	#include "libswifft/swifft_avx512.h"
-        #define SWIFFT_ISET() AVX512
-        #include "swifft_object.inl"
-        #undef SWIFFT_ISET
+LIBSWIFFT_BEGIN_EXTERN_C
+
+void SWIFFT_InitBestObject(swifft_object_t *swifft)
+{
+#if defined(__aarch64__)
+	// NEON is the minimum instruction set the library supports on AArch64
+	SWIFFT_InitObject_NEON(swifft);
 #else
-        #pragma message "LibSWIFFT API for AVX512 is disabled"
+	if (SWIFFT_IsSupported_AVX512BW()) {
+		SWIFFT_InitObject_AVX512BW(swifft);
+	}
+	else if (SWIFFT_IsSupported_AVX512()) {
+		SWIFFT_InitObject_AVX512(swifft);
+	}
+	else if (SWIFFT_IsSupported_AVX2()) {
+		SWIFFT_InitObject_AVX2(swifft);
+	}
+	else {
+		// AVX is the minimum instruction set the library supports
+		SWIFFT_InitObject_AVX(swifft);
+	}
 #endif
+}
+
+LIBSWIFFT_END_EXTERN_C
@@ -6,7 +6,8 @@
 /*! \file src/swifft_object.inl
  * \brief LibSWIFFT object internal C implementation
  *
- * Implementation using the best instruction set available at build time.
+ * Implementation for the instruction set given by SWIFFT_ISET, or for the
+ * runtime-dispatched API when SWIFFT_ISET is undefined.
  */
 
 #include "libswifft/swifft_common.h"
@@ -49,6 +50,14 @@ void SWIFFT_ISET_NAME(SWIFFT_InitArithObject)(swifft_arith_object_t *swifft_arit
 	swifft_arith->SWIFFT_AddMultiple = SWIFFT_ISET_NAME(SWIFFT_AddMultiple);
 	swifft_arith->SWIFFT_SubMultiple = SWIFFT_ISET_NAME(SWIFFT_SubMultiple);
 	swifft_arith->SWIFFT_MulMultiple = SWIFFT_ISET_NAME(SWIFFT_MulMultiple);
+	swifft_arith->SWIFFT_SumMultiple = SWIFFT_ISET_NAME(SWIFFT_SumMultiple);
+	swifft_arith->SWIFFT_LinearCombination = SWIFFT_ISET_NAME(SWIFFT_LinearCombination);
+	swifft_arith->SWIFFT_AddMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_AddMultipleStrided);
+	swifft_arith->SWIFFT_AddMultipleGather = SWIFFT_ISET_NAME(SWIFFT_AddMultipleGather);
+	swifft_arith->SWIFFT_SubMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_SubMultipleStrided);
+	swifft_arith->SWIFFT_SubMultipleGather = SWIFFT_ISET_NAME(SWIFFT_SubMultipleGather);
+	swifft_arith->SWIFFT_MulMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_MulMultipleStrided);
+	swifft_arith->SWIFFT_MulMultipleGather = SWIFFT_ISET_NAME(SWIFFT_MulMultipleGather);
 }
 
 void SWIFFT_ISET_NAME(SWIFFT_InitHashObject)(swifft_hash_object_t *swifft_hash)
@@ -59,6 +68,36 @@ void SWIFFT_ISET_NAME(SWIFFT_InitHashObject)(swifft_hash_object_t *swifft_hash)
 	swifft_hash->SWIFFT_CompactMultiple = SWIFFT_ISET_NAME(SWIFFT_CompactMultiple);
 	swifft_hash->SWIFFT_ComputeMultiple = SWIFFT_ISET_NAME(SWIFFT_ComputeMultiple);
 	swifft_hash->SWIFFT_ComputeMultipleSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSigned);
+	swifft_hash->SWIFFT_ComputeMultipleSignMask = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignMask);
+	swifft_hash->SWIFFT_ComputeMultipleUniformSign = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleUniformSign);
+	swifft_hash->SWIFFT_ComputeWithKey = SWIFFT_ISET_NAME(SWIFFT_ComputeWithKey);
+	swifft_hash->SWIFFT_ComputeWithKeySigned = SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeySigned);
+	swifft_hash->SWIFFT_ComputeWithKeyMultiple = SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultiple);
+	swifft_hash->SWIFFT_ComputeWithKeyMultipleSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeWithKeyMultipleSigned);
+	swifft_hash->SWIFFT_ComputeMultiKey = SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKey);
+	swifft_hash->SWIFFT_ComputeMultiKeySigned = SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeySigned);
+	swifft_hash->SWIFFT_ComputeMultiKeyMultiple = SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultiple);
+	swifft_hash->SWIFFT_ComputeMultiKeyMultipleSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeMultiKeyMultipleSigned);
+	swifft_hash->SWIFFT_Update = SWIFFT_ISET_NAME(SWIFFT_Update);
+	swifft_hash->SWIFFT_UpdateSigned = SWIFFT_ISET_NAME(SWIFFT_UpdateSigned);
+	swifft_hash->SWIFFT_UpdateMultiple = SWIFFT_ISET_NAME(SWIFFT_UpdateMultiple);
+	swifft_hash->SWIFFT_ComputeSparse = SWIFFT_ISET_NAME(SWIFFT_ComputeSparse);
+	swifft_hash->SWIFFT_ComputeShort = SWIFFT_ISET_NAME(SWIFFT_ComputeShort);
+	swifft_hash->SWIFFT_ComputeShortSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeShortSigned);
+	swifft_hash->SWIFFT_ComputeSparseMultiple = SWIFFT_ISET_NAME(SWIFFT_ComputeSparseMultiple);
+	swifft_hash->SWIFFT_ComputeMultipleSoA = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSoA);
+	swifft_hash->SWIFFT_ComputeCompact = SWIFFT_ISET_NAME(SWIFFT_ComputeCompact);
+	swifft_hash->SWIFFT_ComputeCompactSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeCompactSigned);
+	swifft_hash->SWIFFT_ComputeCompactMultiple = SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultiple);
+	swifft_hash->SWIFFT_ComputeCompactMultipleSigned = SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleSigned);
+	swifft_hash->SWIFFT_ComputeMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleStrided);
+	swifft_hash->SWIFFT_ComputeMultipleSignedStrided = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedStrided);
+	swifft_hash->SWIFFT_ComputeCompactMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleStrided);
+	swifft_hash->SWIFFT_CompactMultipleStrided = SWIFFT_ISET_NAME(SWIFFT_CompactMultipleStrided);
+	swifft_hash->SWIFFT_ComputeMultipleGather = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleGather);
+	swifft_hash->SWIFFT_ComputeMultipleSignedGather = SWIFFT_ISET_NAME(SWIFFT_ComputeMultipleSignedGather);
+	swifft_hash->SWIFFT_ComputeCompactMultipleGather = SWIFFT_ISET_NAME(SWIFFT_ComputeCompactMultipleGather);
+	swifft_hash->SWIFFT_CompactMultipleGather = SWIFFT_ISET_NAME(SWIFFT_CompactMultipleGather);
 }
 
 void SWIFFT_ISET_NAME(SWIFFT_InitObject)(swifft_object_t *swifft)
@@ -68,4 +107,14 @@ void SWIFFT_ISET_NAME(SWIFFT_InitObject)(swifft_object_t *swifft)
 	SWIFFT_ISET_NAME(SWIFFT_InitHashObject)(&swifft->hash);
 }
 
+#ifdef SWIFFT_ISET
+int SWIFFT_ISET_NAME(SWIFFT_IsSupported)(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+#endif
+	return SWIFFT_CPU_SUPPORTS();
+}
+#endif
+
 LIBSWIFFT_END_EXTERN_C
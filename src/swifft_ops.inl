@@ -74,6 +74,17 @@ static inline ZOvec SWIFFT_modP(ZOvec x)
 	return tmp ^ ((tmp == ZO_M1) & ZO_M257);
 }
 
+//! \brief Reduces a SWIFFT vector element-wise mod-257 to the range {-128,..,128}, where products of
+//! two elements fit in 16 bits.
+//! \param[in] x the SWIFFT vector.
+//! \returns the reduced SWIFFT vector.
+static inline ZOvec SWIFFT_center(ZOvec x)
+{
+	ZOvec ZO_128 = ZOCONST(128), ZO_257 = ZOCONST(257);
+	ZOvec tmp = SWIFFT_qReduce(SWIFFT_qReduce(x));
+	return tmp - ((tmp > ZO_128) & ZO_257);
+}
+
 //! \brief Safely multiply two SWIFFT vectors element-wise in the range [-128..128] * [0..256]
 //! Overflow (which happens only for 128 * 256) is adjusted mod SWIFFT_P.
 //! This method corrects for one specific case of overflow only, relying on SWIFFT_qReduce to limit the parameter range
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_pool.c
+ * \brief LibSWIFFT memory pool public C implementation
+ *
+ * Each chunk starts with a header of SWIFFT_ALIGNMENT bytes recording how to
+ * reuse and release it, followed by the memory returned. A thread only ever
+ * touches its own free lists, which live in thread-local storage, so reusing
+ * a chunk takes no lock. A key destructor releases the free lists of an
+ * exiting thread.
+ *
+ * The copies of the tables set by SWIFFT_SetTablePages are made once per kind
+ * of pages and live as long as the process, as the static tables do, since
+ * kernels running concurrently may still read a replaced copy.
+ */
+
+#include <pthread.h>
+#include <stdint.h> // for uintptr_t
+#include <stdlib.h> // for aligned_alloc, free
+#include <string.h> // for memcpy
+#include <sys/mman.h>
+#include "libswifft/swifft_pool.h"
+#include "swifft_impl.inl"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+#define SWIFFT_POOL_MIN_LOG2 12        ///< The log base-2 size in bytes of the smallest chunk
+#define SWIFFT_POOL_CLASSES ((int)(sizeof(size_t) * 8) - SWIFFT_POOL_MIN_LOG2) ///< The number of chunk sizes, the largest being half the address space
+#define SWIFFT_POOL_HEADER SWIFFT_ALIGNMENT ///< The size in bytes of the header of a chunk
+
+//! \brief The header of a chunk.
+typedef struct swifft_pool_chunk {
+	struct swifft_pool_chunk *next; ///< The next free chunk of the same size
+	size_t mapped;                  ///< The length of the mapping of the chunk, or 0 if not mapped
+	int cls;                        ///< The log base-2 size of the chunk, less SWIFFT_POOL_MIN_LOG2
+} swifft_pool_chunk_t;
+
+//! \brief The free lists of a thread.
+typedef struct {
+	swifft_pool_chunk_t *free[SWIFFT_POOL_CLASSES]; ///< The free chunks, per size
+	int nfree[SWIFFT_POOL_CLASSES];                 ///< The number of free chunks, per size
+	int registered;                                 ///< Whether the key destructor is set for the thread
+} swifft_thread_pool_t;
+
+static __thread swifft_thread_pool_t SWIFFT_threadPool;              ///< The free lists of the thread
+static int SWIFFT_poolPages = SWIFFT_POOL_PAGES_DEFAULT;             ///< The pages backing new chunks
+static pthread_key_t SWIFFT_poolKey;                                 ///< The key whose destructor releases the free lists of a thread
+static pthread_once_t SWIFFT_poolKeyOnce = PTHREAD_ONCE_INIT;        ///< Creates SWIFFT_poolKey once
+
+const swifft_tables_t SWIFFT_staticTables = {
+	SWIFFT_multipliers, SWIFFT_fftTable, SWIFFT_PI_key, SWIFFT_PI_keyPaired, SWIFFT_fftTableSoA
+};
+const swifft_tables_t *SWIFFT_tables = &SWIFFT_staticTables;
+
+static pthread_mutex_t SWIFFT_tablesMutex = PTHREAD_MUTEX_INITIALIZER; ///< Serializes SWIFFT_SetTablePages
+static swifft_tables_t SWIFFT_tableCopies[SWIFFT_POOL_PAGES_HUGETLB + 1]; ///< The copies of the tables, per pages, with NULL tables until made
+static int SWIFFT_tablePages = SWIFFT_POOL_PAGES_DEFAULT;               ///< The pages backing SWIFFT_tables
+
+//! \brief Releases a chunk to the system.
+//!
+//! \param[in] chunk the chunk.
+static void SWIFFT_ReleaseChunk(swifft_pool_chunk_t *chunk)
+{
+	if (chunk->mapped) {
+		munmap(chunk, chunk->mapped);
+	} else {
+		free(chunk);
+	}
+}
+
+//! \brief Releases the free chunks of a thread.
+//!
+//! \param[in] value the free lists of the thread.
+static void SWIFFT_ReleaseThreadPool(void *value)
+{
+	swifft_thread_pool_t *pool = (swifft_thread_pool_t *)value;
+	int cls;
+	for (cls=0; cls<SWIFFT_POOL_CLASSES; cls++) {
+		while (pool->free[cls] != NULL) {
+			swifft_pool_chunk_t *chunk = pool->free[cls];
+			pool->free[cls] = chunk->next;
+			SWIFFT_ReleaseChunk(chunk);
+		}
+		pool->nfree[cls] = 0;
+	}
+	pool->registered = 0;
+}
+
+//! \brief Creates the key whose destructor releases the free lists of a thread.
+static void SWIFFT_CreatePoolKey(void)
+{
+	pthread_key_create(&SWIFFT_poolKey, SWIFFT_ReleaseThreadPool);
+}
+
+void *SWIFFT_MapHugePages(size_t size, int pages)
+{
+	size_t len = size + SWIFFT_POOL_HUGE_SIZE;
+	char *map, *aligned;
+#ifdef MAP_HUGETLB
+	if (pages == SWIFFT_POOL_PAGES_HUGETLB) {
+		map = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (map != MAP_FAILED) {
+			return map;
+		}
+	}
+#else
+	(void)pages;
+#endif
+	// over-map by a huge page and trim to align to one, so the chunk may be backed by whole huge pages
+	map = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+	aligned = (char *)(((uintptr_t)map + SWIFFT_POOL_HUGE_SIZE - 1) & ~(uintptr_t)(SWIFFT_POOL_HUGE_SIZE - 1));
+	if (aligned != map) {
+		munmap(map, aligned - map);
+	}
+	if (aligned + size != map + len) {
+		munmap(aligned + size, map + len - (aligned + size));
+	}
+#ifdef MADV_HUGEPAGE
+	madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+	return aligned;
+}
+
+void *SWIFFT_PoolAlloc(size_t size)
+{
+	swifft_thread_pool_t *pool = &SWIFFT_threadPool;
+	swifft_pool_chunk_t *chunk;
+	size_t chunkSize;
+	int cls = 0, pages;
+	if (size > ((size_t)1 << (SWIFFT_POOL_MIN_LOG2 + SWIFFT_POOL_CLASSES - 1)) - SWIFFT_POOL_HEADER) {
+		return NULL;
+	}
+	while (((size_t)1 << (SWIFFT_POOL_MIN_LOG2 + cls)) - SWIFFT_POOL_HEADER < size) {
+		cls++;
+	}
+	chunk = pool->free[cls];
+	if (chunk != NULL) {
+		pool->free[cls] = chunk->next;
+		pool->nfree[cls]--;
+		return (char *)chunk + SWIFFT_POOL_HEADER;
+	}
+	chunkSize = (size_t)1 << (SWIFFT_POOL_MIN_LOG2 + cls);
+	pages = __atomic_load_n(&SWIFFT_poolPages, __ATOMIC_RELAXED);
+	if (pages != SWIFFT_POOL_PAGES_DEFAULT && chunkSize >= SWIFFT_POOL_HUGE_SIZE) {
+		chunk = (swifft_pool_chunk_t *)SWIFFT_MapHugePages(chunkSize, pages);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->mapped = chunkSize;
+	} else {
+		chunk = (swifft_pool_chunk_t *)aligned_alloc(SWIFFT_ALIGNMENT, chunkSize);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->mapped = 0;
+	}
+	chunk->next = NULL;
+	chunk->cls = cls;
+	return (char *)chunk + SWIFFT_POOL_HEADER;
+}
+
+void SWIFFT_PoolFree(void *ptr)
+{
+	swifft_thread_pool_t *pool = &SWIFFT_threadPool;
+	swifft_pool_chunk_t *chunk;
+	if (ptr == NULL) {
+		return;
+	}
+	chunk = (swifft_pool_chunk_t *)((char *)ptr - SWIFFT_POOL_HEADER);
+	if (pool->nfree[chunk->cls] >= SWIFFT_POOL_MAX_CACHED) {
+		SWIFFT_ReleaseChunk(chunk);
+		return;
+	}
+	if (!pool->registered) {
+		pthread_once(&SWIFFT_poolKeyOnce, SWIFFT_CreatePoolKey);
+		pthread_setspecific(SWIFFT_poolKey, pool);
+		pool->registered = 1;
+	}
+	chunk->next = pool->free[chunk->cls];
+	pool->free[chunk->cls] = chunk;
+	pool->nfree[chunk->cls]++;
+}
+
+void SWIFFT_PoolTrim(void)
+{
+	SWIFFT_ReleaseThreadPool(&SWIFFT_threadPool);
+}
+
+size_t SWIFFT_PoolCachedBytes(void)
+{
+	const swifft_thread_pool_t *pool = &SWIFFT_threadPool;
+	size_t bytes = 0;
+	int cls;
+	for (cls=0; cls<SWIFFT_POOL_CLASSES; cls++) {
+		bytes += (size_t)pool->nfree[cls] << (SWIFFT_POOL_MIN_LOG2 + cls);
+	}
+	return bytes;
+}
+
+int SWIFFT_SetPoolPages(int pages)
+{
+	if (pages != SWIFFT_POOL_PAGES_DEFAULT && pages != SWIFFT_POOL_PAGES_THP && pages != SWIFFT_POOL_PAGES_HUGETLB) {
+		return -1;
+	}
+	__atomic_store_n(&SWIFFT_poolPages, pages, __ATOMIC_RELAXED);
+	return 0;
+}
+
+int SWIFFT_GetPoolPages(void)
+{
+	return __atomic_load_n(&SWIFFT_poolPages, __ATOMIC_RELAXED);
+}
+
+//! \brief Copies a table.
+//!
+//! \param[in,out] next the next free element of the copies, advanced past the copy.
+//! \param[in] table the table.
+//! \param[in] size the size in bytes of the table.
+//! \returns the copy.
+static const int16_t *SWIFFT_CopyTable(int16_t **next, const int16_t *table, size_t size)
+{
+	int16_t *copy = *next;
+	memcpy(copy, table, size);
+	*next += size / sizeof(int16_t);
+	return copy;
+}
+
+void SWIFFT_CopyTables(swifft_tables_t *tables, void *memory)
+{
+	int16_t *next = (int16_t *)memory;
+	// the FFT table first, for it to start at a huge page when the memory does
+	tables->fftTable = SWIFFT_CopyTable(&next, SWIFFT_fftTable, sizeof(SWIFFT_fftTable));
+	tables->multipliers = SWIFFT_CopyTable(&next, SWIFFT_multipliers, sizeof(SWIFFT_multipliers));
+	tables->PI_key = SWIFFT_CopyTable(&next, SWIFFT_PI_key, sizeof(SWIFFT_PI_key));
+	tables->PI_keyPaired = SWIFFT_CopyTable(&next, SWIFFT_PI_keyPaired, sizeof(SWIFFT_PI_keyPaired));
+	tables->fftTableSoA = SWIFFT_CopyTable(&next, SWIFFT_fftTableSoA, sizeof(SWIFFT_fftTableSoA));
+}
+
+int SWIFFT_SetTablePages(int pages)
+{
+	swifft_tables_t *copy;
+	if (pages != SWIFFT_POOL_PAGES_DEFAULT && pages != SWIFFT_POOL_PAGES_THP && pages != SWIFFT_POOL_PAGES_HUGETLB) {
+		return -1;
+	}
+	pthread_mutex_lock(&SWIFFT_tablesMutex);
+	copy = &SWIFFT_tableCopies[pages];
+	if (pages != SWIFFT_POOL_PAGES_DEFAULT && copy->fftTable == NULL) {
+		void *memory = SWIFFT_MapHugePages(SWIFFT_TABLES_HUGE_SIZE, pages);
+		if (memory == NULL) {
+			pthread_mutex_unlock(&SWIFFT_tablesMutex);
+			return -1;
+		}
+		SWIFFT_CopyTables(copy, memory);
+	}
+	__atomic_store_n(&SWIFFT_tables, (pages == SWIFFT_POOL_PAGES_DEFAULT) ? &SWIFFT_staticTables : copy, __ATOMIC_RELEASE);
+	__atomic_store_n(&SWIFFT_tablePages, pages, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&SWIFFT_tablesMutex);
+	return 0;
+}
+
+int SWIFFT_GetTablePages(void)
+{
+	return __atomic_load_n(&SWIFFT_tablePages, __ATOMIC_RELAXED);
+}
+
+LIBSWIFFT_END_EXTERN_C
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_queue.c
+ * \brief LibSWIFFT asynchronous queue public C implementation
+ *
+ * The pending batches are held in a ring of depth slots. A batch keeps its slot
+ * until it has completed, so that the depth bounds the buffers in use. Since
+ * the thread of the queue computes the batches one after the other, they
+ * complete in order, and a ticket has completed iff it is below the number of
+ * completed batches.
+ *
+ * The batches are not run concurrently on the executor, since that would nest
+ * a ParallelFor within the job of another, which an executor provided by the
+ * caller need not support.
+ */
+
+#include <pthread.h>
+#include <stdlib.h> // for calloc, free
+#include "libswifft/swifft_queue.h"
+#include "libswifft/swifft.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The state of a queue.
+struct swifft_queue {
+	pthread_t thread;          ///< The thread computing the batches
+	pthread_mutex_t mutex;     ///< Protects the fields below
+	pthread_cond_t submitted;  ///< Signaled when a batch is submitted or the queue is closing
+	pthread_cond_t completed;  ///< Broadcast when a batch has completed
+	swifft_batch_t *slots;     ///< The ring of pending batches
+	int depth;                 ///< The number of slots
+	int closing;               ///< Whether the queue is being destroyed
+	int64_t nsubmitted;        ///< The number of batches submitted
+	int64_t ncompleted;        ///< The number of batches completed
+};
+
+//! \brief Computes a batch.
+//!
+//! \param[in] batch the batch.
+static void SWIFFT_QueueCompute(const swifft_batch_t *batch)
+{
+	if (batch->compact) {
+		if (batch->sign != NULL) {
+			SWIFFT_ComputeCompactMultipleSigned(batch->nblocks, batch->input, batch->sign, batch->output);
+		}
+		else {
+			SWIFFT_ComputeCompactMultiple(batch->nblocks, batch->input, batch->output);
+		}
+	}
+	else {
+		if (batch->sign != NULL) {
+			SWIFFT_ComputeMultipleSigned(batch->nblocks, batch->input, batch->sign, batch->output);
+		}
+		else {
+			SWIFFT_ComputeMultiple(batch->nblocks, batch->input, batch->output);
+		}
+	}
+}
+
+//! \brief Runs the thread of a queue, computing its batches in order until it is closing and empty.
+//!
+//! \param[in] arg the queue.
+//! \returns NULL.
+static void *SWIFFT_QueueThread(void *arg)
+{
+	swifft_queue_t *queue = (swifft_queue_t *)arg;
+	swifft_batch_t batch;
+	int64_t ticket;
+	pthread_mutex_lock(&queue->mutex);
+	for (;;) {
+		while (queue->ncompleted == queue->nsubmitted && !queue->closing) {
+			pthread_cond_wait(&queue->submitted, &queue->mutex);
+		}
+		if (queue->ncompleted == queue->nsubmitted) {
+			break;
+		}
+		ticket = queue->ncompleted;
+		batch = queue->slots[ticket % queue->depth];
+		pthread_mutex_unlock(&queue->mutex);
+		SWIFFT_QueueCompute(&batch);
+		if (batch.callback != NULL) {
+			batch.callback(batch.context, ticket);
+		}
+		pthread_mutex_lock(&queue->mutex);
+		queue->ncompleted++;
+		pthread_cond_broadcast(&queue->completed);
+	}
+	pthread_mutex_unlock(&queue->mutex);
+	return NULL;
+}
+
+//! \brief Frees the resources of a queue whose thread is not running.
+//!
+//! \param[in] queue the queue.
+static void SWIFFT_QueueFree(swifft_queue_t *queue)
+{
+	pthread_mutex_destroy(&queue->mutex);
+	pthread_cond_destroy(&queue->submitted);
+	pthread_cond_destroy(&queue->completed);
+	free(queue->slots);
+	free(queue);
+}
+
+swifft_queue_t *SWIFFT_CreateQueue(int depth)
+{
+	swifft_queue_t *queue;
+	if (depth <= 0) {
+		depth = SWIFFT_QUEUE_DEFAULT_DEPTH;
+	}
+	queue = (swifft_queue_t *)calloc(1, sizeof(swifft_queue_t));
+	if (queue == NULL) {
+		return NULL;
+	}
+	queue->depth = depth;
+	queue->slots = (swifft_batch_t *)calloc(depth, sizeof(swifft_batch_t));
+	pthread_mutex_init(&queue->mutex, NULL);
+	pthread_cond_init(&queue->submitted, NULL);
+	pthread_cond_init(&queue->completed, NULL);
+	if (queue->slots == NULL || pthread_create(&queue->thread, NULL, SWIFFT_QueueThread, queue) != 0) {
+		SWIFFT_QueueFree(queue);
+		return NULL;
+	}
+	return queue;
+}
+
+void SWIFFT_DestroyQueue(swifft_queue_t *queue)
+{
+	if (queue == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&queue->mutex);
+	queue->closing = 1;
+	pthread_cond_signal(&queue->submitted);
+	pthread_mutex_unlock(&queue->mutex);
+	pthread_join(queue->thread, NULL);
+	SWIFFT_QueueFree(queue);
+}
+
+//! \brief Submits a batch to a queue, if it is not full or waiting is allowed.
+//!
+//! \param[in] queue the queue.
+//! \param[in] batch the batch.
+//! \param[in] wait whether to wait while the queue is full.
+//! \returns the ticket of the batch, or -1 if it was not submitted.
+static int64_t SWIFFT_QueueSubmitBatch(swifft_queue_t *queue, const swifft_batch_t *batch, int wait)
+{
+	int64_t ticket = -1;
+	if (batch->nblocks < 0) {
+		return -1;
+	}
+	pthread_mutex_lock(&queue->mutex);
+	while (wait && queue->nsubmitted - queue->ncompleted == queue->depth) {
+		pthread_cond_wait(&queue->completed, &queue->mutex);
+	}
+	if (queue->nsubmitted - queue->ncompleted < queue->depth) {
+		ticket = queue->nsubmitted++;
+		queue->slots[ticket % queue->depth] = *batch;
+		pthread_cond_signal(&queue->submitted);
+	}
+	pthread_mutex_unlock(&queue->mutex);
+	return ticket;
+}
+
+int64_t SWIFFT_QueueSubmit(swifft_queue_t *queue, const swifft_batch_t *batch)
+{
+	return SWIFFT_QueueSubmitBatch(queue, batch, 1);
+}
+
+int64_t SWIFFT_QueueTrySubmit(swifft_queue_t *queue, const swifft_batch_t *batch)
+{
+	return SWIFFT_QueueSubmitBatch(queue, batch, 0);
+}
+
+int SWIFFT_QueuePoll(swifft_queue_t *queue, int64_t ticket)
+{
+	int done;
+	pthread_mutex_lock(&queue->mutex);
+	done = (ticket < queue->ncompleted);
+	pthread_mutex_unlock(&queue->mutex);
+	return done;
+}
+
+void SWIFFT_QueueWait(swifft_queue_t *queue, int64_t ticket)
+{
+	pthread_mutex_lock(&queue->mutex);
+	while (ticket >= queue->ncompleted && ticket < queue->nsubmitted) {
+		pthread_cond_wait(&queue->completed, &queue->mutex);
+	}
+	pthread_mutex_unlock(&queue->mutex);
+}
+
+void SWIFFT_QueueWaitAll(swifft_queue_t *queue)
+{
+	pthread_mutex_lock(&queue->mutex);
+	while (queue->ncompleted < queue->nsubmitted) {
+		pthread_cond_wait(&queue->completed, &queue->mutex);
+	}
+	pthread_mutex_unlock(&queue->mutex);
+}
+
+LIBSWIFFT_END_EXTERN_C
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_runtime_key.c
+ * \brief LibSWIFFT runtime key public C implementation
+ */
+
+#include <string.h> // for memcpy
+#include "libswifft/swifft_runtime_key.h"
+#include "libswifft/swifft_stream.h"
+#include "swifft_impl.inl"
+
+#define SWIFFT_KEY_SEED_DOMAIN "LibSWIFFT key"      ///< The domain separation prefix of the seed expansion
+#define SWIFFT_KEY_SEED_BOUND (SWIFFT_P * 255)      ///< The bound of accepted 16-bit words, a multiple of 257
+
+LIBSWIFFT_STATIC_ASSERT(SWIFFT_KEY_SIZE == SWIFFT_M*SWIFFT_N, SWIFFT_KEY_SIZE_must_match_SWIFFT_M_N);
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Centers a mod-257 number around 0, as in the generation of the PI key.
+//! \param[in] x the mod-257 number.
+//! \returns the number equal to x modulo 257 in [-128,128].
+static int16_t SWIFFT_KeyCenter(int x)
+{
+	int result = x % SWIFFT_P;
+	if (result > (SWIFFT_P >> 1)) {
+		result -= SWIFFT_P;
+	}
+	else if (result < -(SWIFFT_P >> 1)) {
+		result += SWIFFT_P;
+	}
+	return (int16_t)result;
+}
+
+void SWIFFT_InitKey(swifft_key_t *key, const int16_t elements[SWIFFT_KEY_SIZE])
+{
+	int i;
+	for (i=0; i<SWIFFT_KEY_SIZE; i++) {
+		key->elements[i] = SWIFFT_KeyCenter(elements[i]);
+	}
+}
+
+void SWIFFT_InitKeyPI(swifft_key_t *key)
+{
+	memcpy(key->elements, SWIFFT_PI_key, sizeof(key->elements));
+}
+
+void SWIFFT_InitKeyFromSeed(swifft_key_t *key, const void *seed, size_t len)
+{
+	SWIFFT_ALIGN int16_t elements[SWIFFT_KEY_SIZE];
+	BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE];
+	BitSequence counterBytes[4];
+	swifft_stream_t stream, expand;
+	uint32_t counter;
+	int i, n = 0;
+
+	SWIFFT_StreamInit(&stream);
+	SWIFFT_StreamUpdate(&stream, SWIFFT_KEY_SEED_DOMAIN, sizeof(SWIFFT_KEY_SEED_DOMAIN));
+	SWIFFT_StreamUpdate(&stream, seed, len);
+	for (counter=0; n<SWIFFT_KEY_SIZE; counter++) {
+		// continue from the state after the seed, then append the big-endian counter
+		expand = stream;
+		for (i=0; i<4; i++) {
+			counterBytes[i] = (BitSequence)(counter >> (8 * (3 - i)));
+		}
+		SWIFFT_StreamUpdate(&expand, counterBytes, sizeof(counterBytes));
+		SWIFFT_StreamFinal(&expand, digest);
+		for (i=0; i<SWIFFT_COMPACT_BLOCK_SIZE && n<SWIFFT_KEY_SIZE; i+=2) {
+			int word = digest[i] | (digest[i + 1] << 8);
+			if (word < SWIFFT_KEY_SEED_BOUND) {
+				elements[n++] = (int16_t)(word % SWIFFT_P);
+			}
+		}
+	}
+	SWIFFT_InitKey(key, elements);
+}
+
+LIBSWIFFT_END_EXTERN_C
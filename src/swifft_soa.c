@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_soa.c
+ * \brief LibSWIFFT structure-of-arrays public C implementation
+ */
+
+#include <string.h> // for memset
+#include "libswifft/swifft_soa.h"
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Transposes blocks of elements between the array-of-structures and structure-of-arrays layouts.
+//!
+//! \param[in] nblocks the number of blocks.
+//! \param[in] nelements the number of elements per block.
+//! \param[in] esize the size in bytes of an element.
+//! \param[in] toSoA whether to convert to the structure-of-arrays layout, rather than from it.
+//! \param[in] from the blocks to convert.
+//! \param[out] to the converted blocks.
+static void SWIFFT_TransposeSoA(int nblocks, int nelements, int esize, int toSoA,
+	const BitSequence * from, BitSequence * to)
+{
+	int b, e, c;
+	size_t batchSize = (size_t)SWIFFT_SOA_BLOCKS * nelements * esize;
+	if (toSoA && nblocks % SWIFFT_SOA_BLOCKS != 0) {
+		// the padding blocks of the last batch are all-zero
+		memset(to + (size_t)(nblocks / SWIFFT_SOA_BLOCKS) * batchSize, 0, batchSize);
+	}
+	for (b=0; b<nblocks; b++) {
+		const size_t aos = (size_t)b * nelements * esize;
+		const size_t soa = (size_t)(b / SWIFFT_SOA_BLOCKS) * batchSize + (size_t)(b % SWIFFT_SOA_BLOCKS) * esize;
+		for (e=0; e<nelements; e++) {
+			for (c=0; c<esize; c++) {
+				if (toSoA) {
+					to[soa + (size_t)e * SWIFFT_SOA_BLOCKS * esize + c] = from[aos + (size_t)e * esize + c];
+				}
+				else {
+					to[aos + (size_t)e * esize + c] = from[soa + (size_t)e * SWIFFT_SOA_BLOCKS * esize + c];
+				}
+			}
+		}
+	}
+}
+
+void SWIFFT_InputToSoA(int nblocks, const BitSequence * input, BitSequence * soaInput)
+{
+	SWIFFT_TransposeSoA(nblocks, SWIFFT_INPUT_BLOCK_SIZE, 1, 1, input, soaInput);
+}
+
+void SWIFFT_InputFromSoA(int nblocks, const BitSequence * soaInput, BitSequence * input)
+{
+	SWIFFT_TransposeSoA(nblocks, SWIFFT_INPUT_BLOCK_SIZE, 1, 0, soaInput, input);
+}
+
+void SWIFFT_OutputToSoA(int nblocks, const BitSequence * output, BitSequence * soaOutput)
+{
+	SWIFFT_TransposeSoA(nblocks, SWIFFT_OUTPUT_BLOCK_SIZE / 2, 2, 1, output, soaOutput);
+}
+
+void SWIFFT_OutputFromSoA(int nblocks, const BitSequence * soaOutput, BitSequence * output)
+{
+	SWIFFT_TransposeSoA(nblocks, SWIFFT_OUTPUT_BLOCK_SIZE / 2, 2, 0, soaOutput, output);
+}
+
+LIBSWIFFT_END_EXTERN_C
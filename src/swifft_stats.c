@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_stats.c
+ * \brief LibSWIFFT statistics public C implementation
+ *
+ * Each thread registers its counters on first use in a list, from which they
+ * are aggregated. A thread only ever writes its own counters, so counting takes
+ * no lock nor atomic read-modify-write. Resetting records the current counters
+ * as a base to subtract, rather than writing them, and the counters of exiting
+ * threads are folded into those of the registry.
+ */
+
+#include <string.h> // for memset
+#include "libswifft/swifft_stats.h"
+#include "swifft_impl.inl"
+
+#ifdef SWIFFT_ENABLE_STATS
+#include <pthread.h>
+#include <stdlib.h> // for aligned_alloc, free
+#endif
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+#ifdef SWIFFT_ENABLE_STATS
+
+__thread swifft_thread_stats_t *SWIFFT_threadStats = NULL;
+
+static pthread_mutex_t SWIFFT_statsMutex = PTHREAD_MUTEX_INITIALIZER; ///< Protects the fields below
+static swifft_thread_stats_t *SWIFFT_statsThreads = NULL;             ///< The registered thread statistics
+static swifft_stats_t SWIFFT_statsExited;                             ///< The statistics of exited threads since the last reset
+static pthread_key_t SWIFFT_statsKey;                                 ///< The key whose destructor unregisters a thread
+static pthread_once_t SWIFFT_statsKeyOnce = PTHREAD_ONCE_INIT;        ///< Creates SWIFFT_statsKey once
+
+//! \brief Adds to the statistics the counters of a thread, less their base.
+//!
+//! \param[in,out] total the statistics.
+//! \param[in] stats the statistics of the thread.
+static void SWIFFT_AddThreadStats(swifft_stats_t *total, const swifft_thread_stats_t *stats)
+{
+	swifft_op_stats_t *sum = total->op;
+	int op;
+	total->cacheHits += __atomic_load_n(&stats->cacheHits, __ATOMIC_RELAXED) - stats->baseCacheHits;
+	total->cacheMisses += __atomic_load_n(&stats->cacheMisses, __ATOMIC_RELAXED) - stats->baseCacheMisses;
+	for (op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		const swifft_op_stats_t *counters = &stats->op[op];
+		const swifft_op_stats_t *base = &stats->base[op];
+		sum[op].calls += __atomic_load_n(&counters->calls, __ATOMIC_RELAXED) - base->calls;
+		sum[op].blocks += __atomic_load_n(&counters->blocks, __ATOMIC_RELAXED) - base->blocks;
+		sum[op].bytes += __atomic_load_n(&counters->bytes, __ATOMIC_RELAXED) - base->bytes;
+		sum[op].cycles += __atomic_load_n(&counters->cycles, __ATOMIC_RELAXED) - base->cycles;
+		sum[op].serialRuns += __atomic_load_n(&counters->serialRuns, __ATOMIC_RELAXED) - base->serialRuns;
+		sum[op].parallelRuns += __atomic_load_n(&counters->parallelRuns, __ATOMIC_RELAXED) - base->parallelRuns;
+	}
+}
+
+//! \brief Folds the statistics of an exiting thread into those of the registry and frees them.
+//!
+//! \param[in] value the statistics of the thread.
+static void SWIFFT_UnregisterThreadStats(void *value)
+{
+	swifft_thread_stats_t *stats = (swifft_thread_stats_t *)value;
+	swifft_thread_stats_t **link;
+	pthread_mutex_lock(&SWIFFT_statsMutex);
+	SWIFFT_AddThreadStats(&SWIFFT_statsExited, stats);
+	for (link=&SWIFFT_statsThreads; *link!=stats; link=&(*link)->next) {
+	}
+	*link = stats->next;
+	pthread_mutex_unlock(&SWIFFT_statsMutex);
+	SWIFFT_threadStats = NULL;
+	free(stats);
+}
+
+//! \brief Creates the key whose destructor unregisters a thread.
+static void SWIFFT_CreateStatsKey(void)
+{
+	pthread_key_create(&SWIFFT_statsKey, SWIFFT_UnregisterThreadStats);
+}
+
+swifft_thread_stats_t *SWIFFT_RegisterThreadStats(void)
+{
+	swifft_thread_stats_t *stats = (swifft_thread_stats_t *)aligned_alloc(64, sizeof(swifft_thread_stats_t));
+	if (stats == NULL) {
+		return NULL;
+	}
+	memset(stats, 0, sizeof(swifft_thread_stats_t));
+	pthread_once(&SWIFFT_statsKeyOnce, SWIFFT_CreateStatsKey);
+	pthread_mutex_lock(&SWIFFT_statsMutex);
+	stats->next = SWIFFT_statsThreads;
+	SWIFFT_statsThreads = stats;
+	pthread_mutex_unlock(&SWIFFT_statsMutex);
+	pthread_setspecific(SWIFFT_statsKey, stats);
+	SWIFFT_threadStats = stats;
+	return stats;
+}
+
+int SWIFFT_GetStats(swifft_stats_t *stats)
+{
+	const swifft_thread_stats_t *thread;
+	memset(stats, 0, sizeof(swifft_stats_t));
+	pthread_mutex_lock(&SWIFFT_statsMutex);
+	*stats = SWIFFT_statsExited;
+	for (thread=SWIFFT_statsThreads; thread!=NULL; thread=thread->next) {
+		SWIFFT_AddThreadStats(stats, thread);
+	}
+	pthread_mutex_unlock(&SWIFFT_statsMutex);
+	return 0;
+}
+
+void SWIFFT_ResetStats(void)
+{
+	swifft_thread_stats_t *thread;
+	int op;
+	pthread_mutex_lock(&SWIFFT_statsMutex);
+	memset(&SWIFFT_statsExited, 0, sizeof(SWIFFT_statsExited));
+	for (thread=SWIFFT_statsThreads; thread!=NULL; thread=thread->next) {
+		thread->baseCacheHits = __atomic_load_n(&thread->cacheHits, __ATOMIC_RELAXED);
+		thread->baseCacheMisses = __atomic_load_n(&thread->cacheMisses, __ATOMIC_RELAXED);
+		for (op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+			const swifft_op_stats_t *counters = &thread->op[op];
+			swifft_op_stats_t *base = &thread->base[op];
+			base->calls = __atomic_load_n(&counters->calls, __ATOMIC_RELAXED);
+			base->blocks = __atomic_load_n(&counters->blocks, __ATOMIC_RELAXED);
+			base->bytes = __atomic_load_n(&counters->bytes, __ATOMIC_RELAXED);
+			base->cycles = __atomic_load_n(&counters->cycles, __ATOMIC_RELAXED);
+			base->serialRuns = __atomic_load_n(&counters->serialRuns, __ATOMIC_RELAXED);
+			base->parallelRuns = __atomic_load_n(&counters->parallelRuns, __ATOMIC_RELAXED);
+		}
+	}
+	pthread_mutex_unlock(&SWIFFT_statsMutex);
+}
+
+#else
+
+int SWIFFT_GetStats(swifft_stats_t *stats)
+{
+	memset(stats, 0, sizeof(swifft_stats_t));
+	return -1;
+}
+
+void SWIFFT_ResetStats(void)
+{
+}
+
+#endif
+
+LIBSWIFFT_END_EXTERN_C
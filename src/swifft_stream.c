@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_stream.c
+ * \brief LibSWIFFT streaming public C implementation
+ */
+
+#include <string.h> // for memcpy, memset
+#include "libswifft/swifft_stream.h"
+#include "libswifft/swifft.h"
+#include "swifft_impl.inl"
+
+#define SWIFFT_STREAM_STATE_M (SWIFFT_COMPACT_BLOCK_SIZE/8)   ///< Number of 8-element columns of the state
+#define SWIFFT_STREAM_CHUNK_M (SWIFFT_STREAM_CHUNK_SIZE/8)    ///< Number of 8-element columns of a chunk
+#define SWIFFT_STREAM_LENGTH_SIZE 8                           ///< The size in bytes of the message bit-length in the padding
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief Replaces the state with the compact-form of the SWIFFT of the state followed by a chunk.
+//! The FFT phase is computed separately for the columns of the state and those of the chunk, which
+//! is possible since each column is transformed independently, so the chunk is read in place.
+//!
+//! \param[in,out] state the state, in compact-form.
+//! \param[in] chunk the chunk of SWIFFT_STREAM_CHUNK_SIZE bytes, with no alignment requirement.
+static void SWIFFT_StreamCompress(BitSequence state[SWIFFT_COMPACT_BLOCK_SIZE], const BitSequence *chunk)
+{
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M];
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_fft(state, SWIFFT_sign0, SWIFFT_STREAM_STATE_M, fftout);
+	SWIFFT_fft(chunk, SWIFFT_sign0, SWIFFT_STREAM_CHUNK_M, fftout + SWIFFT_N*SWIFFT_STREAM_STATE_M);
+	SWIFFT_fftsum(SWIFFT_PI_key, fftout, SWIFFT_M, (int16_t *)output);
+	SWIFFT_Compact(output, state);
+}
+
+void SWIFFT_StreamInit(swifft_stream_t *stream)
+{
+	memset(stream->state, 0, sizeof(stream->state));
+	stream->buffered = 0;
+	stream->length = 0;
+}
+
+void SWIFFT_StreamUpdate(swifft_stream_t *stream, const void *data, size_t len)
+{
+	const BitSequence *bytes = (const BitSequence *)data;
+	stream->length += len;
+	if (stream->buffered > 0) {
+		size_t n = SWIFFT_STREAM_CHUNK_SIZE - stream->buffered;
+		if (n > len) {
+			n = len;
+		}
+		memcpy(stream->buffer + stream->buffered, bytes, n);
+		stream->buffered += n;
+		bytes += n;
+		len -= n;
+		if (stream->buffered < SWIFFT_STREAM_CHUNK_SIZE) {
+			return;
+		}
+		SWIFFT_StreamCompress(stream->state, stream->buffer);
+		stream->buffered = 0;
+	}
+	for (; len >= SWIFFT_STREAM_CHUNK_SIZE; bytes += SWIFFT_STREAM_CHUNK_SIZE, len -= SWIFFT_STREAM_CHUNK_SIZE) {
+		SWIFFT_StreamCompress(stream->state, bytes);
+	}
+	memcpy(stream->buffer, bytes, len);
+	stream->buffered = len;
+}
+
+void SWIFFT_StreamFinal(swifft_stream_t *stream, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	int i;
+	uint64_t bitLength = stream->length * 8;
+	stream->buffer[stream->buffered++] = 0x80;
+	if (stream->buffered > SWIFFT_STREAM_CHUNK_SIZE - SWIFFT_STREAM_LENGTH_SIZE) {
+		memset(stream->buffer + stream->buffered, 0, SWIFFT_STREAM_CHUNK_SIZE - stream->buffered);
+		SWIFFT_StreamCompress(stream->state, stream->buffer);
+		stream->buffered = 0;
+	}
+	memset(stream->buffer + stream->buffered, 0, SWIFFT_STREAM_CHUNK_SIZE - SWIFFT_STREAM_LENGTH_SIZE - stream->buffered);
+	for (i=0; i<SWIFFT_STREAM_LENGTH_SIZE; i++) {
+		stream->buffer[SWIFFT_STREAM_CHUNK_SIZE - 1 - i] = (BitSequence)(bitLength >> (8 * i));
+	}
+	SWIFFT_StreamCompress(stream->state, stream->buffer);
+	stream->buffered = 0;
+	memcpy(digest, stream->state, SWIFFT_COMPACT_BLOCK_SIZE);
+}
+
+void SWIFFT_StreamHash(const void *data, size_t len, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	swifft_stream_t stream;
+	SWIFFT_StreamInit(&stream);
+	SWIFFT_StreamUpdate(&stream, data, len);
+	SWIFFT_StreamFinal(&stream, digest);
+}
+
+LIBSWIFFT_END_EXTERN_C
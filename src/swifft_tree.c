@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/swifft_tree.c
+ * \brief LibSWIFFT tree-hash public C implementation
+ *
+ * The message is processed in batches of SWIFFT_TREE_BATCH blocks, each reduced
+ * level by level to a single node of level SWIFFT_TREE_LOG4_BATCH. These nodes
+ * are then combined using a stack holding the pending nodes of each level.
+ */
+
+#include <stdlib.h> // for aligned_alloc, free
+#include <string.h> // for memcpy, memset
+#include "libswifft/swifft_tree.h"
+#include "libswifft/swifft.h"
+
+#define SWIFFT_TREE_BATCH (1 << (2 * SWIFFT_TREE_LOG4_BATCH))                ///< Number of blocks of the message in a batch
+#define SWIFFT_TREE_ARITY (SWIFFT_INPUT_BLOCK_SIZE / SWIFFT_COMPACT_BLOCK_SIZE) ///< Number of nodes packed in a block
+#define SWIFFT_TREE_MAX_LEVELS 32                                            ///< Maximum number of levels above the batch level
+#define SWIFFT_TREE_LENGTH_SIZE 8                                            ///< The size in bytes of the message bit-length in the root block
+
+LIBSWIFFT_STATIC_ASSERT(SWIFFT_TREE_ARITY == 4, SWIFFT_TREE_ARITY_must_be_4);
+
+LIBSWIFFT_BEGIN_EXTERN_C
+
+//! \brief The buffers for processing a batch.
+typedef struct {
+	BitSequence *outputs;   ///< SWIFFT_TREE_BATCH hash values
+	BitSequence *nodes;     ///< SWIFFT_TREE_BATCH nodes, in compact-form
+	int16_t *constants;     ///< SWIFFT_TREE_BATCH constants
+} swifft_tree_work_t;
+
+//! \brief Computes the nodes of a level from the blocks packing the nodes of the level below.
+//! The nodes are padded with all-zero nodes to a whole number of blocks.
+//!
+//! \param[in,out] work the buffers, whose nodes are replaced.
+//! \param[in] blocks the blocks, possibly the nodes of the buffers.
+//! \param[in] nblocks the number of blocks.
+//! \param[in] level the level of the computed nodes.
+static void SWIFFT_TreeLevel(swifft_tree_work_t *work, const BitSequence *blocks, int nblocks, int level)
+{
+	int i;
+	int npad = (SWIFFT_TREE_ARITY - nblocks % SWIFFT_TREE_ARITY) % SWIFFT_TREE_ARITY;
+	SWIFFT_ComputeMultiple(nblocks, blocks, work->outputs);
+	if (level > 0) {
+		for (i=0; i<nblocks; i++) {
+			work->constants[i] = (int16_t)level;
+		}
+		SWIFFT_ConstAddMultiple(nblocks, work->outputs, work->constants);
+	}
+	SWIFFT_CompactMultiple(nblocks, work->outputs, work->nodes);
+	memset(work->nodes + nblocks * SWIFFT_COMPACT_BLOCK_SIZE, 0, npad * SWIFFT_COMPACT_BLOCK_SIZE);
+}
+
+//! \brief Reduces a batch of the message to nodes of a level.
+//!
+//! \param[in,out] work the buffers, whose nodes are replaced by the resulting ones.
+//! \param[in] data the bytes of the batch.
+//! \param[in] len the number of bytes of the batch, at most SWIFFT_TREE_BATCH blocks.
+//! \param[in] levels the level to reduce to, or -1 to reduce to a single node.
+//! \returns the number of resulting nodes.
+static int SWIFFT_TreeBatch(swifft_tree_work_t *work, const BitSequence *data, size_t len, int levels)
+{
+	int level, n;
+	int nfull = (int)(len / SWIFFT_INPUT_BLOCK_SIZE);
+	size_t rem = len % SWIFFT_INPUT_BLOCK_SIZE;
+	SWIFFT_ALIGN BitSequence last[SWIFFT_INPUT_BLOCK_SIZE];
+
+	// the full blocks are read in place, the last partial one from a padded copy
+	SWIFFT_ComputeCompactMultiple(nfull, data, work->nodes);
+	n = nfull;
+	if (rem > 0 || nfull == 0) {
+		memcpy(last, data + (size_t)nfull * SWIFFT_INPUT_BLOCK_SIZE, rem);
+		memset(last + rem, 0, SWIFFT_INPUT_BLOCK_SIZE - rem);
+		SWIFFT_ComputeCompact(last, work->nodes + (size_t)nfull * SWIFFT_COMPACT_BLOCK_SIZE);
+		n++;
+	}
+	memset(work->nodes + n * SWIFFT_COMPACT_BLOCK_SIZE, 0,
+		((SWIFFT_TREE_ARITY - n % SWIFFT_TREE_ARITY) % SWIFFT_TREE_ARITY) * SWIFFT_COMPACT_BLOCK_SIZE);
+
+	for (level=0; (levels >= 0) ? (level < levels) : (n > 1); level++) {
+		n = (n + SWIFFT_TREE_ARITY - 1) / SWIFFT_TREE_ARITY;
+		SWIFFT_TreeLevel(work, work->nodes, n, level + 1);
+	}
+	return n;
+}
+
+//! \brief Computes the node of a level from a block packing nodes of the level below.
+//!
+//! \param[in] block the block.
+//! \param[in] level the level of the computed node.
+//! \param[out] node the computed node.
+static void SWIFFT_TreeNode(const BitSequence block[SWIFFT_INPUT_BLOCK_SIZE], int16_t level,
+	BitSequence node[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	SWIFFT_Compute(block, output);
+	SWIFFT_ConstAdd(output, level);
+	SWIFFT_Compact(output, node);
+}
+
+//! \brief Pushes a node to the stack of pending nodes, combining any full block of pending nodes.
+//!
+//! \param[in,out] pending the blocks of pending nodes, per level above the batch level.
+//! \param[in,out] npending the number of pending nodes, per level above the batch level.
+//! \param[in] k the level of the node, above the batch level.
+//! \param[in] node the node.
+static void SWIFFT_TreePush(BitSequence pending[][SWIFFT_INPUT_BLOCK_SIZE], int *npending, int k,
+	const BitSequence node[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN BitSequence parent[SWIFFT_COMPACT_BLOCK_SIZE];
+	memcpy(pending[k] + npending[k] * SWIFFT_COMPACT_BLOCK_SIZE, node, SWIFFT_COMPACT_BLOCK_SIZE);
+	if (++npending[k] == SWIFFT_TREE_ARITY) {
+		SWIFFT_TreeNode(pending[k], (int16_t)(SWIFFT_TREE_LOG4_BATCH + k + 1), parent);
+		npending[k] = 0;
+		SWIFFT_TreePush(pending, npending, k + 1, parent);
+	}
+}
+
+//! \brief Allocates the buffers for processing a batch.
+//!
+//! \param[out] work the buffers.
+//! \returns 0 on success, or -1 if they could not be allocated, in which case none are.
+static int SWIFFT_TreeAlloc(swifft_tree_work_t *work)
+{
+	work->outputs = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, (size_t)SWIFFT_TREE_BATCH * SWIFFT_OUTPUT_BLOCK_SIZE);
+	work->nodes = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, (size_t)SWIFFT_TREE_BATCH * SWIFFT_COMPACT_BLOCK_SIZE);
+	work->constants = (int16_t *)aligned_alloc(SWIFFT_ALIGNMENT, (size_t)SWIFFT_TREE_BATCH * sizeof(int16_t));
+	if (work->outputs == NULL || work->nodes == NULL || work->constants == NULL) {
+		free(work->outputs);
+		free(work->nodes);
+		free(work->constants);
+		return -1;
+	}
+	return 0;
+}
+
+//! \brief Frees the buffers for processing a batch.
+//!
+//! \param[in] work the buffers.
+static void SWIFFT_TreeFree(swifft_tree_work_t *work)
+{
+	free(work->outputs);
+	free(work->nodes);
+	free(work->constants);
+}
+
+//! \brief Combines the pending nodes of a message of more than one batch into its single top node.
+//!
+//! \param[in,out] pending the blocks of pending nodes, per level above the batch level.
+//! \param[in,out] npending the number of pending nodes, per level above the batch level.
+//! \param[in] nbatches the number of batches of the message, all pushed.
+//! \param[out] root the block whose first node is set to the top node.
+static void SWIFFT_TreeTop(BitSequence pending[][SWIFFT_INPUT_BLOCK_SIZE], int *npending, uint64_t nbatches,
+	BitSequence root[SWIFFT_INPUT_BLOCK_SIZE])
+{
+	uint64_t n = nbatches;
+	int k;
+	// complete the last, partial, block of pending nodes of each level up to a level of one node
+	for (k=0; n > 1; k++) {
+		n = (n + SWIFFT_TREE_ARITY - 1) / SWIFFT_TREE_ARITY;
+		if (npending[k] > 0) {
+			SWIFFT_ALIGN BitSequence parent[SWIFFT_COMPACT_BLOCK_SIZE];
+			memset(pending[k] + npending[k] * SWIFFT_COMPACT_BLOCK_SIZE, 0,
+				(SWIFFT_TREE_ARITY - npending[k]) * SWIFFT_COMPACT_BLOCK_SIZE);
+			SWIFFT_TreeNode(pending[k], (int16_t)(SWIFFT_TREE_LOG4_BATCH + k + 1), parent);
+			npending[k] = 0;
+			SWIFFT_TreePush(pending, npending, k + 1, parent);
+		}
+	}
+	memcpy(root, pending[k], SWIFFT_COMPACT_BLOCK_SIZE);
+}
+
+//! \brief Computes the digest of a message from the block holding its top node.
+//!
+//! \param[in,out] root the block whose first node is the top node, and the rest zero bytes.
+//! \param[in] len the number of bytes of the message.
+//! \param[out] digest the digest of the message.
+static void SWIFFT_TreeDigest(BitSequence root[SWIFFT_INPUT_BLOCK_SIZE], uint64_t len,
+	BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	uint64_t bitLength = len * 8;
+	int i;
+	SWIFFT_ALIGN BitSequence output[SWIFFT_OUTPUT_BLOCK_SIZE];
+	for (i=0; i<SWIFFT_TREE_LENGTH_SIZE; i++) {
+		root[SWIFFT_COMPACT_BLOCK_SIZE + SWIFFT_TREE_LENGTH_SIZE - 1 - i] = (BitSequence)(bitLength >> (8 * i));
+	}
+	SWIFFT_Compute(root, output);
+	SWIFFT_ConstAdd(output, -1);
+	SWIFFT_Compact(output, digest);
+}
+
+int SWIFFT_TreeHash(const void *data, size_t len, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	const BitSequence *bytes = (const BitSequence *)data;
+	const size_t batchSize = (size_t)SWIFFT_TREE_BATCH * SWIFFT_INPUT_BLOCK_SIZE;
+	swifft_tree_work_t work;
+	SWIFFT_ALIGN BitSequence root[SWIFFT_INPUT_BLOCK_SIZE];
+
+	if (SWIFFT_TreeAlloc(&work) != 0) {
+		return -1;
+	}
+
+	memset(root, 0, sizeof(root));
+	if (len <= batchSize) {
+		SWIFFT_TreeBatch(&work, bytes, len, -1);
+		memcpy(root, work.nodes, SWIFFT_COMPACT_BLOCK_SIZE);
+	}
+	else {
+		SWIFFT_ALIGN BitSequence pending[SWIFFT_TREE_MAX_LEVELS][SWIFFT_INPUT_BLOCK_SIZE];
+		int npending[SWIFFT_TREE_MAX_LEVELS] = {0};
+		size_t offset;
+		for (offset=0; offset<len; offset+=batchSize) {
+			SWIFFT_TreeBatch(&work, bytes + offset, (len - offset < batchSize) ? len - offset : batchSize, SWIFFT_TREE_LOG4_BATCH);
+			SWIFFT_TreePush(pending, npending, 0, work.nodes);
+		}
+		SWIFFT_TreeTop(pending, npending, (len + batchSize - 1) / batchSize, root);
+	}
+
+	SWIFFT_TreeFree(&work);
+	SWIFFT_TreeDigest(root, len, digest);
+	return 0;
+}
+
+//! \brief The state of an incremental tree-hash.
+//! The last batch of the message seen is held back until more of it follows, since the reduction
+//! of a batch depends on whether it is the only one.
+struct swifft_tree {
+	//! \brief The blocks of pending nodes, per level above the batch level.
+	SWIFFT_ALIGN BitSequence pending[SWIFFT_TREE_MAX_LEVELS][SWIFFT_INPUT_BLOCK_SIZE];
+	//! \brief The number of pending nodes, per level above the batch level.
+	int npending[SWIFFT_TREE_MAX_LEVELS];
+	//! \brief The buffers for processing a batch.
+	swifft_tree_work_t work;
+	//! \brief The bytes of the message held back, up to a batch.
+	BitSequence *buffer;
+	//! \brief The number of bytes held back.
+	size_t nbuffered;
+	//! \brief The number of batches processed.
+	uint64_t nbatches;
+	//! \brief The number of bytes of the message so far.
+	uint64_t len;
+};
+
+swifft_tree_t *SWIFFT_TreeCreate(void)
+{
+	swifft_tree_t *tree = (swifft_tree_t *)aligned_alloc(SWIFFT_ALIGNMENT, sizeof(swifft_tree_t));
+	if (tree == NULL) {
+		return NULL;
+	}
+	tree->buffer = (BitSequence *)aligned_alloc(SWIFFT_ALIGNMENT, (size_t)SWIFFT_TREE_BATCH * SWIFFT_INPUT_BLOCK_SIZE);
+	if (tree->buffer == NULL || SWIFFT_TreeAlloc(&tree->work) != 0) {
+		free(tree->buffer);
+		free(tree);
+		return NULL;
+	}
+	SWIFFT_TreeReset(tree);
+	return tree;
+}
+
+void SWIFFT_TreeDestroy(swifft_tree_t *tree)
+{
+	if (tree == NULL) {
+		return;
+	}
+	SWIFFT_TreeFree(&tree->work);
+	free(tree->buffer);
+	free(tree);
+}
+
+void SWIFFT_TreeReset(swifft_tree_t *tree)
+{
+	memset(tree->npending, 0, sizeof(tree->npending));
+	tree->nbuffered = 0;
+	tree->nbatches = 0;
+	tree->len = 0;
+}
+
+//! \brief Processes a full batch of the message that is not the last one.
+//!
+//! \param[in,out] tree the state.
+//! \param[in] data the bytes of the batch.
+static void SWIFFT_TreeUpdateBatch(swifft_tree_t *tree, const BitSequence *data)
+{
+	SWIFFT_TreeBatch(&tree->work, data, (size_t)SWIFFT_TREE_BATCH * SWIFFT_INPUT_BLOCK_SIZE, SWIFFT_TREE_LOG4_BATCH);
+	SWIFFT_TreePush(tree->pending, tree->npending, 0, tree->work.nodes);
+	tree->nbatches++;
+}
+
+void SWIFFT_TreeUpdate(swifft_tree_t *tree, const void *data, size_t len)
+{
+	const BitSequence *bytes = (const BitSequence *)data;
+	const size_t batchSize = (size_t)SWIFFT_TREE_BATCH * SWIFFT_INPUT_BLOCK_SIZE;
+	size_t n;
+	tree->len += len;
+	if (tree->nbuffered == batchSize && len > 0) {
+		SWIFFT_TreeUpdateBatch(tree, tree->buffer);
+		tree->nbuffered = 0;
+	}
+	if (tree->nbuffered > 0) {
+		n = (len < batchSize - tree->nbuffered) ? len : batchSize - tree->nbuffered;
+		memcpy(tree->buffer + tree->nbuffered, bytes, n);
+		tree->nbuffered += n;
+		bytes += n;
+		len -= n;
+		if (len > 0) {
+			SWIFFT_TreeUpdateBatch(tree, tree->buffer);
+			tree->nbuffered = 0;
+		}
+	}
+	// the full batches followed by more bytes are read in place
+	for (; len > batchSize; bytes+=batchSize,len-=batchSize) {
+		SWIFFT_TreeUpdateBatch(tree, bytes);
+	}
+	memcpy(tree->buffer + tree->nbuffered, bytes, len);
+	tree->nbuffered += len;
+}
+
+void SWIFFT_TreeFinal(swifft_tree_t *tree, BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE])
+{
+	SWIFFT_ALIGN BitSequence root[SWIFFT_INPUT_BLOCK_SIZE];
+	memset(root, 0, sizeof(root));
+	if (tree->nbatches == 0) {
+		SWIFFT_TreeBatch(&tree->work, tree->buffer, tree->nbuffered, -1);
+		memcpy(root, tree->work.nodes, SWIFFT_COMPACT_BLOCK_SIZE);
+	}
+	else {
+		SWIFFT_TreeBatch(&tree->work, tree->buffer, tree->nbuffered, SWIFFT_TREE_LOG4_BATCH);
+		SWIFFT_TreePush(tree->pending, tree->npending, 0, tree->work.nodes);
+		SWIFFT_TreeTop(tree->pending, tree->npending, tree->nbatches + 1, root);
+	}
+	SWIFFT_TreeDigest(root, tree->len, digest);
+}
+
+LIBSWIFFT_END_EXTERN_C
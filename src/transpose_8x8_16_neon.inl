@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file src/transpose_8x8_16_neon.inl
+ * \brief LibSWIFFT internal 8x8 16-bit transpose for NEON
+ *
+ * The same transpose as transpose_8x8_16_sse2, by transposing 2x2 blocks of
+ * 16-bit, then 32-bit, then 64-bit elements with the AArch64 TRN1/TRN2
+ * instructions, each taking one instruction per pair of rows.
+ */
+
+#include <arm_neon.h>
+
+static inline void transpose_8x8_16_neon(int16x8_t * array)
+{
+	int16_t *p = (int16_t *)array;
+	int16x8_t a = vld1q_s16(p);
+	int16x8_t b = vld1q_s16(p + 8);
+	int16x8_t c = vld1q_s16(p + 16);
+	int16x8_t d = vld1q_s16(p + 24);
+	int16x8_t e = vld1q_s16(p + 32);
+	int16x8_t f = vld1q_s16(p + 40);
+	int16x8_t g = vld1q_s16(p + 48);
+	int16x8_t h = vld1q_s16(p + 56);
+
+	int32x4_t a0b0a2b2 = vreinterpretq_s32_s16(vtrn1q_s16(a, b));
+	int32x4_t a1b1a3b3 = vreinterpretq_s32_s16(vtrn2q_s16(a, b));
+	int32x4_t c0d0c2d2 = vreinterpretq_s32_s16(vtrn1q_s16(c, d));
+	int32x4_t c1d1c3d3 = vreinterpretq_s32_s16(vtrn2q_s16(c, d));
+	int32x4_t e0f0e2f2 = vreinterpretq_s32_s16(vtrn1q_s16(e, f));
+	int32x4_t e1f1e3f3 = vreinterpretq_s32_s16(vtrn2q_s16(e, f));
+	int32x4_t g0h0g2h2 = vreinterpretq_s32_s16(vtrn1q_s16(g, h));
+	int32x4_t g1h1g3h3 = vreinterpretq_s32_s16(vtrn2q_s16(g, h));
+
+	int64x2_t a0b0c0d0 = vreinterpretq_s64_s32(vtrn1q_s32(a0b0a2b2, c0d0c2d2));
+	int64x2_t a2b2c2d2 = vreinterpretq_s64_s32(vtrn2q_s32(a0b0a2b2, c0d0c2d2));
+	int64x2_t a1b1c1d1 = vreinterpretq_s64_s32(vtrn1q_s32(a1b1a3b3, c1d1c3d3));
+	int64x2_t a3b3c3d3 = vreinterpretq_s64_s32(vtrn2q_s32(a1b1a3b3, c1d1c3d3));
+	int64x2_t e0f0g0h0 = vreinterpretq_s64_s32(vtrn1q_s32(e0f0e2f2, g0h0g2h2));
+	int64x2_t e2f2g2h2 = vreinterpretq_s64_s32(vtrn2q_s32(e0f0e2f2, g0h0g2h2));
+	int64x2_t e1f1g1h1 = vreinterpretq_s64_s32(vtrn1q_s32(e1f1e3f3, g1h1g3h3));
+	int64x2_t e3f3g3h3 = vreinterpretq_s64_s32(vtrn2q_s32(e1f1e3f3, g1h1g3h3));
+
+	// each name above is of the columns in its low half, followed by the columns 4 apart
+	vst1q_s16(p,      vreinterpretq_s16_s64(vtrn1q_s64(a0b0c0d0, e0f0g0h0)));
+	vst1q_s16(p + 8,  vreinterpretq_s16_s64(vtrn1q_s64(a1b1c1d1, e1f1g1h1)));
+	vst1q_s16(p + 16, vreinterpretq_s16_s64(vtrn1q_s64(a2b2c2d2, e2f2g2h2)));
+	vst1q_s16(p + 24, vreinterpretq_s16_s64(vtrn1q_s64(a3b3c3d3, e3f3g3h3)));
+	vst1q_s16(p + 32, vreinterpretq_s16_s64(vtrn2q_s64(a0b0c0d0, e0f0g0h0)));
+	vst1q_s16(p + 40, vreinterpretq_s16_s64(vtrn2q_s64(a1b1c1d1, e1f1g1h1)));
+	vst1q_s16(p + 48, vreinterpretq_s16_s64(vtrn2q_s64(a2b2c2d2, e2f2g2h2)));
+	vst1q_s16(p + 56, vreinterpretq_s16_s64(vtrn2q_s64(a3b3c3d3, e3f3g3h3)));
+}
@@ -6,8 +6,14 @@
 /*! \file test/swifft_catch.cpp
  * \brief LibSWIFFT Catch2 test cases
  */
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
@@ -17,18 +23,43 @@
 #include "testcommon.h"
 
 #include "libswifft/swifft.h"
+#include "libswifft/swifft_cache.h"
 #include "libswifft/swifft_avx.h"
 #include "libswifft/swifft_avx2.h"
 #include "libswifft/swifft_avx512.h"
+#include "libswifft/swifft_avx512bw.h"
+#include "libswifft/swifft_neon.h"
 
 #undef SWIFFT_ISET
 #define SWIFFT_ISET() SWIFFT_INSTRUCTION_SET
 #include "swifft_ops.inl"
 
+#include "libswifft/swifft_executor.h"
+#include "libswifft/swifft_file.h"
+#include "libswifft/swifft_numa.h"
 #include "libswifft/swifft_object.h"
+#include "libswifft/swifft_pool.h"
+#include "libswifft/swifft_queue.h"
+#include "libswifft/swifft_runtime_key.h"
+#include "libswifft/swifft_soa.h"
+#include "libswifft/swifft_stats.h"
+#include "libswifft/swifft_tree.h"
 
 namespace LibSwifft {
 
+#if defined(__aarch64__)
+//! Expands TESTCODE for the suffix of each instruction-set the running CPU supports
+#define TESTCODE_ISETS() \
+	if (SWIFFT_IsSupported_NEON()) TESTCODE(_NEON)
+#else
+//! Expands TESTCODE for the suffix of each instruction-set the running CPU supports
+#define TESTCODE_ISETS() \
+	if (SWIFFT_IsSupported_AVX()) TESTCODE(_AVX) \
+	if (SWIFFT_IsSupported_AVX2()) TESTCODE(_AVX2) \
+	if (SWIFFT_IsSupported_AVX512()) TESTCODE(_AVX512) \
+	if (SWIFFT_IsSupported_AVX512BW()) TESTCODE(_AVX512BW)
+#endif
+
 static uint64_t rdtsc_cycles() {
 	uint64_t n = 1000, cycles = 0;
 	for (uint64_t i=0; i<n; i++) {
@@ -59,6 +90,35 @@ static void randomize(SwifftInput * input, size_t size) {
 	}
 }
 
+//! \brief Zeroes each 8-byte column of the inputs with probability 1-density.
+static void sparsify(SwifftInput * input, size_t size, double density) {
+	for (size_t i=0; i<size; i++) {
+		for (size_t j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j+=8) {
+			if (rand() >= density * RAND_MAX) {
+				memset(input[i].data + j, 0, 8);
+			}
+		}
+	}
+}
+
+//! \brief Sets the elements of a SWIFFT output to random values in {0,..,256}, including 256.
+static void randomize_elements(SwifftOutput &output) {
+	int16_t *e = (int16_t *)output.data;
+	for (int j=0; j<SWIFFT_OUTPUT_BLOCK_SIZE/(int)sizeof(int16_t); j++) {
+		e[j] = (int16_t)((j % 8 == 0) ? 256 : rand() % 257);
+	}
+}
+
+//! \brief Returns an element of a SWIFFT output.
+static int element(const SwifftOutput &output, int j) {
+	return ((const int16_t *)output.data)[j];
+}
+
+//! \brief Returns a value mod 257 in {0,..,256}.
+static int mod257(int64_t x) {
+	return (int)(((x % 257) + 257) % 257);
+}
+
 template<class Callable>
 static void test_swifft_iter_cycles(int nrepeats, int niters, double cycles_per_iter_limit, const char * iterobj, const Callable & callable) {
 	uint64_t cycles_per_rdtsc = rdtsc_cycles();
@@ -150,6 +210,123 @@ TEST_CASE( "swifft takes at most 4000 cycles per block in-large-memory", "[.][sw
 	test_swifft_block_cycles(1000000, 1, 4000);
 }
 
+TEST_CASE( "swifft compute-compact takes at most 4000 cycles per block in-large-memory", "[.][swifftperf]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	const int nblocks = 1000000;
+	Array<SwifftInput> input(nblocks);
+	Array<SwifftCompact> compact(nblocks);
+	randomize(input.array, nblocks);
+	test_swifft_iter_cycles(1, nblocks, 4000, "blocks" LABEL_OPENMP, [&swifft, &input, &compact, nblocks]() {
+		swifft.hash.SWIFFT_ComputeCompactMultiple(nblocks, input.array[0].data, compact.array[0].data);
+	});
+}
+
+TEST_CASE( "swifft takes at most 4000 cycles per block in-large-memory in the structure-of-arrays layout", "[.][swifftperf]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	const int nblocks = 1000000;
+	const int nbatches = SWIFFT_SOA_BATCHES(nblocks);
+	Array<SwifftInput> input(nblocks);
+	Array<BitSequence> soaInput(nbatches * SWIFFT_SOA_INPUT_BATCH_SIZE);
+	Array<BitSequence> soaOutput(nbatches * SWIFFT_SOA_OUTPUT_BATCH_SIZE);
+	randomize(input.array, nblocks);
+	SWIFFT_InputToSoA(nblocks, input.array[0].data, soaInput.array);
+	test_swifft_iter_cycles(1, nblocks, 4000, "blocks" LABEL_OPENMP, [&swifft, &soaInput, &soaOutput, nblocks]() {
+		swifft.hash.SWIFFT_ComputeMultipleSoA(nblocks, soaInput.array, soaOutput.array);
+	});
+}
+
+TEST_CASE( "swifft takes at most 4000 cycles per block in-medium-memory with a thread pool", "[.][swifftperf]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(0);
+	REQUIRE( pool != NULL );
+	SWIFFT_SetExecutor(pool);
+	test_swifft_block_cycles(10000, 10, 4000);
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_DestroyThreadPool(pool);
+}
+
+void test_swifft_signed_block_cycles(int nblocks, int nrepeats, double cycles_per_block_limit, int fft_table_mode) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	Array<SwifftInput> input(nblocks);
+	Array<SwifftInput> sign(nblocks);
+	Array<SwifftOutput> output(nblocks);
+	randomize(input.array, nblocks);
+	randomize(sign.array, nblocks);
+	int mode = SWIFFT_GetFftTableMode();
+	SWIFFT_SetFftTableMode(fft_table_mode);
+	test_swifft_iter_cycles(nrepeats, nblocks, cycles_per_block_limit,
+		fft_table_mode == SWIFFT_FFT_TABLE_SMALL ? "signed-blocks(small-table)" LABEL_OPENMP : "signed-blocks(large-table)" LABEL_OPENMP,
+		[&swifft, &input, &sign, &output, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			swifft.hash.SWIFFT_ComputeMultipleSigned(nblocks, input.array[0].data, sign.array[0].data, output.array[0].data);
+		}
+	});
+	SWIFFT_SetFftTableMode(mode);
+}
+
+TEST_CASE( "swifft takes at most 4000 cycles per signed block in-large-memory with the large FFT table", "[.][swifftperf]" ) {
+	test_swifft_signed_block_cycles(1000000, 1, 4000, SWIFFT_FFT_TABLE_LARGE);
+}
+
+TEST_CASE( "swifft takes at most 4000 cycles per signed block in-large-memory with the small FFT table", "[.][swifftperf]" ) {
+	test_swifft_signed_block_cycles(1000000, 1, 4000, SWIFFT_FFT_TABLE_SMALL);
+}
+
+void test_swifft_single_block_cycles(int nblocks, int nrepeats, double cycles_per_block_limit) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	Array<SwifftInput> input(nblocks);
+	Array<SwifftOutput> output(nblocks);
+	randomize(input.array, nblocks);
+	test_swifft_iter_cycles(nrepeats, nblocks, cycles_per_block_limit, "single-blocks", [&swifft, &input, &output, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			for (int i=0; i<nblocks; i++) {
+				swifft.hash.SWIFFT_Compute(input.array[i].data, output.array[i].data);
+			}
+		}
+	});
+}
+
+TEST_CASE( "swifft takes at most 2000 cycles per single-block call in-small-memory", "[.][swifftperf]" ) {
+	int nblocks = 1000, nrepeats = 10, cycles_per_block_limit = 2000;
+	test_swifft_single_block_cycles(nblocks, nrepeats, cycles_per_block_limit);
+}
+
+TEST_CASE( "swifft sparse takes at most 2000 cycles per single-block call at any density", "[.][swifftperf]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	int nblocks = 1000, nrepeats = 10;
+	Array<SwifftInput> input(nblocks);
+	Array<SwifftOutput> output(nblocks);
+	for (double density=0; density<=1; density+=0.125) {
+		srand(1);
+		randomize(input.array, nblocks);
+		sparsify(input.array, nblocks, density);
+		std::cerr << "density=" << density << std::endl;
+		test_swifft_iter_cycles(nrepeats, nblocks, 2000, "dense-blocks", [&swifft, &input, &output, nblocks, nrepeats]() {
+			for (int r=0; r<nrepeats; r++) {
+				for (int i=0; i<nblocks; i++) {
+					swifft.hash.SWIFFT_Compute(input.array[i].data, output.array[i].data);
+				}
+			}
+		});
+		test_swifft_iter_cycles(nrepeats, nblocks, 2000, "sparse-blocks", [&swifft, &input, &output, nblocks, nrepeats]() {
+			for (int r=0; r<nrepeats; r++) {
+				for (int i=0; i<nblocks; i++) {
+					swifft.hash.SWIFFT_ComputeSparse(input.array[i].data, output.array[i].data);
+				}
+			}
+		});
+	}
+}
+
 TEST_CASE( "swifft compact takes at most 150 cycles per call", "[.][swifftperf]" ) {
 	swifft_object_t swifft;
 	SWIFFT_InitObject(&swifft);
@@ -169,6 +346,108 @@ TEST_CASE( "swifft compact takes at most 150 cycles per call", "[.][swifftperf]"
 	});
 }
 
+TEST_CASE( "swifft multiple compact takes at most 150 cycles per block", "[.][swifftperf]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	const int nblocks = 1000, nrepeats = 100;
+	Array<SwifftInput> input(nblocks);
+	Array<SwifftOutput> output(nblocks);
+	Array<SwifftCompact> compact(nblocks);
+	randomize(input.array, nblocks);
+	SWIFFT_ComputeMultiple(nblocks, input.array[0].data, output.array[0].data);
+	test_swifft_iter_cycles(nrepeats, nblocks, 150, "compact-blocks" LABEL_OPENMP, [&swifft, &output, &compact, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			swifft.hash.SWIFFT_CompactMultiple(nblocks, output.array[0].data, compact.array[0].data);
+		}
+	});
+}
+
+TEST_CASE( "swifft arithmetic expression takes at most 100 cycles per block", "[.][swifftperf]" ) {
+	srand(1);
+	const int nblocks = 100, nrepeats = 1000;
+	Array<SwifftOutput> a(nblocks), b(nblocks), c(nblocks), d(nblocks);
+	for (int i=0; i<nblocks; i++) {
+		randomize_elements(a.array[i]);
+		randomize_elements(b.array[i]);
+		randomize_elements(c.array[i]);
+		randomize_elements(d.array[i]);
+	}
+	test_swifft_iter_cycles(nrepeats, nblocks, 100, "expression-blocks", [&a, &b, &c, &d, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			for (int i=0; i<nblocks; i++) {
+				a.array[i] += b.array[i]*c.array[i] - d.array[i];
+			}
+		}
+	});
+}
+
+TEST_CASE( "swifft linear combination takes at most 50 cycles per block in-medium-memory", "[.][swifftperf]" ) {
+	srand(1);
+	const int nblocks = 10000, nrepeats = 100;
+	Array<SwifftOutput> outputs(nblocks);
+	std::vector<int16_t> coeffs(nblocks);
+	for (int i=0; i<nblocks; i++) {
+		randomize_elements(outputs.array[i]);
+		coeffs[i] = (int16_t)(rand() % 16);
+	}
+	SwifftOutput result;
+	test_swifft_iter_cycles(nrepeats, nblocks, 50, "combined-blocks" LABEL_OPENMP, [&outputs, &coeffs, &result, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			SWIFFT_LinearCombination(nblocks, coeffs.data(), outputs.array[0].data, result.data);
+		}
+	});
+}
+
+TEST_CASE( "swifft update takes at most 500 cycles per 8-byte change within one group of 8, 16 or 32 bytes", "[.][swifftperf]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	SwifftInput input = {0};
+	SwifftInput input2 = {0};
+	SwifftOutput output;
+	randomize(&input, 1);
+	randomize(&input2, 1);
+	SWIFFT_Compute(input.data, output.data);
+	int nrepeats = 1, nrounds=1000000;
+	test_swifft_iter_cycles(nrepeats, nrounds, 500, "update-rounds", [&swifft, &input, &input2, &output, nrepeats, nrounds]() {
+		for (int r=0; r<nrepeats; r++) {
+			for (int64_t i=0; i<nrounds; i++) {
+				size_t offset = (i * 8) % SWIFFT_INPUT_BLOCK_SIZE;
+				swifft.hash.SWIFFT_Update(output.data, input.data + offset, input2.data + offset, offset, 8);
+			}
+		}
+	});
+}
+
+TEST_CASE( "swifft stream takes at most 2000 cycles per chunk in-small-memory", "[.][swifftperf]" ) {
+	srand(1);
+	int nchunks = 1000, nrepeats = 10;
+	std::vector<BitSequence> data(nchunks * SWIFFT_STREAM_CHUNK_SIZE);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	SwifftCompact digest;
+	test_swifft_iter_cycles(nrepeats, nchunks, 2000, "stream-chunks", [&data, &digest, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			SWIFFT_StreamHash(data.data(), data.size(), digest.data);
+		}
+	});
+}
+
+TEST_CASE( "swifft tree-hash takes at most 4000 cycles per block in-large-memory", "[.][swifftperf]" ) {
+	srand(1);
+	int nblocks = 1000000, nrepeats = 1;
+	Array<SwifftInput> input(nblocks);
+	randomize(input.array, nblocks);
+	SwifftCompact digest;
+	test_swifft_iter_cycles(nrepeats, nblocks, 4000, "tree-blocks" LABEL_OPENMP, [&input, &digest, nblocks, nrepeats]() {
+		for (int r=0; r<nrepeats; r++) {
+			SWIFFT_TreeHash(input.array[0].data, (size_t)nblocks * SWIFFT_INPUT_BLOCK_SIZE, digest.data);
+		}
+	});
+}
+
 TEST_CASE( "swifft FFT-only takes at most 1500 cycles per call", "[.][swifftperf]" ) {
 	swifft_object_t swifft;
 	SWIFFT_InitObject(&swifft);
@@ -268,142 +547,816 @@ TEST_CASE( "SWIFFT_fft is consistent across instruction-sets", "[swifft]" ) {
 	SWIFFT_ALIGN int16_t fftout0[SWIFFT_N*SWIFFT_M] = {0};
 	swifft.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout0);
 	swifft.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout0, SWIFFT_M, (int16_t *)output0.data);
-#if defined(__AVX__)
-	swifft_object_t swifft_avx;
-	SWIFFT_InitObject(&swifft_avx);
-	SwifftOutput output1 = {0};
-	SWIFFT_ALIGN int16_t fftout1[SWIFFT_N*SWIFFT_M] = {0};
-	swifft_avx.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout1);
-	swifft_avx.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout1, SWIFFT_M, (int16_t *)output1.data);
-	CHECK( 0 == memcmp(fftout0, fftout1, sizeof(fftout1)) );
-#endif
-#if defined(__AVX2__)
-	swifft_object_t swifft_avx2;
-	SWIFFT_InitObject(&swifft_avx2);
-	SwifftOutput output2 = {0};
-	SWIFFT_ALIGN int16_t fftout2[SWIFFT_N*SWIFFT_M] = {0};
-	swifft_avx2.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout2);
-	swifft_avx2.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout2, SWIFFT_M, (int16_t *)output2.data);
-	CHECK( 0 == memcmp(fftout0, fftout2, sizeof(fftout1)) );
-#endif
-#if defined(__AVX512F__)
-	swifft_object_t swifft_avx512;
-	SWIFFT_InitObject(&swifft_avx512);
-	SwifftOutput output3 = {0};
-	SWIFFT_ALIGN int16_t fftout3[SWIFFT_N*SWIFFT_M] = {0};
-	swifft_avx512.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout3);
-	swifft_avx512.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout3, SWIFFT_M, (int16_t *)output3.data);
-	CHECK( 0 == memcmp(fftout0, fftout3, sizeof(fftout1)) );
-#endif
-}
-
-TEST_CASE( "SWIFFT_safeMult is correct on the range [-128+1,128-1]*[-128,128]", "[swifft]" ) {
-	for (int16_t i=-128+1; i<=128-1; i++) {
-		CAPTURE( i );
-		for (int16_t j=-128; j<=128; j++) {
-			CAPTURE( j );
-			ZOvec v = ZOCONST(i);
-			ZOvec u = ZOCONST(j);
-			ZOvec m0 = u * v;
-			ZOvec m1 = SWIFFT_safeMult(u, v);
-			int16_t m0x = *(int16_t *)&m0;
-			CAPTURE( m0x );
-			int32_t m32 = (int32_t)i * (int32_t)j;
-			CAPTURE( m32 );
-			if (m32 >= 1 << 15) m0x += 1;
-			if (-m32 > 1 << 15) m0x -= 1;
-			CAPTURE( m0x );
-			int16_t m0xp = m0x % SWIFFT_P;
-			if (m0xp < 0) m0xp += SWIFFT_P;
-			int32_t m32p = m32 % SWIFFT_P;
-			if (m32p < 0) m32p += SWIFFT_P;
-			REQUIRE( m32p == m0xp );
-			int16_t m1x = *(int16_t *)&m1;
-			int16_t m1xp = m1x % SWIFFT_P;
-			if (m1xp < 0) m1xp += SWIFFT_P;
-			REQUIRE( m0xp == m1xp );
-		}
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft_iset; \
+		SWIFFT_InitObject##suffix(&swifft_iset); \
+		SwifftOutput output1 = {0}; \
+		SWIFFT_ALIGN int16_t fftout1[SWIFFT_N*SWIFFT_M] = {0}; \
+		swifft_iset.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout1); \
+		swifft_iset.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout1, SWIFFT_M, (int16_t *)output1.data); \
+		CHECK( 0 == memcmp(fftout0, fftout1, sizeof(fftout1)) ); \
+		CHECK( output0 == output1 ); \
 	}
+	TESTCODE_ISETS()
+#undef TESTCODE
 }
 
-TEST_CASE( "swifft with sign is consistent", "[swifft]" ) {
+TEST_CASE( "SWIFFT_fftsum is consistent across instruction-sets for any number of 8-elements", "[swifft]" ) {
 	swifft_object_t swifft;
 	SWIFFT_InitObject(&swifft);
 	srand(1);
-	SwifftInput input[3] = {0}, sign[3] = {0}, zeroinput = {0};
-	SwifftOutput output[3] = {0}, zerooutput = {0};
-	// set up input
+	SwifftInput input = {0};
 	for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
-		input[0].data[j] = rand() & 0xFF;
+		input.data[j] = rand() & 0xFF;
 	}
-	// check input and its output are not zero
-	REQUIRE( input[0] != zeroinput );
-	swifft.hash.SWIFFT_Compute(input[0].data, output[0].data);
-	REQUIRE( output[0] != zerooutput );
-	// check positive sign gets the same output
-	swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[1].data, output[1].data);
-	REQUIRE( output[0] == output[1] );
-	// check negative sign gets the mod-SWIFFT_P negative output
-	for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
-		sign[2].data[j] = 0xFF;
+	SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M] = {0};
+	swifft.fft.SWIFFT_fft(input.data, SWIFFT_sign0, SWIFFT_M, fftout);
+	for (int m=1; m<=SWIFFT_M; m++) {
+		SwifftOutput output0 = {0};
+		swifft.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout, m, (int16_t *)output0.data);
+#define TESTCODE(suffix) \
+		{ \
+			swifft_object_t swifft_iset; \
+			SWIFFT_InitObject##suffix(&swifft_iset); \
+			SwifftOutput output1 = {0}; \
+			swifft_iset.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout, m, (int16_t *)output1.data); \
+			CHECK( output0 == output1 ); \
+		}
+		TESTCODE_ISETS()
+#undef TESTCODE
 	}
-	swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[2].data, output[2].data);
-	REQUIRE( output[2] != zerooutput );
-	for (int j=0; j<SWIFFT_OUTPUT_BLOCK_SIZE/2; j++) {
-		int v0 = ((int16_t *)output[0].data)[j];
-		int v2 = ((int16_t *)output[2].data)[j];
-		CAPTURE( j );
-		CAPTURE( v0 );
-		CAPTURE( v2 );
-		int summod = (v0 + v2) % SWIFFT_P;
-		REQUIRE( summod == 0 );
+}
+
+TEST_CASE( "swifft computes the same as SWIFFT_fft followed by SWIFFT_fftsum", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 64; \
+		SwifftInput input[n]; \
+		SwifftInput sign[n]; \
+		randomize(input, n); \
+		randomize(sign, n); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			SwifftOutput output0, output1, output2, output3; \
+			SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M]; \
+			swifft.fft.SWIFFT_fft(input[i].data, SWIFFT_sign0, SWIFFT_M, fftout); \
+			swifft.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout, SWIFFT_M, (int16_t *)output0.data); \
+			swifft.hash.SWIFFT_Compute(input[i].data, output1.data); \
+			REQUIRE( output0 == output1 ); \
+			swifft.fft.SWIFFT_fft(input[i].data, sign[i].data, SWIFFT_M, fftout); \
+			swifft.fft.SWIFFT_fftsum(SWIFFT_PI_key, fftout, SWIFFT_M, (int16_t *)output2.data); \
+			swifft.hash.SWIFFT_ComputeSigned(input[i].data, sign[i].data, output3.data); \
+			REQUIRE( output2 == output3 ); \
+		} \
 	}
-	// check that adding positive and negative gives zero
-	swifft.arith.SWIFFT_Add(output[2].data, output[1].data);
-	REQUIRE( output[2] == zerooutput );
-	// check that negating a sign vector gives mod-SWIFFT_P negative output
-	for (int i=0; i<8; i++) {
-		CAPTURE( i );
-		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
-			sign[1].data[j] = j & ~(1 << i);
-			sign[2].data[j] = ~sign[1].data[j];
-		}
-		swifft.arith.SWIFFT_ConstSet(output[0].data, 0);
-		for (int k=1; k<3; k++) {
-			CAPTURE( k );
-			swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[k].data, output[k].data);
-			REQUIRE( output[k] != zerooutput );
-			swifft.arith.SWIFFT_Add(output[0].data, output[k].data);
-		}
-		REQUIRE( output[0] == zerooutput );
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft computes multiple the same as one block at a time", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 67; \
+		SwifftInput input[n]; \
+		SwifftInput sign[n]; \
+		SwifftOutput output1[n]; \
+		SwifftOutput output2[n]; \
+		randomize(input, n); \
+		randomize(sign, n); \
+		for (int nblocks=1; nblocks<=n; nblocks+=(nblocks < 9 ? 1 : 29)) { \
+			CAPTURE( nblocks ); \
+			swifft.hash.SWIFFT_ComputeMultiple(nblocks, input[0].data, output1[0].data); \
+			for (int i=0; i<nblocks; i++) { \
+				swifft.hash.SWIFFT_Compute(input[i].data, output2[i].data); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+			swifft.hash.SWIFFT_ComputeMultipleSigned(nblocks, input[0].data, sign[0].data, output1[0].data); \
+			for (int i=0; i<nblocks; i++) { \
+				swifft.hash.SWIFFT_ComputeSigned(input[i].data, sign[i].data, output2[i].data); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+		} \
 	}
-	// check splitting a signed input and composing back outputs
-	for (int i=0; i<8; i++) {
-		CAPTURE( i );
-		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
-			CAPTURE( j );
-			// input is random with random sign
-			input[0].data[j] = rand() & 0xFF;
-			sign[0].data[j] = rand() & 0xFF;
-			// select where one split would be non-zero (half of bits on average)
-			BitSequence select = rand() & 0xFF;
-			// one split has the same sign except where zero is selected
-			input[1].data[j] = select;
-			sign[1].data[j] = sign[0].data[j];
-			// second split has inverted sign when data is zero and inverted zero selection otherwise
-			input[2].data[j] = input[0].data[j] ^ select;
-			sign[2].data[j] = sign[0].data[j] ^ ~input[0].data[j];
-			// canonicalize: input sign is zero if data is zero
-			CAPTURE( (int)sign[0].data[j] );
-			CAPTURE( (int)sign[1].data[j] );
-			CAPTURE( (int)sign[2].data[j] );
-			sign[0].data[j] &= input[0].data[j];
-			sign[1].data[j] &= input[1].data[j];
-			sign[2].data[j] &= input[2].data[j];
-			CAPTURE( (int)input[0].data[j] );
-			CAPTURE( (int)input[1].data[j] );
-			CAPTURE( (int)input[2].data[j] );
-			CAPTURE( (int)sign[0].data[j] );
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft computes with a runtime key the same as SWIFFT_fft followed by SWIFFT_fftsum", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 67; \
+		SwifftInput input[n]; \
+		SwifftInput sign[n]; \
+		SwifftOutput output1[n]; \
+		SwifftOutput output2[n]; \
+		randomize(input, n); \
+		randomize(sign, n); \
+		SWIFFT_ALIGN swifft_key_t key; \
+		SWIFFT_ALIGN int16_t elements[SWIFFT_KEY_SIZE]; \
+		for (int i=0; i<SWIFFT_KEY_SIZE; i++) { \
+			elements[i] = (int16_t)(rand() % 2001 - 1000); \
+		} \
+		SWIFFT_InitKey(&key, elements); \
+		for (int i=0; i<8; i++) { \
+			CAPTURE( i ); \
+			SwifftOutput output0, output3; \
+			SWIFFT_ALIGN int16_t fftout[SWIFFT_N*SWIFFT_M]; \
+			swifft.fft.SWIFFT_fft(input[i].data, SWIFFT_sign0, SWIFFT_M, fftout); \
+			swifft.fft.SWIFFT_fftsum(key.elements, fftout, SWIFFT_M, (int16_t *)output0.data); \
+			swifft.hash.SWIFFT_ComputeWithKey(&key, input[i].data, output3.data); \
+			REQUIRE( output0 == output3 ); \
+			swifft.fft.SWIFFT_fft(input[i].data, sign[i].data, SWIFFT_M, fftout); \
+			swifft.fft.SWIFFT_fftsum(key.elements, fftout, SWIFFT_M, (int16_t *)output0.data); \
+			swifft.hash.SWIFFT_ComputeWithKeySigned(&key, input[i].data, sign[i].data, output3.data); \
+			REQUIRE( output0 == output3 ); \
+		} \
+		for (int nblocks=1; nblocks<=n; nblocks+=(nblocks < 9 ? 1 : 29)) { \
+			CAPTURE( nblocks ); \
+			swifft.hash.SWIFFT_ComputeWithKeyMultiple(nblocks, &key, input[0].data, output1[0].data); \
+			for (int i=0; i<nblocks; i++) { \
+				swifft.hash.SWIFFT_ComputeWithKey(&key, input[i].data, output2[i].data); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+			swifft.hash.SWIFFT_ComputeWithKeyMultipleSigned(nblocks, &key, input[0].data, sign[0].data, output1[0].data); \
+			for (int i=0; i<nblocks; i++) { \
+				swifft.hash.SWIFFT_ComputeWithKeySigned(&key, input[i].data, sign[i].data, output2[i].data); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+		} \
+		SWIFFT_InitKeyPI(&key); \
+		swifft.hash.SWIFFT_ComputeWithKeyMultipleSigned(n, &key, input[0].data, sign[0].data, output1[0].data); \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input[0].data, sign[0].data, output2[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( output1[i] == output2[i] ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft updates after a range of the input changed the same as computing anew", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 11; \
+		SwifftInput input[n]; \
+		SwifftInput sign[n]; \
+		SwifftInput input2[n]; \
+		SwifftInput sign2[n]; \
+		SwifftOutput output1[n]; \
+		SwifftOutput output2[n]; \
+		BitSequence oldBytes[n*SWIFFT_INPUT_BLOCK_SIZE], newBytes[n*SWIFFT_INPUT_BLOCK_SIZE]; \
+		for (int iter=0; iter<200; iter++) { \
+			size_t offset = rand() % SWIFFT_INPUT_BLOCK_SIZE; \
+			size_t len = (iter % 4 == 0) ? rand() % (SWIFFT_INPUT_BLOCK_SIZE - offset + 1) : rand() % (SWIFFT_INPUT_BLOCK_SIZE - offset < 17 ? SWIFFT_INPUT_BLOCK_SIZE - offset + 1 : 17); \
+			CAPTURE( offset, len ); \
+			randomize(input, n); \
+			randomize(sign, n); \
+			randomize(input2, n); \
+			randomize(sign2, n); \
+			swifft.hash.SWIFFT_Compute(input[0].data, output1[0].data); \
+			REQUIRE( swifft.hash.SWIFFT_Update(output1[0].data, input[0].data + offset, input2[0].data + offset, offset, len) == 0 ); \
+			memcpy(input[0].data + offset, input2[0].data + offset, len); \
+			swifft.hash.SWIFFT_Compute(input[0].data, output2[0].data); \
+			REQUIRE( output1[0] == output2[0] ); \
+			swifft.hash.SWIFFT_ComputeSigned(input[1].data, sign[1].data, output1[1].data); \
+			REQUIRE( swifft.hash.SWIFFT_UpdateSigned(output1[1].data, input[1].data + offset, sign[1].data + offset, \
+				input2[1].data + offset, sign2[1].data + offset, offset, len) == 0 ); \
+			memcpy(input[1].data + offset, input2[1].data + offset, len); \
+			memcpy(sign[1].data + offset, sign2[1].data + offset, len); \
+			swifft.hash.SWIFFT_ComputeSigned(input[1].data, sign[1].data, output2[1].data); \
+			REQUIRE( output1[1] == output2[1] ); \
+			swifft.hash.SWIFFT_ComputeMultiple(n, input[0].data, output1[0].data); \
+			for (int i=0; i<n; i++) { \
+				memcpy(oldBytes + i * len, input[i].data + offset, len); \
+				memcpy(newBytes + i * len, input2[i].data + offset, len); \
+				memcpy(input[i].data + offset, input2[i].data + offset, len); \
+			} \
+			REQUIRE( swifft.hash.SWIFFT_UpdateMultiple(n, output1[0].data, oldBytes, newBytes, offset, len) == 0 ); \
+			swifft.hash.SWIFFT_ComputeMultiple(n, input[0].data, output2[0].data); \
+			for (int i=0; i<n; i++) { \
+				CAPTURE( i ); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft rejects an update of a range beyond the input", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		SwifftInput input, sign; \
+		SwifftOutput output, expected; \
+		BitSequence bytes[2*SWIFFT_INPUT_BLOCK_SIZE] = {0}; \
+		randomize(&input, 1); \
+		randomize(&sign, 1); \
+		swifft.hash.SWIFFT_Compute(input.data, output.data); \
+		expected = output; \
+		const size_t ranges[][2] = { {0, SWIFFT_INPUT_BLOCK_SIZE + 1}, {SWIFFT_INPUT_BLOCK_SIZE - 8, 9}, \
+			{SWIFFT_INPUT_BLOCK_SIZE + 1, 0}, {8, (size_t)-1} }; \
+		for (const auto &range : ranges) { \
+			size_t offset = range[0], len = range[1]; \
+			CAPTURE( offset, len ); \
+			REQUIRE( swifft.hash.SWIFFT_Update(output.data, input.data, bytes, offset, len) == -1 ); \
+			REQUIRE( swifft.hash.SWIFFT_UpdateSigned(output.data, input.data, sign.data, bytes, bytes, offset, len) == -1 ); \
+			REQUIRE( swifft.hash.SWIFFT_UpdateMultiple(1, output.data, input.data, bytes, offset, len) == -1 ); \
+			REQUIRE( output == expected ); \
+		} \
+		REQUIRE( swifft.hash.SWIFFT_Update(output.data, input.data, input.data, SWIFFT_INPUT_BLOCK_SIZE, 0) == 0 ); \
+		REQUIRE( output == expected ); \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft computes sparse input the same as dense input", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 67; \
+		SwifftInput input[n]; \
+		SwifftOutput output1[n]; \
+		SwifftOutput output2[n]; \
+		for (double density=0; density<=1; density+=0.125) { \
+			CAPTURE( density ); \
+			randomize(input, n); \
+			sparsify(input, n, density); \
+			for (int i=0; i<n; i++) { \
+				CAPTURE( i ); \
+				swifft.hash.SWIFFT_Compute(input[i].data, output1[i].data); \
+				swifft.hash.SWIFFT_ComputeSparse(input[i].data, output2[i].data); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+			swifft.hash.SWIFFT_ComputeSparseMultiple(n, input[0].data, output2[0].data); \
+			for (int i=0; i<n; i++) { \
+				CAPTURE( i ); \
+				REQUIRE( output1[i] == output2[i] ); \
+			} \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft computes short input the same as zero-padded input", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		SwifftInput input, sign, padded, paddedSign; \
+		SwifftOutput output1, output2; \
+		for (int m=0; m<=SWIFFT_INPUT_BLOCK_SIZE/8+4; m++) { \
+			CAPTURE( m ); \
+			randomize(&input, 1); \
+			randomize(&sign, 1); \
+			const bool valid = (m > 0 && m <= SWIFFT_INPUT_BLOCK_SIZE/8 && m % SWIFFT_SHORT_COLUMNS == 0); \
+			const int ret = swifft.hash.SWIFFT_ComputeShort(m, input.data, output2.data); \
+			REQUIRE( ret == (valid ? 0 : -1) ); \
+			if (!valid) { \
+				REQUIRE( -1 == swifft.hash.SWIFFT_ComputeShortSigned(m, input.data, sign.data, output2.data) ); \
+				continue; \
+			} \
+			padded = 0; \
+			paddedSign = 0; \
+			memcpy(padded.data, input.data, 8*m); \
+			memcpy(paddedSign.data, sign.data, 8*m); \
+			swifft.hash.SWIFFT_Compute(padded.data, output1.data); \
+			REQUIRE( output1 == output2 ); \
+			swifft.hash.SWIFFT_ComputeSigned(padded.data, paddedSign.data, output1.data); \
+			REQUIRE( 0 == swifft.hash.SWIFFT_ComputeShortSigned(m, input.data, sign.data, output2.data) ); \
+			REQUIRE( output1 == output2 ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+	// the templates, on inputs with no alignment
+	srand(2);
+	SwifftInput padded, paddedSign;
+	SwifftOutput output1, output2;
+	BitSequence unaligned[1 + 12*8], unalignedSign[1 + 12*8];
+	randomize(&padded, 1);
+	randomize(&paddedSign, 1);
+	memset(padded.data + 12*8, 0, SWIFFT_INPUT_BLOCK_SIZE - 12*8);
+	memset(paddedSign.data + 12*8, 0, SWIFFT_INPUT_BLOCK_SIZE - 12*8);
+	memcpy(unaligned + 1, padded.data, 12*8);
+	memcpy(unalignedSign + 1, paddedSign.data, 12*8);
+	REQUIRE( Swifft<SwifftIsetBest, 12>::INPUT_SIZE == 12*8 );
+	SWIFFT_Compute(padded.data, output1.data);
+	REQUIRE( Swifft<SwifftIsetBest, 12>::Compute(output2, unaligned + 1) == output1 );
+	SWIFFT_ComputeSigned(padded.data, paddedSign.data, output1.data);
+	REQUIRE( Swifft<SwifftIsetBest, 12>::Compute(output2, unaligned + 1, unalignedSign + 1) == output1 );
+#if defined(__x86_64__) || defined(__i386__)
+	if (SWIFFT_IsSupported_AVX2()) {
+		REQUIRE( Swifft<SwifftIsetAVX2, 12>::Compute(output2, unaligned + 1, unalignedSign + 1) == output1 );
+	}
+#endif
+}
+
+TEST_CASE( "swifft structure-of-arrays conversions round-trip and pad with zero blocks", "[swifft]" ) {
+	const int n = 33;
+	const int nbatches = SWIFFT_SOA_BATCHES(n);
+	Array<SwifftInput> input(n), input2(n);
+	Array<SwifftOutput> output(n), output2(n);
+	Array<BitSequence> soaInput(nbatches * SWIFFT_SOA_INPUT_BATCH_SIZE);
+	Array<BitSequence> soaOutput(nbatches * SWIFFT_SOA_OUTPUT_BATCH_SIZE);
+	srand(1);
+	randomize(input.array, n);
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<SWIFFT_OUTPUT_BLOCK_SIZE; j++) {
+			output.array[i].data[j] = rand() & 0xFF;
+		}
+	}
+	SWIFFT_InputToSoA(n, input.array[0].data, soaInput.array);
+	SWIFFT_OutputToSoA(n, output.array[0].data, soaOutput.array);
+	for (int i=0; i<n; i++) {
+		CAPTURE( i );
+		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+			CAPTURE( j );
+			REQUIRE( soaInput.array[(i / SWIFFT_SOA_BLOCKS) * SWIFFT_SOA_INPUT_BATCH_SIZE + j * SWIFFT_SOA_BLOCKS + i % SWIFFT_SOA_BLOCKS] == input.array[i].data[j] );
+		}
+	}
+	for (int i=n; i<nbatches * SWIFFT_SOA_BLOCKS; i++) {
+		CAPTURE( i );
+		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+			CAPTURE( j );
+			REQUIRE( soaInput.array[(i / SWIFFT_SOA_BLOCKS) * SWIFFT_SOA_INPUT_BATCH_SIZE + j * SWIFFT_SOA_BLOCKS + i % SWIFFT_SOA_BLOCKS] == 0 );
+		}
+	}
+	SWIFFT_InputFromSoA(n, soaInput.array, input2.array[0].data);
+	SWIFFT_OutputFromSoA(n, soaOutput.array, output2.array[0].data);
+	for (int i=0; i<n; i++) {
+		CAPTURE( i );
+		REQUIRE( memcmp(input.array[i].data, input2.array[i].data, SWIFFT_INPUT_BLOCK_SIZE) == 0 );
+		REQUIRE( output.array[i] == output2.array[i] );
+	}
+}
+
+TEST_CASE( "swifft computes multiple in the structure-of-arrays layout the same as in blocks", "[swifft]" ) {
+	const int ns[] = {1, 31, 32, 33, 67};
+	const int nmax = 67;
+	const int nbatches = SWIFFT_SOA_BATCHES(nmax);
+	Array<SwifftInput> input(nmax);
+	Array<SwifftOutput> output1(nmax), output2(nmax);
+	Array<BitSequence> soaInput(nbatches * SWIFFT_SOA_INPUT_BATCH_SIZE);
+	Array<BitSequence> soaOutput(nbatches * SWIFFT_SOA_OUTPUT_BATCH_SIZE);
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		for (int n : ns) { \
+			CAPTURE( n ); \
+			randomize(input.array, n); \
+			swifft.hash.SWIFFT_ComputeMultiple(n, input.array[0].data, output1.array[0].data); \
+			SWIFFT_InputToSoA(n, input.array[0].data, soaInput.array); \
+			swifft.hash.SWIFFT_ComputeMultipleSoA(n, soaInput.array, soaOutput.array); \
+			SWIFFT_OutputFromSoA(n, soaOutput.array, output2.array[0].data); \
+			for (int i=0; i<n; i++) { \
+				CAPTURE( i ); \
+				REQUIRE( output1.array[i] == output2.array[i] ); \
+			} \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft runtime keys are normalized and deterministic", "[swifft]" ) {
+	SWIFFT_ALIGN swifft_key_t key0, key1;
+	SWIFFT_ALIGN int16_t elements[SWIFFT_KEY_SIZE];
+	srand(1);
+	for (int i=0; i<SWIFFT_KEY_SIZE; i++) {
+		elements[i] = (int16_t)(rand() % 257);
+	}
+	SWIFFT_InitKey(&key0, elements);
+	for (int i=0; i<SWIFFT_KEY_SIZE; i++) {
+		CAPTURE( i );
+		REQUIRE( key0.elements[i] >= -128 );
+		REQUIRE( key0.elements[i] <= 128 );
+		REQUIRE( (key0.elements[i] - elements[i]) % SWIFFT_P == 0 );
+		elements[i] += (i & 1) ? SWIFFT_P : -2*SWIFFT_P;
+	}
+	SWIFFT_InitKey(&key1, elements);
+	REQUIRE( memcmp(&key0, &key1, sizeof(swifft_key_t)) == 0 );
+
+	SWIFFT_InitKeyPI(&key0);
+	memcpy(elements, SWIFFT_PI_key, sizeof(elements));
+	SWIFFT_InitKey(&key1, elements);
+	REQUIRE( memcmp(&key0, &key1, sizeof(swifft_key_t)) == 0 );
+
+	SWIFFT_InitKeyFromSeed(&key0, "seed", 4);
+	SWIFFT_InitKeyFromSeed(&key1, "seed", 4);
+	REQUIRE( memcmp(&key0, &key1, sizeof(swifft_key_t)) == 0 );
+	SWIFFT_InitKeyFromSeed(&key1, "seee", 4);
+	REQUIRE( memcmp(&key0, &key1, sizeof(swifft_key_t)) != 0 );
+	SWIFFT_InitKeyFromSeed(&key1, "seed", 3);
+	REQUIRE( memcmp(&key0, &key1, sizeof(swifft_key_t)) != 0 );
+	int counts[SWIFFT_P] = {0};
+	for (int i=0; i<SWIFFT_KEY_SIZE; i++) {
+		counts[(key0.elements[i] + SWIFFT_P) % SWIFFT_P]++;
+	}
+	REQUIRE( *std::max_element(counts, counts + SWIFFT_P) < 4 * SWIFFT_KEY_SIZE / SWIFFT_P );
+}
+
+TEST_CASE( "swifft computes multiple with compact sign forms the same as with sign bytes", "[swifft]" ) {
+	const int n = 23;
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> output1(n), output2(n);
+	Array<BitSequence> signMask(n * SWIFFT_SIGN_MASK_BLOCK_SIZE), signs(n);
+	srand(1);
+	randomize(input.array, n);
+	for (int i=0; i<n; i++) {
+		// blocks 0-3 have zero sign bits, blocks 4-7 have the same ones, and the others random ones
+		for (int j=0; j<SWIFFT_SIGN_MASK_BLOCK_SIZE; j++) {
+			signMask.array[i * SWIFFT_SIGN_MASK_BLOCK_SIZE + j] = (i < 4) ? 0 : (i < 8) ? (BitSequence)(j * 37) : (BitSequence)rand();
+		}
+		signs.array[i] = (i < 4) ? 0 : (i < 8) ? 0xA5 : (BitSequence)rand();
+	}
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		for (int i=0; i<n; i++) { \
+			for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) { \
+				sign.array[i].data[j] = ((signMask.array[i * SWIFFT_SIGN_MASK_BLOCK_SIZE + j / 8] >> (j % 8)) & 1) ? 0xFF : 0; \
+			} \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, output1.array[0].data); \
+		swifft.hash.SWIFFT_ComputeMultipleSignMask(n, input.array[0].data, signMask.array, output2.array[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( output1.array[i] == output2.array[i] ); \
+		} \
+		for (int i=0; i<n; i++) { \
+			memset(sign.array[i].data, signs.array[i], SWIFFT_INPUT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, output1.array[0].data); \
+		swifft.hash.SWIFFT_ComputeMultipleUniformSign(n, input.array[0].data, signs.array, output2.array[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( output1.array[i] == output2.array[i] ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft strided and gather functions compute the same as those on packed blocks", "[swifft]" ) {
+	// records of an odd-sized header followed by an input, sign bits, a hash value and a compacted one, so that no block is aligned
+	const int n = 23;
+	const size_t header = 7, inputAt = header, signAt = inputAt + SWIFFT_INPUT_BLOCK_SIZE,
+		outputAt = signAt + SWIFFT_INPUT_BLOCK_SIZE, compactAt = outputAt + SWIFFT_OUTPUT_BLOCK_SIZE,
+		record = compactAt + SWIFFT_COMPACT_BLOCK_SIZE;
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> output(n), operand(n), expected(n);
+	Array<SwifftCompact> compact(n), expectedCompact(n);
+	Array<BitSequence> records((int)(n * record + SWIFFT_ALIGNMENT));
+	const BitSequence *inputs[n], *signs[n], *outputs[n], *operands[n];
+	BitSequence *routputs[n], *rcompacts[n];
+	srand(1);
+	randomize(input.array, n);
+	randomize(sign.array, n);
+	for (int i=0; i<n; i++) {
+		BitSequence *r = records.array + i * record;
+		memcpy(r + inputAt, input.array[i].data, SWIFFT_INPUT_BLOCK_SIZE);
+		memcpy(r + signAt, sign.array[i].data, SWIFFT_INPUT_BLOCK_SIZE);
+		inputs[i] = r + inputAt;
+		signs[i] = r + signAt;
+		outputs[i] = routputs[i] = r + outputAt;
+		rcompacts[i] = r + compactAt;
+		operands[i] = operand.array[i].data;
+	}
+#define REQUIRE_RECORDS(expected, at, size) \
+	for (int i=0; i<n; i++) { \
+		CAPTURE( i ); \
+		REQUIRE( memcmp(expected.array[i].data, records.array + i * record + at, size) == 0 ); \
+	}
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		swifft.hash.SWIFFT_ComputeMultiple(n, input.array[0].data, expected.array[0].data); \
+		swifft.hash.SWIFFT_ComputeMultipleStrided(n, records.array + inputAt, record, records.array + outputAt, record); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		for (int i=0; i<n; i++) { \
+			memset(routputs[i], 0, SWIFFT_OUTPUT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleGather(n, inputs, routputs); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		swifft.hash.SWIFFT_ComputeMultipleSignedStrided(n, records.array + inputAt, record, sign.array[0].data, 0, records.array + outputAt, record); \
+		for (int i=0; i<n; i++) { \
+			memcpy(sign.array[i].data, sign.array[0].data, SWIFFT_INPUT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expected.array[0].data); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		randomize(sign.array, n); \
+		for (int i=0; i<n; i++) { \
+			memcpy((BitSequence *)signs[i], sign.array[i].data, SWIFFT_INPUT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expected.array[0].data); \
+		swifft.hash.SWIFFT_ComputeMultipleSignedStrided(n, records.array + inputAt, record, records.array + signAt, record, records.array + outputAt, record); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		for (int i=0; i<n; i++) { \
+			memset(routputs[i], 0, SWIFFT_OUTPUT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSignedGather(n, inputs, signs, routputs); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		swifft.hash.SWIFFT_CompactMultiple(n, expected.array[0].data, expectedCompact.array[0].data); \
+		swifft.hash.SWIFFT_CompactMultipleStrided(n, records.array + outputAt, record, records.array + compactAt, record); \
+		REQUIRE_RECORDS(expectedCompact, compactAt, SWIFFT_COMPACT_BLOCK_SIZE) \
+		swifft.hash.SWIFFT_CompactMultipleStrided(n, expected.array[0].data, SWIFFT_OUTPUT_BLOCK_SIZE, compact.array[0].data, SWIFFT_COMPACT_BLOCK_SIZE); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( compact.array[i] == expectedCompact.array[i] ); \
+		} \
+		for (int i=0; i<n; i++) { \
+			memset(rcompacts[i], 0, SWIFFT_COMPACT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_CompactMultipleGather(n, outputs, rcompacts); \
+		REQUIRE_RECORDS(expectedCompact, compactAt, SWIFFT_COMPACT_BLOCK_SIZE) \
+		swifft.hash.SWIFFT_ComputeCompactMultiple(n, input.array[0].data, expectedCompact.array[0].data); \
+		swifft.hash.SWIFFT_ComputeCompactMultipleStrided(n, records.array + inputAt, record, records.array + compactAt, record); \
+		REQUIRE_RECORDS(expectedCompact, compactAt, SWIFFT_COMPACT_BLOCK_SIZE) \
+		for (int i=0; i<n; i++) { \
+			memset(rcompacts[i], 0, SWIFFT_COMPACT_BLOCK_SIZE); \
+		} \
+		swifft.hash.SWIFFT_ComputeCompactMultipleGather(n, inputs, rcompacts); \
+		REQUIRE_RECORDS(expectedCompact, compactAt, SWIFFT_COMPACT_BLOCK_SIZE) \
+		for (int i=0; i<n; i++) { \
+			randomize_elements(output.array[i]); \
+			randomize_elements(operand.array[i]); \
+			memcpy(routputs[i], output.array[i].data, SWIFFT_OUTPUT_BLOCK_SIZE); \
+		} \
+		memcpy(expected.array[0].data, output.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE); \
+		swifft.arith.SWIFFT_AddMultiple(n, expected.array[0].data, operand.array[0].data); \
+		swifft.arith.SWIFFT_AddMultipleStrided(n, records.array + outputAt, record, operand.array[0].data, SWIFFT_OUTPUT_BLOCK_SIZE); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		swifft.arith.SWIFFT_SubMultiple(n, expected.array[0].data, operand.array[0].data); \
+		swifft.arith.SWIFFT_SubMultipleGather(n, routputs, operands); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		swifft.arith.SWIFFT_MulMultiple(n, expected.array[0].data, operand.array[0].data); \
+		swifft.arith.SWIFFT_MulMultipleGather(n, routputs, operands); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		for (int i=0; i<n; i++) { \
+			swifft.arith.SWIFFT_Sub(expected.array[i].data, operand.array[0].data); \
+		} \
+		swifft.arith.SWIFFT_SubMultipleStrided(n, records.array + outputAt, record, operand.array[0].data, 0); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		swifft.arith.SWIFFT_AddMultiple(n, expected.array[0].data, operand.array[0].data); \
+		swifft.arith.SWIFFT_AddMultipleGather(n, routputs, operands); \
+		REQUIRE_RECORDS(expected, outputAt, SWIFFT_OUTPUT_BLOCK_SIZE) \
+		memcpy(output.array[0].data, expected.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE); \
+		swifft.arith.SWIFFT_MulMultipleStrided(n, output.array[0].data, SWIFFT_OUTPUT_BLOCK_SIZE, operand.array[0].data, 0); \
+		for (int i=0; i<n; i++) { \
+			swifft.arith.SWIFFT_Mul(expected.array[i].data, operand.array[0].data); \
+			CAPTURE( i ); \
+			REQUIRE( output.array[i] == expected.array[i] ); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleGather(0, NULL, NULL); \
+		swifft.arith.SWIFFT_AddMultipleGather(0, NULL, NULL); \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+#undef REQUIRE_RECORDS
+}
+
+TEST_CASE( "swifft multi-key functions compute the same as those with a given key", "[swifft]" ) {
+	const int nks[] = {0, 1, 3, 4, 5, 9};
+	const int nkmax = 9, n = 13;
+	Array<swifft_key_t> keys(nkmax);
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> output(n * nkmax), expected(n);
+	for (int k=0; k<nkmax; k++) {
+		SWIFFT_InitKeyFromSeed(&keys.array[k], &k, sizeof(k));
+	}
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		randomize(input.array, n); \
+		randomize(sign.array, n); \
+		for (int nk : nks) { \
+			CAPTURE( nk ); \
+			for (int k=0; k<nk; k++) { \
+				CAPTURE( k ); \
+				swifft.hash.SWIFFT_ComputeMultiKey(nk, keys.array, input.array[0].data, output.array[0].data); \
+				swifft.hash.SWIFFT_ComputeWithKey(&keys.array[k], input.array[0].data, expected.array[0].data); \
+				REQUIRE( output.array[k] == expected.array[0] ); \
+				swifft.hash.SWIFFT_ComputeMultiKeySigned(nk, keys.array, input.array[0].data, sign.array[0].data, output.array[0].data); \
+				swifft.hash.SWIFFT_ComputeWithKeySigned(&keys.array[k], input.array[0].data, sign.array[0].data, expected.array[0].data); \
+				REQUIRE( output.array[k] == expected.array[0] ); \
+				swifft.hash.SWIFFT_ComputeMultiKeyMultiple(n, nk, keys.array, input.array[0].data, output.array[0].data); \
+				swifft.hash.SWIFFT_ComputeWithKeyMultiple(n, &keys.array[k], input.array[0].data, expected.array[0].data); \
+				for (int i=0; i<n; i++) { \
+					CAPTURE( i ); \
+					REQUIRE( output.array[i * nk + k] == expected.array[i] ); \
+				} \
+				swifft.hash.SWIFFT_ComputeMultiKeyMultipleSigned(n, nk, keys.array, input.array[0].data, sign.array[0].data, output.array[0].data); \
+				swifft.hash.SWIFFT_ComputeWithKeyMultipleSigned(n, &keys.array[k], input.array[0].data, sign.array[0].data, expected.array[0].data); \
+				for (int i=0; i<n; i++) { \
+					CAPTURE( i ); \
+					REQUIRE( output.array[i * nk + k] == expected.array[i] ); \
+				} \
+			} \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft computes the same in the small and large FFT table modes", "[swifft]" ) {
+	int mode = SWIFFT_GetFftTableMode();
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		SwifftInput input = {0}; \
+		SwifftInput sign = {0}; \
+		SWIFFT_ALIGN int16_t fftout1[SWIFFT_N*SWIFFT_M]; \
+		SWIFFT_ALIGN int16_t fftout2[SWIFFT_N*SWIFFT_M]; \
+		for (int w=0; w<SWIFFT_INPUT_BLOCK_SIZE; w++) { \
+			CAPTURE( w ); \
+			for (int x=0; x<SWIFFT_INPUT_BLOCK_SIZE; x++) { \
+				input.data[x] = x; \
+				sign.data[x] = w; \
+			} \
+			SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_LARGE); \
+			swifft.fft.SWIFFT_fft(input.data, sign.data, SWIFFT_M, fftout1); \
+			SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_SMALL); \
+			swifft.fft.SWIFFT_fft(input.data, sign.data, SWIFFT_M, fftout2); \
+			REQUIRE( 0 == memcmp(fftout1, fftout2, sizeof(fftout1)) ); \
+		} \
+		srand(1); \
+		const int n = 13; \
+		SwifftInput inputs[n]; \
+		SwifftInput signs[n]; \
+		SwifftOutput output1[n]; \
+		SwifftOutput output2[n]; \
+		randomize(inputs, n); \
+		randomize(signs, n); \
+		SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_LARGE); \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, inputs[0].data, signs[0].data, output1[0].data); \
+		SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_SMALL); \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, inputs[0].data, signs[0].data, output2[0].data); \
+		for (int i=0; i<n; i++) { \
+			REQUIRE( output1[i] == output2[i] ); \
+		} \
+		SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_LARGE); \
+		swifft.hash.SWIFFT_ComputeMultiple(n, inputs[0].data, output1[0].data); \
+		SWIFFT_SetFftTableMode(SWIFFT_FFT_TABLE_SMALL); \
+		swifft.hash.SWIFFT_ComputeMultiple(n, inputs[0].data, output2[0].data); \
+		for (int i=0; i<n; i++) { \
+			REQUIRE( output1[i] == output2[i] ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+	SWIFFT_SetFftTableMode(-1);
+	CHECK( SWIFFT_GetFftTableMode() == SWIFFT_FFT_TABLE_LARGE );
+	SWIFFT_SetFftTableMode(mode);
+}
+
+TEST_CASE( "SWIFFT_safeMult is correct on the range [-128+1,128-1]*[-128,128]", "[swifft]" ) {
+	for (int16_t i=-128+1; i<=128-1; i++) {
+		CAPTURE( i );
+		for (int16_t j=-128; j<=128; j++) {
+			CAPTURE( j );
+			ZOvec v = ZOCONST(i);
+			ZOvec u = ZOCONST(j);
+			ZOvec m0 = u * v;
+			ZOvec m1 = SWIFFT_safeMult(u, v);
+			int16_t m0x = *(int16_t *)&m0;
+			CAPTURE( m0x );
+			int32_t m32 = (int32_t)i * (int32_t)j;
+			CAPTURE( m32 );
+			if (m32 >= 1 << 15) m0x += 1;
+			if (-m32 > 1 << 15) m0x -= 1;
+			CAPTURE( m0x );
+			int16_t m0xp = m0x % SWIFFT_P;
+			if (m0xp < 0) m0xp += SWIFFT_P;
+			int32_t m32p = m32 % SWIFFT_P;
+			if (m32p < 0) m32p += SWIFFT_P;
+			REQUIRE( m32p == m0xp );
+			int16_t m1x = *(int16_t *)&m1;
+			int16_t m1xp = m1x % SWIFFT_P;
+			if (m1xp < 0) m1xp += SWIFFT_P;
+			REQUIRE( m0xp == m1xp );
+		}
+	}
+}
+
+TEST_CASE( "swifft with sign is consistent", "[swifft]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitObject(&swifft);
+	srand(1);
+	SwifftInput input[3] = {0}, sign[3] = {0}, zeroinput = {0};
+	SwifftOutput output[3] = {0}, zerooutput = {0};
+	// set up input
+	for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+		input[0].data[j] = rand() & 0xFF;
+	}
+	// check input and its output are not zero
+	REQUIRE( input[0] != zeroinput );
+	swifft.hash.SWIFFT_Compute(input[0].data, output[0].data);
+	REQUIRE( output[0] != zerooutput );
+	// check positive sign gets the same output
+	swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[1].data, output[1].data);
+	REQUIRE( output[0] == output[1] );
+	// check negative sign gets the mod-SWIFFT_P negative output
+	for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+		sign[2].data[j] = 0xFF;
+	}
+	swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[2].data, output[2].data);
+	REQUIRE( output[2] != zerooutput );
+	for (int j=0; j<SWIFFT_OUTPUT_BLOCK_SIZE/2; j++) {
+		int v0 = ((int16_t *)output[0].data)[j];
+		int v2 = ((int16_t *)output[2].data)[j];
+		CAPTURE( j );
+		CAPTURE( v0 );
+		CAPTURE( v2 );
+		int summod = (v0 + v2) % SWIFFT_P;
+		REQUIRE( summod == 0 );
+	}
+	// check that adding positive and negative gives zero
+	swifft.arith.SWIFFT_Add(output[2].data, output[1].data);
+	REQUIRE( output[2] == zerooutput );
+	// check that negating a sign vector gives mod-SWIFFT_P negative output
+	for (int i=0; i<8; i++) {
+		CAPTURE( i );
+		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+			sign[1].data[j] = j & ~(1 << i);
+			sign[2].data[j] = ~sign[1].data[j];
+		}
+		swifft.arith.SWIFFT_ConstSet(output[0].data, 0);
+		for (int k=1; k<3; k++) {
+			CAPTURE( k );
+			swifft.hash.SWIFFT_ComputeSigned(input[0].data, sign[k].data, output[k].data);
+			REQUIRE( output[k] != zerooutput );
+			swifft.arith.SWIFFT_Add(output[0].data, output[k].data);
+		}
+		REQUIRE( output[0] == zerooutput );
+	}
+	// check splitting a signed input and composing back outputs
+	for (int i=0; i<8; i++) {
+		CAPTURE( i );
+		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+			CAPTURE( j );
+			// input is random with random sign
+			input[0].data[j] = rand() & 0xFF;
+			sign[0].data[j] = rand() & 0xFF;
+			// select where one split would be non-zero (half of bits on average)
+			BitSequence select = rand() & 0xFF;
+			// one split has the same sign except where zero is selected
+			input[1].data[j] = select;
+			sign[1].data[j] = sign[0].data[j];
+			// second split has inverted sign when data is zero and inverted zero selection otherwise
+			input[2].data[j] = input[0].data[j] ^ select;
+			sign[2].data[j] = sign[0].data[j] ^ ~input[0].data[j];
+			// canonicalize: input sign is zero if data is zero
+			CAPTURE( (int)sign[0].data[j] );
+			CAPTURE( (int)sign[1].data[j] );
+			CAPTURE( (int)sign[2].data[j] );
+			sign[0].data[j] &= input[0].data[j];
+			sign[1].data[j] &= input[1].data[j];
+			sign[2].data[j] &= input[2].data[j];
+			CAPTURE( (int)input[0].data[j] );
+			CAPTURE( (int)input[1].data[j] );
+			CAPTURE( (int)input[2].data[j] );
+			CAPTURE( (int)sign[0].data[j] );
 			CAPTURE( (int)sign[1].data[j] );
 			CAPTURE( (int)sign[2].data[j] );
 			// sanity check that, per signed bit the sum of the splits recovers the input
@@ -991,15 +1944,7 @@ TEST_CASE( "swifft compacts correctly (specific input)", "[swifft]" ) {
 		} \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
@@ -1019,15 +1964,7 @@ TEST_CASE( "swifft compacts signed correctly (specific input)", "[swifft]" ) {
 		} \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
@@ -1044,15 +1981,7 @@ TEST_CASE( "swifft computes multiple correctly (specific input)", "[swifft]" ) {
 		} \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
@@ -1070,18 +1999,39 @@ TEST_CASE( "swifft computes multiple signed correctly (specific input)", "[swiff
 		} \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
+TEST_CASE( "SWIFFT_InitBestObject selects the most advanced supported instruction-set", "[swifft]" ) {
+	swifft_object_t swifft;
+	SWIFFT_InitBestObject(&swifft);
+#if defined(__aarch64__)
+	REQUIRE( SWIFFT_IsSupported_NEON() );
+	CHECK( swifft.hash.SWIFFT_Compute == SWIFFT_Compute_NEON );
+#else
+	REQUIRE( SWIFFT_IsSupported_AVX() );
+	if (SWIFFT_IsSupported_AVX512BW()) {
+		CHECK( swifft.hash.SWIFFT_Compute == SWIFFT_Compute_AVX512BW );
+	}
+	else if (SWIFFT_IsSupported_AVX512()) {
+		CHECK( swifft.hash.SWIFFT_Compute == SWIFFT_Compute_AVX512 );
+	}
+	else if (SWIFFT_IsSupported_AVX2()) {
+		CHECK( swifft.hash.SWIFFT_Compute == SWIFFT_Compute_AVX2 );
+	}
+	else {
+		CHECK( swifft.hash.SWIFFT_Compute == SWIFFT_Compute_AVX );
+	}
+#endif
+	SwifftOutput output;
+	for (int i=0; i<ninputs; i++) {
+		CAPTURE( i );
+		swifft.hash.SWIFFT_Compute(specific_input1[i].data, output.data);
+		REQUIRE( output == specific_output1[i] );
+	}
+}
+
 TEST_CASE( "swifft vector-and-const operations compute correctly", "[swifft]" ) {
 #define TESTCODE(suffix) \
 	{ \
@@ -1105,15 +2055,7 @@ TEST_CASE( "swifft vector-and-const operations compute correctly", "[swifft]" )
 		REQUIRE( output1 == output2 ); \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
@@ -1136,18 +2078,79 @@ TEST_CASE( "swifft two-vectors operations compute correctly", "[swifft]" ) {
 		REQUIRE( output1 == output2 ); \
 	}
 	TESTCODE()
-#if defined(__AVX__)
-	TESTCODE(_AVX)
-#endif
-#if defined(__AVX2__)
-	TESTCODE(_AVX2)
-#endif
-#if defined(__AVX512F__)
-	TESTCODE(_AVX512)
-#endif
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft arithmetic operations compute mod 257 for any operands", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		const int16_t values[] = {256, -32768, 32767, 1000}; \
+		srand(1); \
+		for (int r=0; r<100; r++) { \
+			SwifftOutput a, b, c; \
+			randomize_elements(a); \
+			randomize_elements(b); \
+			const int16_t value = (r < 4) ? values[r] : (int16_t)rand(); \
+			const int n = SWIFFT_OUTPUT_BLOCK_SIZE/(int)sizeof(int16_t); \
+			c = a; swifft.arith.SWIFFT_Add(c.data, b.data); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) + element(b, j)) ); \
+			c = a; swifft.arith.SWIFFT_Sub(c.data, b.data); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) - element(b, j)) ); \
+			c = a; swifft.arith.SWIFFT_Mul(c.data, b.data); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) * element(b, j)) ); \
+			c = a; swifft.arith.SWIFFT_ConstAdd(c.data, value); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) + value) ); \
+			c = a; swifft.arith.SWIFFT_ConstSub(c.data, value); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) - value) ); \
+			c = a; swifft.arith.SWIFFT_ConstMul(c.data, value); \
+			for (int j=0; j<n; j++) REQUIRE( element(c, j) == mod257(element(a, j) * value) ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
 #undef TESTCODE
 }
 
+TEST_CASE( "swifft arithmetic expressions compute the same as one operation at a time", "[swifft]" ) {
+	const int n = SWIFFT_OUTPUT_BLOCK_SIZE/(int)sizeof(int16_t);
+	srand(1);
+	for (int r=0; r<100; r++) {
+		SwifftOutput a, b, c, d, e, f;
+		randomize_elements(a);
+		randomize_elements(b);
+		randomize_elements(c);
+		randomize_elements(d);
+		const int16_t value = (int16_t)rand();
+		SECTION( "accumulating a product" ) {
+			e = a; e += b*c - d;
+			f = b; f *= c; f -= d; f += a;
+			REQUIRE( e == f );
+			for (int j=0; j<n; j++) {
+				REQUIRE( element(e, j) == mod257(element(a, j) + element(b, j) * element(c, j) - element(d, j)) );
+			}
+		}
+		SECTION( "with values and the assigned output" ) {
+			e = a; e = (e*b + value) * (c - d*value) - e*e;
+			for (int j=0; j<n; j++) {
+				int64_t x = element(a, j), y = element(b, j), z = element(c, j), w = element(d, j);
+				REQUIRE( element(e, j) == mod257((x*y + value) * mod257(z - w*value) - x*x) );
+			}
+		}
+		SECTION( "deep chains" ) {
+			e = a + b + c + d + a + b + c + d + a + b + c + d + a + b + c + d + a + b + c + d;
+			f = a*b*c*d*a*b*c*d - (a - b - c - d - a - b - c - d - a - b - c - d - a - b - c - d);
+			for (int j=0; j<n; j++) {
+				int64_t x = element(a, j), y = element(b, j), z = element(c, j), w = element(d, j);
+				REQUIRE( element(e, j) == mod257(5*(x + y + z + w)) );
+				REQUIRE( element(f, j) == mod257(mod257(x*y*z*w) * mod257(x*y*z*w) - (x - 4*y - 4*z - 4*w - 3*x)) );
+			}
+		}
+	}
+}
+
 TEST_CASE( "swifft prints correctly (specific input)", "[swifft]" ) {
 	for (int i=0; i<ninputs; i++) {
 		std::stringstream s;
@@ -1239,6 +2242,101 @@ TEST_CODE(Sub)
 TEST_CODE(Mul)
 #undef TEST_CODE
 
+TEST_CASE( "swifft sums and linearly combines multiple blocks mod 257", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		for (int n : ns) { \
+			CAPTURE( n ); \
+			SwifftOutput sum, combination; \
+			swifft.arith.SWIFFT_SumMultiple(n, outputs.array[0].data, sum.data); \
+			swifft.arith.SWIFFT_LinearCombination(n, coeffs.data(), outputs.array[0].data, combination.data); \
+			for (int j=0; j<nelements; j++) { \
+				int64_t s = 0, c = 0; \
+				for (int i=0; i<n; i++) { \
+					s += element(outputs.array[i], j); \
+					c += (int64_t)coeffs[i] * element(outputs.array[i], j); \
+				} \
+				REQUIRE( element(sum, j) == mod257(s) ); \
+				REQUIRE( element(combination, j) == mod257(c) ); \
+			} \
+		} \
+	}
+	const int ns[] = {0, 1, 63, 64, 65, 200, 4095, 20000};
+	const int nmax = 20000, nelements = SWIFFT_OUTPUT_BLOCK_SIZE/(int)sizeof(int16_t);
+	Array<SwifftOutput> outputs(nmax);
+	std::vector<int16_t> coeffs(nmax);
+	srand(1);
+	for (int i=0; i<nmax; i++) {
+		randomize_elements(outputs.array[i]);
+		coeffs[i] = (i % 3 == 0) ? (int16_t)((i % 2 == 0) ? 256 : -32768) : (int16_t)rand();
+	}
+	// the worst case for the accumulator
+	for (int j=0; j<nelements; j++) {
+		((int16_t *)outputs.array[nmax-1].data)[j] = 256;
+		((int16_t *)outputs.array[nmax-2].data)[j] = 255;
+	}
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(3);
+	REQUIRE( pool != NULL );
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	SWIFFT_SetExecutor(pool);
+	TESTCODE()
+	TESTCODE_ISETS()
+	SwifftOutput sum1, sum2, combination1, combination2;
+	SWIFFT_SumMultiple(nmax, outputs.array[0].data, sum1.data);
+	SWIFFT_LinearCombination(nmax, coeffs.data(), outputs.array[0].data, combination1.data);
+	REQUIRE( SumMultiple(sum2, nmax, outputs.array) == sum1 );
+	REQUIRE( LinearCombination(combination2, nmax, coeffs.data(), outputs.array) == combination1 );
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_DestroyThreadPool(pool);
+#undef TESTCODE
+}
+
+//! \brief Runs a job over ranges of 37 blocks, whatever the grain, each on a thread of its own.
+static void test_swifft_misaligned_parallel_for(void *self, int nblocks, int grain, swifft_job_t job, void *context) {
+	(void)self;
+	(void)grain;
+	std::vector<std::thread> threads;
+	for (int begin=0; begin<nblocks; begin+=37) {
+		int end = std::min(begin + 37, nblocks);
+		threads.emplace_back([job, context, begin, end]() { job(context, begin, end); });
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+TEST_CASE( "swifft sums and linearly combines over ranges not starting at chunks", "[swifft]" ) {
+	const int n = 20000, nelements = SWIFFT_OUTPUT_BLOCK_SIZE/(int)sizeof(int16_t);
+	Array<SwifftOutput> outputs(n);
+	std::vector<int16_t> coeffs(n);
+	srand(1);
+	for (int i=0; i<n; i++) {
+		randomize_elements(outputs.array[i]);
+		coeffs[i] = (int16_t)rand();
+	}
+	const swifft_executor_t misaligned = { test_swifft_misaligned_parallel_for, NULL };
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_parallelization_t parallelization = { 0, 1 };
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_ARITH, &parallelization);
+	SWIFFT_SetExecutor(&misaligned);
+	SwifftOutput sum, combination;
+	SWIFFT_SumMultiple(n, outputs.array[0].data, sum.data);
+	SWIFFT_LinearCombination(n, coeffs.data(), outputs.array[0].data, combination.data);
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_ARITH, NULL);
+	for (int j=0; j<nelements; j++) {
+		int64_t s = 0, c = 0;
+		for (int i=0; i<n; i++) {
+			s += element(outputs.array[i], j);
+			c += (int64_t)coeffs[i] * element(outputs.array[i], j);
+		}
+		REQUIRE( element(sum, j) == mod257(s) );
+		REQUIRE( element(combination, j) == mod257(c) );
+	}
+}
+
 TEST_CASE( "swifft multiple compact computes correctly", "[swifft]" ) {
 	swifft_object_t swifft;
 	SWIFFT_InitObject(&swifft);
@@ -1266,4 +2364,910 @@ TEST_CASE( "swifft multiple compact computes correctly", "[swifft]" ) {
 	}
 }
 
+TEST_CASE( "swifft computes compact the same as compute followed by compact", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 67; \
+		SwifftInput input[n]; \
+		SwifftInput sign[n]; \
+		SwifftOutput output[n]; \
+		SwifftCompact compact1[n]; \
+		SwifftCompact compact2[n]; \
+		randomize(input, n); \
+		randomize(sign, n); \
+		swifft.hash.SWIFFT_ComputeMultiple(n, input[0].data, output[0].data); \
+		swifft.hash.SWIFFT_CompactMultiple(n, output[0].data, compact1[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			swifft.hash.SWIFFT_ComputeCompact(input[i].data, compact2[i].data); \
+			REQUIRE( compact1[i] == compact2[i] ); \
+		} \
+		for (int i=0; i<n; i++) { \
+			compact2[i] = (BitSequence)0; \
+		} \
+		swifft.hash.SWIFFT_ComputeCompactMultiple(n, input[0].data, compact2[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( compact1[i] == compact2[i] ); \
+		} \
+		swifft.hash.SWIFFT_ComputeMultipleSigned(n, input[0].data, sign[0].data, output[0].data); \
+		swifft.hash.SWIFFT_CompactMultiple(n, output[0].data, compact1[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			swifft.hash.SWIFFT_ComputeCompactSigned(input[i].data, sign[i].data, compact2[i].data); \
+			REQUIRE( compact1[i] == compact2[i] ); \
+		} \
+		for (int i=0; i<n; i++) { \
+			compact2[i] = (BitSequence)0; \
+		} \
+		swifft.hash.SWIFFT_ComputeCompactMultipleSigned(n, input[0].data, sign[0].data, compact2[0].data); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			REQUIRE( compact1[i] == compact2[i] ); \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+TEST_CASE( "swifft C++ compute of compact-forms is the same as the C API", "[swifft]" ) {
+	const int n = 9;
+	SwifftInput input[n];
+	SwifftInput sign[n];
+	SwifftCompact compact1[n];
+	SwifftCompact compact2[n];
+	srand(1);
+	randomize(input, n);
+	randomize(sign, n);
+	SWIFFT_ComputeCompactMultiple(n, input[0].data, compact1[0].data);
+	REQUIRE( ComputeMultiple(n, compact2, input) == compact2 );
+	for (int i=0; i<n; i++) {
+		CAPTURE( i );
+		REQUIRE( compact1[i] == compact2[i] );
+		REQUIRE( Compute(compact2[i], input[i]) == compact1[i] );
+	}
+	SWIFFT_ComputeCompactMultipleSigned(n, input[0].data, sign[0].data, compact1[0].data);
+	ComputeMultiple(n, compact2, input, sign);
+	for (int i=0; i<n; i++) {
+		CAPTURE( i );
+		REQUIRE( compact1[i] == compact2[i] );
+		REQUIRE( Compute(compact2[i], input[i], sign[i]) == compact1[i] );
+	}
+}
+
+TEST_CASE( "swifft multiple compact computes the same as compact per block across instruction-sets", "[swifft]" ) {
+#define TESTCODE(suffix) \
+	{ \
+		swifft_object_t swifft; \
+		SWIFFT_InitObject##suffix(&swifft); \
+		srand(1); \
+		const int n = 67; \
+		SwifftInput input[n]; \
+		SwifftOutput output[n]; \
+		SwifftCompact compact1[n]; \
+		SwifftCompact compact2[n]; \
+		randomize(input, n); \
+		swifft.hash.SWIFFT_ComputeMultiple(n, input[0].data, output[0].data); \
+		/* the extreme hash values, with a carry out of the base change */ \
+		output[1] = (int16_t)0; \
+		output[2] = (int16_t)(SWIFFT_P - 1); \
+		for (int i=0; i<n; i++) { \
+			CAPTURE( i ); \
+			swifft.hash.SWIFFT_Compact(output[i].data, compact1[i].data); \
+		} \
+		for (int offset=0; offset<4; offset++) { \
+			CAPTURE( offset ); \
+			swifft.hash.SWIFFT_CompactMultiple(n - offset, output[offset].data, compact2[offset].data); \
+			for (int i=offset; i<n; i++) { \
+				CAPTURE( i ); \
+				REQUIRE( compact1[i] == compact2[i] ); \
+			} \
+		} \
+	}
+	TESTCODE()
+	TESTCODE_ISETS()
+#undef TESTCODE
+}
+
+//! \brief Computes the stream digest of a message by chaining SWIFFT_Compute and SWIFFT_Compact over copied blocks.
+static void test_swifft_stream_reference(const BitSequence *data, size_t len, SwifftCompact &digest) {
+	std::vector<BitSequence> padded(data, data + len);
+	padded.push_back(0x80);
+	while (padded.size() % SWIFFT_STREAM_CHUNK_SIZE != SWIFFT_STREAM_CHUNK_SIZE - 8) {
+		padded.push_back(0);
+	}
+	uint64_t bitLength = 8 * (uint64_t)len;
+	for (int i=7; i>=0; i--) {
+		padded.push_back((BitSequence)(bitLength >> (8 * i)));
+	}
+	Set(digest, 0);
+	SwifftInput input;
+	SwifftOutput output;
+	for (size_t i=0; i<padded.size(); i+=SWIFFT_STREAM_CHUNK_SIZE) {
+		memcpy(input.data, digest.data, SWIFFT_COMPACT_BLOCK_SIZE);
+		memcpy(input.data + SWIFFT_COMPACT_BLOCK_SIZE, &padded[i], SWIFFT_STREAM_CHUNK_SIZE);
+		SWIFFT_Compute(input.data, output.data);
+		SWIFFT_Compact(output.data, digest.data);
+	}
+}
+
+TEST_CASE( "swifft stream computes the same as chained SWIFFT_Compute and SWIFFT_Compact", "[swifft]" ) {
+	srand(1);
+	std::vector<BitSequence> data(4 * SWIFFT_INPUT_BLOCK_SIZE + 1);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	for (size_t len=0; len<data.size(); len+=(len < 2 * SWIFFT_STREAM_CHUNK_SIZE ? 1 : 37)) {
+		CAPTURE( len );
+		SwifftCompact digest1, digest2;
+		test_swifft_stream_reference(data.data(), len, digest1);
+		// unaligned start
+		memmove(data.data() + 1, data.data(), len);
+		SWIFFT_StreamHash(data.data() + 1, len, digest2.data);
+		memmove(data.data(), data.data() + 1, len);
+		REQUIRE( digest1 == digest2 );
+	}
+}
+
+TEST_CASE( "SwifftHasher computes the same for any split of the message", "[swifft]" ) {
+	srand(1);
+	std::vector<BitSequence> data(3 * SWIFFT_INPUT_BLOCK_SIZE + 17);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	SwifftCompact digest1, digest2;
+	SWIFFT_StreamHash(data.data(), data.size(), digest1.data);
+	SwifftHasher hasher;
+	for (int r=0; r<100; r++) {
+		CAPTURE( r );
+		hasher.Reset();
+		size_t pos = 0;
+		while (pos < data.size()) {
+			size_t n = rand() % (r < 50 ? 8 : 2 * SWIFFT_INPUT_BLOCK_SIZE);
+			if (n > data.size() - pos) {
+				n = data.size() - pos;
+			}
+			hasher.Update(data.data() + pos, n);
+			pos += n;
+		}
+		hasher.Final(digest2);
+		REQUIRE( digest1 == digest2 );
+	}
+	hasher.Reset().Update(data.data(), data.size() - 1).Final(digest2);
+	REQUIRE( digest1 != digest2 );
+}
+
+//! \brief Computes the tree-hash digest of a message level by level, per its definition.
+static void test_swifft_tree_reference(const BitSequence *data, size_t len, SwifftCompact &digest) {
+	// nodes are kept as bytes, since std::vector does not honor SWIFFT_ALIGN
+	std::vector<BitSequence> nodes;
+	SwifftInput input;
+	SwifftOutput output;
+	SwifftCompact node;
+	size_t pos = 0;
+	do {
+		size_t n = std::min(len - pos, (size_t)SWIFFT_INPUT_BLOCK_SIZE);
+		Set(input, 0);
+		memcpy(input.data, data + pos, n);
+		SWIFFT_Compute(input.data, output.data);
+		SWIFFT_Compact(output.data, node.data);
+		nodes.insert(nodes.end(), node.data, node.data + SWIFFT_COMPACT_BLOCK_SIZE);
+		pos += n;
+	} while (pos < len);
+	for (int16_t level=1; nodes.size() > SWIFFT_COMPACT_BLOCK_SIZE; level++) {
+		std::vector<BitSequence> parents;
+		for (size_t i=0; i<nodes.size(); i+=SWIFFT_INPUT_BLOCK_SIZE) {
+			Set(input, 0);
+			memcpy(input.data, &nodes[i], std::min(nodes.size() - i, (size_t)SWIFFT_INPUT_BLOCK_SIZE));
+			SWIFFT_Compute(input.data, output.data);
+			SWIFFT_ConstAdd(output.data, level);
+			SWIFFT_Compact(output.data, node.data);
+			parents.insert(parents.end(), node.data, node.data + SWIFFT_COMPACT_BLOCK_SIZE);
+		}
+		nodes.swap(parents);
+	}
+	Set(input, 0);
+	memcpy(input.data, nodes.data(), SWIFFT_COMPACT_BLOCK_SIZE);
+	uint64_t bitLength = 8 * (uint64_t)len;
+	for (int i=0; i<8; i++) {
+		input.data[SWIFFT_COMPACT_BLOCK_SIZE + 7 - i] = (BitSequence)(bitLength >> (8 * i));
+	}
+	SWIFFT_Compute(input.data, output.data);
+	SWIFFT_ConstAdd(output.data, -1);
+	SWIFFT_Compact(output.data, digest.data);
+}
+
+TEST_CASE( "swifft tree-hash computes the same as its level by level definition", "[swifft]" ) {
+	const size_t batchSize = ((size_t)1 << (2 * SWIFFT_TREE_LOG4_BATCH)) * SWIFFT_INPUT_BLOCK_SIZE;
+	srand(1);
+	std::vector<BitSequence> data(5 * batchSize + 2 * SWIFFT_INPUT_BLOCK_SIZE);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	const size_t lens[] = {0, 1, 255, 256, 257, 1000, 4 * 256, 16 * 256 + 1,
+		batchSize - 1, batchSize, batchSize + 1, 4 * batchSize, 4 * batchSize + 256, 5 * batchSize + 300};
+	for (size_t len : lens) {
+		CAPTURE( len );
+		SwifftCompact digest1, digest2;
+		test_swifft_tree_reference(data.data() + 1, len, digest1);
+		REQUIRE( 0 == SWIFFT_TreeHash(data.data() + 1, len, digest2.data) );
+		REQUIRE( digest1 == digest2 );
+	}
+	SwifftCompact digest1, digest2;
+	SWIFFT_TreeHash(data.data(), 1000, digest1.data);
+	SWIFFT_TreeHash(data.data(), 1001, digest2.data);
+	REQUIRE( digest1 != digest2 );
+	SWIFFT_StreamHash(data.data(), 1000, digest2.data);
+	REQUIRE( digest1 != digest2 );
+}
+
+TEST_CASE( "swifft incremental tree-hash computes the same as the tree-hash for any split", "[swifft]" ) {
+	const size_t batchSize = ((size_t)1 << (2 * SWIFFT_TREE_LOG4_BATCH)) * SWIFFT_INPUT_BLOCK_SIZE;
+	srand(1);
+	std::vector<BitSequence> data(3 * batchSize + 1000);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	const size_t lens[] = {0, 1, 256, batchSize - 1, batchSize, batchSize + 1, 2 * batchSize, 3 * batchSize + 1000};
+	const size_t chunks[] = {1000, batchSize - 1, batchSize, batchSize + 1, 3 * batchSize};
+	swifft_tree_t *tree = SWIFFT_TreeCreate();
+	REQUIRE( tree != NULL );
+	for (size_t len : lens) {
+		CAPTURE( len );
+		SwifftCompact expected, digest;
+		REQUIRE( 0 == SWIFFT_TreeHash(data.data(), len, expected.data) );
+		for (size_t chunk : chunks) {
+			CAPTURE( chunk );
+			SWIFFT_TreeReset(tree);
+			for (size_t pos=0; pos<len; pos+=chunk) {
+				SWIFFT_TreeUpdate(tree, data.data() + pos, std::min(chunk, len - pos));
+				SWIFFT_TreeUpdate(tree, data.data(), 0);
+			}
+			SWIFFT_TreeFinal(tree, digest.data);
+			REQUIRE( digest == expected );
+		}
+	}
+	SWIFFT_TreeDestroy(tree);
+}
+
+TEST_CASE( "swifft file tree-hash computes the same whether mapped, read or piped", "[swifft]" ) {
+	const size_t len = 2 * SWIFFT_FILE_READ_SIZE + 12345;
+	srand(1);
+	std::vector<BitSequence> data(len);
+	for (size_t i=0; i<data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	char path[] = "/tmp/swifft_catch_XXXXXX";
+	int fd = mkstemp(path);
+	REQUIRE( fd >= 0 );
+	REQUIRE( write(fd, data.data(), len) == (ssize_t)len );
+	SwifftCompact expected, digest;
+	swifft_file_info_t info;
+	SWIFFT_TreeHash(data.data(), len, expected.data);
+	const int flags[] = {0, SWIFFT_FILE_NO_MAP, SWIFFT_FILE_DIRECT};
+	for (int f : flags) {
+		CAPTURE( f );
+		REQUIRE( 0 == SWIFFT_TreeHashFile(path, f, digest.data, &info) );
+		REQUIRE( digest == expected );
+		REQUIRE( info.bytes == len );
+		REQUIRE( info.mapped == (f == 0) );
+		// a file descriptor is hashed from its current offset, e.g. unaligned for O_DIRECT
+		REQUIRE( 1000 == lseek(fd, 1000, SEEK_SET) );
+		REQUIRE( 0 == SWIFFT_TreeHashFd(fd, f, digest.data, &info) );
+		SwifftCompact rest;
+		SWIFFT_TreeHash(data.data() + 1000, len - 1000, rest.data);
+		REQUIRE( digest == rest );
+		REQUIRE( (off_t)len == lseek(fd, 0, SEEK_CUR) );
+	}
+	close(fd);
+	unlink(path);
+	int pipefd[2];
+	REQUIRE( 0 == pipe(pipefd) );
+	std::thread writer([&data, &pipefd, len]() {
+		for (size_t pos=0; pos<len; ) {
+			ssize_t n = write(pipefd[1], data.data() + pos, std::min(len - pos, (size_t)100000));
+			if (n <= 0) {
+				break;
+			}
+			pos += n;
+		}
+		close(pipefd[1]);
+	});
+	REQUIRE( 0 == SWIFFT_TreeHashFd(pipefd[0], 0, digest.data, &info) );
+	writer.join();
+	close(pipefd[0]);
+	REQUIRE( digest == expected );
+	REQUIRE( info.bytes == len );
+	REQUIRE( !info.mapped );
+	REQUIRE( -1 == SWIFFT_TreeHashFile("/nonexistent/swifft", 0, digest.data, &info) );
+}
+
+//! \brief An executor running the ranges in reverse order on the calling thread, counting the runs of each block.
+struct TestReverseExecutor {
+	swifft_executor_t executor;
+	std::vector<int> runs;
+	int ncalls;
+	int nranges;
+	int grain;
+
+	TestReverseExecutor() : executor{ParallelFor, this}, ncalls(0), nranges(0), grain(0) {}
+
+	static void ParallelFor(void *self, int nblocks, int grain, swifft_job_t job, void *context) {
+		TestReverseExecutor *reverse = (TestReverseExecutor *)self;
+		reverse->ncalls++;
+		reverse->nranges = 0;
+		reverse->grain = grain;
+		reverse->runs.assign(nblocks, 0);
+		for (int begin=(nblocks - 1) / grain * grain; begin>=0; begin-=grain) {
+			int end = std::min(begin + grain, nblocks);
+			job(context, begin, end);
+			reverse->nranges++;
+			for (int i=begin; i<end; i++) {
+				reverse->runs[i]++;
+			}
+		}
+	}
+};
+
+//! \brief Computes with each of the functions for multiple blocks on the same blocks, into one byte vector.
+static std::vector<BitSequence> test_swifft_multiple_all(int n) {
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> output(n), operand(n);
+	Array<SwifftCompact> compact(n);
+	Array<int16_t> fftout(n * SWIFFT_INPUT_BLOCK_SIZE * 8);
+	std::vector<int16_t> constants(n);
+	std::vector<BitSequence> result;
+	auto append = [&result](const BitSequence *data, size_t size) { result.insert(result.end(), data, data + size); };
+	std::minstd_rand random(1); // rather than rand(), for calling from concurrent threads
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<SWIFFT_INPUT_BLOCK_SIZE; j++) {
+			input.array[i].data[j] = random() & 0xFF;
+			sign.array[i].data[j] = random() & 0xFF;
+		}
+		constants[i] = (int16_t)(random() % 257);
+	}
+	SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, operand.array[0].data);
+	append(operand.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_fftMultiple(n, input.array[0].data, sign.array[0].data, SWIFFT_INPUT_BLOCK_SIZE / 8, fftout.array);
+	SWIFFT_fftsumMultiple(n, SWIFFT_PI_key, fftout.array, SWIFFT_INPUT_BLOCK_SIZE / 8, (int16_t *)output.array[0].data);
+	append(output.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_ComputeMultiple(n, input.array[0].data, output.array[0].data);
+	append(output.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_ConstAddMultiple(n, output.array[0].data, constants.data());
+	SWIFFT_ConstMulMultiple(n, output.array[0].data, constants.data());
+	SWIFFT_AddMultiple(n, output.array[0].data, operand.array[0].data);
+	SWIFFT_MulMultiple(n, output.array[0].data, operand.array[0].data);
+	append(output.array[0].data, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_CompactMultiple(n, output.array[0].data, compact.array[0].data);
+	append(compact.array[0].data, n * SWIFFT_COMPACT_BLOCK_SIZE);
+	SwifftOutput sum, combination;
+	SWIFFT_SumMultiple(n, output.array[0].data, sum.data);
+	append(sum.data, SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_LinearCombination(n, constants.data(), output.array[0].data, combination.data);
+	append(combination.data, SWIFFT_OUTPUT_BLOCK_SIZE);
+	SWIFFT_ComputeCompactMultipleSigned(n, input.array[0].data, sign.array[0].data, compact.array[0].data);
+	append(compact.array[0].data, n * SWIFFT_COMPACT_BLOCK_SIZE);
+	Array<BitSequence> soaInput(SWIFFT_SOA_BATCHES(n) * SWIFFT_SOA_INPUT_BATCH_SIZE);
+	Array<BitSequence> soaOutput(SWIFFT_SOA_BATCHES(n) * SWIFFT_SOA_OUTPUT_BATCH_SIZE);
+	SWIFFT_InputToSoA(n, input.array[0].data, soaInput.array);
+	SWIFFT_ComputeMultipleSoA(n, soaInput.array, soaOutput.array);
+	append(soaOutput.array, SWIFFT_SOA_BATCHES(n) * SWIFFT_SOA_OUTPUT_BATCH_SIZE);
+	return result;
+}
+
+TEST_CASE( "swifft multiple functions compute the same with any executor", "[swifft]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	const int ns[] = {1, 8, 9, 64, 131};
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(3);
+	REQUIRE( pool != NULL );
+	const swifft_parallelization_t parallelization = {8, 8};
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, &parallelization);
+	}
+	for (int n : ns) {
+		CAPTURE( n );
+		SWIFFT_SetExecutor(NULL);
+		std::vector<BitSequence> expected = test_swifft_multiple_all(n);
+		SWIFFT_SetExecutor(SWIFFT_GetDefaultExecutor());
+		REQUIRE( expected == test_swifft_multiple_all(n) );
+		SWIFFT_SetExecutor(pool);
+		REQUIRE( expected == test_swifft_multiple_all(n) );
+		TestReverseExecutor reverse;
+		SWIFFT_SetExecutor(&reverse.executor);
+		REQUIRE( expected == test_swifft_multiple_all(n) );
+		// SWIFFT_ComputeMultipleSoA processes at least a batch of SWIFFT_SOA_BLOCKS blocks, and
+		// SWIFFT_{SumMultiple,LinearCombination} run in parallel only for more than a chunk of 64 blocks
+		REQUIRE( reverse.ncalls == ((n > 8) ? 11 : 1) + ((n > 64) ? 2 : 0) );
+		REQUIRE( (n <= 8 || std::all_of(reverse.runs.begin(), reverse.runs.end(), [](int runs) { return runs == 1; })) );
+	}
+	// concurrent calls on the pool run on their calling threads
+	SWIFFT_SetExecutor(pool);
+	std::vector<BitSequence> expected = test_swifft_multiple_all(131), result1, result2;
+	std::thread thread1([&result1]() { result1 = test_swifft_multiple_all(131); });
+	std::thread thread2([&result2]() { result2 = test_swifft_multiple_all(131); });
+	thread1.join();
+	thread2.join();
+	REQUIRE( expected == result1 );
+	REQUIRE( expected == result2 );
+	SWIFFT_DestroyThreadPool(pool);
+	REQUIRE( SWIFFT_GetExecutor() == NULL );
+	SWIFFT_SetExecutor(executor);
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, NULL);
+	}
+}
+
+TEST_CASE( "swifft multiple functions compute the same with a NUMA-aware thread pool", "[swifft]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	const int ns[] = {9, 64, 131};
+	const int flags[] = {0, SWIFFT_NUMA_PIN};
+	const swifft_parallelization_t parallelization = {8, 8};
+	REQUIRE( SWIFFT_NumaNodes() >= 1 );
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, &parallelization);
+	}
+	for (int f : flags) {
+		for (int nthreads=1; nthreads<=3; nthreads++) {
+			CAPTURE( f, nthreads );
+			swifft_executor_t *pool = SWIFFT_CreateNumaThreadPool(nthreads, f);
+			REQUIRE( pool != NULL );
+			for (int n : ns) {
+				CAPTURE( n );
+				SWIFFT_SetExecutor(NULL);
+				std::vector<BitSequence> expected = test_swifft_multiple_all(n);
+				SWIFFT_SetExecutor(pool);
+				REQUIRE( expected == test_swifft_multiple_all(n) );
+			}
+			SWIFFT_DestroyThreadPool(pool);
+			REQUIRE( SWIFFT_GetExecutor() == NULL );
+		}
+	}
+	SWIFFT_SetExecutor(executor);
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, NULL);
+	}
+}
+
+//! \brief Records the tickets of the completed batches of a queue.
+static void test_swifft_queue_completion(void *context, int64_t ticket) {
+	static_cast<std::vector<int64_t> *>(context)->push_back(ticket);
+}
+
+TEST_CASE( "swifft queue computes batches in order the same as the multiple functions", "[swifft]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(3);
+	REQUIRE( pool != NULL );
+	SWIFFT_SetExecutor(pool);
+	const int n = 37, nbatches = 8;
+	Array<SwifftInput> input(n * nbatches), sign(n * nbatches);
+	Array<SwifftOutput> output(n * nbatches), expectedOutput(n * nbatches);
+	Array<SwifftCompact> compact(n * nbatches), expectedCompact(n * nbatches);
+	randomize(input.array, n * nbatches);
+	randomize(sign.array, n * nbatches);
+	std::vector<int64_t> tickets;
+	swifft_queue_t *queue = SWIFFT_CreateQueue(2);
+	REQUIRE( queue != NULL );
+	for (int b=0; b<nbatches; b++) {
+		const int k = b * n;
+		swifft_batch_t batch = { n, input.array[k].data, (b & 1) ? sign.array[k].data : NULL,
+			(b & 2) ? compact.array[k].data : output.array[k].data, b & 2, test_swifft_queue_completion, &tickets };
+		REQUIRE( SWIFFT_QueueSubmit(queue, &batch) == b );
+		if (b & 2) {
+			if (b & 1) {
+				SWIFFT_ComputeCompactMultipleSigned(n, input.array[k].data, sign.array[k].data, expectedCompact.array[k].data);
+			} else {
+				SWIFFT_ComputeCompactMultiple(n, input.array[k].data, expectedCompact.array[k].data);
+			}
+		} else {
+			if (b & 1) {
+				SWIFFT_ComputeMultipleSigned(n, input.array[k].data, sign.array[k].data, expectedOutput.array[k].data);
+			} else {
+				SWIFFT_ComputeMultiple(n, input.array[k].data, expectedOutput.array[k].data);
+			}
+		}
+	}
+	SWIFFT_QueueWaitAll(queue);
+	for (int b=0; b<nbatches; b++) {
+		REQUIRE( SWIFFT_QueuePoll(queue, b) == 1 );
+	}
+	REQUIRE( tickets == std::vector<int64_t>({0, 1, 2, 3, 4, 5, 6, 7}) );
+	for (int b=0; b<nbatches; b++) {
+		CAPTURE( b );
+		for (int i=b*n; i<(b+1)*n; i++) {
+			if (b & 2) {
+				REQUIRE( compact.array[i] == expectedCompact.array[i] );
+			} else {
+				REQUIRE( output.array[i] == expectedOutput.array[i] );
+			}
+		}
+	}
+	swifft_batch_t invalid = { -1, input.array[0].data, NULL, output.array[0].data, 0, NULL, NULL };
+	REQUIRE( SWIFFT_QueueSubmit(queue, &invalid) == -1 );
+	SWIFFT_DestroyQueue(queue);
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_DestroyThreadPool(pool);
+}
+
+//! \brief The state of a completion callback blocking its queue until released.
+struct TestBlockingCompletion {
+	std::atomic<int> started{0};
+	std::atomic<int> released{0};
+};
+
+//! \brief Blocks the queue until released.
+static void test_swifft_queue_blocking_completion(void *context, int64_t ticket) {
+	TestBlockingCompletion *blocking = static_cast<TestBlockingCompletion *>(context);
+	(void)ticket;
+	blocking->started = 1;
+	while (!blocking->released) {
+		std::this_thread::yield();
+	}
+}
+
+TEST_CASE( "swifft queue applies back-pressure beyond its depth", "[swifft]" ) {
+	Array<SwifftInput> input(2);
+	Array<SwifftOutput> output(2);
+	randomize(input.array, 2);
+	TestBlockingCompletion blocking;
+	swifft_queue_t *queue = SWIFFT_CreateQueue(1);
+	REQUIRE( queue != NULL );
+	swifft_batch_t first = { 1, input.array[0].data, NULL, output.array[0].data, 0, test_swifft_queue_blocking_completion, &blocking };
+	swifft_batch_t second = { 1, input.array[1].data, NULL, output.array[1].data, 0, NULL, NULL };
+	REQUIRE( SWIFFT_QueueTrySubmit(queue, &first) == 0 );
+	while (!blocking.started) {
+		std::this_thread::yield();
+	}
+	// the first batch holds the only slot until its callback returns
+	REQUIRE( SWIFFT_QueuePoll(queue, 0) == 0 );
+	REQUIRE( SWIFFT_QueueTrySubmit(queue, &second) == -1 );
+	blocking.released = 1;
+	REQUIRE( SWIFFT_QueueSubmit(queue, &second) == 1 );
+	SWIFFT_QueueWait(queue, 1);
+	REQUIRE( SWIFFT_QueuePoll(queue, 0) == 1 );
+	REQUIRE( SWIFFT_QueuePoll(queue, 1) == 1 );
+	SwifftOutput expected;
+	SWIFFT_Compute(input.array[1].data, expected.data);
+	REQUIRE( output.array[1] == expected );
+	SWIFFT_DestroyQueue(queue);
+}
+
+TEST_CASE( "swifft C++ queue futures are ready with the same result as the C API", "[swifft]" ) {
+	const int n = 19;
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> output(n), expectedOutput(n);
+	Array<SwifftCompact> compact(n), expectedCompact(n);
+	randomize(input.array, n);
+	randomize(sign.array, n);
+	SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expectedOutput.array[0].data);
+	SWIFFT_ComputeCompactMultiple(n, input.array[0].data, expectedCompact.array[0].data);
+	{
+		SwifftQueue queue(2);
+		std::future<void> outputReady = queue.Submit(n, output.array, input.array, sign.array);
+		std::future<void> compactReady = queue.Submit(n, compact.array, input.array);
+		outputReady.get();
+		compactReady.get();
+		REQUIRE_THROWS_AS( queue.Submit(-1, output.array, input.array).get(), std::invalid_argument );
+	}
+	for (int i=0; i<n; i++) {
+		REQUIRE( output.array[i] == expectedOutput.array[i] );
+		REQUIRE( compact.array[i] == expectedCompact.array[i] );
+	}
+}
+
+TEST_CASE( "swifft pool reuses the chunks freed by a thread with any pages", "[swifft]" ) {
+	const int pages[] = {SWIFFT_POOL_PAGES_DEFAULT, SWIFFT_POOL_PAGES_THP, SWIFFT_POOL_PAGES_HUGETLB};
+	const size_t sizes[] = {0, 1000, SWIFFT_POOL_HUGE_SIZE, 3 * SWIFFT_POOL_HUGE_SIZE + 1};
+	const int oldPages = SWIFFT_GetPoolPages();
+	REQUIRE( SWIFFT_SetPoolPages(3) == -1 );
+	REQUIRE( SWIFFT_GetPoolPages() == oldPages );
+	for (int p : pages) {
+		REQUIRE( SWIFFT_SetPoolPages(p) == 0 );
+		REQUIRE( SWIFFT_GetPoolPages() == p );
+		SWIFFT_PoolTrim();
+		for (size_t size : sizes) {
+			unsigned char *ptr = static_cast<unsigned char *>(SWIFFT_PoolAlloc(size));
+			REQUIRE( ptr != NULL );
+			REQUIRE( reinterpret_cast<uintptr_t>(ptr) % SWIFFT_ALIGNMENT == 0 );
+			memset(ptr, 0x5a, size);
+			SWIFFT_PoolFree(ptr);
+			REQUIRE( SWIFFT_PoolCachedBytes() >= size );
+			REQUIRE( SWIFFT_PoolAlloc(size) == ptr );
+			SWIFFT_PoolFree(ptr);
+		}
+		SWIFFT_PoolTrim();
+		REQUIRE( SWIFFT_PoolCachedBytes() == 0 );
+	}
+	REQUIRE( SWIFFT_SetPoolPages(oldPages) == 0 );
+	SWIFFT_PoolFree(NULL);
+	REQUIRE( SWIFFT_PoolAlloc((size_t)-1) == NULL );
+}
+
+TEST_CASE( "swifft computes the same with the tables backed by any pages", "[swifft]" ) {
+	const int pages[] = {SWIFFT_POOL_PAGES_THP, SWIFFT_POOL_PAGES_HUGETLB, SWIFFT_POOL_PAGES_DEFAULT};
+	const int n = 13;
+	Array<SwifftInput> input(n), sign(n);
+	Array<SwifftOutput> expected(n), output(n);
+	Array<SwifftCompact> expectedCompact(n), compact(n);
+	randomize(input.array, n);
+	randomize(sign.array, n);
+	REQUIRE( SWIFFT_GetTablePages() == SWIFFT_POOL_PAGES_DEFAULT );
+	REQUIRE( SWIFFT_SetTablePages(-1) == -1 );
+	SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expected.array[0].data);
+	SWIFFT_ComputeCompactMultiple(n, input.array[0].data, expectedCompact.array[0].data);
+	for (int p : pages) {
+		REQUIRE( SWIFFT_SetTablePages(p) == 0 );
+		REQUIRE( SWIFFT_GetTablePages() == p );
+		SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, output.array[0].data);
+		SWIFFT_ComputeCompactMultiple(n, input.array[0].data, compact.array[0].data);
+		for (int i=0; i<n; i++) {
+			REQUIRE( output.array[i] == expected.array[i] );
+			REQUIRE( compact.array[i] == expectedCompact.array[i] );
+			SWIFFT_ComputeSigned(input.array[i].data, sign.array[i].data, output.array[i].data);
+			REQUIRE( output.array[i] == expected.array[i] );
+		}
+	}
+}
+
+TEST_CASE( "swifft C++ batches compute the same as the multiple functions", "[swifft]" ) {
+	const int n = 19;
+	SwifftInputBatch input(n), sign(n);
+	SwifftOutputBatch output(n), other(n), expected(n), operand(n);
+	SwifftCompactBatch compact(n), expectedCompact(n);
+	randomize(input.data, n);
+	randomize(sign.data, n);
+	for (int i=0; i<n; i++) {
+		randomize_elements(operand[i]);
+	}
+	SWIFFT_ComputeMultipleSigned(n, input[0].data, sign[0].data, expected[0].data);
+	Compute(output, input, sign);
+	SWIFFT_ComputeCompactMultipleSigned(n, input[0].data, sign[0].data, expectedCompact[0].data);
+	Compute(compact, input, sign);
+	for (int i=0; i<n; i++) {
+		REQUIRE( output[i] == expected[i] );
+		REQUIRE( compact[i] == expectedCompact[i] );
+	}
+	SWIFFT_ComputeMultiple(n, input[0].data, expected[0].data);
+	Compute(output, input);
+	SWIFFT_CompactMultiple(n, expected[0].data, expectedCompact[0].data);
+	Compact(compact, output);
+	for (int i=0; i<n; i++) {
+		REQUIRE( output[i] == expected[i] );
+		REQUIRE( compact[i] == expectedCompact[i] );
+	}
+	Compute(compact, input);
+	for (int i=0; i<n; i++) {
+		REQUIRE( compact[i] == expectedCompact[i] );
+	}
+	SWIFFT_AddMultiple(n, expected[0].data, operand[0].data);
+	SWIFFT_MulMultiple(n, expected[0].data, operand[0].data);
+	SWIFFT_SubMultiple(n, expected[0].data, operand[0].data);
+	(((output += operand) *= operand) -= operand);
+	for (int i=0; i<n; i++) {
+		REQUIRE( output[i] == expected[i] );
+	}
+	SwifftOutput sum, expectedSum;
+	SWIFFT_SumMultiple(n, expected[0].data, expectedSum.data);
+	REQUIRE( Sum(sum, output) == expectedSum );
+	SwifftOutputBatch shorter(n - 1);
+	REQUIRE_THROWS_AS( Compute(shorter, input), std::invalid_argument );
+	REQUIRE_THROWS_AS( output += shorter, std::invalid_argument );
+	SwifftOutput *data = output.data;
+	other = std::move(output);
+	REQUIRE( other.data == data );
+	REQUIRE( other.size == n );
+	REQUIRE( output.data == NULL );
+	REQUIRE( output.size == 0 );
+	SwifftOutputBatch moved(std::move(other));
+	REQUIRE( moved.data == data );
+	REQUIRE( other.data == NULL );
+	REQUIRE_THROWS_AS( SwifftOutputBatch(-1), std::bad_alloc );
+}
+
+TEST_CASE( "swifft parallelization parameters apply per kind of operation", "[swifft]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_parallelization_t parallelization;
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		REQUIRE( 0 == SWIFFT_GetParallelization(op, &parallelization) );
+		REQUIRE( parallelization.threshold >= 0 );
+		REQUIRE( parallelization.grain >= 1 );
+	}
+	REQUIRE( -1 == SWIFFT_GetParallelization(SWIFFT_PARALLEL_NOPS, &parallelization) );
+	// out-of-range parameters are clamped
+	const swifft_parallelization_t invalid = {-5, 0};
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_ARITH, &invalid);
+	SWIFFT_GetParallelization(SWIFFT_PARALLEL_ARITH, &parallelization);
+	REQUIRE( (parallelization.threshold == 0 && parallelization.grain == 1) );
+	// the threshold of one kind of operation does not affect another, the grain sets the ranges
+	const swifft_parallelization_t serial = {1000, 1}, parallel = {0, 5};
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_ARITH, &serial);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPACT, &parallel);
+	const int n = 64;
+	Array<SwifftOutput> output(n), operand(n);
+	Array<SwifftCompact> compact(n);
+	memset(output.array[0].data, 1, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	memset(operand.array[0].data, 2, n * SWIFFT_OUTPUT_BLOCK_SIZE);
+	TestReverseExecutor reverse;
+	SWIFFT_SetExecutor(&reverse.executor);
+	SWIFFT_AddMultiple(n, output.array[0].data, operand.array[0].data);
+	REQUIRE( reverse.ncalls == 0 );
+	SWIFFT_CompactMultiple(n, output.array[0].data, compact.array[0].data);
+	REQUIRE( reverse.ncalls == 1 );
+	REQUIRE( reverse.nranges == (n + 4) / 5 );
+	// the grain of SWIFFT_ComputeMultiple is rounded up to whole interleaved groups
+	Array<SwifftInput> input(n);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPUTE, &parallel);
+	SWIFFT_ComputeMultiple(n, input.array[0].data, output.array[0].data);
+	REQUIRE( reverse.ncalls == 2 );
+	REQUIRE( reverse.grain % 4 == 0 );
+	SWIFFT_SetExecutor(executor);
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, NULL);
+	}
+}
+
+TEST_CASE( "swifft calibrates the parallelization parameters", "[swifft]" ) {
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(2);
+	REQUIRE( pool != NULL );
+	SWIFFT_SetExecutor(pool);
+	swifft_calibration_t calibration;
+	REQUIRE( 0 == SWIFFT_CalibrateParallelization(&calibration) );
+	REQUIRE( calibration.dispatchNanos > 0 );
+	CAPTURE( calibration.dispatchNanos );
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		CAPTURE( op );
+		CAPTURE( calibration.blockNanos[op] );
+		CAPTURE( calibration.parallelization[op].threshold );
+		CAPTURE( calibration.parallelization[op].grain );
+		swifft_parallelization_t parallelization;
+		SWIFFT_GetParallelization(op, &parallelization);
+		REQUIRE( calibration.blockNanos[op] > 0 );
+		REQUIRE( parallelization.threshold == calibration.parallelization[op].threshold );
+		REQUIRE( parallelization.grain == calibration.parallelization[op].grain );
+		REQUIRE( parallelization.threshold >= 1 );
+		REQUIRE( parallelization.grain >= 1 );
+	}
+	// the per-block cost of computing exceeds that of compacting or arithmetic
+	REQUIRE( calibration.blockNanos[SWIFFT_PARALLEL_COMPUTE] > calibration.blockNanos[SWIFFT_PARALLEL_ARITH] );
+	REQUIRE( calibration.parallelization[SWIFFT_PARALLEL_COMPUTE].threshold <=
+		calibration.parallelization[SWIFFT_PARALLEL_ARITH].threshold );
+	std::vector<BitSequence> result = test_swifft_multiple_all(131);
+	SWIFFT_SetExecutor(NULL);
+	REQUIRE( result == test_swifft_multiple_all(131) );
+	SWIFFT_DestroyThreadPool(pool);
+	SWIFFT_SetExecutor(executor);
+	for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+		SWIFFT_SetParallelization(op, NULL);
+	}
+}
+
+
+TEST_CASE( "swifft memo cache computes the same as the multiple functions", "[swifft]" ) {
+	// the squares modulo 7 pick 4 of the 7 distinct blocks
+	const int n = 203, ndistinct = 7, nused = 4;
+	Array<SwifftInput> distinct(ndistinct), input(n), sign(n);
+	Array<SwifftOutput> expected(n), output(n);
+	Array<SwifftCompact> expectedCompact(n), compact(n);
+	randomize(distinct.array, ndistinct);
+	memset(distinct.array[0].data, 0, SWIFFT_INPUT_BLOCK_SIZE);
+	for (int i=0; i<n; i++) {
+		input.array[i] = distinct.array[(i * i) % ndistinct];
+		sign.array[i] = distinct.array[(i / 3) % 2];
+	}
+	swifft_stats_t stats;
+	SWIFFT_ResetStats();
+	const bool counting = (SWIFFT_GetStats(&stats) == 0);
+	// a cache too small for the distinct blocks is still correct
+	const size_t sizes[] = {0, 4};
+	for (size_t size : sizes) {
+		swifft_cache_t *cache = SWIFFT_CreateCache(size);
+		REQUIRE( cache != NULL );
+		for (int round=0; round<2; round++) {
+			SWIFFT_ResetStats();
+			SWIFFT_ComputeMultiple(n, input.array[0].data, expected.array[0].data);
+			SWIFFT_CacheComputeMultiple(cache, n, input.array[0].data, output.array[0].data);
+			if (counting && size == 0) {
+				REQUIRE( 0 == SWIFFT_GetStats(&stats) );
+				REQUIRE( stats.cacheHits + stats.cacheMisses == n );
+				REQUIRE( stats.cacheMisses == ((round == 0) ? (uint64_t)nused : 0) );
+				REQUIRE( stats.op[SWIFFT_PARALLEL_COMPUTE].blocks == n + stats.cacheMisses );
+			}
+			SWIFFT_CompactMultiple(n, expected.array[0].data, expectedCompact.array[0].data);
+			SWIFFT_CacheComputeCompactMultiple(cache, n, input.array[0].data, compact.array[0].data);
+			for (int i=0; i<n; i++) {
+				REQUIRE( output.array[i] == expected.array[i] );
+				REQUIRE( compact.array[i] == expectedCompact.array[i] );
+			}
+			SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expected.array[0].data);
+			SWIFFT_CacheComputeMultipleSigned(cache, n, input.array[0].data, sign.array[0].data, output.array[0].data);
+			SWIFFT_CompactMultiple(n, expected.array[0].data, expectedCompact.array[0].data);
+			SWIFFT_CacheComputeCompactMultipleSigned(cache, n, input.array[0].data, sign.array[0].data, compact.array[0].data);
+			for (int i=0; i<n; i++) {
+				REQUIRE( output.array[i] == expected.array[i] );
+				REQUIRE( compact.array[i] == expectedCompact.array[i] );
+			}
+		}
+		SWIFFT_ClearCache(cache);
+		SWIFFT_DestroyCache(cache);
+	}
+	SWIFFT_DestroyCache(NULL);
+	SWIFFT_ResetStats();
+	// threads sharing a cache
+	SwifftCache cache(8);
+	std::vector<std::thread> threads;
+	std::atomic<int> mismatches(0);
+	SWIFFT_ComputeMultipleSigned(n, input.array[0].data, sign.array[0].data, expected.array[0].data);
+	for (int t=0; t<3; t++) {
+		threads.emplace_back([&]() {
+			Array<SwifftOutput> out(n);
+			for (int round=0; round<20; round++) {
+				cache.ComputeMultiple(n, out.array, input.array, sign.array);
+				for (int i=0; i<n; i++) {
+					mismatches += !(out.array[i] == expected.array[i]);
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	REQUIRE( mismatches == 0 );
+}
+
+TEST_CASE( "swifft statistics count each outermost operation once with any executor", "[swifft]" ) {
+	swifft_stats_t stats;
+	if (SWIFFT_GetStats(&stats) != 0) {
+		// not built with SWIFFT_ENABLE_STATS: no statistics are reported
+		for (int op=0; op<SWIFFT_PARALLEL_NOPS; op++) {
+			REQUIRE( stats.op[op].calls == 0 );
+			REQUIRE( stats.op[op].blocks == 0 );
+		}
+		return;
+	}
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_executor_t *pool = SWIFFT_CreateThreadPool(3);
+	REQUIRE( pool != NULL );
+	const swifft_parallelization_t parallel = {0, 5};
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPUTE, &parallel);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPACT, &parallel);
+	const int n = 67;
+	Array<SwifftInput> input(n);
+	Array<SwifftOutput> output(n);
+	Array<SwifftCompact> compact(n);
+	randomize(input.array, n);
+	const swifft_executor_t *executors[] = {NULL, pool};
+	for (const swifft_executor_t *e : executors) {
+		SWIFFT_SetExecutor(e);
+		SWIFFT_ResetStats();
+		SWIFFT_ComputeMultiple(n, input.array[0].data, output.array[0].data);
+		SWIFFT_CompactMultiple(n, output.array[0].data, compact.array[0].data);
+		SWIFFT_ComputeCompact(input.array[0].data, compact.array[0].data);
+		REQUIRE( 0 == SWIFFT_GetStats(&stats) );
+		const swifft_op_stats_t &compute = stats.op[SWIFFT_PARALLEL_COMPUTE];
+		const swifft_op_stats_t &compacting = stats.op[SWIFFT_PARALLEL_COMPACT];
+		REQUIRE( compute.calls == 2 );
+		REQUIRE( compute.blocks == n + 1 );
+		REQUIRE( compute.bytes == (n + 1) * SWIFFT_INPUT_BLOCK_SIZE );
+		// the compaction within SWIFFT_ComputeCompact is counted too
+		REQUIRE( compacting.calls == 2 );
+		REQUIRE( compacting.blocks == n + 1 );
+		REQUIRE( compacting.bytes == (n + 1) * SWIFFT_OUTPUT_BLOCK_SIZE );
+		REQUIRE( compute.serialRuns + compute.parallelRuns == 1 );
+		REQUIRE( compute.parallelRuns == ((e != NULL) ? 1 : 0) );
+		REQUIRE( compacting.parallelRuns == ((e != NULL) ? 1 : 0) );
+		REQUIRE( stats.op[SWIFFT_PARALLEL_ARITH].calls == 0 );
+	}
+	SWIFFT_ResetStats();
+	REQUIRE( 0 == SWIFFT_GetStats(&stats) );
+	REQUIRE( stats.op[SWIFFT_PARALLEL_COMPUTE].calls == 0 );
+	SWIFFT_SetExecutor(executor);
+	SWIFFT_DestroyThreadPool(pool);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPUTE, NULL);
+	SWIFFT_SetParallelization(SWIFFT_PARALLEL_COMPACT, NULL);
+}
+
 } // end namespace LibSwifft
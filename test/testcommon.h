@@ -9,6 +9,24 @@
 #ifndef __LIBSWIFFT_TESTCOMMON_H_
 #define __LIBSWIFFT_TESTCOMMON_H_
 
+#if defined(__aarch64__)
+//! \brief Measure the virtual counter at start of segment, which ticks at a fixed frequency
+//! rather than per cycle as RDTSC does
+//! \returns the counter measurement
+LIBSWIFFT_INLINE uint64_t rdtsc_start() {
+	uint64_t ticks;
+	__asm__ __volatile__ ("isb; mrs %0, cntvct_el0" : "=r" (ticks) :: "memory");
+	return ticks;
+}
+
+//! \brief Measure the virtual counter at end of segment
+//! \returns the counter measurement
+LIBSWIFFT_INLINE uint64_t rdtsc_stop() {
+	uint64_t ticks;
+	__asm__ __volatile__ ("isb; mrs %0, cntvct_el0" : "=r" (ticks) :: "memory");
+	return ticks;
+}
+#else
 //! \brief Measure RDTSC at start of segment
 //! \returns the RDTSC measurement
 LIBSWIFFT_INLINE uint64_t rdtsc_start() {
@@ -32,5 +50,6 @@ LIBSWIFFT_INLINE uint64_t rdtsc_stop() {
 		::: "%rax", "%rbx", "%rcx", "%rdx" );
 		return (uint64_t)high << 32 | low;
 }
+#endif
 
 #endif /* __LIBSWIFFT_TESTCOMMON_H_ */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Yaron Gvili and Gvili Tech Ltd.
+ *
+ * See the accompanying LICENSE.txt file for licensing information.
+ */
+/*! \file tools/swifft_sum.c
+ * \brief LibSWIFFT file-hashing tool
+ *
+ * Prints the tree-hash digest of each file, in hexadecimal followed by the path,
+ * like the sha256sum tool does, and its throughput to the standard error. Files
+ * are memory-mapped where possible, and otherwise read, and their blocks are
+ * hashed by a NUMA-aware thread pool.
+ *
+ * Run with --help for the options.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "libswifft/swifft_executor.h"
+#include "libswifft/swifft_file.h"
+#include "libswifft/swifft_numa.h"
+
+static const char *usage =
+	"usage: swifft_sum [options] [file...]\n"
+	"  Prints the SWIFFT tree-hash digest of each file, or of the standard input if none or -.\n"
+	"  --threads=N             the number of hashing threads (default: one per CPU)\n"
+	"  --read                  read files rather than memory-map them\n"
+	"  --direct                read files bypassing the page cache, where possible\n"
+	"  --quiet                 do not print the throughput\n";
+
+//! \brief Returns the time in nanoseconds from a monotonic clock.
+static double nanos(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! \brief Hashes a file and prints its digest and throughput.
+//!
+//! \param[in] path the path of the file, or "-" for the standard input.
+//! \param[in] flags a combination of SWIFFT_FILE_* flags.
+//! \param[in] quiet whether not to print the throughput.
+//! \returns 0 on success, or 1 if the file could not be hashed.
+static int sum(const char *path, int flags, int quiet)
+{
+	BitSequence digest[SWIFFT_COMPACT_BLOCK_SIZE];
+	swifft_file_info_t info;
+	double start = nanos(), seconds;
+	int i, result;
+	if (strcmp(path, "-") == 0) {
+		result = SWIFFT_TreeHashFd(STDIN_FILENO, flags, digest, &info);
+	}
+	else {
+		result = SWIFFT_TreeHashFile(path, flags, digest, &info);
+	}
+	if (result != 0) {
+		fprintf(stderr, "swifft_sum: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+	seconds = (nanos() - start) / 1e9;
+	for (i=0; i<SWIFFT_COMPACT_BLOCK_SIZE; i++) {
+		printf("%02x", digest[i]);
+	}
+	printf("  %s\n", path);
+	fflush(stdout);
+	if (!quiet) {
+		fprintf(stderr, "swifft_sum: %s: %llu bytes %s in %.3f s, %.3f GB/s\n", path,
+			(unsigned long long)info.bytes, info.mapped ? "mapped" : (info.direct ? "read direct" : "read"),
+			seconds, (seconds > 0) ? info.bytes / seconds / 1e9 : 0.0);
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const swifft_executor_t *executor = SWIFFT_GetExecutor();
+	swifft_executor_t *pool = NULL;
+	int flags = 0, quiet = 0, nthreads = 0, nfiles = 0, status = 0;
+	int i;
+	for (i=1; i<argc && strncmp(argv[i], "--", 2) == 0; i++) {
+		char *end;
+		if (strcmp(argv[i], "--") == 0) {
+			i++;
+			break;
+		}
+		else if (strncmp(argv[i], "--threads=", 10) == 0 && (nthreads = (int)strtol(argv[i] + 10, &end, 10)) > 0 && *end == '\0') {
+		}
+		else if (strcmp(argv[i], "--read") == 0) {
+			flags |= SWIFFT_FILE_NO_MAP;
+		}
+		else if (strcmp(argv[i], "--direct") == 0) {
+			flags |= SWIFFT_FILE_DIRECT;
+		}
+		else if (strcmp(argv[i], "--quiet") == 0) {
+			quiet = 1;
+		}
+		else {
+			fputs(usage, stderr);
+			return (argc == 2 && strcmp(argv[1], "--help") == 0) ? 0 : 1;
+		}
+	}
+	if (nthreads != 1) {
+		pool = SWIFFT_CreateNumaThreadPool(nthreads, 0);
+		if (pool == NULL) {
+			fprintf(stderr, "swifft_sum: hashing on one thread: no thread pool\n");
+		}
+		SWIFFT_SetExecutor(pool);
+	}
+	for (; i<argc; i++,nfiles++) {
+		status |= sum(argv[i], flags, quiet);
+	}
+	if (nfiles == 0) {
+		status |= sum("-", flags, quiet);
+	}
+	SWIFFT_DestroyThreadPool(pool);
+	SWIFFT_SetExecutor(executor);
+	return status;
+}